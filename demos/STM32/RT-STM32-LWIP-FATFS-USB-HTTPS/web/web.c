@@ -31,6 +31,7 @@
  */
 
 #include <ctype.h>
+#include <string.h>
 
 #include "ch.h"
 
@@ -43,7 +44,6 @@
 
 #if LWIP_NETCONN
 
-static char url_buffer[WEB_MAX_PATH_SIZE];
 extern unsigned char server_cert[];
 extern unsigned int server_cert_len;
 extern unsigned char server_key[];
@@ -126,14 +126,31 @@ static bool decode_url(const char *url, char *buf, size_t max) {
 #define MAX_HTTPREQ_SIZE 256
 static const char http_html_hdr[] = "HTTP/1.1 200 OK\r\nContent-type: text/html\r\n\r\n";
 static const char http_index_html[] = "<html><head><title>Congrats!</title></head><body><h1>Welcome to chibiOS HTTPS server!</h1><p>Powered by LwIP + WolfSSL</body></html>";
+static const char http_bench_hdr[] = "HTTP/1.1 200 OK\r\nContent-type: application/octet-stream\r\n\r\n";
 
-static char inbuf[MAX_HTTPREQ_SIZE];
+/**
+ * @brief   Payload of the throughput test, sent repeatedly.
+ */
+static char bench_chunk[WEB_BENCH_CHUNK_SIZE];
+
+/**
+ * @brief   Serves a single request.
+ * @note    Buffers are on the stack because connections are served
+ *          concurrently.
+ *
+ * @param[in] sc        the SSL connection
+ *
+ * @notapi
+ */
 static void https_server_serve(sslconn *sc) 
 {
+  char inbuf[MAX_HTTPREQ_SIZE];
+  char url_buffer[WEB_MAX_PATH_SIZE];
+  size_t sent;
   int ret;
 
   /* Read the data from the port, blocking if nothing yet there.
-     We assume the request (the part we care about) is in one netbuf.*/
+     We assume the request (the part we care about) is in one record.*/
   ret = wolfSSL_read(sc->ssl, inbuf, MAX_HTTPREQ_SIZE);
   if (ret >= 5 &&
           inbuf[0] == 'G' &&
@@ -147,9 +164,20 @@ static void https_server_serve(sslconn *sc)
           return;
       }
 
+      if (strcmp(url_buffer, "/bench") == 0) {
+          /* Throughput test, WEB_BENCH_SIZE bytes are streamed.*/
+          if (wolfSSL_write(sc->ssl, http_bench_hdr,
+                            sizeof(http_bench_hdr)-1) <= 0)
+              return;
+          for (sent = 0; sent < WEB_BENCH_SIZE; sent += sizeof bench_chunk) {
+              if (wolfSSL_write(sc->ssl, bench_chunk, sizeof bench_chunk) <= 0)
+                  return;
+          }
+          return;
+      }
+
       /* Send the HTML header
        * subtract 1 from the size, since we dont send the \0 in the string
-       * NETCONN_NOCOPY: our data is const static, so no need to copy it
        */
       wolfSSL_write(sc->ssl, http_html_hdr, sizeof(http_html_hdr)-1);
 
@@ -158,6 +186,40 @@ static void https_server_serve(sslconn *sc)
   }
 }
 
+/**
+ * @brief   HTTPS connections worker.
+ * @details Each worker accepts and serves connections from the listening
+ *          connection, there are @p WEB_MAX_CONNECTIONS workers.
+ *
+ * @param[in] sc        the listening SSL connection
+ *
+ * @notapi
+ */
+static void https_server_worker(sslconn *sc)
+{
+  sslconn *newsc;
+
+  while (true) {
+    newsc = sslconn_accept(sc);
+    if (!newsc) {
+        chThdSleepMilliseconds(500);
+        continue;
+    }
+    /* New connection: a new SSL connector is spawned */
+    https_server_serve(newsc);
+    sslconn_close(newsc);
+  }
+}
+
+/**
+ * @brief   Additional workers thread function.
+ */
+static THD_FUNCTION(https_worker, p) {
+
+  chRegSetThreadName("https_worker");
+  https_server_worker((sslconn *)p);
+}
+
 /**
  * @brief   Stack area for the http thread.
  */
@@ -167,10 +229,13 @@ THD_WORKING_AREA(wa_https_server, WEB_THREAD_STACK_SIZE);
  * @brssl   HTTPS server thread.
  */
 THD_FUNCTION(https_server, p) {
-  sslconn *sc, *newsc;
+  sslconn *sc;
+  unsigned i;
   (void)p;
   chRegSetThreadName("https");
 
+  memset(bench_chunk, 'x', sizeof bench_chunk);
+
   /* Initialize wolfSSL */
   wolfSSL_Init();
 
@@ -199,17 +264,16 @@ THD_FUNCTION(https_server, p) {
   /* Goes to the final priority after initialization.*/
   chThdSetPriority(WEB_THREAD_PRIORITY);
 
-  /* Listening loop */
-  while (true) {
-    newsc = sslconn_accept(sc);
-    if (!newsc) {
-        chThdSleepMilliseconds(500);
-        continue;
-    }
-    /* New connection: a new SSL connector is spawned */
-    https_server_serve(newsc);
-    sslconn_close(newsc);
+  /* Additional workers, this thread is the first one.*/
+  for (i = 1; i < WEB_MAX_CONNECTIONS; i++) {
+    if (!chThdCreateFromHeap(NULL, THD_WORKING_AREA_SIZE(WEB_THREAD_STACK_SIZE),
+                             "https_worker", WEB_THREAD_PRIORITY,
+                             https_worker, sc))
+      break;
   }
+
+  /* Listening loop */
+  https_server_worker(sc);
 }
 
 #endif /* LWIP_NETCONN */
@@ -40,6 +40,31 @@
 #define WEB_MAX_PATH_SIZE               128
 #endif
 
+/*
+ * Number of connections served concurrently, each one has its own thread
+ * of WEB_THREAD_STACK_SIZE bytes, the additional ones are allocated from
+ * the heap.
+ */
+#if !defined(WEB_MAX_CONNECTIONS)
+#define WEB_MAX_CONNECTIONS             3
+#endif
+
+/*
+ * Throughput test, "GET /bench" streams WEB_BENCH_SIZE bytes in writes of
+ * WEB_BENCH_CHUNK_SIZE bytes. Running several clients at once measures
+ * the aggregate TLS throughput, for example:
+ *   for i in 1 2 3; do
+ *     curl -k -s -o /dev/null -w "%{speed_download}\n" https://<ip>/bench &
+ *   done
+ */
+#if !defined(WEB_BENCH_SIZE)
+#define WEB_BENCH_SIZE                  (1024 * 1024)
+#endif
+
+#if !defined(WEB_BENCH_CHUNK_SIZE)
+#define WEB_BENCH_CHUNK_SIZE            1024
+#endif
+
 extern THD_WORKING_AREA(wa_https_server, WEB_THREAD_STACK_SIZE);
 
 #ifdef __cplusplus
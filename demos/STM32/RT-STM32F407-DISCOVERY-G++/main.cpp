@@ -14,8 +14,13 @@
     limitations under the License.
 */
 
+#include <list>
+#include <map>
+#include <vector>
+
 #include "ch.hpp"
 #include "hal.h"
+#include "chprintf.h"
 #include "rt_test_root.h"
 #include "oslib_test_root.h"
 
@@ -164,9 +169,302 @@ public:
 };
 
 /*
- * Tester thread class. This thread executes the test suite.
+ * Allocators benchmark, the same workloads are executed using the default
+ * allocator and the ChibiOS memory resources and allocators.
+ */
+#define BMK_ITERATIONS          32
+#define BMK_ELEMENTS            64
+
+/* Node size of the std::list and std::map containers used in the benchmark,
+   it is larger than both nodes on the usual ABIs.*/
+#define BMK_NODE_SIZE           (6 * sizeof (void *) + 2 * sizeof (int))
+
+/* Pool for the containers nodes, larger requests go to the heap.*/
+static ObjectsPool<uint8_t[BMK_NODE_SIZE], BMK_ELEMENTS + 4> bmk_nodes;
+
+template<class V, class L, class M, class... A>
+static rtcnt_t bmk_run(void (*reset)(void), A... args) {
+  rtcnt_t start = chSysGetRealtimeCounterX();
+
+  for (int i = 0; i < BMK_ITERATIONS; i++) {
+    {
+      V v(args...);
+      for (int j = 0; j < BMK_ELEMENTS * 4; j++) {
+        v.push_back(j);
+      }
+    }
+    {
+      L l(args...);
+      for (int j = 0; j < BMK_ELEMENTS; j++) {
+        l.push_back(j);
+      }
+      while (!l.empty()) {
+        l.pop_front();
+      }
+    }
+    {
+      M m(args...);
+      for (int j = 0; j < BMK_ELEMENTS; j++) {
+        m[(j * 37) % BMK_ELEMENTS] = j;
+      }
+      for (int j = 0; j < BMK_ELEMENTS; j++) {
+        m.erase(j);
+      }
+    }
+    if (reset != nullptr) {
+      reset();
+    }
+  }
+
+  return chSysGetRealtimeCounterX() - start;
+}
+
+#if CH_CPP_USE_MEMORY_RESOURCES == TRUE
+static ArenaResource bmk_arena;
+
+static void bmk_arena_release(void) {
+
+  bmk_arena.release();
+}
+#endif
+
+static void bmk_print(BaseSequentialStream *chp, const char *name,
+                      rtcnt_t cycles) {
+
+  chprintf(chp, "--- %-24s: %9U cycles\r\n", name,
+           (uint32_t)(cycles / BMK_ITERATIONS));
+}
+
+static void memory_benchmark(BaseSequentialStream *chp) {
+
+  chprintf(chp, "\r\n*** Allocators benchmark, cycles per iteration\r\n");
+
+  bmk_print(chp, "std::allocator",
+            bmk_run<std::vector<int>,
+                    std::list<int>,
+                    std::map<int, int>>(nullptr));
+
+  bmk_print(chp, "HeapAllocator",
+            bmk_run<std::vector<int, HeapAllocator<int>>,
+                    std::list<int, HeapAllocator<int>>,
+                    std::map<int, int, std::less<int>,
+                             HeapAllocator<std::pair<const int, int>>>>(nullptr));
+
+#if CH_CPP_USE_MEMORY_RESOURCES == TRUE
+  HeapResource heap_resource;
+  PoolResource pool_resource(bmk_nodes, &heap_resource);
+
+  bmk_print(chp, "HeapResource",
+            bmk_run<std::pmr::vector<int>,
+                    std::pmr::list<int>,
+                    std::pmr::map<int, int>>(nullptr, &heap_resource));
+
+  bmk_print(chp, "PoolResource",
+            bmk_run<std::pmr::vector<int>,
+                    std::pmr::list<int>,
+                    std::pmr::map<int, int>>(nullptr, &pool_resource));
+
+  bmk_print(chp, "ArenaResource",
+            bmk_run<std::pmr::vector<int>,
+                    std::pmr::list<int>,
+                    std::pmr::map<int, int>>(bmk_arena_release, &bmk_arena));
+#endif
+}
+
+#if CH_CPP_USE_COROUTINES == TRUE
+/*
+ * Coroutines benchmark, two coroutines sharing the tester thread and two
+ * threads exchange the control using a pair of semaphores.
+ */
+#define BMK_ROUNDS              1000
+#define BMK_FRAME_SIZE          128
+
+static ObjectsPool<uint8_t[BMK_FRAME_SIZE], 2> bmk_frames;
+static CounterSemaphore bmk_sem_a(0), bmk_sem_b(0);
+
+static CoTask bmk_ping(unsigned n) {
+
+  while (n-- > 0U) {
+    bmk_sem_b.signal();
+    co_await bmk_sem_a;
+  }
+}
+
+static CoTask bmk_pong(unsigned n) {
+
+  while (n-- > 0U) {
+    co_await bmk_sem_b;
+    bmk_sem_a.signal();
+  }
+}
+
+class PongThread : public BaseStaticThread<256> {
+
+protected:
+  void main(void) override {
+
+    setName("pong");
+
+    for (unsigned i = 0U; i < BMK_ROUNDS; i++) {
+      bmk_sem_b.wait();
+      bmk_sem_a.signal();
+    }
+  }
+
+public:
+  PongThread(void) : BaseStaticThread<256>() {
+  }
+};
+
+static PongThread pong_thread;
+
+static void coroutines_benchmark(BaseSequentialStream *chp) {
+  CoroutineScheduler sched;
+  rtcnt_t start, cycles;
+
+  chprintf(chp, "\r\n*** Coroutines benchmark\r\n");
+
+  CoTask::setFramesPool(&bmk_frames);
+  sched.spawn(bmk_ping(BMK_ROUNDS));
+  sched.spawn(bmk_pong(BMK_ROUNDS));
+  start = chSysGetRealtimeCounterX();
+  sched.run();
+  cycles = chSysGetRealtimeCounterX() - start;
+  chprintf(chp, "--- Coroutine switch          : %9U cycles\r\n",
+           (uint32_t)(cycles / (2U * BMK_ROUNDS)));
+
+  ThreadReference tr = pong_thread.start(chThdGetPriorityX());
+  start = chSysGetRealtimeCounterX();
+  for (unsigned i = 0U; i < BMK_ROUNDS; i++) {
+    bmk_sem_b.signal();
+    bmk_sem_a.wait();
+  }
+  cycles = chSysGetRealtimeCounterX() - start;
+  tr.wait();
+  chprintf(chp, "--- Thread switch             : %9U cycles\r\n",
+           (uint32_t)(cycles / (2U * BMK_ROUNDS)));
+
+  chprintf(chp, "--- Coroutine frame           : %9U bytes\r\n",
+           (uint32_t)CoTask::getMaxFrameSize());
+  chprintf(chp, "--- Thread working area       : %9U bytes\r\n",
+           (uint32_t)THD_WORKING_AREA_SIZE(256));
+}
+#endif
+
+#if CH_CPP_USE_LOCKFREE_QUEUES == TRUE
+/*
+ * Queues benchmark, mailboxes are compared with the lock-free queues, first
+ * with a single thread moving elements in and out, then with a producer
+ * thread streaming elements to the tester thread.
+ */
+#define BMK_QUEUE_SIZE          16
+#define BMK_TRANSFERS           4096
+
+static Mailbox<msg_t, BMK_QUEUE_SIZE> bmk_mb;
+static SPSCQueue<msg_t, BMK_QUEUE_SIZE> bmk_spsc;
+static MPSCQueue<msg_t, BMK_QUEUE_SIZE> bmk_mpsc;
+static BlockingQueue<SPSCQueue<msg_t, BMK_QUEUE_SIZE>> bmk_bq;
+
+class ProducerThread : public BaseStaticThread<256> {
+  bool use_mailbox;
+
+protected:
+  void main(void) override {
+
+    setName("producer");
+
+    for (msg_t i = 0; i < BMK_TRANSFERS; i++) {
+      if (use_mailbox) {
+        bmk_mb.post(i, TIME_INFINITE);
+      }
+      else {
+        bmk_bq.push(i, TIME_INFINITE);
+      }
+    }
+  }
+
+public:
+  ProducerThread(void) : BaseStaticThread<256>(), use_mailbox(false) {
+  }
+
+  void setMailbox(bool mailbox) {
+
+    use_mailbox = mailbox;
+  }
+};
+
+static ProducerThread producer_thread;
+
+template <typename F>
+static rtcnt_t bmk_measure(F f) {
+  rtcnt_t start = chSysGetRealtimeCounterX();
+
+  for (msg_t i = 0; i < BMK_TRANSFERS; i++) {
+    f(i);
+  }
+
+  return (chSysGetRealtimeCounterX() - start) / BMK_TRANSFERS;
+}
+
+static rtcnt_t bmk_stream(bool mailbox) {
+  ThreadReference tr;
+  rtcnt_t cycles;
+
+  producer_thread.setMailbox(mailbox);
+  tr = producer_thread.start(chThdGetPriorityX());
+  cycles = bmk_measure([mailbox](msg_t i) {
+    msg_t v;
+
+    if (mailbox) {
+      bmk_mb.fetch(&v, TIME_INFINITE);
+    }
+    else {
+      bmk_bq.pop(v, TIME_INFINITE);
+    }
+    chDbgAssert(v == i, "out of order");
+  });
+  tr.wait();
+
+  return cycles;
+}
+
+static void queues_benchmark(BaseSequentialStream *chp) {
+  msg_t v;
+
+  chprintf(chp, "\r\n*** Queues benchmark, cycles per element\r\n");
+
+  chprintf(chp, "--- Mailbox in+out            : %9U cycles\r\n",
+           (uint32_t)bmk_measure([&v](msg_t i) {
+             bmk_mb.post(i, TIME_IMMEDIATE);
+             bmk_mb.fetch(&v, TIME_IMMEDIATE);
+           }));
+  chprintf(chp, "--- SPSCQueue in+out          : %9U cycles\r\n",
+           (uint32_t)bmk_measure([&v](msg_t i) {
+             bmk_spsc.tryPush(i);
+             bmk_spsc.tryPop(v);
+           }));
+  chprintf(chp, "--- MPSCQueue in+out          : %9U cycles\r\n",
+           (uint32_t)bmk_measure([&v](msg_t i) {
+             bmk_mpsc.tryPush(i);
+             bmk_mpsc.tryPop(v);
+           }));
+  chprintf(chp, "--- BlockingQueue in+out      : %9U cycles\r\n",
+           (uint32_t)bmk_measure([&v](msg_t i) {
+             bmk_bq.push(i, TIME_IMMEDIATE);
+             bmk_bq.pop(v, TIME_IMMEDIATE);
+           }));
+  chprintf(chp, "--- Mailbox stream            : %9U cycles\r\n",
+           (uint32_t)bmk_stream(true));
+  chprintf(chp, "--- BlockingQueue stream      : %9U cycles\r\n",
+           (uint32_t)bmk_stream(false));
+}
+#endif
+
+/*
+ * Tester thread class. This thread executes the test suite and the
+ * benchmarks.
  */
-class TesterThread : public BaseStaticThread<256> {
+class TesterThread : public BaseStaticThread<1024> {
 
 protected:
   void main(void) override {
@@ -175,11 +473,18 @@ protected:
 
     test_execute((BaseSequentialStream *)&SD2, &rt_test_suite);
     test_execute((BaseSequentialStream *)&SD2, &oslib_test_suite);
+    memory_benchmark((BaseSequentialStream *)&SD2);
+#if CH_CPP_USE_COROUTINES == TRUE
+    coroutines_benchmark((BaseSequentialStream *)&SD2);
+#endif
+#if CH_CPP_USE_LOCKFREE_QUEUES == TRUE
+    queues_benchmark((BaseSequentialStream *)&SD2);
+#endif
     exit(chtest.global_fail);
   }
 
 public:
-  TesterThread(void) : BaseStaticThread<256>() {
+  TesterThread(void) : BaseStaticThread<1024>() {
   }
 };
 
@@ -89,6 +89,17 @@
 #define SB_CFG_EXEC_DEBUG                   FALSE
 #endif
 
+/**
+ * @brief   Enables in-place access to read-only sections of sandbox files.
+ * @note    Only effective for files stored on a memory-mapped file system
+ *          and with a non-writable executable region covering it.
+ * @note    Sections requiring relocation, including @p .text, are still
+ *          loaded in RAM.
+ */
+#if !defined(SB_CFG_ELF_ENABLE_XIP) || defined(__DOXYGEN__)
+#define SB_CFG_ELF_ENABLE_XIP               TRUE
+#endif
+
 #endif  /* SBCONF_H */
 
 /** @} */
@@ -79,6 +79,13 @@
 #define VFS_CFG_ENABLE_DRV_STREAMS          TRUE
 #endif
 
+/**
+ * @brief   Enables the VFS ROM FS Driver.
+ */
+#if !defined(VFS_CFG_ENABLE_DRV_ROMFS) || defined(__DOXYGEN__)
+#define VFS_CFG_ENABLE_DRV_ROMFS            TRUE
+#endif
+
 /**
  * @brief   Enables the VFS ChibiFS Driver.
  */
@@ -148,6 +155,29 @@
 
 /** @} */
 
+/*===========================================================================*/
+/**
+ * @name ROM FS driver settings
+ * @{
+ */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of directory nodes pre-allocated in the pool.
+ */
+#if !defined(DRV_CFG_ROMFS_DIR_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_ROMFS_DIR_NODES_NUM         1
+#endif
+
+/**
+ * @brief   Number of file nodes pre-allocated in the pool.
+ */
+#if !defined(DRV_CFG_ROMFS_FILE_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_ROMFS_FILE_NODES_NUM        2
+#endif
+
+/** @} */
+
 /*===========================================================================*/
 /**
  * @name ChibiFS driver settings
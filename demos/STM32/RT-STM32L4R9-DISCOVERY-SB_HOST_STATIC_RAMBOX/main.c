@@ -24,6 +24,8 @@
 #include "startup_defs.h"
 #include "sdmon.h"
 
+#include "sbelf_test_root.h"
+
 /*===========================================================================*/
 /* VFS-related.                                                              */
 /*===========================================================================*/
@@ -42,6 +44,18 @@ static vfs_overlay_driver_c sb1_root_overlay_driver;
 /* VFS streams driver objects representing the /dev private directories.*/
 static vfs_streams_driver_c sb1_dev_driver;
 
+#if SB_CFG_ELF_ENABLE_XIP == TRUE
+/* VFS ROM FS driver object representing the /rom directory of SB1.*/
+static vfs_romfs_driver_c sb1_rom_driver;
+
+/* The sandbox image can be programmed as a raw file at the start of the
+   flash1 region, the file spans the whole region.*/
+static const drv_romfs_element_t sb1_rom_files[] = {
+  {"msh.elf", (const uint8_t *)STARTUP_FLASH1_BASE, STARTUP_FLASH1_SIZE},
+  {NULL, NULL, 0}
+};
+#endif
+
 /* VFS API will use this object as implicit root, defining this
    symbol is expected.*/
 vfs_driver_c *vfs_root = (vfs_driver_c *)&root_overlay_driver;
@@ -79,6 +93,16 @@ static const char *sbx1_envp[] = {
   NULL
 };
 
+/* Images for SB1, the first one that can be loaded is executed. The image
+   in flash has its read-only sections accessed in place.*/
+static const char *sbx1_images[] = {
+#if SB_CFG_ELF_ENABLE_XIP == TRUE
+  "/rom/msh.elf",
+#endif
+  "/bin/msh.elf",
+  NULL
+};
+
 /*===========================================================================*/
 /* Main and generic code.                                                    */
 /*===========================================================================*/
@@ -117,6 +141,8 @@ static void SBHandler(eventid_t id) {
 int main(void) {
   event_listener_t elsb;
   vfs_node_c *np;
+  const char **pp;
+  rtcnt_t start;
   msg_t ret;
   static const evhandler_t evhndl[] = {
     sdmonInsertHandler,
@@ -166,10 +192,23 @@ int main(void) {
   if (CH_RET_IS_ERROR(ret)) {
     chSysHalt("VFS");
   }
+#if SB_CFG_ELF_ENABLE_XIP == TRUE
+  ret = ovldrvRegisterDriver(&sb1_root_overlay_driver,
+                             (vfs_driver_c *)romfsdrvObjectInit(&sb1_rom_driver,
+                                                                &sb1_rom_files[0]),
+                             "rom");
+  if (CH_RET_IS_ERROR(ret)) {
+    chSysHalt("VFS");
+  }
+#endif
 
-  /* Sandbox object initialization.*/
+  /* Sandbox object initialization, the flash1 region is made accessible
+     to the sandbox for the sections accessed in place.*/
   sbObjectInit(&sbx1);
   sbSetRegion(&sbx1, 0, STARTUP_RAM1_BASE, STARTUP_RAM1_SIZE, SB_REG_IS_CODE_AND_DATA);
+#if SB_CFG_ELF_ENABLE_XIP == TRUE
+  sbSetRegion(&sbx1, 1, STARTUP_FLASH1_BASE, STARTUP_FLASH1_SIZE, SB_REG_IS_CODE);
+#endif
   sbSetFileSystem(&sbx1, (vfs_driver_c *)&sb1_root_overlay_driver);
 
   /* Listening to sandbox events.*/
@@ -179,6 +218,11 @@ int main(void) {
   while (true) {
     chEvtDispatch(evhndl, chEvtWaitOneTimeout(ALL_EVENTS, TIME_MS2I(500)));
 
+    /* The ELF loader test suite is executed when the button is pressed.*/
+    if (palReadLine(LINE_BUTTON)) {
+      test_execute((BaseSequentialStream *)&SD2, &sbelf_test_suite);
+    }
+
     if (sdmon_ready && !sbIsThreadRunningX(&sbx1)) {
 
       /* Small delay before relaunching.*/
@@ -197,13 +241,24 @@ int main(void) {
       vfsClose(np);
 
       /*
-       * Running the sandbox.
+       * Running the sandbox, the time required for loading is measured.
        */
-      ret = sbExecStatic(&sbx1, NORMALPRIO-10, sbx1stk,
-                         "/bin/msh.elf", sbx1_argv, sbx1_envp);
+      for (pp = &sbx1_images[0]; *pp != NULL; pp++) {
+        start = chSysGetRealtimeCounterX();
+        ret = sbExecStatic(&sbx1, NORMALPRIO-10, sbx1stk,
+                           *pp, sbx1_argv, sbx1_envp);
+        if (!CH_RET_IS_ERROR(ret)) {
+          break;
+        }
+      }
       if (CH_RET_IS_ERROR(ret)) {
         chprintf((BaseSequentialStream *)&SD2, "SBX1 launch failed (%08lx)\r\n", ret);
       }
+      else {
+        chprintf((BaseSequentialStream *)&SD2, "SBX1 loaded from %s in %lu us\r\n",
+                 *pp, (unsigned long)RTC2US(STM32_HCLK,
+                                            chSysGetRealtimeCounterX() - start));
+      }
     }
   }
 }
@@ -0,0 +1,353 @@
+/*
+    ChibiOS - Copyright (C) 2006..2025 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    templates/vfsconf.h
+ * @brief   VFS configuration header.
+ *
+ * @addtogroup VFS_CONF
+ * @{
+ */
+
+#ifndef VFSCONF_H
+#define VFSCONF_H
+
+#define _CHIBIOS_VFS_CONF_
+#define _CHIBIOS_VFS_CONF_VER_1_0_
+
+/*===========================================================================*/
+/**
+ * @name VFS general settings
+ * @{
+ */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum filename length.
+ */
+#if !defined(VFS_CFG_NAMELEN_MAX) || defined(__DOXYGEN__)
+#define VFS_CFG_NAMELEN_MAX                 15
+#endif
+
+/**
+ * @brief   Maximum paths length.
+ */
+#if !defined(VFS_CFG_PATHLEN_MAX) || defined(__DOXYGEN__)
+#define VFS_CFG_PATHLEN_MAX                 1023
+#endif
+
+/**
+ * @brief   Number of shared path buffers.
+ */
+#if !defined(VFS_CFG_PATHBUFS_NUM) || defined(__DOXYGEN__)
+#define VFS_CFG_PATHBUFS_NUM                1
+#endif
+
+/** @} */
+
+/*===========================================================================*/
+/**
+ * @name VFS drivers
+ * @{
+ */
+/*===========================================================================*/
+
+/**
+ * @brief   Enables the VFS Overlay Driver.
+ */
+#if !defined(VFS_CFG_ENABLE_DRV_OVERLAY) || defined(__DOXYGEN__)
+#define VFS_CFG_ENABLE_DRV_OVERLAY          TRUE
+#endif
+
+/**
+ * @brief   Enables the VFS Streams Driver.
+ */
+#if !defined(VFS_CFG_ENABLE_DRV_STREAMS) || defined(__DOXYGEN__)
+#define VFS_CFG_ENABLE_DRV_STREAMS          FALSE
+#endif
+
+/**
+ * @brief   Enables the VFS RAM FS Driver.
+ */
+#if !defined(VFS_CFG_ENABLE_DRV_TMPFS) || defined(__DOXYGEN__)
+#define VFS_CFG_ENABLE_DRV_TMPFS            TRUE
+#endif
+
+/**
+ * @brief   Enables the VFS ROM FS Driver.
+ */
+#if !defined(VFS_CFG_ENABLE_DRV_ROMFS) || defined(__DOXYGEN__)
+#define VFS_CFG_ENABLE_DRV_ROMFS            FALSE
+#endif
+
+/**
+ * @brief   Enables the VFS ChibiFS Driver.
+ */
+#if !defined(VFS_CFG_ENABLE_DRV_CHFS) || defined(__DOXYGEN__)
+#define VFS_CFG_ENABLE_DRV_CHFS             TRUE
+#endif
+
+/**
+ * @brief   Enables the VFS FatFS Driver.
+ */
+#if !defined(VFS_CFG_ENABLE_DRV_FATFS) || defined(__DOXYGEN__)
+#define VFS_CFG_ENABLE_DRV_FATFS            FALSE
+#endif
+
+/**
+ * @brief   Enables the VFS LittleFS Driver.
+ */
+#if !defined(VFS_CFG_ENABLE_DRV_LITTLEFS) || defined(__DOXYGEN__)
+#define VFS_CFG_ENABLE_DRV_LITTLEFS         FALSE
+#endif
+
+/** @} */
+
+/*===========================================================================*/
+/**
+ * @name Overlay driver settings
+ * @{
+ */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum number of overlay directories.
+ */
+#if !defined(DRV_CFG_OVERLAY_DRV_MAX) || defined(__DOXYGEN__)
+#define DRV_CFG_OVERLAY_DRV_MAX             2
+#endif
+
+/**
+ * @brief   Number of directory nodes pre-allocated in the pool.
+ */
+#if !defined(DRV_CFG_OVERLAY_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_OVERLAY_DIR_NODES_NUM       1
+#endif
+
+/**
+ * @brief   Maximum length of a path in the path-resolution cache.
+ */
+#if !defined(DRV_CFG_OVERLAY_CACHE_PATHLEN_MAX) || defined(__DOXYGEN__)
+#define DRV_CFG_OVERLAY_CACHE_PATHLEN_MAX   63
+#endif
+
+/** @} */
+
+/*===========================================================================*/
+/**
+ * @name Streams driver settings
+ * @{
+ */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of directory nodes pre-allocated in the pool.
+ */
+#if !defined(DRV_CFG_STREAMS_DIR_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_STREAMS_DIR_NODES_NUM       1
+#endif
+
+/**
+ * @brief   Number of file nodes pre-allocated in the pool.
+ */
+#if !defined(DRV_CFG_STREAMS_FILE_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_STREAMS_FILE_NODES_NUM      2
+#endif
+
+/** @} */
+
+/*===========================================================================*/
+/**
+ * @name RAM FS driver settings
+ * @{
+ */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of directory nodes pre-allocated in the pool.
+ */
+#if !defined(DRV_CFG_TMPFS_DIR_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_TMPFS_DIR_NODES_NUM         1
+#endif
+
+/**
+ * @brief   Number of file nodes pre-allocated in the pool.
+ */
+#if !defined(DRV_CFG_TMPFS_FILE_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_TMPFS_FILE_NODES_NUM        2
+#endif
+
+/**
+ * @brief   Size of the data area of a file extent.
+ */
+#if !defined(DRV_CFG_TMPFS_EXTENT_SIZE) || defined(__DOXYGEN__)
+#define DRV_CFG_TMPFS_EXTENT_SIZE           256
+#endif
+
+/**
+ * @brief   Number of hash buckets in each directory.
+ * @note    Must be a power of two.
+ */
+#if !defined(DRV_CFG_TMPFS_DIR_BUCKETS) || defined(__DOXYGEN__)
+#define DRV_CFG_TMPFS_DIR_BUCKETS           8
+#endif
+
+/** @} */
+
+/*===========================================================================*/
+/**
+ * @name ChibiFS driver settings
+ * @{
+ */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of directory nodes pre-allocated in the pool.
+ */
+#if !defined(DRV_CFG_CHFS_DIR_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_DIR_NODES_NUM          1
+#endif
+
+/**
+ * @brief   Number of file nodes pre-allocated in the pool.
+ */
+#if !defined(DRV_CFG_CHFS_FILE_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_FILE_NODES_NUM         1
+#endif
+
+/**
+ * @brief   Number of page buffers in the shared pages cache.
+ */
+#if !defined(DRV_CFG_CHFS_CACHE_BUFFERS_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_CACHE_BUFFERS_NUM      2
+#endif
+
+/**
+ * @brief   Size of a ChibiFS page.
+ * @note    Must be a power of two and a divider of the flash sector size.
+ */
+#if !defined(DRV_CFG_CHFS_PAGE_SIZE) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_PAGE_SIZE              256
+#endif
+
+/**
+ * @brief   Flash programming granularity.
+ */
+#if !defined(DRV_CFG_CHFS_PROGRAM_SIZE) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_PROGRAM_SIZE           8
+#endif
+
+/**
+ * @brief   Maximum number of flash blocks in a volume.
+ */
+#if !defined(DRV_CFG_CHFS_MAX_BLOCKS) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_MAX_BLOCKS             64
+#endif
+
+/**
+ * @brief   Maximum number of files and directories in a volume.
+ */
+#if !defined(DRV_CFG_CHFS_MAX_NODES) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_MAX_NODES              32
+#endif
+
+/**
+ * @brief   Size of the in-RAM data chunks index.
+ * @note    Must be a power of two.
+ */
+#if !defined(DRV_CFG_CHFS_MAX_CHUNKS) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_MAX_CHUNKS             1024
+#endif
+
+/**
+ * @brief   Pages moved by each incremental garbage collection step.
+ */
+#if !defined(DRV_CFG_CHFS_GC_STEP_PAGES) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_GC_STEP_PAGES          4
+#endif
+
+/**
+ * @brief   Erase cycles difference triggering static wear leveling.
+ */
+#if !defined(DRV_CFG_CHFS_WEAR_DELTA) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_WEAR_DELTA             32
+#endif
+
+/** @} */
+
+/*===========================================================================*/
+/**
+ * @name FatFS driver settings
+ * @{
+ */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum number of FatFS file systems mounted.
+ */
+#if !defined(DRV_CFG_FATFS_FS_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_FATFS_FS_NUM                1
+#endif
+
+/**
+ * @brief   Number of directory nodes pre-allocated in the pool.
+ */
+#if !defined(DRV_CFG_FATFS_DIR_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_FATFS_DIR_NODES_NUM         1
+#endif
+
+/**
+ * @brief   Number of file nodes pre-allocated in the pool.
+ */
+#if !defined(DRV_CFG_FATFS_FILE_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_FATFS_FILE_NODES_NUM        2
+#endif
+
+/** @} */
+
+/*===========================================================================*/
+/**
+ * @name LittleFS driver settings
+ * @{
+ */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of shared path buffers.
+ */
+#if !defined(DRV_CFG_LITTLEFS_DIR_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_LITTLEFS_DIR_NODES_NUM      2
+#endif
+
+/**
+ * @brief   Number of file nodes pre-allocated in the pool.
+ */
+#if !defined(DRV_CFG_LITTLEFS_FILE_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_LITTLEFS_FILE_NODES_NUM     2
+#endif
+
+/**
+ * @brief   Number of info nodes pre-allocated in the pool.
+ */
+#if !defined(DRV_CFG_LITTLEFS_INFO_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_LITTLEFS_INFO_NODES_NUM     1
+#endif
+
+/** @} */
+
+#endif /* VFSCONF_H */
+
+/** @} */
@@ -0,0 +1,760 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "vfs.h"
+#include "shell.h"
+#include "chprintf.h"
+#include "nullstreams.h"
+
+#include "lfs.h"
+#include "lfs_hal.h"
+
+#include "chfs_test_root.h"
+
+#define SHELL_WA_SIZE       THD_WORKING_AREA_SIZE(8192)
+
+/* Benchmark parameters, both file systems use the same flash sectors.*/
+#define BENCH_SECTORS       64U
+#define BENCH_STATIC_FILES  12U
+#define BENCH_STATIC_SIZE   (8U * 1024U)
+#define BENCH_FILES         16U
+#define BENCH_ROUNDS        32U
+#define BENCH_MIN_SIZE      64U
+#define BENCH_MAX_SIZE      1024U
+
+/* Size of the RAM FS heap, it must hold all the benchmark files.*/
+#define TMPFS_HEAP_SIZE     (160U * 1024U)
+
+/* Lookup benchmark parameters.*/
+#define LOOKUP_DEPTH        8U
+#define LOOKUP_ITERATIONS   10000U
+
+/* Splice benchmark parameters.*/
+#define SPLICE_FILE_SIZE    (64U * 1024U)
+#define SPLICE_ITERATIONS   16U
+
+/* Number of entries in the root path-resolution cache.*/
+#define ROOT_CACHE_ENTRIES  16U
+
+/* Size of a small file in a round.*/
+#define BENCH_SIZE(round, i)                                                \
+  (BENCH_MIN_SIZE + ((((round) * 7U) + ((i) * 13U)) *                       \
+                     ((BENCH_MAX_SIZE - BENCH_MIN_SIZE) / 64U)) %           \
+                    (BENCH_MAX_SIZE - BENCH_MIN_SIZE))
+
+/* Results of a benchmark run.*/
+typedef struct {
+  const char                *name;
+  int                       err;
+  sysinterval_t             busy;
+  uint32_t                  user;
+  sim_efl_stats_t           stats;
+  rtcnt_t                   mount;
+} bench_result_t;
+
+static thread_t *shelltp;
+
+static uint8_t buf[BENCH_MAX_SIZE];
+static uint8_t rbuf[BENCH_MAX_SIZE];
+
+/*===========================================================================*/
+/* ChibiFS-related.                                                          */
+/*===========================================================================*/
+
+static const chfs_config_t chfscfg = {
+  .flashp               = (BaseFlash *)&EFLD1,
+  .sector_start         = 0U,
+  .sectors_count        = BENCH_SECTORS
+};
+
+/* VFS ChibiFS driver object, it is overlaid by the VFS root.*/
+static vfs_chfs_driver_c chfs_driver;
+
+/*
+ * Eight sectors after the benchmark sectors, the configuration name is the
+ * one expected by the ChibiFS test suite.
+ */
+const chfs_config_t chfscfg1 = {
+  .flashp               = (BaseFlash *)&EFLD1,
+  .sector_start         = BENCH_SECTORS,
+  .sectors_count        = 8U
+};
+
+/*===========================================================================*/
+/* RAM FS-related.                                                           */
+/*===========================================================================*/
+
+/* Dedicated heap for the RAM FS, the benchmark fills most of it.*/
+static memory_heap_t tmpfs_heap;
+static CH_HEAP_AREA(tmpfs_heap_area, TMPFS_HEAP_SIZE);
+
+static const tmpfs_config_t tmpfscfg = {
+  .heapp                = &tmpfs_heap,
+  .size_max             = 0U
+};
+
+/* VFS RAM FS driver object, it is mounted under "/tmp".*/
+static vfs_tmpfs_driver_c tmpfs_driver;
+
+/*===========================================================================*/
+/* VFS-related.                                                              */
+/*===========================================================================*/
+
+/* VFS overlay driver object, it is the VFS root.*/
+static vfs_overlay_driver_c root_overlay_driver;
+
+/* Path-resolution cache of the VFS root.*/
+static ovl_cache_entry_t root_cache[ROOT_CACHE_ENTRIES];
+
+/* Global pointer to the root VFS driver.*/
+vfs_driver_c *vfs_root = (vfs_driver_c *)&root_overlay_driver;
+
+static int vfs_write_file(const char *path, const uint8_t *bp, size_t n) {
+  vfs_file_node_c *vfnp;
+  ssize_t nw;
+  msg_t ret;
+
+  ret = vfsOpenFile(path, VO_WRONLY | VO_CREAT | VO_TRUNC, &vfnp);
+  if (CH_RET_IS_ERROR(ret)) {
+    return (int)ret;
+  }
+  nw = vfsWriteFile(vfnp, bp, n);
+  vfsClose((vfs_node_c *)vfnp);
+
+  return nw == (ssize_t)n ? 0 : (nw < 0 ? (int)nw : (int)CH_RET_ENOSPC);
+}
+
+static int vfs_read_file(const char *path, uint8_t *bp, size_t n) {
+  vfs_file_node_c *vfnp;
+  ssize_t nr;
+  msg_t ret;
+
+  ret = vfsOpenFile(path, VO_RDONLY, &vfnp);
+  if (CH_RET_IS_ERROR(ret)) {
+    return (int)ret;
+  }
+  nr = vfsReadFile(vfnp, bp, n);
+  vfsClose((vfs_node_c *)vfnp);
+
+  return (int)nr;
+}
+
+/*===========================================================================*/
+/* LittleFS-related.                                                         */
+/*===========================================================================*/
+
+static const hal_lfs_binding_t binding = {
+  .base                 = 0,
+  .flp                  = (BaseFlash *)&EFLD1,
+  .preerase             = NULL
+};
+
+static const struct lfs_config lfscfg = {
+  .context              = (void *)&binding,
+  .read                 = __lfs_read,
+  .prog                 = __lfs_prog,
+  .erase                = __lfs_erase,
+  .sync                 = __lfs_sync,
+  .lock                 = __lfs_lock,
+  .unlock               = __lfs_unlock,
+  .read_size            = 16,
+  .prog_size            = 16,
+  .block_size           = SIM_EFL_SECTOR_SIZE,
+  .block_count          = BENCH_SECTORS,
+  .block_cycles         = 500,
+  .cache_size           = 256,
+  .lookahead_size       = 32
+};
+
+static lfs_t lfs;
+static lfs_file_t file;
+
+static int lfs_write_file(const char *path, const uint8_t *bp, size_t n) {
+  int err;
+
+  err = lfs_file_open(&lfs, &file, path,
+                      LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+  if (err < 0) {
+    return err;
+  }
+  err = (int)lfs_file_write(&lfs, &file, bp, (lfs_size_t)n);
+  if (err >= 0) {
+    err = lfs_file_close(&lfs, &file);
+  }
+  else {
+    (void) lfs_file_close(&lfs, &file);
+  }
+
+  return err;
+}
+
+static int lfs_read_file(const char *path, uint8_t *bp, size_t n) {
+  int err;
+
+  err = lfs_file_open(&lfs, &file, path, LFS_O_RDONLY);
+  if (err < 0) {
+    return err;
+  }
+  err = (int)lfs_file_read(&lfs, &file, bp, (lfs_size_t)n);
+  (void) lfs_file_close(&lfs, &file);
+
+  return err;
+}
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+/* File system operations used by the benchmark.*/
+typedef struct {
+  const char                *name;
+  const char                *prefix;
+  int (*format)(void);
+  int (*mount)(void);
+  int (*unmount)(void);
+  int (*write_file)(const char *path, const uint8_t *bp, size_t n);
+  int (*read_file)(const char *path, uint8_t *bp, size_t n);
+} bench_fs_t;
+
+static int chfs_format(void) {
+
+  return (int)chfsdrvFormat(&chfs_driver);
+}
+
+static int chfs_mount(void) {
+
+  /* Files appear without passing through the overlay.*/
+  ovldrvFlushPathCache(&root_overlay_driver);
+
+  return (int)chfsdrvMount(&chfs_driver);
+}
+
+static int chfs_unmount(void) {
+
+  return (int)chfsdrvUnmount(&chfs_driver);
+}
+
+static int tmpfs_format(void) {
+
+  return (int)tmpfsdrvErase(&tmpfs_driver);
+}
+
+static int tmpfs_mount(void) {
+
+  return 0;
+}
+
+static int lfs_bench_format(void) {
+
+  return lfs_format(&lfs, &lfscfg);
+}
+
+static int lfs_bench_mount(void) {
+
+  return lfs_mount(&lfs, &lfscfg);
+}
+
+static int lfs_bench_unmount(void) {
+
+  return lfs_unmount(&lfs);
+}
+
+static const bench_fs_t bench_chfs = {
+  "ChibiFS", "", chfs_format, chfs_mount, chfs_unmount,
+  vfs_write_file, vfs_read_file
+};
+
+static const bench_fs_t bench_tmpfs = {
+  "tmpfs", "/tmp", tmpfs_format, tmpfs_mount, tmpfs_mount,
+  vfs_write_file, vfs_read_file
+};
+
+static const bench_fs_t bench_lfs = {
+  "LittleFS", "", lfs_bench_format, lfs_bench_mount, lfs_bench_unmount,
+  lfs_write_file, lfs_read_file
+};
+
+static void fill(uint8_t *bp, size_t n, unsigned seed) {
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    bp[i] = (uint8_t)((seed * 31U) + (i * 7U));
+  }
+}
+
+/*
+ * Writes a set of static files then rewrites BENCH_FILES small files
+ * for BENCH_ROUNDS rounds, the static data forces the garbage collectors
+ * to move live data. Only the small files writes are accounted.
+ */
+static void bench_run(const bench_fs_t *fsp, bench_result_t *rp) {
+  unsigned round, i;
+  char path[24];
+  rtcnt_t start;
+  int err;
+
+  memset(rp, 0, sizeof *rp);
+  rp->name = fsp->name;
+
+  eflSimResetStats(&EFLD1);
+  err = fsp->format();
+  if (err >= 0) {
+    err = fsp->mount();
+  }
+
+  /* Static data.*/
+  for (i = 0U; (i < BENCH_STATIC_FILES) && (err >= 0); i++) {
+    static uint8_t sbuf[BENCH_STATIC_SIZE];
+
+    fill(sbuf, sizeof sbuf, 1000U + i);
+    chsnprintf(path, sizeof path, "%s/s%u", fsp->prefix, i);
+    err = fsp->write_file(path, sbuf, sizeof sbuf);
+  }
+
+  /* Small files, rewritten with varying sizes.*/
+  eflSimResetStats(&EFLD1);
+  for (round = 0U; (round < BENCH_ROUNDS) && (err >= 0); round++) {
+    for (i = 0U; (i < BENCH_FILES) && (err >= 0); i++) {
+      size_t n = BENCH_SIZE(round, i);
+      systime_t t;
+
+      fill(buf, n, (round * BENCH_FILES) + i);
+      chsnprintf(path, sizeof path, "%s/f%u", fsp->prefix, i);
+      t = chVTGetSystemTimeX();
+      err = fsp->write_file(path, buf, n);
+      rp->busy += chTimeDiffX(t, chVTGetSystemTimeX());
+      rp->user += (uint32_t)n;
+    }
+  }
+  eflSimGetStats(&EFLD1, &rp->stats);
+
+  /* Mount time after the workload.*/
+  if (err >= 0) {
+    err = fsp->unmount();
+  }
+  if (err >= 0) {
+    start = chSysGetRealtimeCounterX();
+    err = fsp->mount();
+    rp->mount = chSysGetRealtimeCounterX() - start;
+  }
+
+  /* Verification of the last round.*/
+  for (i = 0U; (i < BENCH_FILES) && (err >= 0); i++) {
+    size_t n = BENCH_SIZE(BENCH_ROUNDS - 1U, i);
+
+    fill(buf, n, ((BENCH_ROUNDS - 1U) * BENCH_FILES) + i);
+    chsnprintf(path, sizeof path, "%s/f%u", fsp->prefix, i);
+    err = fsp->read_file(path, rbuf, sizeof rbuf);
+    if ((err >= 0) && (((size_t)err != n) || (memcmp(buf, rbuf, n) != 0))) {
+      err = -1;
+    }
+  }
+
+  (void) fsp->unmount();
+  rp->err = err < 0 ? err : 0;
+}
+
+static void bench_print(BaseSequentialStream *chp, const bench_result_t *rp) {
+  uint32_t wa100;
+
+  if (rp->err < 0) {
+    chprintf(chp, "%-10s error %d" SHELL_NEWLINE_STR, rp->name, rp->err);
+    return;
+  }
+
+  wa100 = (uint32_t)(((uint64_t)rp->stats.programmed * 100U) / rp->user);
+  chprintf(chp, "%-10s %7lu %4lu.%02lu %7lu %10lu" SHELL_NEWLINE_STR,
+           rp->name,
+           (unsigned long)(((uint64_t)BENCH_ROUNDS * BENCH_FILES * 1000U) /
+                           (TIME_I2MS(rp->busy) + 1U)),
+           (unsigned long)(wa100 / 100U), (unsigned long)(wa100 % 100U),
+           (unsigned long)rp->stats.erases,
+           (unsigned long)rp->mount);
+}
+
+/*
+ * Average realtime counter cycles of a stat() or of an open()/close()
+ * pair on the specified path.
+ */
+static rtcnt_t lookup_run(const char *path, bool opening) {
+  vfs_file_node_c *vfnp;
+  vfs_stat_t st;
+  rtcnt_t start;
+  unsigned i;
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < LOOKUP_ITERATIONS; i++) {
+    if (opening) {
+      if (!CH_RET_IS_ERROR(vfsOpenFile(path, VO_RDONLY, &vfnp))) {
+        vfsClose((vfs_node_c *)vfnp);
+      }
+    }
+    else {
+      (void) vfsStat(path, &st);
+    }
+  }
+
+  return (chSysGetRealtimeCounterX() - start) / LOOKUP_ITERATIONS;
+}
+
+/*
+ * Creates a deep directory tree on tmpfs then measures lookups of an
+ * existing and of a missing file, with and without the root cache.
+ */
+static void lookup_bench(BaseSequentialStream *chp) {
+  char path[48], missing[48];
+  unsigned i, cached;
+  size_t n;
+
+  if (tmpfs_format() < 0) {
+    chprintf(chp, "tmpfs error" SHELL_NEWLINE_STR);
+    return;
+  }
+  n = (size_t)chsnprintf(path, sizeof path, "/tmp");
+  for (i = 0U; i < LOOKUP_DEPTH; i++) {
+    n += (size_t)chsnprintf(path + n, sizeof path - n, "/d%u", i);
+    if (CH_RET_IS_ERROR(vfsMkdir(path, 0777))) {
+      chprintf(chp, "mkdir error" SHELL_NEWLINE_STR);
+      return;
+    }
+  }
+  chsnprintf(missing, sizeof missing, "%s/missing", path);
+  chsnprintf(path + n, sizeof path - n, "/file");
+  if (vfs_write_file(path, buf, 16U) < 0) {
+    chprintf(chp, "write error" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  chprintf(chp, "%-10s %10s %10s %10s" SHELL_NEWLINE_STR,
+           "cache", "stat cyc", "miss cyc", "open cyc");
+  for (cached = 0U; cached < 2U; cached++) {
+    ovldrvSetPathCache(&root_overlay_driver,
+                       cached ? root_cache : NULL, ROOT_CACHE_ENTRIES);
+    chprintf(chp, "%-10s %10lu %10lu %10lu" SHELL_NEWLINE_STR,
+             cached ? "on" : "off",
+             (unsigned long)lookup_run(path, false),
+             (unsigned long)lookup_run(missing, false),
+             (unsigned long)lookup_run(path, true));
+  }
+
+  (void) tmpfs_format();
+}
+
+/*
+ * Average realtime counter cycles for moving a whole file into a null
+ * stream, either with a read()/write() loop or with a splice.
+ */
+static rtcnt_t splice_run(const char *path, bool splicing) {
+  static NullStream nullstream;
+  sequential_stream_i *stmp = (sequential_stream_i *)&nullstream;
+  vfs_file_node_c *vfnp;
+  rtcnt_t start;
+  unsigned i;
+  ssize_t n;
+
+  nullObjectInit(&nullstream);
+  if (CH_RET_IS_ERROR(vfsOpenFile(path, VO_RDONLY, &vfnp))) {
+    return (rtcnt_t)0;
+  }
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < SPLICE_ITERATIONS; i++) {
+    (void) vfsSetFilePosition(vfnp, (vfs_offset_t)0, VFS_SEEK_SET);
+    do {
+      if (splicing) {
+        n = vfsSpliceFile(vfnp, stmp, SPLICE_FILE_SIZE);
+      }
+      else {
+        n = vfsReadFile(vfnp, rbuf, sizeof rbuf);
+        if (n > (ssize_t)0) {
+          (void) stmWrite(stmp, rbuf, (size_t)n);
+        }
+      }
+    } while (n > (ssize_t)0);
+  }
+  start = chSysGetRealtimeCounterX() - start;
+  vfsClose((vfs_node_c *)vfnp);
+
+  return start / SPLICE_ITERATIONS;
+}
+
+/*
+ * Creates a large file on the specified file system then measures a
+ * buffered copy and a splice of its whole content.
+ */
+static void splice_bench(BaseSequentialStream *chp, const bench_fs_t *fsp) {
+  vfs_file_node_c *vfnp;
+  char path[24];
+  size_t n;
+  int err;
+
+  err = fsp->format();
+  if (err >= 0) {
+    err = fsp->mount();
+  }
+
+  chsnprintf(path, sizeof path, "%s/splice", fsp->prefix);
+  if (err >= 0) {
+    err = (int)vfsOpenFile(path, VO_WRONLY | VO_CREAT | VO_TRUNC, &vfnp);
+  }
+  if (err >= 0) {
+    fill(buf, sizeof buf, 0U);
+    for (n = 0U; (n < SPLICE_FILE_SIZE) && (err >= 0); n += sizeof buf) {
+      if (vfsWriteFile(vfnp, buf, sizeof buf) != (ssize_t)sizeof buf) {
+        err = -1;
+      }
+    }
+    vfsClose((vfs_node_c *)vfnp);
+  }
+
+  if (err < 0) {
+    chprintf(chp, "%-10s error %d" SHELL_NEWLINE_STR, fsp->name, err);
+  }
+  else {
+    chprintf(chp, "%-10s %10lu %10lu" SHELL_NEWLINE_STR,
+             fsp->name,
+             (unsigned long)splice_run(path, false),
+             (unsigned long)splice_run(path, true));
+  }
+
+  (void) fsp->unmount();
+}
+
+/*===========================================================================*/
+/* Command line related.                                                     */
+/*===========================================================================*/
+
+static void cmd_test(BaseSequentialStream *chp, int argc, char *argv[]) {
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: test" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  eflSimSetPowerLoss(&EFLD1, 0U);
+  test_execute(chp, &chfs_test_suite);
+}
+
+static void cmd_bench(BaseSequentialStream *chp, int argc, char *argv[]) {
+  static bench_result_t res;
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: bench" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  chprintf(chp, "%-10s %7s %7s %7s %10s" SHELL_NEWLINE_STR,
+           "fs", "files/s", "WA", "erases", "mount cyc");
+  bench_run(&bench_chfs, &res);
+  bench_print(chp, &res);
+  bench_run(&bench_tmpfs, &res);
+  bench_print(chp, &res);
+  bench_run(&bench_lfs, &res);
+  bench_print(chp, &res);
+}
+
+static void cmd_lookup(BaseSequentialStream *chp, int argc, char *argv[]) {
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: lookup" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  lookup_bench(chp);
+}
+
+static void cmd_splice(BaseSequentialStream *chp, int argc, char *argv[]) {
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: splice" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  chprintf(chp, "%-10s %10s %10s" SHELL_NEWLINE_STR,
+           "fs", "read cyc", "splice cyc");
+  splice_bench(chp, &bench_chfs);
+  splice_bench(chp, &bench_tmpfs);
+}
+
+static void cmd_usage(BaseSequentialStream *chp, int argc, char *argv[]) {
+  chfs_usage_t usage;
+  msg_t ret;
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: usage" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  ret = chfsdrvMount(&chfs_driver);
+  if (CH_RET_IS_SUCCESS(ret)) {
+    ret = chfsdrvGetUsage(&chfs_driver, &usage);
+    (void) chfsdrvUnmount(&chfs_driver);
+  }
+  if (CH_RET_IS_ERROR(ret)) {
+    chprintf(chp, "No ChibiFS volume (%d)" SHELL_NEWLINE_STR, (int)ret);
+    return;
+  }
+
+  chprintf(chp, "blocks %lu, free %lu, pages per block %lu, live pages %lu"
+           SHELL_NEWLINE_STR,
+           (unsigned long)usage.blocks, (unsigned long)usage.free_blocks,
+           (unsigned long)usage.block_pages, (unsigned long)usage.live_pages);
+  chprintf(chp, "erase cycles min %lu, max %lu" SHELL_NEWLINE_STR,
+           (unsigned long)usage.erase_min, (unsigned long)usage.erase_max);
+}
+
+static const ShellCommand commands[] = {
+  {"test", cmd_test},
+  {"bench", cmd_bench},
+  {"lookup", cmd_lookup},
+  {"splice", cmd_splice},
+  {"usage", cmd_usage},
+  {NULL, NULL}
+};
+
+static const ShellConfig shell_cfg1 = {
+  (BaseSequentialStream *)&SD1,
+  commands
+};
+
+/*===========================================================================*/
+/* Generic code.                                                             */
+/*===========================================================================*/
+
+/*
+ * Shell termination handler.
+ */
+static void termination_handler(eventid_t id) {
+
+  (void)id;
+  if (shelltp && chThdTerminatedX(shelltp)) {
+    chThdWait(shelltp);
+    shelltp = NULL;
+    chThdSleepMilliseconds(10);
+    chSysLock();
+    oqResetI(&SD1.oqueue);
+    chSchRescheduleS();
+    chSysUnlock();
+  }
+}
+
+static event_listener_t sd1fel;
+
+/*
+ * SD1 status change handler.
+ */
+static void sd1_handler(eventid_t id) {
+  eventflags_t flags;
+
+  (void)id;
+  flags = chEvtGetAndClearFlags(&sd1fel);
+  if ((flags & CHN_CONNECTED) && (shelltp == NULL)) {
+    shelltp = chThdCreateFromHeap(NULL, SHELL_WA_SIZE,
+                                  "shell", NORMALPRIO + 10,
+                                  shellThread, (void *)&shell_cfg1);
+  }
+  if (flags & CHN_DISCONNECTED) {
+    chSysLock();
+    iqResetI(&SD1.iqueue);
+    chSchRescheduleS();
+    chSysUnlock();
+  }
+}
+
+static evhandler_t fhandlers[] = {
+  termination_handler,
+  sd1_handler
+};
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  event_listener_t tel;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   * - VFS initialization.
+   */
+  halInit();
+  chSysInit();
+  vfsInit();
+
+  /*
+   * Simulated flash and serial port initialization.
+   */
+  eflStart(&EFLD1, NULL);
+  sdStart(&SD1, NULL);
+
+  /*
+   * ChibiFS driver initialization, the volume is formatted by the
+   * benchmark.
+   */
+  chfsdrvObjectInit(&chfs_driver, &chfscfg);
+
+  /*
+   * RAM FS driver initialization, it uses its own heap.
+   */
+  chHeapObjectInit(&tmpfs_heap, tmpfs_heap_area, sizeof tmpfs_heap_area);
+  tmpfsdrvObjectInit(&tmpfs_driver, &tmpfscfg);
+
+  /*
+   * The overlay root forwards everything to ChibiFS except "/tmp".
+   */
+  ovldrvObjectInit(&root_overlay_driver, (vfs_driver_c *)&chfs_driver, NULL);
+  (void) ovldrvRegisterDriver(&root_overlay_driver,
+                              (vfs_driver_c *)&tmpfs_driver, "tmp");
+  ovldrvSetPathCache(&root_overlay_driver, root_cache, ROOT_CACHE_ENTRIES);
+
+  /*
+   * Shell manager initialization.
+   */
+  shellInit();
+  chEvtRegister(&shell_terminated, &tel, 0);
+
+  /*
+   * Initializing connection/disconnection events.
+   */
+  printf("Shell service started on SD1\n");
+  fflush(stdout);
+  chEvtRegister(chnGetEventSource(&SD1), &sd1fel, 1);
+
+  /*
+   * Events servicing loop.
+   */
+  while (!chThdShouldTerminateX())
+    chEvtDispatch(fhandlers, chEvtWaitOne(ALL_EVENTS));
+
+  /*
+   * Clean simulator exit.
+   */
+  chEvtUnregister(chnGetEventSource(&SD1), &sd1fel);
+  return 0;
+}
@@ -0,0 +1,261 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "shell.h"
+#include "chprintf.h"
+
+#include "ff.h"
+#include "fatfs_cache.h"
+
+#define SHELL_WA_SIZE       THD_WORKING_AREA_SIZE(8192)
+
+/* Benchmark parameters.*/
+#define BENCH_FILES         32U
+#define BENCH_APPENDS       16U
+#define BENCH_CHUNK_SIZE    100U
+
+static thread_t *shelltp;
+
+/*===========================================================================*/
+/* Simulated SD card.                                                        */
+/*===========================================================================*/
+
+/*
+ * Card image in a host file, the timings are those of a typical class 10
+ * card.
+ */
+static const SDCConfig sdccfg = {
+  .bus_width        = SDC_MODE_4BIT,
+  .path             = "sdcard.img",
+  .blocks           = 8192U,
+  .read_only        = false,
+  .read_latency_us  = 500U,
+  .write_latency_us = 2000U,
+  .read_kbps        = 20000U,
+  .write_kbps       = 10000U
+};
+
+/*===========================================================================*/
+/* Command line related.                                                     */
+/*===========================================================================*/
+
+static FATFS fs;
+static FIL file;
+static uint8_t mkfs_buf[4096];
+
+/*
+ * Formats the disk then creates BENCH_FILES small files and appends to
+ * each of them BENCH_APPENDS times, files are closed after each append.
+ * This is dominated by directory and FAT updates.
+ */
+static void file_bench(BaseSequentialStream *chp, const char *name,
+                       bool cached) {
+  static const MKFS_PARM mkfs_opt = {FM_FAT, 0, 0, 0, 0};
+  static char chunk[BENCH_CHUNK_SIZE];
+  fatfs_cache_stats_t stats;
+  sim_sdc_stats_t sdc_stats;
+  systime_t start;
+  sysinterval_t busy;
+  uint32_t commands;
+  unsigned round, i;
+  char path[16];
+  FRESULT err;
+  UINT bw;
+
+  memset(chunk, 'x', sizeof chunk);
+
+  (void) fatfsCacheSetEnabled(cached);
+  err = f_mkfs("", &mkfs_opt, mkfs_buf, sizeof mkfs_buf);
+  if (err == FR_OK) {
+    err = f_mount(&fs, "", 1);
+  }
+  if (err != FR_OK) {
+    chprintf(chp, "%s: format/mount failed (%d)" SHELL_NEWLINE_STR,
+             name, (int)err);
+    return;
+  }
+
+  fatfsCacheResetStats();
+  sdcSimGetStats(&SDCD1, &sdc_stats);
+  commands = sdc_stats.commands;
+  start = chVTGetSystemTimeX();
+
+  for (round = 0U; (round <= BENCH_APPENDS) && (err == FR_OK); round++) {
+    for (i = 0U; (i < BENCH_FILES) && (err == FR_OK); i++) {
+      chsnprintf(path, sizeof path, "f%u.txt", i);
+      err = f_open(&file, path, round == 0U ? FA_WRITE | FA_CREATE_ALWAYS :
+                                              FA_WRITE | FA_OPEN_APPEND);
+      if (err == FR_OK) {
+        err = f_write(&file, chunk, sizeof chunk, &bw);
+        if (err == FR_OK) {
+          err = f_close(&file);
+        }
+      }
+    }
+  }
+
+  busy = chTimeDiffX(start, chVTGetSystemTimeX());
+  sdcSimGetStats(&SDCD1, &sdc_stats);
+  commands = sdc_stats.commands - commands;
+  fatfsCacheGetStats(&stats);
+  (void) f_mount(NULL, "", 0);
+
+  if (err != FR_OK) {
+    chprintf(chp, "%s: error %d" SHELL_NEWLINE_STR, name, (int)err);
+    return;
+  }
+
+  chprintf(chp, "%-9s %6lu ms %6lu commands", name,
+           (unsigned long)TIME_I2MS(busy), (unsigned long)commands);
+  if (cached) {
+    chprintf(chp, ", read hits %lu/%lu, write hits %lu/%lu",
+             (unsigned long)stats.read_hits, (unsigned long)stats.reads,
+             (unsigned long)stats.write_hits, (unsigned long)stats.writes);
+    chprintf(chp, SHELL_NEWLINE_STR "          "
+             "%lu flushed in %lu writes, %lu evicted, %lu pinned",
+             (unsigned long)stats.flushed, (unsigned long)stats.flush_writes,
+             (unsigned long)stats.evictions, (unsigned long)stats.pinned);
+  }
+  chprintf(chp, SHELL_NEWLINE_STR);
+}
+
+static void cmd_bench(BaseSequentialStream *chp, int argc, char *argv[]) {
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: bench" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  file_bench(chp, "uncached", false);
+  file_bench(chp, "cached", true);
+}
+
+static const ShellCommand commands[] = {
+  {"bench", cmd_bench},
+  {NULL, NULL}
+};
+
+static const ShellConfig shell_cfg1 = {
+  (BaseSequentialStream *)&SD1,
+  commands
+};
+
+/*===========================================================================*/
+/* Generic code.                                                             */
+/*===========================================================================*/
+
+/*
+ * Shell termination handler.
+ */
+static void termination_handler(eventid_t id) {
+
+  (void)id;
+  if (shelltp && chThdTerminatedX(shelltp)) {
+    chThdWait(shelltp);
+    shelltp = NULL;
+    chThdSleepMilliseconds(10);
+    chSysLock();
+    oqResetI(&SD1.oqueue);
+    chSchRescheduleS();
+    chSysUnlock();
+  }
+}
+
+static event_listener_t sd1fel;
+
+/*
+ * SD1 status change handler.
+ */
+static void sd1_handler(eventid_t id) {
+  eventflags_t flags;
+
+  (void)id;
+  flags = chEvtGetAndClearFlags(&sd1fel);
+  if ((flags & CHN_CONNECTED) && (shelltp == NULL)) {
+    shelltp = chThdCreateFromHeap(NULL, SHELL_WA_SIZE,
+                                  "shell", NORMALPRIO + 10,
+                                  shellThread, (void *)&shell_cfg1);
+  }
+  if (flags & CHN_DISCONNECTED) {
+    chSysLock();
+    iqResetI(&SD1.iqueue);
+    chSchRescheduleS();
+    chSysUnlock();
+  }
+}
+
+static evhandler_t fhandlers[] = {
+  termination_handler,
+  sd1_handler
+};
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  event_listener_t tel;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * Simulated SD card and serial port initialization.
+   */
+  if ((sdcStart(&SDCD1, &sdccfg) != HAL_RET_SUCCESS) ||
+      (sdcConnect(&SDCD1) != HAL_SUCCESS)) {
+    printf("SD card initialization failed\n");
+    return 1;
+  }
+  sdStart(&SD1, NULL);
+
+  /*
+   * Shell manager initialization.
+   */
+  shellInit();
+  chEvtRegister(&shell_terminated, &tel, 0);
+
+  /*
+   * Initializing connection/disconnection events.
+   */
+  printf("Shell service started on SD1\n");
+  fflush(stdout);
+  chEvtRegister(chnGetEventSource(&SD1), &sd1fel, 1);
+
+  /*
+   * Events servicing loop.
+   */
+  while (!chThdShouldTerminateX())
+    chEvtDispatch(fhandlers, chEvtWaitOne(ALL_EVENTS));
+
+  /*
+   * Clean simulator exit.
+   */
+  chEvtUnregister(chnGetEventSource(&SD1), &sd1fel);
+  return 0;
+}
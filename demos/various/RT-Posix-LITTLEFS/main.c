@@ -0,0 +1,318 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "shell.h"
+#include "chprintf.h"
+
+#include "lfs.h"
+#include "lfs_hal.h"
+
+#define SHELL_WA_SIZE       THD_WORKING_AREA_SIZE(8192)
+#define PREERASE_WA_SIZE    THD_WORKING_AREA_SIZE(4096)
+
+/* Benchmark parameters.*/
+#define BENCH_ROUNDS        4U
+#define BENCH_FILES         8U
+#define BENCH_FILE_SIZE     (32U * 1024U)
+#define BENCH_CHUNK_SIZE    512U
+#define BENCH_IDLE_MS       250U
+
+static thread_t *shelltp;
+
+/*===========================================================================*/
+/* LittleFS-related.                                                         */
+/*===========================================================================*/
+
+/* Pre-erase manager and its bitmaps.*/
+static uint32_t pe_used[LFS_HAL_PREERASE_MAP_SIZE(SIM_EFL_SECTORS_COUNT)];
+static uint32_t pe_erased[LFS_HAL_PREERASE_MAP_SIZE(SIM_EFL_SECTORS_COUNT)];
+static hal_lfs_preerase_t pe;
+
+/* Bindings without and with the pre-erase manager.*/
+static const hal_lfs_binding_t binding_plain = {
+  .base                 = 0,
+  .flp                  = (BaseFlash *)&EFLD1,
+  .preerase             = NULL
+};
+
+static const hal_lfs_binding_t binding_preerase = {
+  .base                 = 0,
+  .flp                  = (BaseFlash *)&EFLD1,
+  .preerase             = &pe
+};
+
+#define LFS_CONFIG_INIT(binding) {                                          \
+  .context              = (void *)&(binding),                               \
+  .read                 = __lfs_read,                                       \
+  .prog                 = __lfs_prog,                                       \
+  .erase                = __lfs_erase,                                      \
+  .sync                 = __lfs_sync,                                       \
+  .lock                 = __lfs_lock,                                       \
+  .unlock               = __lfs_unlock,                                     \
+  .read_size            = 16,                                               \
+  .prog_size            = 16,                                               \
+  .block_size           = SIM_EFL_SECTOR_SIZE,                              \
+  .block_count          = SIM_EFL_SECTORS_COUNT,                            \
+  .block_cycles         = 500,                                              \
+  .cache_size           = 256,                                              \
+  .lookahead_size       = 32                                                \
+}
+
+static const struct lfs_config lfscfg_plain = LFS_CONFIG_INIT(binding_plain);
+static const struct lfs_config lfscfg_preerase = LFS_CONFIG_INIT(binding_preerase);
+
+static lfs_t lfs;
+static lfs_file_t file;
+
+/*
+ * Low priority thread erasing free blocks while the file system is idle.
+ */
+static THD_FUNCTION(preerase_thread, arg) {
+  lfs_t *lfsp = (lfs_t *)arg;
+
+  chRegSetThreadName("preerase");
+
+  while (!chThdShouldTerminateX()) {
+    if (lfsPreEraseScan(lfsp) == 0) {
+      while (!chThdShouldTerminateX() && (lfsPreEraseStep(lfsp) > 0)) {
+      }
+    }
+    chThdSleepMilliseconds(100);
+  }
+}
+
+/*===========================================================================*/
+/* Command line related.                                                     */
+/*===========================================================================*/
+
+/*
+ * Writes BENCH_FILES files per round, pausing between files, then deletes
+ * them. Only the time spent writing is accounted.
+ */
+static void write_bench(BaseSequentialStream *chp, const char *name,
+                        const struct lfs_config *cfgp) {
+  static uint8_t buf[BENCH_CHUNK_SIZE];
+  thread_t *tp = NULL;
+  sysinterval_t busy = (sysinterval_t)0;
+  unsigned round, i, j;
+  char path[16];
+  int err;
+
+  memset(buf, 0x55, sizeof buf);
+
+  err = lfs_format(&lfs, cfgp);
+  if (err == 0) {
+    err = lfs_mount(&lfs, cfgp);
+  }
+  if (err < 0) {
+    chprintf(chp, "%s: format/mount failed (%d)" SHELL_NEWLINE_STR, name, err);
+    return;
+  }
+
+  if (cfgp == &lfscfg_preerase) {
+    lfsPreEraseObjectInit(&pe, pe_used, pe_erased, SIM_EFL_SECTORS_COUNT);
+    tp = chThdCreateFromHeap(NULL, PREERASE_WA_SIZE, "preerase",
+                             LOWPRIO + 1, preerase_thread, &lfs);
+  }
+
+  for (round = 0U; (round < BENCH_ROUNDS) && (err >= 0); round++) {
+    for (i = 0U; (i < BENCH_FILES) && (err >= 0); i++) {
+      systime_t start;
+
+      /* Idle time, available for background activities.*/
+      chThdSleepMilliseconds(BENCH_IDLE_MS);
+
+      chsnprintf(path, sizeof path, "f%u", i);
+      start = chVTGetSystemTimeX();
+      err = lfs_file_open(&lfs, &file, path,
+                          LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+      for (j = 0U; (j < BENCH_FILE_SIZE / BENCH_CHUNK_SIZE) && (err >= 0); j++) {
+        err = (int)lfs_file_write(&lfs, &file, buf, sizeof buf);
+      }
+      if (err >= 0) {
+        err = lfs_file_close(&lfs, &file);
+      }
+      busy += chTimeDiffX(start, chVTGetSystemTimeX());
+    }
+    for (i = 0U; (i < BENCH_FILES) && (err >= 0); i++) {
+      chsnprintf(path, sizeof path, "f%u", i);
+      err = lfs_remove(&lfs, path);
+    }
+  }
+
+  if (tp != NULL) {
+    chThdTerminate(tp);
+    chThdWait(tp);
+  }
+  (void) lfs_unmount(&lfs);
+
+  if (err < 0) {
+    chprintf(chp, "%s: error %d" SHELL_NEWLINE_STR, name, err);
+    return;
+  }
+
+  chprintf(chp, "%-10s %6lu kB/s", name,
+           (unsigned long)((BENCH_ROUNDS * BENCH_FILES * BENCH_FILE_SIZE) /
+                           TIME_I2MS(busy)));
+  if (cfgp == &lfscfg_preerase) {
+    chprintf(chp, " (pre-erased %lu, erased %lu)",
+             (unsigned long)pe.hits, (unsigned long)pe.misses);
+  }
+  chprintf(chp, SHELL_NEWLINE_STR);
+}
+
+static void crc_bench(BaseSequentialStream *chp) {
+  static uint8_t buf[4096];
+  rtcnt_t start, cycles;
+  uint32_t crc = 0xFFFFFFFFU;
+  unsigned i;
+
+  memset(buf, 0xA5, sizeof buf);
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < 256U; i++) {
+    crc = lfs_crc(crc, buf, sizeof buf);
+  }
+  cycles = chSysGetRealtimeCounterX() - start;
+
+  chprintf(chp, "%-10s %6lu cycles/kB (%08lX)" SHELL_NEWLINE_STR, "lfs_crc",
+           (unsigned long)(cycles / (256U * 4U)), (unsigned long)crc);
+}
+
+static void cmd_bench(BaseSequentialStream *chp, int argc, char *argv[]) {
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: bench" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  crc_bench(chp);
+  write_bench(chp, "plain", &lfscfg_plain);
+  write_bench(chp, "pre-erase", &lfscfg_preerase);
+}
+
+static const ShellCommand commands[] = {
+  {"bench", cmd_bench},
+  {NULL, NULL}
+};
+
+static const ShellConfig shell_cfg1 = {
+  (BaseSequentialStream *)&SD1,
+  commands
+};
+
+/*===========================================================================*/
+/* Generic code.                                                             */
+/*===========================================================================*/
+
+/*
+ * Shell termination handler.
+ */
+static void termination_handler(eventid_t id) {
+
+  (void)id;
+  if (shelltp && chThdTerminatedX(shelltp)) {
+    chThdWait(shelltp);
+    shelltp = NULL;
+    chThdSleepMilliseconds(10);
+    chSysLock();
+    oqResetI(&SD1.oqueue);
+    chSchRescheduleS();
+    chSysUnlock();
+  }
+}
+
+static event_listener_t sd1fel;
+
+/*
+ * SD1 status change handler.
+ */
+static void sd1_handler(eventid_t id) {
+  eventflags_t flags;
+
+  (void)id;
+  flags = chEvtGetAndClearFlags(&sd1fel);
+  if ((flags & CHN_CONNECTED) && (shelltp == NULL)) {
+    shelltp = chThdCreateFromHeap(NULL, SHELL_WA_SIZE,
+                                  "shell", NORMALPRIO + 10,
+                                  shellThread, (void *)&shell_cfg1);
+  }
+  if (flags & CHN_DISCONNECTED) {
+    chSysLock();
+    iqResetI(&SD1.iqueue);
+    chSchRescheduleS();
+    chSysUnlock();
+  }
+}
+
+static evhandler_t fhandlers[] = {
+  termination_handler,
+  sd1_handler
+};
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  event_listener_t tel;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * Simulated flash and serial port initialization.
+   */
+  eflStart(&EFLD1, NULL);
+  sdStart(&SD1, NULL);
+
+  /*
+   * Shell manager initialization.
+   */
+  shellInit();
+  chEvtRegister(&shell_terminated, &tel, 0);
+
+  /*
+   * Initializing connection/disconnection events.
+   */
+  printf("Shell service started on SD1\n");
+  fflush(stdout);
+  chEvtRegister(chnGetEventSource(&SD1), &sd1fel, 1);
+
+  /*
+   * Events servicing loop.
+   */
+  while (!chThdShouldTerminateX())
+    chEvtDispatch(fhandlers, chEvtWaitOne(ALL_EVENTS));
+
+  /*
+   * Clean simulator exit.
+   */
+  chEvtUnregister(chnGetEventSource(&SD1), &sd1fel);
+  return 0;
+}
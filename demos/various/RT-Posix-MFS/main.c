@@ -0,0 +1,429 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "shell.h"
+#include "chprintf.h"
+
+#include "hal_mfs.h"
+
+#include "mfs_test_root.h"
+
+#define SHELL_WA_SIZE       THD_WORKING_AREA_SIZE(8192)
+
+/* Power-loss torture parameters.*/
+#define TORTURE_RECORDS     8U
+#define TORTURE_WORDS       16U
+#define TORTURE_WINDOW      64U
+
+/* Benchmark parameters.*/
+#define BENCH_RECORDS       16U
+#define BENCH_SIZE          120U
+
+static thread_t *shelltp;
+
+/*===========================================================================*/
+/* MFS-related.                                                              */
+/*===========================================================================*/
+
+/*
+ * Two banks of two sectors at the start of the simulated flash, the
+ * configuration name is the one expected by the MFS test suite.
+ */
+const MFSConfig mfscfg1 = {
+  .flashp           = (BaseFlash *)&EFLD1,
+  .erased           = 0xFFFFFFFFU,
+  .bank_size        = 2U * SIM_EFL_SECTOR_SIZE,
+  .bank0_start      = 0U,
+  .bank0_sectors    = 2U,
+  .bank1_start      = 2U,
+  .bank1_sectors    = 2U
+};
+
+#if MFS_CFG_MULTI_BANK == TRUE
+/*
+ * Ring of four banks of two sectors after the banks of the first
+ * configuration, used by the multi-bank tests of the MFS test suite and
+ * for comparison by the "bench" command.
+ */
+const MFSConfig mfscfg2 = {
+  .flashp           = (BaseFlash *)&EFLD1,
+  .erased           = 0xFFFFFFFFU,
+  .bank_size        = 2U * SIM_EFL_SECTOR_SIZE,
+  .bank0_start      = 4U,
+  .bank0_sectors    = 2U,
+  .bank1_start      = 6U,
+  .bank1_sectors    = 2U,
+  .banks_num        = 4U
+};
+#endif
+
+/*===========================================================================*/
+/* Command line related.                                                     */
+/*===========================================================================*/
+
+static void cmd_test(BaseSequentialStream *chp, int argc, char *argv[]) {
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: test" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  eflSimSetPowerLoss(&EFLD1, 0U);
+  test_execute(chp, &mfs_test_suite);
+}
+
+/*
+ * Writes records while power losses are injected at random points, after
+ * each loss the storage is mounted again and all records are checked. The
+ * record being written when the power was lost must hold either the old or
+ * the new value, all other records must be intact.
+ */
+static void cmd_torture(BaseSequentialStream *chp, int argc, char *argv[]) {
+  static uint32_t wbuf[TORTURE_WORDS], rbuf[TORTURE_WORDS];
+  uint32_t expected[TORTURE_RECORDS + 1U];
+  unsigned i, n, losses = 0U, failures = 0U;
+  mfs_error_t err;
+
+  if (argc > 1) {
+    chprintf(chp, "Usage: torture [iterations]" SHELL_NEWLINE_STR);
+    return;
+  }
+  n = argc > 0 ? (unsigned)atoi(argv[0]) : 200U;
+
+  eflSimSetPowerLoss(&EFLD1, 0U);
+  eflSimResetStats(&EFLD1);
+  mfsStop(&mfs1);
+  err = mfsStart(&mfs1, &mfscfg1);
+  if (!MFS_IS_ERROR(err)) {
+    err = mfsErase(&mfs1);
+  }
+  if (MFS_IS_ERROR(err)) {
+    chprintf(chp, "mount failed (%d)" SHELL_NEWLINE_STR, err);
+    return;
+  }
+  memset(expected, 0, sizeof expected);
+
+  srand(1U);
+  eflSimSetPowerLoss(&EFLD1, (uint32_t)(rand() % TORTURE_WINDOW) + 1U);
+  for (i = 1U; (i <= n) && (failures == 0U); i++) {
+    mfs_id_t id = (mfs_id_t)(rand() % TORTURE_RECORDS) + 1U;
+    unsigned j, r;
+
+    for (j = 0U; j < TORTURE_WORDS; j++) {
+      wbuf[j] = i;
+    }
+    err = mfsWriteRecord(&mfs1, id, sizeof wbuf, (const uint8_t *)wbuf);
+    if (!eflSimIsPowerLost(&EFLD1)) {
+      if (MFS_IS_ERROR(err)) {
+        chprintf(chp, "%u: write failed (%d)" SHELL_NEWLINE_STR, i, err);
+        failures++;
+      }
+      expected[id] = i;
+      continue;
+    }
+
+    /* Power lost, mounting again.*/
+    losses++;
+    mfsStop(&mfs1);
+    eflSimPowerCycle(&EFLD1);
+    err = mfsStart(&mfs1, &mfscfg1);
+    if (MFS_IS_ERROR(err)) {
+      chprintf(chp, "%u: mount failed (%d)" SHELL_NEWLINE_STR, i, err);
+      failures++;
+      break;
+    }
+
+    for (r = 1U; r <= TORTURE_RECORDS; r++) {
+      size_t size = sizeof rbuf;
+      uint32_t value = 0U;
+
+      err = mfsReadRecord(&mfs1, (mfs_id_t)r, &size, (uint8_t *)rbuf);
+      if (err == MFS_NO_ERROR) {
+        value = rbuf[0];
+        for (j = 1U; (j < TORTURE_WORDS) && (size == sizeof rbuf); j++) {
+          if (rbuf[j] != value) {
+            size = 0U;
+          }
+        }
+        if (size != sizeof rbuf) {
+          value = ~0U;
+        }
+      }
+      else if (err != MFS_ERR_NOT_FOUND) {
+        value = ~0U;
+      }
+
+      if ((value != expected[r]) && ((r != id) || (value != i))) {
+        chprintf(chp, "%u: record %u is %lu, expected %lu" SHELL_NEWLINE_STR,
+                 i, r, (unsigned long)value, (unsigned long)expected[r]);
+        failures++;
+      }
+      if (r == id) {
+        expected[r] = value;
+      }
+    }
+    eflSimSetPowerLoss(&EFLD1, (uint32_t)(rand() % TORTURE_WINDOW) + 1U);
+  }
+  eflSimSetPowerLoss(&EFLD1, 0U);
+
+  chprintf(chp, "%u writes, %u power losses, %u failures" SHELL_NEWLINE_STR,
+           i - 1U, losses, failures);
+}
+
+static void cmd_wear(BaseSequentialStream *chp, int argc, char *argv[]) {
+  sim_efl_stats_t stats;
+  flash_sector_t sector;
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: wear" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  eflSimGetStats(&EFLD1, &stats);
+  chprintf(chp, "reads        %lu" SHELL_NEWLINE_STR, (unsigned long)stats.reads);
+  chprintf(chp, "programs     %lu (%lu bytes)" SHELL_NEWLINE_STR,
+           (unsigned long)stats.programs, (unsigned long)stats.programmed);
+  chprintf(chp, "erases       %lu" SHELL_NEWLINE_STR, (unsigned long)stats.erases);
+  chprintf(chp, "violations   %lu" SHELL_NEWLINE_STR,
+           (unsigned long)stats.violations);
+  chprintf(chp, "power losses %lu" SHELL_NEWLINE_STR,
+           (unsigned long)stats.power_losses);
+  for (sector = 0U; sector < 4U; sector++) {
+    chprintf(chp, "sector %lu    %lu erases" SHELL_NEWLINE_STR,
+             (unsigned long)sector,
+             (unsigned long)eflSimGetEraseCount(&EFLD1, sector));
+  }
+}
+
+/*
+ * Rewrites records on an erased storage measuring the worst write time,
+ * then measures the time and the flash reads required by a mount.
+ */
+static void bench_config(BaseSequentialStream *chp, const char *name,
+                         const MFSConfig *config, unsigned n) {
+  static uint8_t buf[BENCH_SIZE];
+  sim_efl_stats_t before, after;
+  sysinterval_t worst = 0, total = 0;
+  systime_t start;
+  flash_sector_t sector, first, last;
+  uint32_t min = ~0U, max = 0U;
+  unsigned i;
+  mfs_error_t err;
+
+  mfsStop(&mfs1);
+  err = mfsStart(&mfs1, config);
+  if (!MFS_IS_ERROR(err)) {
+    err = mfsErase(&mfs1);
+  }
+  if (MFS_IS_ERROR(err)) {
+    chprintf(chp, "%s: mount failed (%d)" SHELL_NEWLINE_STR, name, err);
+    return;
+  }
+
+  eflSimResetStats(&EFLD1);
+  srand(1U);
+  for (i = 0U; i < n; i++) {
+    sysinterval_t elapsed;
+
+    memset(buf, (int)i, sizeof buf);
+    start = chVTGetSystemTimeX();
+    err = mfsWriteRecord(&mfs1, (mfs_id_t)(rand() % BENCH_RECORDS) + 1U,
+                         sizeof buf, buf);
+    elapsed = chTimeDiffX(start, chVTGetSystemTimeX());
+    if (MFS_IS_ERROR(err)) {
+      chprintf(chp, "%s: write failed (%d)" SHELL_NEWLINE_STR, name, err);
+      return;
+    }
+    total += elapsed;
+    if (elapsed > worst) {
+      worst = elapsed;
+    }
+  }
+
+  mfsStop(&mfs1);
+  eflSimGetStats(&EFLD1, &before);
+  start = chVTGetSystemTimeX();
+  (void)mfsStart(&mfs1, config);
+  eflSimGetStats(&EFLD1, &after);
+  chprintf(chp, "%s: %u writes in %lu ms, worst write %lu ms, "
+                "mount %lu ms (%lu reads)" SHELL_NEWLINE_STR,
+           name, n,
+           (unsigned long)TIME_I2MS(total),
+           (unsigned long)TIME_I2MS(worst),
+           (unsigned long)TIME_I2MS(chTimeDiffX(start, chVTGetSystemTimeX())),
+           (unsigned long)(after.reads - before.reads));
+
+  /* Erase cycles spread over the sectors used by the configuration.*/
+  first = config->bank0_start;
+  last  = config->bank1_start + config->bank1_sectors;
+#if MFS_CFG_MULTI_BANK == TRUE
+  if (config->banks_num > 0U) {
+    last = first + (config->banks_num * config->bank0_sectors);
+  }
+#endif
+  for (sector = first; sector < last; sector++) {
+    uint32_t count = eflSimGetEraseCount(&EFLD1, sector);
+
+    if (count < min) {
+      min = count;
+    }
+    if (count > max) {
+      max = count;
+    }
+  }
+  chprintf(chp, "%s: %lu sectors, erases min %lu max %lu" SHELL_NEWLINE_STR,
+           name, (unsigned long)(last - first),
+           (unsigned long)min, (unsigned long)max);
+}
+
+static void cmd_bench(BaseSequentialStream *chp, int argc, char *argv[]) {
+  unsigned n;
+
+  if (argc > 1) {
+    chprintf(chp, "Usage: bench [writes]" SHELL_NEWLINE_STR);
+    return;
+  }
+  n = argc > 0 ? (unsigned)atoi(argv[0]) : 500U;
+
+  eflSimSetPowerLoss(&EFLD1, 0U);
+  bench_config(chp, "two banks", &mfscfg1, n);
+#if MFS_CFG_MULTI_BANK == TRUE
+  bench_config(chp, "multi-bank", &mfscfg2, n);
+#endif
+
+  /* The test suite configuration is left mounted.*/
+  mfsStop(&mfs1);
+  (void)mfsStart(&mfs1, &mfscfg1);
+}
+
+static const ShellCommand commands[] = {
+  {"test", cmd_test},
+  {"torture", cmd_torture},
+  {"wear", cmd_wear},
+  {"bench", cmd_bench},
+  {NULL, NULL}
+};
+
+static const ShellConfig shell_cfg1 = {
+  (BaseSequentialStream *)&SD1,
+  commands
+};
+
+/*===========================================================================*/
+/* Generic code.                                                             */
+/*===========================================================================*/
+
+/*
+ * Shell termination handler.
+ */
+static void termination_handler(eventid_t id) {
+
+  (void)id;
+  if (shelltp && chThdTerminatedX(shelltp)) {
+    chThdWait(shelltp);
+    shelltp = NULL;
+    chThdSleepMilliseconds(10);
+    chSysLock();
+    oqResetI(&SD1.oqueue);
+    chSchRescheduleS();
+    chSysUnlock();
+  }
+}
+
+static event_listener_t sd1fel;
+
+/*
+ * SD1 status change handler.
+ */
+static void sd1_handler(eventid_t id) {
+  eventflags_t flags;
+
+  (void)id;
+  flags = chEvtGetAndClearFlags(&sd1fel);
+  if ((flags & CHN_CONNECTED) && (shelltp == NULL)) {
+    shelltp = chThdCreateFromHeap(NULL, SHELL_WA_SIZE,
+                                  "shell", NORMALPRIO + 10,
+                                  shellThread, (void *)&shell_cfg1);
+  }
+  if (flags & CHN_DISCONNECTED) {
+    chSysLock();
+    iqResetI(&SD1.iqueue);
+    chSchRescheduleS();
+    chSysUnlock();
+  }
+}
+
+static evhandler_t fhandlers[] = {
+  termination_handler,
+  sd1_handler
+};
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  event_listener_t tel;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * Simulated flash, MFS and serial port initialization.
+   */
+  eflStart(&EFLD1, NULL);
+  mfsObjectInit(&mfs1, &__nocache_mfsbuf1);
+  sdStart(&SD1, NULL);
+
+  /*
+   * Shell manager initialization.
+   */
+  shellInit();
+  chEvtRegister(&shell_terminated, &tel, 0);
+
+  /*
+   * Initializing connection/disconnection events.
+   */
+  printf("Shell service started on SD1\n");
+  fflush(stdout);
+  chEvtRegister(chnGetEventSource(&SD1), &sd1fel, 1);
+
+  /*
+   * Events servicing loop.
+   */
+  while (!chThdShouldTerminateX())
+    chEvtDispatch(fhandlers, chEvtWaitOne(ALL_EVENTS));
+
+  /*
+   * Clean simulator exit.
+   */
+  chEvtUnregister(chnGetEventSource(&SD1), &sd1fel);
+  return 0;
+}
@@ -14,10 +14,16 @@
     limitations under the License.
 */
 
+#include <string.h>
+
 #include "ch.h"
 #include "hal.h"
 #include "shell.h"
 #include "chprintf.h"
+#include "memstreams.h"
+#include "nullstreams.h"
+#include "dlog.h"
+#include "blkq.h"
 
 #define SHELL_WA_SIZE       THD_WORKING_AREA_SIZE(4096)
 #define CONSOLE_WA_SIZE     THD_WORKING_AREA_SIZE(4096)
@@ -29,7 +35,557 @@ static thread_t *cdtp;
 static thread_t *shelltp1;
 static thread_t *shelltp2;
 
+/*
+ * Log ring of the main thread.
+ */
+static dlog_record_t main_records[32];
+static dlog_ring_t main_ring;
+
+/*
+ * Stream wrapper counting the calls forwarded to the wrapped stream, each
+ * call to a serial driver is a critical zone on the driver queues.
+ */
+typedef struct {
+  const struct BaseSequentialStreamVMT *vmt;
+  BaseSequentialStream *target;
+  unsigned calls;
+} CountingStream;
+
+static size_t cnt_write(void *ip, const uint8_t *bp, size_t n) {
+  CountingStream *csp = (CountingStream *)ip;
+
+  csp->calls++;
+  return streamWrite(csp->target, bp, n);
+}
+
+static size_t cnt_read(void *ip, uint8_t *bp, size_t n) {
+  CountingStream *csp = (CountingStream *)ip;
+
+  csp->calls++;
+  return streamRead(csp->target, bp, n);
+}
+
+static msg_t cnt_put(void *ip, uint8_t b) {
+  CountingStream *csp = (CountingStream *)ip;
+
+  csp->calls++;
+  return streamPut(csp->target, b);
+}
+
+static msg_t cnt_get(void *ip) {
+  CountingStream *csp = (CountingStream *)ip;
+
+  csp->calls++;
+  return streamGet(csp->target);
+}
+
+static const struct BaseSequentialStreamVMT cnt_vmt = {
+  (size_t)0, cnt_write, cnt_read, cnt_put, cnt_get
+};
+
+#define PRINTF_BMK_LINES    1000
+
+/*
+ * Formats a typical log line PRINTF_BMK_LINES times on the specified
+ * stream and reports the average cycles and stream calls per line.
+ */
+static void printf_bmk(BaseSequentialStream *chp, const char *name,
+                       BaseSequentialStream *target, MemoryStream *msp) {
+  CountingStream cs = {&cnt_vmt, target, 0U};
+  rtcnt_t start, cycles;
+  unsigned i;
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < PRINTF_BMK_LINES; i++) {
+    if (msp != NULL) {
+      msp->eos = 0U;
+    }
+    chprintf((BaseSequentialStream *)&cs,
+             "\r%5u: t=%08lX v=%-6d s=%s\r",
+             i, (unsigned long)chVTGetSystemTimeX(), -(int)i, name);
+  }
+  cycles = chSysGetRealtimeCounterX() - start;
+
+  chprintf(chp, "\r\n%-8s %8lu cycles/line %4u calls/line" SHELL_NEWLINE_STR,
+           name,
+           (unsigned long)(cycles / PRINTF_BMK_LINES),
+           cs.calls / PRINTF_BMK_LINES);
+}
+
+/*
+ * Same log line recorded using the deferred logger, the cost of recording
+ * and the cost of the deferred formatting are reported separately.
+ */
+static void dlog_bmk(BaseSequentialStream *chp) {
+  CountingStream cs = {&cnt_vmt, NULL, 0U};
+  dlog_record_t *buf;
+  dlog_ring_t ring;
+  NullStream ns;
+  rtcnt_t start, cycles;
+  unsigned i;
+
+  buf = chHeapAlloc(NULL, sizeof (dlog_record_t) * (PRINTF_BMK_LINES + 1U));
+  if (buf == NULL) {
+    chprintf(chp, "out of memory" SHELL_NEWLINE_STR);
+    return;
+  }
+  dlogRingObjectInit(&ring, "bmk", buf, PRINTF_BMK_LINES + 1U);
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < PRINTF_BMK_LINES; i++) {
+    DLOG_INFO(&ring, "%5lu: t=%08lX v=%-6ld s=%s",
+              i, (unsigned long)chVTGetSystemTimeX(), -(int)i, "dlog");
+  }
+  cycles = chSysGetRealtimeCounterX() - start;
+  chprintf(chp, "%-8s %8lu cycles/line %4u calls/line" SHELL_NEWLINE_STR,
+           "dlog", (unsigned long)(cycles / PRINTF_BMK_LINES), 0U);
+
+  nullObjectInit(&ns);
+  cs.target = (BaseSequentialStream *)&ns;
+  start = chSysGetRealtimeCounterX();
+  (void) dlogRingFlush(&ring, (BaseSequentialStream *)&cs, false);
+  cycles = chSysGetRealtimeCounterX() - start;
+  chprintf(chp, "%-8s %8lu cycles/line %4u calls/line" SHELL_NEWLINE_STR,
+           "dlog fmt", (unsigned long)(cycles / PRINTF_BMK_LINES),
+           cs.calls / PRINTF_BMK_LINES);
+
+  chHeapFree(buf);
+}
+
+static void cmd_printf(BaseSequentialStream *chp, int argc, char *argv[]) {
+  static uint8_t buf[128];
+  MemoryStream ms;
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: printf" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  chprintf(chp, "chprintf() buffer size: %u" SHELL_NEWLINE_STR,
+           (unsigned)CHPRINTF_BUFFER_SIZE);
+  msObjectInit(&ms, buf, sizeof buf, 0U);
+  printf_bmk(chp, "memory", (BaseSequentialStream *)&ms, &ms);
+  printf_bmk(chp, "serial", chp, NULL);
+  dlog_bmk(chp);
+}
+
+static void cmd_log(BaseSequentialStream *chp, int argc, char *argv[]) {
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: log" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  (void) dlogFlush(chp, false);
+}
+
+/*
+ * RAM block device with a command latency and a per-block transfer time,
+ * used for measuring the block queue.
+ */
+#define SIMDISK_BLOCK_SIZE      512U
+#define SIMDISK_BLOCKS          2048U
+#define SIMDISK_COMMAND_US      1000U
+#define SIMDISK_BLOCK_US        50U
+
+typedef struct {
+  BaseBlockDevice blk;
+  uint8_t *data;
+  uint32_t debt;
+  unsigned commands;
+} SimDisk;
+
+static uint8_t simdisk_data[SIMDISK_BLOCKS * SIMDISK_BLOCK_SIZE];
+
+static void sd_spend(SimDisk *sdp, uint32_t n) {
+  uint32_t ms;
+
+  sdp->commands++;
+  sdp->debt += SIMDISK_COMMAND_US + (n * SIMDISK_BLOCK_US);
+  ms = sdp->debt / 1000U;
+  if (ms > 0U) {
+    sdp->debt -= ms * 1000U;
+    chThdSleepMilliseconds(ms);
+  }
+}
+
+static bool sd_true(void *ip) {
+
+  (void)ip;
+  return true;
+}
+
+static bool sd_false(void *ip) {
+
+  (void)ip;
+  return false;
+}
+
+static bool sd_read(void *ip, uint32_t startblk, uint8_t *buf, uint32_t n) {
+  SimDisk *sdp = (SimDisk *)ip;
+
+  sd_spend(sdp, n);
+  memcpy(buf, &sdp->data[startblk * SIMDISK_BLOCK_SIZE],
+         n * SIMDISK_BLOCK_SIZE);
+  return HAL_SUCCESS;
+}
+
+static bool sd_write(void *ip, uint32_t startblk,
+                     const uint8_t *buf, uint32_t n) {
+  SimDisk *sdp = (SimDisk *)ip;
+
+  sd_spend(sdp, n);
+  memcpy(&sdp->data[startblk * SIMDISK_BLOCK_SIZE], buf,
+         n * SIMDISK_BLOCK_SIZE);
+  return HAL_SUCCESS;
+}
+
+static bool sd_get_info(void *ip, BlockDeviceInfo *bdip) {
+
+  (void)ip;
+  bdip->blk_size = SIMDISK_BLOCK_SIZE;
+  bdip->blk_num  = SIMDISK_BLOCKS;
+  return HAL_SUCCESS;
+}
+
+static bool sd_discard(void *ip, uint32_t startblk, uint32_t n) {
+  SimDisk *sdp = (SimDisk *)ip;
+
+  sd_spend(sdp, 0U);
+  memset(&sdp->data[startblk * SIMDISK_BLOCK_SIZE], 0xFF,
+         n * SIMDISK_BLOCK_SIZE);
+  return HAL_SUCCESS;
+}
+
+static const struct BaseBlockDeviceVMT simdisk_vmt = {
+  (size_t)0, sd_true, sd_false, sd_false, sd_false,
+  sd_read, sd_write, sd_false, sd_get_info, sd_discard
+};
+
+#define BLKQ_BMK_BLOCKS     256U
+#define BLKQ_BMK_READS      32U
+
+static SimDisk simdisk;
+static BlockQueue bq;
+static blkq_request_t bmk_requests[BLKQ_BMK_BLOCKS];
+static uint8_t bmk_buffer[BLKQ_BMK_BLOCKS * SIMDISK_BLOCK_SIZE];
+static uint8_t bmk_merge[BLKQ_MAX_MERGE_BLOCKS * SIMDISK_BLOCK_SIZE];
+static const BlockQueueConfig bmk_fifo_config = {
+  &simdisk.blk, bmk_merge, BLKQ_MAX_MERGE_BLOCKS, 0U
+};
+static const BlockQueueConfig bmk_prio_config = {
+  &simdisk.blk, bmk_merge, BLKQ_MAX_MERGE_BLOCKS, 4U
+};
+
+static void blkq_bmk_report(BaseSequentialStream *chp, const char *name,
+                            sysinterval_t t, unsigned commands) {
+
+  chprintf(chp, "%-16s %6lu blocks/s %5u commands" SHELL_NEWLINE_STR, name,
+           (unsigned long)((BLKQ_BMK_BLOCKS * 1000U) /
+                           (TIME_I2MS(t) > 0U ? TIME_I2MS(t) : 1U)),
+           commands);
+}
+
+/*
+ * Single block transfers issued directly on the device or submitted to the
+ * queue without waiting. The average latency of single block reads queued
+ * behind writes is also measured, with reads served in order or ahead of
+ * the writes.
+ */
+static void blkq_bmk(BaseSequentialStream *chp) {
+  systime_t start;
+  blkq_stats_t stats;
+  thread_t *qtp;
+  unsigned i, j;
+
+  simdisk.blk.vmt   = &simdisk_vmt;
+  simdisk.blk.state = BLK_READY;
+  simdisk.data      = simdisk_data;
+  simdisk.debt      = 0U;
+
+  /* Direct device writes.*/
+  simdisk.commands = 0U;
+  start = chVTGetSystemTimeX();
+  for (i = 0U; i < BLKQ_BMK_BLOCKS; i++) {
+    (void) blkWrite(&simdisk.blk, i,
+                    &bmk_buffer[i * SIMDISK_BLOCK_SIZE], 1U);
+  }
+  blkq_bmk_report(chp, "direct write",
+                  chTimeDiffX(start, chVTGetSystemTimeX()),
+                  simdisk.commands);
+
+  /* Same writes submitted without waiting, buffers are contiguous so the
+     merged transfers are done in place.*/
+  blkqObjectInit(&bq);
+  (void) blkqStart(&bq, &bmk_fifo_config);
+  qtp = chThdCreateFromHeap(NULL, THD_WORKING_AREA_SIZE(2048), "blkq",
+                            NORMALPRIO + 20, blkqThread, &bq);
+  simdisk.commands = 0U;
+  start = chVTGetSystemTimeX();
+  for (i = 0U; i < BLKQ_BMK_BLOCKS; i++) {
+    blkqRequestObjectInit(&bmk_requests[i], NULL, NULL);
+    blkqSubmit(&bq, &bmk_requests[i], BLKQ_OP_WRITE, i,
+               &bmk_buffer[i * SIMDISK_BLOCK_SIZE], 1U);
+  }
+  for (i = 0U; i < BLKQ_BMK_BLOCKS; i++) {
+    (void) blkqWait(&bmk_requests[i]);
+  }
+  blkq_bmk_report(chp, "queued write",
+                  chTimeDiffX(start, chVTGetSystemTimeX()),
+                  simdisk.commands);
+
+  /* Reads submitted even blocks first into scattered buffers, merged
+     transfers go through the merge buffer.*/
+  simdisk.commands = 0U;
+  start = chVTGetSystemTimeX();
+  for (i = 0U; i < BLKQ_BMK_BLOCKS; i++) {
+    uint32_t blk = ((i * 2U) % BLKQ_BMK_BLOCKS) + ((i * 2U) / BLKQ_BMK_BLOCKS);
+
+    blkqRequestObjectInit(&bmk_requests[i], NULL, NULL);
+    blkqSubmit(&bq, &bmk_requests[i], BLKQ_OP_READ, blk,
+               &bmk_buffer[((BLKQ_BMK_BLOCKS - 1U) - i) * SIMDISK_BLOCK_SIZE],
+               1U);
+  }
+  for (i = 0U; i < BLKQ_BMK_BLOCKS; i++) {
+    (void) blkqWait(&bmk_requests[i]);
+  }
+  blkq_bmk_report(chp, "queued read",
+                  chTimeDiffX(start, chVTGetSystemTimeX()),
+                  simdisk.commands);
+
+  /* Read latency behind non adjacent writes.*/
+  for (j = 0U; j < 2U; j++) {
+    sysinterval_t total = (sysinterval_t)0;
+    unsigned k;
+
+    (void) blkqStart(&bq, j == 0U ? &bmk_fifo_config : &bmk_prio_config);
+    for (i = 0U; i < BLKQ_BMK_READS; i++) {
+      for (k = 0U; k < 8U; k++) {
+        blkqRequestObjectInit(&bmk_requests[k], NULL, NULL);
+        blkqSubmit(&bq, &bmk_requests[k], BLKQ_OP_WRITE, k * 2U,
+                   bmk_buffer, 1U);
+      }
+      start = chVTGetSystemTimeX();
+      (void) blkqRead(&bq, SIMDISK_BLOCKS - 1U - i,
+                      &bmk_buffer[SIMDISK_BLOCK_SIZE], 1U);
+      total += chTimeDiffX(start, chVTGetSystemTimeX());
+      for (k = 0U; k < 8U; k++) {
+        (void) blkqWait(&bmk_requests[k]);
+      }
+    }
+    chprintf(chp, "read latency %-4s %6lu us" SHELL_NEWLINE_STR,
+             j == 0U ? "fifo" : "prio",
+             (unsigned long)(TIME_I2US(total) / BLKQ_BMK_READS));
+  }
+
+  blkqGetStats(&bq, &stats);
+  chprintf(chp, "%lu requests, %lu transfers, %lu merged" SHELL_NEWLINE_STR,
+           (unsigned long)stats.requests, (unsigned long)stats.transfers,
+           (unsigned long)stats.merged);
+
+  blkqStop(&bq);
+  chThdWait(qtp);
+}
+
+static void cmd_blkq(BaseSequentialStream *chp, int argc, char *argv[]) {
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: blkq" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  blkq_bmk(chp);
+}
+
+#define REALLOC_BMK_HEAP_SIZE   (64U * 1024U)
+#define REALLOC_BMK_FRAGMENTS   64U
+#define REALLOC_BMK_BUFFERS     8U
+#define REALLOC_BMK_STEP        32U
+#define REALLOC_BMK_MAX_SIZE    1024U
+#define REALLOC_BMK_ROUNDS      1000U
+
+static CH_HEAP_AREA(rbmk_heap_area, REALLOC_BMK_HEAP_SIZE);
+static memory_heap_t rbmk_heap;
+
+/*
+ * Resizing by always allocating a new block, as done by bindings before
+ * chHeapRealloc() was available.
+ */
+static void *rbmk_move(void *p, size_t size) {
+  void *np;
+
+  np = chHeapAlloc(&rbmk_heap, size);
+  if (np != NULL) {
+    memcpy(np, p, chHeapGetSize(p));
+    chHeapFree(p);
+  }
+  return np;
+}
+
+/*
+ * Buffers are grown in small steps, in turn, on a heap fragmented by small
+ * blocks. The number of moved blocks, the copied bytes and the number of
+ * free fragments left when the buffers reached their final size are
+ * reported.
+ */
+static void realloc_bmk(BaseSequentialStream *chp, const char *name,
+                        bool inplace) {
+  void *frags[REALLOC_BMK_FRAGMENTS];
+  void *bufs[REALLOC_BMK_BUFFERS];
+  unsigned long moves, copied, failures;
+  size_t size, n, largest;
+  systime_t start;
+  sysinterval_t t;
+  unsigned i, round;
+
+  chHeapObjectInit(&rbmk_heap, rbmk_heap_area, sizeof rbmk_heap_area);
+
+  /* Fragmenting the heap, one small block every two is freed.*/
+  for (i = 0U; i < REALLOC_BMK_FRAGMENTS; i++) {
+    frags[i] = chHeapAlloc(&rbmk_heap, 48U);
+  }
+  for (i = 0U; i < REALLOC_BMK_FRAGMENTS; i += 2U) {
+    chHeapFree(frags[i]);
+  }
+
+  moves    = 0U;
+  copied   = 0U;
+  failures = 0U;
+  n        = 0U;
+  largest  = 0U;
+  start = chVTGetSystemTimeX();
+  for (round = 0U; round < REALLOC_BMK_ROUNDS; round++) {
+    for (i = 0U; i < REALLOC_BMK_BUFFERS; i++) {
+      bufs[i] = chHeapAlloc(&rbmk_heap, REALLOC_BMK_STEP);
+    }
+    for (size = REALLOC_BMK_STEP * 2U;
+         size <= REALLOC_BMK_MAX_SIZE;
+         size += REALLOC_BMK_STEP) {
+      for (i = 0U; i < REALLOC_BMK_BUFFERS; i++) {
+        void *np;
+
+        np = inplace ? chHeapRealloc(bufs[i], size) : rbmk_move(bufs[i], size);
+        if (np == NULL) {
+          failures++;
+          continue;
+        }
+        if (np != bufs[i]) {
+          moves++;
+          copied += size - REALLOC_BMK_STEP;
+        }
+        bufs[i] = np;
+      }
+    }
+    if (round == 0U) {
+      n = chHeapStatus(&rbmk_heap, NULL, &largest);
+    }
+    for (i = 0U; i < REALLOC_BMK_BUFFERS; i++) {
+      chHeapFree(bufs[i]);
+    }
+  }
+  t = chTimeDiffX(start, chVTGetSystemTimeX());
+
+  for (i = 1U; i < REALLOC_BMK_FRAGMENTS; i += 2U) {
+    chHeapFree(frags[i]);
+  }
+
+  chprintf(chp, "%-10s %6lu ms %8lu moves %10lu bytes copied "
+                "%4lu failures" SHELL_NEWLINE_STR,
+           name, (unsigned long)TIME_I2MS(t), moves, copied, failures);
+  chprintf(chp, "%-10s %6lu fragments, largest %lu bytes" SHELL_NEWLINE_STR,
+           "", (unsigned long)n, (unsigned long)largest);
+}
+
+static void cmd_realloc(BaseSequentialStream *chp, int argc, char *argv[]) {
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: realloc" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  realloc_bmk(chp, "alloc+copy", false);
+  realloc_bmk(chp, "realloc", true);
+}
+
+#define FACTORY_BMK_MAX_OBJECTS 1000U
+#define FACTORY_BMK_LOOKUPS     100000U
+
+/*
+ * Named buffers are created in the factory then looked up, and released,
+ * in creation order. The time per lookup and the number of objects left
+ * in the factory are reported, the lookup time depends on the
+ * CH_CFG_FACTORY_HASH_SIZE setting.
+ */
+static void factory_bmk(BaseSequentialStream *chp, unsigned objects) {
+  static dyn_buffer_t *bufs[FACTORY_BMK_MAX_OBJECTS];
+  char name[8];
+  unsigned long misses;
+  systime_t start;
+  sysinterval_t t;
+  unsigned i, n;
+
+  for (n = 0U; n < objects; n++) {
+    chsnprintf(name, sizeof name, "b%u", n);
+    bufs[n] = chFactoryCreateBuffer(name, 4U);
+    if (bufs[n] == NULL) {
+      break;
+    }
+  }
+  if (n == 0U) {
+    chprintf(chp, "no objects created" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  misses = 0U;
+  start = chVTGetSystemTimeX();
+  for (i = 0U; i < FACTORY_BMK_LOOKUPS; i++) {
+    dyn_buffer_t *dbp;
+
+    chsnprintf(name, sizeof name, "b%u", i % n);
+    dbp = chFactoryFindBuffer(name);
+    if (dbp == NULL) {
+      misses++;
+      continue;
+    }
+    (void) chFactoryReleaseBuffer(dbp);
+  }
+  t = chTimeDiffX(start, chVTGetSystemTimeX());
+
+  for (i = 0U; i < n; i++) {
+    (void) chFactoryReleaseBuffer(bufs[i]);
+  }
+
+  chprintf(chp, "%5u objects %6lu ns/lookup %4lu misses" SHELL_NEWLINE_STR,
+           n, (unsigned long)(((uint64_t)TIME_I2US(t) * 1000U) /
+                              FACTORY_BMK_LOOKUPS),
+           misses);
+}
+
+static void cmd_factory(BaseSequentialStream *chp, int argc, char *argv[]) {
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: factory" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  chprintf(chp, "hash size %u" SHELL_NEWLINE_STR,
+           (unsigned)CH_CFG_FACTORY_HASH_SIZE);
+  factory_bmk(chp, 10U);
+  factory_bmk(chp, 100U);
+  factory_bmk(chp, FACTORY_BMK_MAX_OBJECTS);
+}
+
 static const ShellCommand commands[] = {
+  {"printf", cmd_printf},
+  {"log", cmd_log},
+  {"blkq", cmd_blkq},
+  {"realloc", cmd_realloc},
+  {"factory", cmd_factory},
   {NULL, NULL}
 };
 
@@ -103,12 +659,14 @@ static void sd1_handler(eventid_t id) {
   flags = chEvtGetAndClearFlags(&sd1fel);
   if ((flags & CHN_CONNECTED) && (shelltp1 == NULL)) {
     cputs("Init: connection on SD1");
+    DLOG_INFO(&main_ring, "connection on SD%lu", 1U);
     shelltp1 = chThdCreateFromHeap(NULL, SHELL_WA_SIZE,
                                    "shell1", NORMALPRIO + 10,
                                    shellThread, (void *)&shell_cfg1);
   }
   if (flags & CHN_DISCONNECTED) {
     cputs("Init: disconnection on SD1");
+    DLOG_INFO(&main_ring, "disconnection on SD%lu", 1U);
     chSysLock();
     iqResetI(&SD1.iqueue);
     chSchRescheduleS();
@@ -128,12 +686,14 @@ static void sd2_handler(eventid_t id) {
   flags = chEvtGetAndClearFlags(&sd2fel);
   if ((flags & CHN_CONNECTED) && (shelltp2 == NULL)) {
     cputs("Init: connection on SD2");
+    DLOG_INFO(&main_ring, "connection on SD%lu", 2U);
     shelltp2 = chThdCreateFromHeap(NULL, SHELL_WA_SIZE,
                                    "shell2", NORMALPRIO + 10,
                                    shellThread, (void *)&shell_cfg2);
   }
   if (flags & CHN_DISCONNECTED) {
     cputs("Init: disconnection on SD2");
+    DLOG_INFO(&main_ring, "disconnection on SD%lu", 2U);
     chSysLock();
     iqResetI(&SD2.iqueue);
     chSchRescheduleS();
@@ -169,6 +729,14 @@ int main(void) {
   sdStart(&SD1, NULL);
   sdStart(&SD2, NULL);
 
+  /*
+   * Deferred logger initialization, the main thread owns a ring.
+   */
+  dlogInit();
+  dlogRingObjectInit(&main_ring, "main", main_records,
+                     sizeof main_records / sizeof main_records[0]);
+  dlogRegister(&main_ring);
+
   /*
    * Shell manager initialization.
    */
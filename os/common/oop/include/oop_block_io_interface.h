@@ -46,6 +46,7 @@
 #define blkWrite                            bioWrite
 #define blkSync                             biokSync
 #define blkGetInfo                          bioGetInfo
+#define blkDiscard                          bioDiscard
 /** @} */
 #endif /* defined(OOP_USE_LEGACY) */
 
@@ -122,6 +123,7 @@ struct block_io_vmt {
   bool (*write)(void *ip, uint32_t startblk, const uint8_t buf, uint32_t n);
   bool (*sync)(void *ip);
   bool (*get_info)(void *ip, block_io_info_t *bdip);
+  bool (*discard)(void *ip, uint32_t startblk, uint32_t n);
 };
 
 /**
@@ -319,6 +321,28 @@ static inline bool bioGetInfo(void *ip, block_io_info_t *bdip) {
 
   return self->vmt->get_info(ip, bdip);
 }
+
+/**
+ * @memberof    block_io_i
+ * @public
+ *
+ * @brief       Discards one or more blocks.
+ * @details     The content of discarded blocks is undefined until they are
+ *              written again.
+ *
+ * @param[in,out] ip            Pointer to a @p block_io_i instance.
+ * @param[in]     startblk      First block to discard.
+ * @param[in]     n             Number of blocks to discard.
+ * @return                      The operation status.
+ * @retval false                If the operation succeeded.
+ * @retval true                 If the operation failed.
+ */
+CC_FORCE_INLINE
+static inline bool bioDiscard(void *ip, uint32_t startblk, uint32_t n) {
+  block_io_i *self = (block_io_i *)ip;
+
+  return self->vmt->discard(ip, startblk, n);
+}
 /** @} */
 
 #endif /* OOP_BLOCK_IO_INTERFACE_H */
@@ -28,39 +28,156 @@
  * @{
  */
 
+#include <string.h>
+
 #include "oop_chprintf.h"
 #include "oop_memstreams.h"
 
-#define MAX_FILLER 11
+/* Digits of the longest number, an unsigned long in octal.*/
+#define MAX_FILLER ((sizeof (unsigned long) * 8U + 2U) / 3U)
 #define FLOAT_PRECISION 9
 
+#if CHPRINTF_BUFFER_SIZE > 0
+/**
+ * @brief   Output buffer used by @p chvprintf().
+ */
+typedef struct {
+  sequential_stream_i   *stmp;
+  size_t                cnt;
+  uint8_t               buf[CHPRINTF_BUFFER_SIZE];
+} out_buffer_t;
+#else
+typedef struct {
+  sequential_stream_i   *stmp;
+} out_buffer_t;
+#endif
+
+static const char digits_table[] = "0123456789ABCDEF";
+
+static const char pairs_table[] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+static void out_flush(out_buffer_t *obp) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  if (obp->cnt > 0U) {
+    (void) stmWrite(obp->stmp, obp->buf, obp->cnt);
+    obp->cnt = 0U;
+  }
+#else
+  (void)obp;
+#endif
+}
+
+static void out_put(out_buffer_t *obp, char c) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  if (obp->cnt >= (size_t)CHPRINTF_BUFFER_SIZE) {
+    out_flush(obp);
+  }
+  obp->buf[obp->cnt++] = (uint8_t)c;
+#else
+  stmPut(obp->stmp, (uint8_t)c);
+#endif
+}
+
+static void out_fill(out_buffer_t *obp, char c, int n) {
+
+  while (n-- > 0) {
+    out_put(obp, c);
+  }
+}
+
+static void out_write(out_buffer_t *obp, const char *s, size_t n) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  /* Long runs bypass the buffer.*/
+  if (n >= (size_t)CHPRINTF_BUFFER_SIZE) {
+    out_flush(obp);
+    (void) stmWrite(obp->stmp, (const uint8_t *)s, n);
+    return;
+  }
+  if (obp->cnt + n > (size_t)CHPRINTF_BUFFER_SIZE) {
+    out_flush(obp);
+  }
+  memcpy(&obp->buf[obp->cnt], s, n);
+  obp->cnt += n;
+#else
+  while (n-- > 0U) {
+    stmPut(obp->stmp, (uint8_t)*s++);
+  }
+#endif
+}
+
 static char *long_to_string_with_divisor(char *p,
-                                         long num,
+                                         unsigned long num,
                                          unsigned radix,
-                                         long divisor) {
-  int i;
+                                         unsigned long divisor) {
+  char tmp[MAX_FILLER];
   char *q;
-  long l, ll;
+  int i;
 
-  l = num;
-  if (divisor == 0) {
-    ll = num;
-  } else {
-    ll = divisor;
+  /* Digits are generated backward, radix-specific loops allow the
+     compiler to replace divisions with shifts or multiplications.*/
+  q = tmp + MAX_FILLER;
+  if (radix == 10U) {
+    while (num >= 100UL) {
+      unsigned r = (unsigned)(num % 100UL) * 2U;
+      num /= 100UL;
+      *--q = pairs_table[r + 1U];
+      *--q = pairs_table[r];
+    }
+    if (num >= 10UL) {
+      unsigned r = (unsigned)num * 2U;
+      *--q = pairs_table[r + 1U];
+      *--q = pairs_table[r];
+    }
+    else {
+      *--q = digits_table[num];
+    }
+  }
+  else if (radix == 16U) {
+    do {
+      *--q = digits_table[num & 15UL];
+      num >>= 4;
+    } while (num != 0UL);
+  }
+  else if (radix == 8U) {
+    do {
+      *--q = digits_table[num & 7UL];
+      num >>= 3;
+    } while (num != 0UL);
+  }
+  else {
+    do {
+      *--q = digits_table[num % radix];
+      num /= radix;
+    } while (num != 0UL);
   }
 
-  q = p + MAX_FILLER;
-  do {
-    i = (int)(l % radix);
-    i += '0';
-    if (i > '9') {
-      i += 'A' - '0' - 10;
+  /* If a divisor is specified then the number of digits is the same of
+     the divisor, zero padded or truncated.*/
+  if (divisor != 0UL) {
+    i = 0;
+    do {
+      i++;
+    } while ((divisor /= radix) != 0UL);
+    while ((int)(tmp + MAX_FILLER - q) < i) {
+      *--q = '0';
     }
-    *--q = i;
-    l /= radix;
-  } while ((ll /= radix) != 0);
+    q = tmp + MAX_FILLER - i;
+  }
 
-  i = (int)(p + MAX_FILLER - q);
+  i = (int)(tmp + MAX_FILLER - q);
   do
     *p++ = *q++;
   while (--i);
@@ -68,64 +185,40 @@ static char *long_to_string_with_divisor(char *p,
   return p;
 }
 
-static char *ch_ltoa(char *p, long num, unsigned radix) {
+static char *ch_ltoa(char *p, unsigned long num, unsigned radix) {
 
   return long_to_string_with_divisor(p, num, radix, 0);
 }
 
 #if CHPRINTF_USE_FLOAT
 static char *ftoa(char *p, double num, unsigned long precision) {
-  static const long chpow10[FLOAT_PRECISION] = {
+  static const unsigned long chpow10[FLOAT_PRECISION] = {
     10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
   };
-  long l;
+  unsigned long l;
 
   if ((precision == 0) || (precision > FLOAT_PRECISION)) {
     precision = FLOAT_PRECISION;
   }
   precision = chpow10[precision - 1];
 
-  l = (long)num;
+  l = (unsigned long)num;
   p = long_to_string_with_divisor(p, l, 10, 0);
   *p++ = '.';
-  l = (long)((num - l) * precision);
+  l = (unsigned long)((num - l) * precision);
 
   return long_to_string_with_divisor(p, l, 10, precision / 10);
 }
 #endif
 
-/**
- * @brief   System formatted output function.
- * @details This function implements a minimal @p vprintf()-like functionality
- *          with output on a @p BaseSequentialStream.
- *          The general parameters format is: %[-][width|*][.precision|*][l|L]p.
- *          The following parameter types (p) are supported:
- *          - <b>x</b> hexadecimal integer.
- *          - <b>X</b> hexadecimal long.
- *          - <b>o</b> octal integer.
- *          - <b>O</b> octal long.
- *          - <b>d</b> decimal signed integer.
- *          - <b>D</b> decimal signed long.
- *          - <b>u</b> decimal unsigned integer.
- *          - <b>U</b> decimal unsigned long.
- *          - <b>c</b> character.
- *          - <b>s</b> string.
- *          .
- *
- * @param[in] stmp      pointer to a @p sequential_stream_i interface
- * @param[in] fmt       formatting string
- * @param[in] ap        list of parameters
- * @return              The number of bytes that would have been
- *                      written to @p chp if no stream error occurs
- *
- * @api
- */
-int chvprintf(sequential_stream_i *stmp, const char *fmt, va_list ap) {
+static int do_vprintf(out_buffer_t *obp, const char *fmt, va_list ap) {
+  const char *fp;
   char *p, *s, c, filler;
   int i, precision, width;
   int n = 0;
   bool is_long, left_align, do_sign;
   long l;
+  unsigned long ul;
 #if CHPRINTF_USE_FLOAT
   float f;
   char tmpbuf[2*MAX_FILLER + 1];
@@ -134,17 +227,21 @@ int chvprintf(sequential_stream_i *stmp, const char *fmt, va_list ap) {
 #endif
 
   while (true) {
+    /* Literal text is written as a whole run.*/
+    fp = fmt;
+    while ((*fmt != '%') && (*fmt != 0)) {
+      fmt++;
+    }
+    if (fmt > fp) {
+      out_write(obp, fp, (size_t)(fmt - fp));
+      n += (int)(fmt - fp);
+    }
+
     c = *fmt++;
     if (c == 0) {
       return n;
     }
     
-    if (c != '%') {
-      stmPut(stmp, (uint8_t)c);
-      n++;
-      continue;
-    }
-    
     p = tmpbuf;
     s = tmpbuf;
 
@@ -256,13 +353,15 @@ int chvprintf(sequential_stream_i *stmp, const char *fmt, va_list ap) {
       }
       if (l < 0) {
         *p++ = '-';
-        l = -l;
+        ul = 0UL - (unsigned long)l;
       }
-      else
+      else {
         if (do_sign) {
           *p++ = '+';
         }
-      p = ch_ltoa(p, l, 10);
+        ul = (unsigned long)l;
+      }
+      p = ch_ltoa(p, ul, 10);
       break;
 #if CHPRINTF_USE_FLOAT
     case 'f':
@@ -294,12 +393,12 @@ int chvprintf(sequential_stream_i *stmp, const char *fmt, va_list ap) {
       c = 8;
 unsigned_common:
       if (is_long) {
-        l = va_arg(ap, unsigned long);
+        ul = va_arg(ap, unsigned long);
       }
       else {
-        l = va_arg(ap, unsigned int);
+        ul = va_arg(ap, unsigned int);
       }
-      p = ch_ltoa(p, l, c);
+      p = ch_ltoa(p, ul, (unsigned)c);
       break;
     default:
       *p++ = c;
@@ -314,28 +413,68 @@ unsigned_common:
     }
     if (width < 0) {
       if ((*s == '-' || *s == '+') && filler == '0') {
-        stmPut(stmp, (uint8_t)*s++);
+        out_put(obp, *s++);
         n++;
         i--;
       }
-      do {
-        stmPut(stmp, (uint8_t)filler);
-        n++;
-      } while (++width != 0);
+      out_fill(obp, filler, -width);
+      n -= width;
+      width = 0;
     }
-    while (--i >= 0) {
-      stmPut(stmp, (uint8_t)*s++);
-      n++;
+    if (i > 0) {
+      out_write(obp, s, (size_t)i);
+      n += i;
     }
-
-    while (width) {
-      stmPut(stmp, (uint8_t)filler);
-      n++;
-      width--;
+    if (width > 0) {
+      out_fill(obp, filler, width);
+      n += width;
     }
   }
 }
 
+/**
+ * @brief   System formatted output function.
+ * @details This function implements a minimal @p vprintf()-like functionality
+ *          with output on a @p BaseSequentialStream.
+ *          The general parameters format is: %[-][width|*][.precision|*][l|L]p.
+ *          The following parameter types (p) are supported:
+ *          - <b>x</b> hexadecimal integer.
+ *          - <b>X</b> hexadecimal long.
+ *          - <b>o</b> octal integer.
+ *          - <b>O</b> octal long.
+ *          - <b>d</b> decimal signed integer.
+ *          - <b>D</b> decimal signed long.
+ *          - <b>u</b> decimal unsigned integer.
+ *          - <b>U</b> decimal unsigned long.
+ *          - <b>c</b> character.
+ *          - <b>s</b> string.
+ *          .
+ * @note    Output is collected in a buffer of @p CHPRINTF_BUFFER_SIZE bytes
+ *          allocated on the stack and written to the stream in runs using
+ *          @p stmWrite().
+ *
+ * @param[in] stmp      pointer to a @p sequential_stream_i interface
+ * @param[in] fmt       formatting string
+ * @param[in] ap        list of parameters
+ * @return              The number of bytes that would have been
+ *                      written to @p chp if no stream error occurs
+ *
+ * @api
+ */
+int chvprintf(sequential_stream_i *stmp, const char *fmt, va_list ap) {
+  out_buffer_t ob;
+  int n;
+
+  ob.stmp = stmp;
+#if CHPRINTF_BUFFER_SIZE > 0
+  ob.cnt = 0U;
+#endif
+  n = do_vprintf(&ob, fmt, ap);
+  out_flush(&ob);
+
+  return n;
+}
+
 /**
  * @brief   System formatted output function.
  * @details This function implements a minimal @p printf() like functionality
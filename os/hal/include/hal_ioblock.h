@@ -79,7 +79,9 @@ typedef struct {
   /* Write operations synchronization.*/                                    \
   bool (*sync)(void *instance);                                             \
   /* Obtains info about the media.*/                                        \
-  bool (*get_info)(void *instance, BlockDeviceInfo *bdip);
+  bool (*get_info)(void *instance, BlockDeviceInfo *bdip);                  \
+  /* Discards one or more blocks.*/                                         \
+  bool (*discard)(void *instance, uint32_t startblk, uint32_t n);
 
 /**
  * @brief   @p BaseBlockDevice specific data.
@@ -262,6 +264,24 @@ typedef struct {
  */
 #define blkGetInfo(ip, bdip) ((ip)->vmt->get_info(ip, bdip))
 
+/**
+ * @brief   Discards one or more blocks.
+ * @details The device is informed that the content of the blocks is no
+ *          more needed, the content of discarded blocks is undefined
+ *          until they are written again.
+ *
+ * @param[in] ip        pointer to a @p BaseBlockDevice or derived class
+ * @param[in] startblk  first block to discard
+ * @param[in] n         number of blocks to discard
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+#define blkDiscard(ip, startblk, n) ((ip)->vmt->discard(ip, startblk, n))
+
 /** @} */
 
 #endif /* HAL_IOBLOCK_H */
@@ -28,7 +28,13 @@
  *          divided in writable pages.<br>
  *          The module handles flash wear leveling and recovery of damaged
  *          banks (where possible) caused by power loss during operations.
- *          Both operations are transparent to the user.
+ *          Both operations are transparent to the user.<br>
+ *          In multi-bank mode the partition is a ring of three or more
+ *          banks, records are appended to the current bank while the
+ *          live records of the previous bank are moved forward a few at
+ *          time, the previous bank is then erased a sector at time. The
+ *          records index is checkpointed in the current bank so that mount
+ *          only needs to scan records written after the last checkpoint.
  *
  * @addtogroup HAL_MFS
  * @{
@@ -62,6 +68,23 @@
 #define ALIGNED_SIZEOF(t)                                                   \
   (((sizeof (t) - 1U) | MFS_ALIGN_MASK) + 1U)
 
+/**
+ * @brief   Record identifier of index checkpoints.
+ */
+#define CHECKPOINT_ID                       0U
+
+/**
+ * @brief   Size of the data part of an index checkpoint.
+ */
+#define CHECKPOINT_SIZE                                                     \
+  (sizeof (mfs_record_descriptor_t) * (size_t)MFS_CFG_MAX_RECORDS)
+
+/**
+ * @brief   Index checkpoint record size aligned.
+ */
+#define ALIGNED_CKPT_SIZE                                                   \
+  ALIGNED_REC_SIZE(CHECKPOINT_SIZE)
+
 /**
  * @brief   Combines two values (0..3) in one (0..15).
  */
@@ -147,15 +170,54 @@ static void mfs_state_reset(MFSDriver *mfsp) {
     mfsp->descriptors[i].offset = 0U;
     mfsp->descriptors[i].size   = 0U;
   }
+
+#if MFS_CFG_MULTI_BANK == TRUE
+  mfsp->gc_bank         = MFS_BANK_0;
+  mfsp->gc_erased       = 0U;
+  mfsp->ckpt_records    = 0U;
+#endif
+}
+
+/**
+ * @brief   Returns the sectors range of a bank.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] bank      the bank identifier
+ * @param[out] startp   first sector of the bank
+ * @param[out] np       number of sectors in the bank
+ *
+ * @notapi
+ */
+static void mfs_bank_get_sectors(MFSDriver *mfsp, mfs_bank_t bank,
+                                 flash_sector_t *startp, flash_sector_t *np) {
+
+#if MFS_CFG_MULTI_BANK == TRUE
+  if (mfsp->config->banks_num > 0U) {
+    /* Contiguous banks of equal size.*/
+    *startp = mfsp->config->bank0_start +
+              ((flash_sector_t)bank * mfsp->config->bank0_sectors);
+    *np     = mfsp->config->bank0_sectors;
+    return;
+  }
+#endif
+
+  if (bank == MFS_BANK_0) {
+    *startp = mfsp->config->bank0_start;
+    *np     = mfsp->config->bank0_sectors;
+  }
+  else {
+    *startp = mfsp->config->bank1_start;
+    *np     = mfsp->config->bank1_sectors;
+  }
 }
 
 static flash_offset_t mfs_flash_get_bank_offset(MFSDriver *mfsp,
                                                 mfs_bank_t bank) {
+  flash_sector_t sector, n;
+
+  mfs_bank_get_sectors(mfsp, bank, &sector, &n);
 
-  return bank == MFS_BANK_0 ? flashGetSectorOffset(mfsp->config->flashp,
-                                                   mfsp->config->bank0_start) :
-                              flashGetSectorOffset(mfsp->config->flashp,
-                                                   mfsp->config->bank1_start);
+  return flashGetSectorOffset(mfsp->config->flashp, sector);
 }
 
 /**
@@ -267,6 +329,37 @@ static mfs_error_t mfs_flash_copy(MFSDriver *mfsp,
   return MFS_NO_ERROR;
 }
 
+/**
+ * @brief   Erases and verifies a flash sector.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] sector    sector to be erased
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_flash_erase(MFSDriver *mfsp, flash_sector_t sector) {
+  flash_error_t ferr;
+
+  ferr = flashStartEraseSector(mfsp->config->flashp, sector);
+  if (ferr != FLASH_NO_ERROR) {
+    mfsp->state = MFS_ERROR;
+    return MFS_ERR_FLASH_FAILURE;
+  }
+  ferr = flashWaitErase(mfsp->config->flashp);
+  if (ferr != FLASH_NO_ERROR) {
+    mfsp->state = MFS_ERROR;
+    return MFS_ERR_FLASH_FAILURE;
+  }
+  ferr = flashVerifyErase(mfsp->config->flashp, sector);
+  if (ferr != FLASH_NO_ERROR) {
+    mfsp->state = MFS_ERROR;
+    return MFS_ERR_FLASH_FAILURE;
+  }
+
+  return MFS_NO_ERROR;
+}
+
 /**
  * @brief   Erases and verifies all sectors belonging to a bank.
  *
@@ -279,34 +372,11 @@ static mfs_error_t mfs_flash_copy(MFSDriver *mfsp,
 static mfs_error_t mfs_bank_erase(MFSDriver *mfsp, mfs_bank_t bank) {
   flash_sector_t sector, end;
 
-  if (bank == MFS_BANK_0) {
-    sector = mfsp->config->bank0_start;
-    end    = mfsp->config->bank0_start + mfsp->config->bank0_sectors;
-  }
-  else {
-    sector = mfsp->config->bank1_start;
-    end    = mfsp->config->bank1_start + mfsp->config->bank1_sectors;
-  }
+  mfs_bank_get_sectors(mfsp, bank, &sector, &end);
+  end += sector;
 
   while (sector < end) {
-    flash_error_t ferr;
-
-    ferr = flashStartEraseSector(mfsp->config->flashp, sector);
-    if (ferr != FLASH_NO_ERROR) {
-      mfsp->state = MFS_ERROR;
-      return MFS_ERR_FLASH_FAILURE;
-    }
-    ferr = flashWaitErase(mfsp->config->flashp);
-    if (ferr != FLASH_NO_ERROR) {
-      mfsp->state = MFS_ERROR;
-      return MFS_ERR_FLASH_FAILURE;
-    }
-    ferr = flashVerifyErase(mfsp->config->flashp, sector);
-    if (ferr != FLASH_NO_ERROR) {
-      mfsp->state = MFS_ERROR;
-      return MFS_ERR_FLASH_FAILURE;
-    }
-
+    RET_ON_ERROR(mfs_flash_erase(mfsp, sector));
     sector++;
   }
 
@@ -325,14 +395,8 @@ static mfs_error_t mfs_bank_erase(MFSDriver *mfsp, mfs_bank_t bank) {
 static mfs_error_t mfs_bank_verify_erase(MFSDriver *mfsp, mfs_bank_t bank) {
   flash_sector_t sector, end;
 
-  if (bank == MFS_BANK_0) {
-    sector = mfsp->config->bank0_start;
-    end    = mfsp->config->bank0_start + mfsp->config->bank0_sectors;
-  }
-  else {
-    sector = mfsp->config->bank1_start;
-    end    = mfsp->config->bank1_start + mfsp->config->bank1_sectors;
-  }
+  mfs_bank_get_sectors(mfsp, bank, &sector, &end);
+  end += sector;
 
   while (sector < end) {
     flash_error_t ferr;
@@ -365,14 +429,6 @@ static mfs_error_t mfs_bank_verify_erase(MFSDriver *mfsp, mfs_bank_t bank) {
 static mfs_error_t mfs_bank_write_header(MFSDriver *mfsp,
                                          mfs_bank_t bank,
                                          uint32_t cnt) {
-  flash_sector_t sector;
-
-  if (bank == MFS_BANK_0) {
-    sector = mfsp->config->bank0_start;
-  }
-  else {
-    sector = mfsp->config->bank1_start;
-  }
 
   mfsp->ncbuf->bhdr.fields.magic1    = MFS_BANK_MAGIC_1;
   mfsp->ncbuf->bhdr.fields.magic2    = MFS_BANK_MAGIC_2;
@@ -383,7 +439,7 @@ static mfs_error_t mfs_bank_write_header(MFSDriver *mfsp,
                                              sizeof (mfs_bank_header_t) - sizeof (uint16_t));
 
   return mfs_flash_write(mfsp,
-                         flashGetSectorOffset(mfsp->config->flashp, sector),
+                         mfs_flash_get_bank_offset(mfsp, bank),
                          sizeof (mfs_bank_header_t),
                          mfsp->ncbuf->bhdr.hdr8);
 }
@@ -424,12 +480,66 @@ static mfs_bank_state_t mfs_bank_check_header(MFSDriver *mfsp) {
   return MFS_BANK_OK;
 }
 
+/**
+ * @brief   Checks integrity of the data header in the shared buffer.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] space     space between the header and the bank end
+ * @return              The header validity.
+ *
+ * @notapi
+ */
+static bool mfs_record_check_header(MFSDriver *mfsp, flash_offset_t space) {
+
+  if ((mfsp->ncbuf->dhdr.fields.magic1 != MFS_HEADER_MAGIC_1) ||
+      (mfsp->ncbuf->dhdr.fields.magic2 != MFS_HEADER_MAGIC_2) ||
+      (mfsp->ncbuf->dhdr.fields.size > space)) {
+    return false;
+  }
+
+  if ((mfsp->ncbuf->dhdr.fields.id >= 1U) &&
+      (mfsp->ncbuf->dhdr.fields.id <= (uint32_t)MFS_CFG_MAX_RECORDS)) {
+    return true;
+  }
+
+#if MFS_CFG_MULTI_BANK == TRUE
+  /* Index checkpoints only exist in multi-bank mode.*/
+  if ((mfsp->config->banks_num > 0U) &&
+      (mfsp->ncbuf->dhdr.fields.id == CHECKPOINT_ID) &&
+      (mfsp->ncbuf->dhdr.fields.size == (uint32_t)CHECKPOINT_SIZE)) {
+    return true;
+  }
+#endif
+
+  return false;
+}
+
+#if (MFS_CFG_MULTI_BANK == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Loads the records index from an index checkpoint.
+ * @note    The checkpoint integrity is not checked.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] offset    offset of the checkpoint header
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_checkpoint_load(MFSDriver *mfsp,
+                                       flash_offset_t offset) {
+
+  return mfs_flash_read(mfsp, offset + sizeof (mfs_data_header_t),
+                        CHECKPOINT_SIZE, (uint8_t *)mfsp->descriptors);
+}
+#endif /* MFS_CFG_MULTI_BANK == TRUE */
+
 /**
  * @brief   Scans blocks searching for records.
  * @note    The block integrity is strongly checked.
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
  * @param[in] bank      the bank identifier
+ * @param[in] hdr_offset offset of the first record to be scanned
  * @param[out] wflagp   warning flag on anomalies
  *
  * @return              The operation status.
@@ -438,20 +548,20 @@ static mfs_bank_state_t mfs_bank_check_header(MFSDriver *mfsp) {
  */
 static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
                                          mfs_bank_t bank,
+                                         flash_offset_t hdr_offset,
                                          bool *wflagp) {
-  flash_offset_t hdr_offset, start_offset, end_offset;
+  flash_offset_t end_offset;
 
   /* No warning by default.*/
   *wflagp = false;
 
   /* Boundaries.*/
-  start_offset = mfs_flash_get_bank_offset(mfsp, bank);
-  hdr_offset   = start_offset + (flash_offset_t)ALIGNED_SIZEOF(mfs_bank_header_t);
-  end_offset   = start_offset + mfsp->config->bank_size;
+  end_offset = mfs_flash_get_bank_offset(mfsp, bank) +
+               mfsp->config->bank_size;
 
   /* Scanning records until there is there is not enough space left for an
      header.*/
-  while (hdr_offset < end_offset - ALIGNED_DHDR_SIZE) {
+  while (hdr_offset <= end_offset - ALIGNED_DHDR_SIZE) {
     mfs_data_header_t dhdr;
     uint16_t crc;
 
@@ -468,11 +578,7 @@ static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
     }
 
     /* It is not erased so checking for integrity.*/
-    if ((mfsp->ncbuf->dhdr.fields.magic1 != MFS_HEADER_MAGIC_1) ||
-        (mfsp->ncbuf->dhdr.fields.magic2 != MFS_HEADER_MAGIC_2) ||
-        (mfsp->ncbuf->dhdr.fields.id < 1U) ||
-        (mfsp->ncbuf->dhdr.fields.id > (uint32_t)MFS_CFG_MAX_RECORDS) ||
-        (mfsp->ncbuf->dhdr.fields.size > end_offset - hdr_offset)) {
+    if (!mfs_record_check_header(mfsp, end_offset - hdr_offset)) {
       *wflagp = true;
       break;
     }
@@ -507,6 +613,12 @@ static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
          continues because there could be more valid records afterward.*/
       *wflagp = true;
     }
+#if MFS_CFG_MULTI_BANK == TRUE
+    else if (dhdr.fields.id == CHECKPOINT_ID) {
+      /* Index checkpoint, it replaces the index built so far.*/
+      RET_ON_ERROR(mfs_checkpoint_load(mfsp, hdr_offset));
+    }
+#endif
     else {
       /* Zero-sized records are erase markers.*/
       if (dhdr.fields.size == 0U) {
@@ -574,6 +686,403 @@ static mfs_error_t mfs_bank_get_state(MFSDriver *mfsp,
   return MFS_NO_ERROR;
 }
 
+#if (MFS_CFG_MULTI_BANK == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Checks if an offset belongs to a bank.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] bank      the bank identifier
+ * @param[in] offset    flash offset
+ * @return              The check result.
+ *
+ * @notapi
+ */
+static bool mfs_bank_contains(MFSDriver *mfsp, mfs_bank_t bank,
+                              flash_offset_t offset) {
+  flash_offset_t start_offset = mfs_flash_get_bank_offset(mfsp, bank);
+
+  return (offset >= start_offset) &&
+         (offset < start_offset + mfsp->config->bank_size);
+}
+
+/**
+ * @brief   Returns the bank following another bank in the ring.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] bank      the bank identifier
+ * @return              The next bank identifier.
+ *
+ * @notapi
+ */
+static mfs_bank_t mfs_bank_next(MFSDriver *mfsp, mfs_bank_t bank) {
+
+  bank++;
+  if (bank >= mfsp->config->banks_num) {
+    bank = MFS_BANK_0;
+  }
+
+  return bank;
+}
+
+/**
+ * @brief   Space taken by the live records still in the reclaimed bank.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The space to be moved to the current bank.
+ *
+ * @notapi
+ */
+static flash_offset_t mfs_bank_get_reclaim_space(MFSDriver *mfsp) {
+  flash_offset_t space = 0U;
+  unsigned i;
+
+  if (mfsp->gc_bank != mfsp->current_bank) {
+    for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
+      if ((mfsp->descriptors[i].offset != 0U) &&
+          mfs_bank_contains(mfsp, mfsp->gc_bank,
+                            mfsp->descriptors[i].offset)) {
+        space += ALIGNED_REC_SIZE(mfsp->descriptors[i].size);
+      }
+    }
+  }
+
+  return space;
+}
+
+/**
+ * @brief   Makes sure that a bank is erased before using it.
+ * @note    Erased banks are not verified on mount, a bank could be left
+ *          partially erased or partially written by a power loss.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] bank      the bank identifier
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_bank_prepare(MFSDriver *mfsp, mfs_bank_t bank) {
+  mfs_error_t err;
+
+  err = mfs_bank_verify_erase(mfsp, bank);
+  if (err == MFS_ERR_NOT_ERASED) {
+    err = mfs_bank_erase(mfsp, bank);
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Writes an index checkpoint at the next free position.
+ * @details The checkpoint is a snapshot of the records index, records
+ *          written before it do not need to be scanned on mount.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_checkpoint_write(MFSDriver *mfsp) {
+
+  /* Writing the data header without the magic, it will be written last.*/
+  mfsp->ncbuf->dhdr.fields.id     = (uint16_t)CHECKPOINT_ID;
+  mfsp->ncbuf->dhdr.fields.size   = (uint32_t)CHECKPOINT_SIZE;
+  mfsp->ncbuf->dhdr.fields.crc    = crc16(0xFFFFU,
+                                          (const uint8_t *)mfsp->descriptors,
+                                          CHECKPOINT_SIZE);
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->next_offset + (sizeof (uint32_t) * 2U),
+                               sizeof (mfs_data_header_t) - (sizeof (uint32_t) * 2U),
+                               mfsp->ncbuf->data8 + (sizeof (uint32_t) * 2U)));
+
+  /* Writing the index snapshot.*/
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->next_offset + sizeof (mfs_data_header_t),
+                               CHECKPOINT_SIZE,
+                               (const uint8_t *)mfsp->descriptors));
+
+  /* Finally writing the magic number, it seals the operation.*/
+  mfsp->ncbuf->dhdr.fields.magic1 = (uint32_t)MFS_HEADER_MAGIC_1;
+  mfsp->ncbuf->dhdr.fields.magic2 = (uint32_t)MFS_HEADER_MAGIC_2;
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->next_offset,
+                               sizeof (uint32_t) * 2U,
+                               mfsp->ncbuf->data8));
+
+  mfsp->next_offset += ALIGNED_CKPT_SIZE;
+  mfsp->ckpt_records = 0U;
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Finds the last index checkpoint in a bank.
+ * @note    Only record headers are read, data integrity is not checked.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] bank      the bank identifier
+ * @param[out] offsetp  offset of the last checkpoint header or zero if
+ *                      there are no checkpoints in the bank
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_checkpoint_find(MFSDriver *mfsp,
+                                       mfs_bank_t bank,
+                                       flash_offset_t *offsetp) {
+  flash_offset_t hdr_offset, start_offset, end_offset;
+
+  *offsetp = 0U;
+
+  /* Boundaries.*/
+  start_offset = mfs_flash_get_bank_offset(mfsp, bank);
+  hdr_offset   = start_offset + (flash_offset_t)ALIGNED_SIZEOF(mfs_bank_header_t);
+  end_offset   = start_offset + mfsp->config->bank_size;
+
+  /* Walking the records chain, anomalies are left to the scan.*/
+  while (hdr_offset <= end_offset - ALIGNED_DHDR_SIZE) {
+
+    RET_ON_ERROR(mfs_flash_read(mfsp, hdr_offset,
+                                sizeof (mfs_data_header_t),
+                                mfsp->ncbuf->data8));
+
+    if ((mfsp->ncbuf->data32[0] == mfsp->config->erased) &&
+        (mfsp->ncbuf->data32[1] == mfsp->config->erased) &&
+        (mfsp->ncbuf->data32[2] == mfsp->config->erased)) {
+      break;
+    }
+
+    if (!mfs_record_check_header(mfsp, end_offset - hdr_offset)) {
+      break;
+    }
+
+    if (mfsp->ncbuf->dhdr.fields.id == CHECKPOINT_ID) {
+      *offsetp = hdr_offset;
+    }
+
+    /* On the next header.*/
+    hdr_offset = hdr_offset + ALIGNED_REC_SIZE(mfsp->ncbuf->dhdr.fields.size);
+  }
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Moves a record to the next free position of the current bank.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] i         index of the record descriptor
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_record_move(MFSDriver *mfsp, unsigned i) {
+  uint32_t totsize = ALIGNED_REC_SIZE(mfsp->descriptors[i].size);
+
+  /* Space is guaranteed by the allocation policy, checking anyway.*/
+  if (totsize > (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
+                 mfsp->config->bank_size) - mfsp->next_offset) {
+    return MFS_ERR_INTERNAL;
+  }
+
+  /* Copying the header without the magic and the data, the current bank
+     is valid so the magic number must be written last.*/
+  RET_ON_ERROR(mfs_flash_copy(mfsp,
+                              mfsp->next_offset + (sizeof (uint32_t) * 2U),
+                              mfsp->descriptors[i].offset + (sizeof (uint32_t) * 2U),
+                              totsize - (sizeof (uint32_t) * 2U)));
+  mfsp->ncbuf->dhdr.fields.magic1 = (uint32_t)MFS_HEADER_MAGIC_1;
+  mfsp->ncbuf->dhdr.fields.magic2 = (uint32_t)MFS_HEADER_MAGIC_2;
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->next_offset,
+                               sizeof (uint32_t) * 2U,
+                               mfsp->ncbuf->data8));
+
+  mfsp->descriptors[i].offset = mfsp->next_offset;
+  mfsp->next_offset += totsize;
+  mfsp->ckpt_records++;
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Reclaims the previous bank.
+ * @details Live records are moved to the current bank, when there are no
+ *          more live records the bank sectors are erased.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] all       if @p false then at most @p MFS_CFG_GC_STEP_RECORDS
+ *                      records are moved or a single sector is erased,
+ *                      else the bank is reclaimed completely
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_bank_reclaim(MFSDriver *mfsp, bool all) {
+  flash_sector_t sector, n;
+  unsigned i, moved = 0U;
+
+  if (mfsp->gc_bank == mfsp->current_bank) {
+    return MFS_NO_ERROR;
+  }
+
+  /* Moving the live records.*/
+  for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
+    if ((mfsp->descriptors[i].offset != 0U) &&
+        mfs_bank_contains(mfsp, mfsp->gc_bank,
+                          mfsp->descriptors[i].offset)) {
+      if (!all && (moved >= (unsigned)MFS_CFG_GC_STEP_RECORDS)) {
+        return MFS_NO_ERROR;
+      }
+      RET_ON_ERROR(mfs_record_move(mfsp, i));
+      moved++;
+    }
+  }
+  if (!all && (moved > 0U)) {
+    return MFS_NO_ERROR;
+  }
+
+  /* No more live records, erasing the bank sectors.*/
+  mfs_bank_get_sectors(mfsp, mfsp->gc_bank, &sector, &n);
+  do {
+    RET_ON_ERROR(mfs_flash_erase(mfsp, sector + mfsp->gc_erased));
+    mfsp->gc_erased++;
+  } while (all && (mfsp->gc_erased < n));
+
+  if (mfsp->gc_erased >= n) {
+    /* Bank reclaimed.*/
+    mfsp->gc_bank   = mfsp->current_bank;
+    mfsp->gc_erased = 0U;
+  }
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Switches to the next bank in the ring.
+ * @details The new bank starts with an index checkpoint, the records in
+ *          the previous bank are moved incrementally afterward.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_bank_rotate(MFSDriver *mfsp) {
+  mfs_bank_t bank;
+
+  /* The previous bank must have been completely reclaimed.*/
+  RET_ON_ERROR(mfs_bank_reclaim(mfsp, true));
+
+  bank = mfs_bank_next(mfsp, mfsp->current_bank);
+  RET_ON_ERROR(mfs_bank_prepare(mfsp, bank));
+
+  /* The header is written first, the new bank is immediately in use.*/
+  mfsp->current_counter += 1U;
+  RET_ON_ERROR(mfs_bank_write_header(mfsp, bank, mfsp->current_counter));
+
+  /* The old bank is going to be reclaimed.*/
+  mfsp->gc_bank      = mfsp->current_bank;
+  mfsp->gc_erased    = 0U;
+  mfsp->current_bank = bank;
+  mfsp->next_offset  = mfs_flash_get_bank_offset(mfsp, bank) +
+                       ALIGNED_SIZEOF(mfs_bank_header_t);
+
+  return mfs_checkpoint_write(mfsp);
+}
+
+/**
+ * @brief   Enforces a garbage collection in multi-bank mode.
+ * @details Storage data is compacted into the next free bank of the ring.
+ *
+ * @param[out] mfsp     pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_garbage_collect_multi(MFSDriver *mfsp) {
+  unsigned i;
+  mfs_bank_t sbank, rbank, dbank;
+  flash_offset_t dest_offset;
+
+  sbank = mfsp->current_bank;
+  rbank = mfsp->gc_bank;
+  dbank = mfs_bank_next(mfsp, sbank);
+  if (dbank == rbank) {
+    dbank = mfs_bank_next(mfsp, dbank);
+  }
+  RET_ON_ERROR(mfs_bank_prepare(mfsp, dbank));
+
+  /* Write address.*/
+  dest_offset = mfs_flash_get_bank_offset(mfsp, dbank) +
+                ALIGNED_SIZEOF(mfs_bank_header_t);
+
+  /* Copying the most recent record instances only.*/
+  for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
+    uint32_t totsize = ALIGNED_REC_SIZE(mfsp->descriptors[i].size);
+    if (mfsp->descriptors[i].offset != 0) {
+      RET_ON_ERROR(mfs_flash_copy(mfsp, dest_offset,
+                                  mfsp->descriptors[i].offset,
+                                  totsize));
+      mfsp->descriptors[i].offset = dest_offset;
+      dest_offset += totsize;
+    }
+  }
+
+  /* The records are followed by an index checkpoint.*/
+  mfsp->next_offset = dest_offset;
+  RET_ON_ERROR(mfs_checkpoint_write(mfsp));
+
+  /* New current bank.*/
+  mfsp->current_bank = dbank;
+  mfsp->current_counter += 1U;
+  mfsp->gc_bank   = dbank;
+  mfsp->gc_erased = 0U;
+
+  /* The header is written after the data.*/
+  RET_ON_ERROR(mfs_bank_write_header(mfsp, dbank, mfsp->current_counter));
+
+  /* The source banks are erased last.*/
+  if (rbank != sbank) {
+    RET_ON_ERROR(mfs_bank_erase(mfsp, rbank));
+  }
+  RET_ON_ERROR(mfs_bank_erase(mfsp, sbank));
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Housekeeping after writes in multi-bank mode.
+ * @details Performs a garbage collection step and writes an index
+ *          checkpoint if enough records have been written since the last
+ *          one.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] n         number of written records
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_incremental_gc(MFSDriver *mfsp, uint32_t n) {
+  flash_offset_t free;
+
+  /* Moving a bounded number of records out of the previous bank.*/
+  RET_ON_ERROR(mfs_bank_reclaim(mfsp, false));
+
+  /* The checkpoint is skipped if it would not leave enough space for the
+     records still to be moved.*/
+  mfsp->ckpt_records += n;
+  if (mfsp->ckpt_records >= (uint32_t)MFS_CFG_CHECKPOINT_INTERVAL) {
+    free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
+            mfsp->config->bank_size) - mfsp->next_offset;
+    if (ALIGNED_CKPT_SIZE + mfs_bank_get_reclaim_space(mfsp) <= free) {
+      RET_ON_ERROR(mfs_checkpoint_write(mfsp));
+    }
+  }
+
+  return MFS_NO_ERROR;
+}
+#endif /* MFS_CFG_MULTI_BANK == TRUE */
+
 /**
  * @brief   Enforces a garbage collection.
  * @details Storage data is compacted into a single bank.
@@ -588,6 +1097,12 @@ static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
   mfs_bank_t sbank, dbank;
   flash_offset_t dest_offset;
 
+#if MFS_CFG_MULTI_BANK == TRUE
+  if (mfsp->config->banks_num > 0U) {
+    return mfs_garbage_collect_multi(mfsp);
+  }
+#endif
+
   sbank = mfsp->current_bank;
   if (sbank == MFS_BANK_0) {
     dbank = MFS_BANK_1;
@@ -626,6 +1141,224 @@ static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
   return MFS_NO_ERROR;
 }
 
+/**
+ * @brief   Makes sure there is enough space in the current bank.
+ * @details A garbage collection is performed if the required space is
+ *          available but it is not compacted. In multi-bank mode the
+ *          current bank must also be able to receive the live records
+ *          still in the previous bank, if not then the previous bank is
+ *          reclaimed completely and, if still required, the next bank in
+ *          the ring becomes the current one.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] rspace    required space
+ * @param[in] id        identifier of the record being replaced or zero
+ * @param[out] gcp      set to @p true if a garbage collection has been
+ *                      performed
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_bank_make_room(MFSDriver *mfsp,
+                                      flash_offset_t rspace,
+                                      mfs_id_t id,
+                                      bool *gcp) {
+  flash_offset_t free;
+
+  *gcp = false;
+
+  /* Immediately (not compacted) available space.*/
+  free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
+          mfsp->config->bank_size) - mfsp->next_offset;
+
+#if MFS_CFG_MULTI_BANK == TRUE
+  if (mfsp->config->banks_num > 0U) {
+    flash_offset_t mspace = mfs_bank_get_reclaim_space(mfsp);
+
+    /* The record being replaced does not need to be moved.*/
+    if ((id > 0U) && (mfsp->descriptors[id - 1U].offset != 0U) &&
+        (mfsp->gc_bank != mfsp->current_bank) &&
+        mfs_bank_contains(mfsp, mfsp->gc_bank,
+                          mfsp->descriptors[id - 1U].offset)) {
+      mspace -= ALIGNED_REC_SIZE(mfsp->descriptors[id - 1U].size);
+    }
+
+    if (rspace + mspace > free) {
+      *gcp = true;
+      RET_ON_ERROR(mfs_bank_reclaim(mfsp, true));
+
+      free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
+              mfsp->config->bank_size) - mfsp->next_offset;
+      if (rspace > free) {
+        RET_ON_ERROR(mfs_bank_rotate(mfsp));
+      }
+    }
+
+    return MFS_NO_ERROR;
+  }
+#else
+  (void)id;
+#endif
+
+  if (rspace > free) {
+    /* We need to perform a garbage collection, there is enough space
+       but it has to be freed.*/
+    *gcp = true;
+    RET_ON_ERROR(mfs_garbage_collect(mfsp));
+  }
+
+  return MFS_NO_ERROR;
+}
+
+#if (MFS_CFG_MULTI_BANK == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Performs a flash partition mount attempt in multi-bank mode.
+ * @details The most recent bank is the current bank, the bank preceding
+ *          it, if still valid, is being reclaimed. Records are replayed
+ *          from the last index checkpoint in the current bank, both banks
+ *          are scanned only if a valid checkpoint is not found.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_try_mount_multi(MFSDriver *mfsp) {
+  mfs_bank_t bank, head = MFS_BANK_0, source;
+  uint32_t head_cnt = 0U;
+  flash_offset_t ckpt_offset;
+  bool found = false, w1 = false, w2 = false;
+  unsigned i;
+
+  /* Resetting the bank state.*/
+  mfs_state_reset(mfsp);
+
+  /* Finding the most recent bank, unreadable banks are erased. Erased
+     banks are verified only before use.*/
+  for (bank = MFS_BANK_0; bank < mfsp->config->banks_num; bank++) {
+    RET_ON_ERROR(mfs_flash_read(mfsp, mfs_flash_get_bank_offset(mfsp, bank),
+                                sizeof (mfs_bank_header_t),
+                                mfsp->ncbuf->data8));
+    switch (mfs_bank_check_header(mfsp)) {
+    case MFS_BANK_OK:
+      if (!found || (mfsp->ncbuf->bhdr.fields.counter > head_cnt)) {
+        head     = bank;
+        head_cnt = mfsp->ncbuf->bhdr.fields.counter;
+        found    = true;
+      }
+      break;
+    case MFS_BANK_GARBAGE:
+      RET_ON_ERROR(mfs_bank_erase(mfsp, bank));
+      w1 = true;
+      break;
+    default:
+      break;
+    }
+  }
+
+  if (!found) {
+    /* All banks erased, first initialization.*/
+    RET_ON_ERROR(mfs_bank_prepare(mfsp, MFS_BANK_0));
+    RET_ON_ERROR(mfs_bank_write_header(mfsp, MFS_BANK_0, 1));
+    head     = MFS_BANK_0;
+    head_cnt = 1U;
+  }
+
+  /* The bank preceding the most recent one is being reclaimed, any other
+     valid bank is obsolete.*/
+  source = head;
+  for (bank = MFS_BANK_0; bank < mfsp->config->banks_num; bank++) {
+    if (bank != head) {
+      RET_ON_ERROR(mfs_flash_read(mfsp, mfs_flash_get_bank_offset(mfsp, bank),
+                                  sizeof (mfs_bank_header_t),
+                                  mfsp->ncbuf->data8));
+      if (mfs_bank_check_header(mfsp) == MFS_BANK_OK) {
+        if (mfsp->ncbuf->bhdr.fields.counter == head_cnt - 1U) {
+          source = bank;
+        }
+        else {
+          RET_ON_ERROR(mfs_bank_erase(mfsp, bank));
+          w1 = true;
+        }
+      }
+    }
+  }
+
+  /* Reading the bank header again.*/
+  RET_ON_ERROR(mfs_flash_read(mfsp, mfs_flash_get_bank_offset(mfsp, head),
+                              sizeof (mfs_bank_header_t),
+                              mfsp->ncbuf->data8));
+
+  /* Checked again for extra safety.*/
+  if (mfs_bank_check_header(mfsp) != MFS_BANK_OK) {
+    return MFS_ERR_INTERNAL;
+  }
+
+  /* Storing the bank data.*/
+  mfsp->current_bank    = head;
+  mfsp->current_counter = mfsp->ncbuf->bhdr.fields.counter;
+  mfsp->gc_bank         = source;
+
+  /* Replaying records written after the last checkpoint.*/
+  RET_ON_ERROR(mfs_checkpoint_find(mfsp, head, &ckpt_offset));
+  if (ckpt_offset != 0U) {
+    RET_ON_ERROR(mfs_bank_scan_records(mfsp, head, ckpt_offset, &w2));
+  }
+
+  /* Without a checkpoint, or on anomalies, both banks are scanned.*/
+  if ((ckpt_offset == 0U) || w2) {
+    bool w3 = false;
+
+    mfs_state_reset(mfsp);
+    mfsp->current_bank    = head;
+    mfsp->current_counter = head_cnt;
+    mfsp->gc_bank         = source;
+    if (source != head) {
+      RET_ON_ERROR(mfs_bank_scan_records(mfsp, source,
+                                         mfs_flash_get_bank_offset(mfsp, source) +
+                                         ALIGNED_SIZEOF(mfs_bank_header_t),
+                                         &w3));
+    }
+    RET_ON_ERROR(mfs_bank_scan_records(mfsp, head,
+                                       mfs_flash_get_bank_offset(mfsp, head) +
+                                       ALIGNED_SIZEOF(mfs_bank_header_t),
+                                       &w2));
+    w2 = w2 || w3;
+  }
+
+  /* Calculating the effective used size, records must be in one of the
+     two banks, anything else is dropped.*/
+  mfsp->used_space = ALIGNED_SIZEOF(mfs_bank_header_t) + ALIGNED_CKPT_SIZE;
+  for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
+    flash_offset_t offset = mfsp->descriptors[i].offset;
+
+    if (offset != 0U) {
+      uint32_t totsize = ALIGNED_REC_SIZE(mfsp->descriptors[i].size);
+
+      if ((!mfs_bank_contains(mfsp, head, offset) ||
+           !mfs_bank_contains(mfsp, head, offset + totsize - 1U)) &&
+          (!mfs_bank_contains(mfsp, source, offset) ||
+           !mfs_bank_contains(mfsp, source, offset + totsize - 1U))) {
+        mfsp->descriptors[i].offset = 0U;
+        mfsp->descriptors[i].size   = 0U;
+        w2 = true;
+      }
+      else {
+        mfsp->used_space += totsize;
+      }
+    }
+  }
+
+  /* In case of detected problems then a garbage collection is performed in
+     order to repair/remove anomalies.*/
+  if (w2) {
+    RET_ON_ERROR(mfs_garbage_collect(mfsp));
+  }
+
+  return (w1 || w2) ? MFS_WARN_REPAIR : MFS_NO_ERROR;
+}
+#endif /* MFS_CFG_MULTI_BANK == TRUE */
+
 /**
  * @brief   Performs a flash partition mount attempt.
  *
@@ -640,6 +1373,12 @@ static mfs_error_t mfs_try_mount(MFSDriver *mfsp) {
   uint32_t cnt0 = 0, cnt1 = 0;
   bool w1 = false, w2 = false;
 
+#if MFS_CFG_MULTI_BANK == TRUE
+  if (mfsp->config->banks_num > 0U) {
+    return mfs_try_mount_multi(mfsp);
+  }
+#endif
+
   /* Resetting the bank state.*/
   mfs_state_reset(mfsp);
 
@@ -745,7 +1484,10 @@ static mfs_error_t mfs_try_mount(MFSDriver *mfsp) {
     mfsp->current_counter = mfsp->ncbuf->bhdr.fields.counter;
 
     /* Scanning for the most recent instance of all records.*/
-    RET_ON_ERROR(mfs_bank_scan_records(mfsp, bank, &w2));
+    RET_ON_ERROR(mfs_bank_scan_records(mfsp, bank,
+                                       mfs_flash_get_bank_offset(mfsp, bank) +
+                                       ALIGNED_SIZEOF(mfs_bank_header_t),
+                                       &w2));
 
     /* Calculating the effective used size.*/
     mfsp->used_space = ALIGNED_SIZEOF(mfs_bank_header_t);
@@ -852,6 +1594,10 @@ mfs_error_t mfsStart(MFSDriver *mfsp, const MFSConfig *config) {
   osalDbgCheck((mfsp != NULL) && (config != NULL));
   osalDbgAssert((mfsp->state == MFS_STOP) || (mfsp->state == MFS_READY) ||
                 (mfsp->state == MFS_ERROR), "invalid state");
+#if MFS_CFG_MULTI_BANK == TRUE
+  osalDbgAssert((config->banks_num == 0U) || (config->banks_num >= 3U),
+                "invalid number of banks");
+#endif
 
   /* Storing configuration.*/
   mfsp->config = config;
@@ -900,6 +1646,18 @@ mfs_error_t mfsErase(MFSDriver *mfsp) {
     return MFS_ERR_INV_STATE;
   }
 
+#if MFS_CFG_MULTI_BANK == TRUE
+  if (mfsp->config->banks_num > 0U) {
+    mfs_bank_t bank;
+
+    for (bank = MFS_BANK_0; bank < mfsp->config->banks_num; bank++) {
+      RET_ON_ERROR(mfs_bank_erase(mfsp, bank));
+    }
+
+    return mfs_mount(mfsp);
+  }
+#endif
+
   RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_0));
   RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_1));
 
@@ -1005,7 +1763,7 @@ mfs_error_t mfsReadRecord(MFSDriver *mfsp, mfs_id_t id,
  */
 mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
                            size_t n, const uint8_t *buffer) {
-  flash_offset_t free, asize, rspace;
+  flash_offset_t asize, rspace;
 
   osalDbgCheck((mfsp != NULL) &&
                (id >= 1U) && (id <= (mfs_id_t)MFS_CFG_MAX_RECORDS) &&
@@ -1028,14 +1786,7 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
     }
 
     /* Checking for immediately (not compacted) available space.*/
-    free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
-            mfsp->config->bank_size) - mfsp->next_offset;
-    if (rspace > free) {
-      /* We need to perform a garbage collection, there is enough space
-         but it has to be freed.*/
-      warning = true;
-      RET_ON_ERROR(mfs_garbage_collect(mfsp));
-    }
+    RET_ON_ERROR(mfs_bank_make_room(mfsp, rspace, id, &warning));
 
     /* Writing the data header without the magic, it will be written last.*/
     mfsp->ncbuf->dhdr.fields.id     = (uint16_t)id;
@@ -1072,6 +1823,12 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
     mfsp->next_offset += asize;
     mfsp->used_space  += asize;
 
+#if MFS_CFG_MULTI_BANK == TRUE
+    if (mfsp->config->banks_num > 0U) {
+      RET_ON_ERROR(mfs_incremental_gc(mfsp, 1U));
+    }
+#endif
+
     return warning ? MFS_WARN_GC : MFS_NO_ERROR;
   }
 
@@ -1153,7 +1910,7 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
  * @api
  */
 mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
-  flash_offset_t free, asize, rspace;
+  flash_offset_t asize, rspace;
 
   osalDbgCheck((mfsp != NULL) &&
                (id >= 1U) && (id <= (mfs_id_t)MFS_CFG_MAX_RECORDS));
@@ -1178,14 +1935,7 @@ mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
     }
 
     /* Checking for immediately (not compacted) available space.*/
-    free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
-            mfsp->config->bank_size) - mfsp->next_offset;
-    if (rspace > free) {
-      /* We need to perform a garbage collection, there is enough space
-         but it has to be freed.*/
-      warning = true;
-      RET_ON_ERROR(mfs_garbage_collect(mfsp));
-    }
+    RET_ON_ERROR(mfs_bank_make_room(mfsp, rspace, 0U, &warning));
 
     /* Writing the data header with size set to zero, it means that the
        record is logically erased.*/
@@ -1205,6 +1955,12 @@ mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
     mfsp->descriptors[id - 1U].offset = 0U;
     mfsp->descriptors[id - 1U].size   = 0U;
 
+#if MFS_CFG_MULTI_BANK == TRUE
+    if (mfsp->config->banks_num > 0U) {
+      RET_ON_ERROR(mfs_incremental_gc(mfsp, 1U));
+    }
+#endif
+
     return warning ? MFS_WARN_GC : MFS_NO_ERROR;
   }
 
@@ -1318,7 +2074,8 @@ mfs_error_t mfsPerformGarbageCollection(MFSDriver *mfsp) {
  * @api
  */
 mfs_error_t mfsStartTransaction(MFSDriver *mfsp, size_t size) {
-  flash_offset_t free, tspace, rspace;
+  flash_offset_t tspace, rspace;
+  bool warning;
 
   osalDbgCheck((mfsp != NULL) && (size > ALIGNED_DHDR_SIZE));
 
@@ -1338,13 +2095,7 @@ mfs_error_t mfsStartTransaction(MFSDriver *mfsp, size_t size) {
   }
 
   /* Checking for immediately (not compacted) available space.*/
-  free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
-          mfsp->config->bank_size) - mfsp->next_offset;
-  if (rspace > free) {
-    /* We need to perform a garbage collection, there is enough space
-       but it has to be freed.*/
-    RET_ON_ERROR(mfs_garbage_collect(mfsp));
-  }
+  RET_ON_ERROR(mfs_bank_make_room(mfsp, rspace, 0U, &warning));
 
   /* Entering transaction mode.*/
   mfsp->state = MFS_TRANSACTION;
@@ -1433,6 +2184,12 @@ mfs_error_t mfsCommitTransaction(MFSDriver *mfsp) {
   /* Returning to ready mode.*/
   mfsp->state = MFS_READY;
 
+#if MFS_CFG_MULTI_BANK == TRUE
+  if (mfsp->config->banks_num > 0U) {
+    RET_ON_ERROR(mfs_incremental_gc(mfsp, (uint32_t)mfsp->tr_nops));
+  }
+#endif
+
   return MFS_NO_ERROR;
 }
 
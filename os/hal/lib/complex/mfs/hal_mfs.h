@@ -39,6 +39,14 @@
 #define MFS_HEADER_MAGIC_1                  0x5FAE45F0U
 #define MFS_HEADER_MAGIC_2                  0xF045AE5FU
 
+/**
+ * @name    Bank identifiers
+ * @{
+ */
+#define MFS_BANK_0                          0U
+#define MFS_BANK_1                          1U
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -107,6 +115,41 @@
 #if !defined(MFS_CFG_TRANSACTION_MAX) || defined(__DOXYGEN__)
 #define MFS_CFG_TRANSACTION_MAX             16
 #endif
+
+/**
+ * @brief   Enables the multi-bank mode.
+ * @details In multi-bank mode the managed partition is a ring of three or
+ *          more banks used in rotation, the records index is checkpointed
+ *          periodically in order to speed up mount and the garbage
+ *          collection is performed incrementally while writing.
+ * @note    Multi-bank mode is selected at runtime by setting the
+ *          @p banks_num configuration field, the two-bank mode is still
+ *          available.
+ */
+#if !defined(MFS_CFG_MULTI_BANK) || defined(__DOXYGEN__)
+#define MFS_CFG_MULTI_BANK                  FALSE
+#endif
+
+/**
+ * @brief   Records written between index checkpoints.
+ * @details On mount only records written after the last checkpoint need
+ *          to be scanned and verified.
+ * @note    Only used in multi-bank mode.
+ */
+#if !defined(MFS_CFG_CHECKPOINT_INTERVAL) || defined(__DOXYGEN__)
+#define MFS_CFG_CHECKPOINT_INTERVAL         16
+#endif
+
+/**
+ * @brief   Maximum number of records moved by each garbage collection step.
+ * @details A garbage collection step is performed after each write or erase
+ *          operation, once a bank has no more live records its sectors are
+ *          erased one per step.
+ * @note    Only used in multi-bank mode.
+ */
+#if !defined(MFS_CFG_GC_STEP_RECORDS) || defined(__DOXYGEN__)
+#define MFS_CFG_GC_STEP_RECORDS             2
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -144,17 +187,27 @@
 #error "invalid MFS_CFG_TRANSACTION_MAX value"
 #endif
 
+#if (MFS_CFG_MULTI_BANK != FALSE) && (MFS_CFG_MULTI_BANK != TRUE)
+#error "invalid MFS_CFG_MULTI_BANK value"
+#endif
+
+#if MFS_CFG_CHECKPOINT_INTERVAL < 1
+#error "invalid MFS_CFG_CHECKPOINT_INTERVAL value"
+#endif
+
+#if MFS_CFG_GC_STEP_RECORDS < 1
+#error "invalid MFS_CFG_GC_STEP_RECORDS value"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
 
 /**
  * @brief   Type of a flash bank.
+ * @note    Banks above @p MFS_BANK_1 only exist in multi-bank mode.
  */
-typedef enum {
-  MFS_BANK_0 = 0,
-  MFS_BANK_1 = 1
-} mfs_bank_t;
+typedef uint32_t mfs_bank_t;
 
 /**
  * @brief   Type of driver state machine states.
@@ -313,6 +366,17 @@ typedef struct {
    *          @p bank_size.
    */
   flash_sector_t            bank1_sectors;
+#if (MFS_CFG_MULTI_BANK == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Number of banks in multi-bank mode.
+   * @details If zero then the two banks described by the @p bank0 and
+   *          @p bank1 fields are used. If not zero then it must be at least
+   *          three, banks are contiguous starting from @p bank0_start and
+   *          are composed of @p bank0_sectors sectors each, the @p bank1
+   *          fields are ignored.
+   */
+  uint32_t                  banks_num;
+#endif
 } MFSConfig;
 
 /**
@@ -377,6 +441,21 @@ typedef struct {
    * @note    Zero means that there is not a record with that id.
    */
   mfs_record_descriptor_t   descriptors[MFS_CFG_MAX_RECORDS];
+#if (MFS_CFG_MULTI_BANK == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Bank being reclaimed by the garbage collector.
+   * @note    Equal to @p current_bank if there is no bank to be reclaimed.
+   */
+  mfs_bank_t                gc_bank;
+  /**
+   * @brief   Number of sectors of @p gc_bank already erased.
+   */
+  flash_sector_t            gc_erased;
+  /**
+   * @brief   Records written since the last index checkpoint.
+   */
+  uint32_t                  ckpt_records;
+#endif
 #if (MFS_CFG_TRANSACTION_MAX > 0) || defined(__DOXYGEN__)
   /**
    * @brief   Next write offset for current transaction.
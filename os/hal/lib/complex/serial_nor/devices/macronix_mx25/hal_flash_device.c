@@ -655,6 +655,81 @@ flash_error_t snor_device_query_erase(SNORDriver *devp, uint32_t *msec) {
   return FLASH_NO_ERROR;
 }
 
+/**
+ * @brief   Suspends an erase in progress.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ * @return              An error code.
+ * @retval FLASH_NO_ERROR       if the erase is already over.
+ * @retval FLASH_BUSY_ERASING   if the erase has been suspended.
+ * @retval FLASH_ERROR_ERASE    if the erase is over and failed.
+ */
+flash_error_t snor_device_suspend_erase(SNORDriver *devp) {
+
+  /* Suspend command, it is ignored if the erase is already over.*/
+#if MX25_BUS_MODE == MX25_BUS_MODE_SPI
+  bus_cmd(devp->config->busp, MX25_CMD_SPI_PE_SUSPEND);
+#else
+  bus_cmd(devp->config->busp, MX25_CMD_OPI_PE_SUSPEND);
+#endif
+
+  /* Waiting for WIP to go low, the suspend latency is in the order of
+     microseconds so no delays are inserted.*/
+  do {
+#if MX25_BUS_MODE == MX25_BUS_MODE_SPI
+    bus_cmd_receive(devp->config->busp, MX25_CMD_SPI_RDSR, 1U,
+                    &devp->nocache->buf[0]);
+#else
+    bus_cmd_addr_dummy_receive(devp->config->busp, MX25_CMD_OPI_RDSR,
+                               0U, 4U, 2U,
+                               &devp->nocache->buf[0]); /* Note: always 4 dummies.*/
+#endif
+  } while ((devp->nocache->buf[0] & 1U) != 0U);
+
+  /* Read security register.*/
+#if MX25_BUS_MODE == MX25_BUS_MODE_SPI
+  bus_cmd_receive(devp->config->busp, MX25_CMD_SPI_RDSCUR, 1U,
+                  &devp->nocache->buf[16]);
+#else
+  bus_cmd_addr_dummy_receive(devp->config->busp, MX25_CMD_OPI_RDSCUR,
+                             0U, 4U, 2U,
+                             &devp->nocache->buf[16]); /* Note: always 4 dummies.*/
+#endif
+
+  /* Erase suspended, it needs to be resumed.*/
+  if ((devp->nocache->buf[16] & MX25_FLAGS_ESB) != 0U) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* The erase completed, checking for errors.*/
+  if ((devp->nocache->buf[16] & MX25_FLAGS_ALL_ERRORS) != 0U) {
+    return FLASH_ERROR_ERASE;
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Resumes a suspended erase.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ * @return              An error code.
+ */
+flash_error_t snor_device_resume_erase(SNORDriver *devp) {
+
+  /* Resume command.*/
+#if MX25_BUS_MODE == MX25_BUS_MODE_SPI
+  bus_cmd(devp->config->busp, MX25_CMD_SPI_PE_RESUME);
+#else
+  bus_cmd(devp->config->busp, MX25_CMD_OPI_PE_RESUME);
+#endif
+
+  /* The erase must run for a while before it can be suspended again.*/
+  osalThreadSleepMicroseconds(MX25_ERASE_RESUME_TIME);
+
+  return FLASH_NO_ERROR;
+}
+
 flash_error_t snor_device_read_sfdp(SNORDriver *devp, flash_offset_t offset,
                                     size_t n, uint8_t *rp) {
 
@@ -34,6 +34,7 @@
  * @{
  */
 #define SNOR_DEVICE_SUPPORTS_XIP            FALSE
+#define SNOR_DEVICE_SUPPORTS_ERASE_SUSPEND  TRUE
 /** @} */
 
 /**
@@ -315,6 +316,16 @@
 #define MX25_USE_SUB_SECTORS                FALSE
 #endif
 
+/**
+ * @brief   Time in microseconds between an erase resume and the next suspend.
+ * @details The device requires the erase to run for this time after a
+ *          resume before it can be suspended again, this also guarantees
+ *          that the erase progresses under frequent reads.
+ */
+#if !defined(MX25_ERASE_RESUME_TIME) || defined(__DOXYGEN__)
+#define MX25_ERASE_RESUME_TIME              400
+#endif
+
 /**
  * @brief   Number of dummy cycles for fast read (1..15).
  * @details This is the number of dummy cycles to be used for fast read
@@ -409,6 +420,8 @@ extern "C" {
   flash_error_t snor_device_verify_erase(SNORDriver *devp,
                                          flash_sector_t sector);
   flash_error_t snor_device_query_erase(SNORDriver *devp, uint32_t *msec);
+  flash_error_t snor_device_suspend_erase(SNORDriver *devp);
+  flash_error_t snor_device_resume_erase(SNORDriver *devp);
   flash_error_t snor_device_read_sfdp(SNORDriver *devp, flash_offset_t offset,
                                       size_t n, uint8_t *rp);
 #if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) &&                            \
@@ -518,6 +518,41 @@ flash_error_t snor_device_query_erase(SNORDriver *devp, uint32_t *msec) {
   return FLASH_NO_ERROR;
 }
 
+flash_error_t snor_device_suspend_erase(SNORDriver *devp) {
+  uint8_t sts;
+
+  /* Suspend command, it is ignored if the erase is already over.*/
+  bus_cmd(devp->config->busp, N25Q_CMD_PROGRAM_ERASE_SUSPEND);
+
+  /* Waiting for the P/E controller, the suspend latency is in the order
+     of microseconds so no delays are inserted.*/
+  do {
+    bus_cmd_receive(devp->config->busp, N25Q_CMD_READ_FLAG_STATUS_REGISTER,
+                    1, &sts);
+  } while ((sts & N25Q_FLAGS_PROGRAM_ERASE) == 0U);
+
+  /* Erase suspended, it needs to be resumed.*/
+  if ((sts & N25Q_FLAGS_ERASE_SUSPEND) != 0U) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* The erase completed, errors are not cleared here so that they are
+     still reported by snor_device_query_erase().*/
+  if ((sts & N25Q_FLAGS_ALL_ERRORS) != 0U) {
+    return FLASH_ERROR_ERASE;
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+flash_error_t snor_device_resume_erase(SNORDriver *devp) {
+
+  /* Resume command.*/
+  bus_cmd(devp->config->busp, N25Q_CMD_PROGRAM_ERASE_RESUME);
+
+  return FLASH_NO_ERROR;
+}
+
 flash_error_t snor_device_read_sfdp(SNORDriver *devp, flash_offset_t offset,
                                     size_t n, uint8_t *rp) {
 
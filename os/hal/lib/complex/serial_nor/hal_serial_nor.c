@@ -29,6 +29,17 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @brief   Erase suspend enabled and supported by the device.
+ */
+#if ((SNOR_USE_ERASE_SUSPEND == TRUE) &&                                    \
+     defined(SNOR_DEVICE_SUPPORTS_ERASE_SUSPEND) &&                         \
+     (SNOR_DEVICE_SUPPORTS_ERASE_SUSPEND == TRUE)) || defined(__DOXYGEN__)
+#define SNOR_ERASE_SUSPEND                  TRUE
+#else
+#define SNOR_ERASE_SUSPEND                  FALSE
+#endif
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -68,6 +79,73 @@ static const struct SNORDriverVMT snor_vmt = {
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (SNOR_ERASE_SUSPEND == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Read or program operation during an erase.
+ * @details The erase operation is suspended for the duration of the access
+ *          then resumed, the driver stays in @p FLASH_ERASE state. Areas
+ *          overlapping the area being erased cannot be accessed.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes to be accessed
+ * @param[out] rp       pointer to the read buffer or @p NULL
+ * @param[in] pp        pointer to the program buffer, used if @p rp is
+ *                      @p NULL
+ * @return              An error code.
+ * @retval FLASH_BUSY_ERASING   if the area cannot be accessed.
+ */
+static flash_error_t snor_suspended_access(SNORDriver *devp,
+                                           flash_offset_t offset, size_t n,
+                                           uint8_t *rp, const uint8_t *pp) {
+  flash_error_t err, serr;
+
+  /* The area being erased cannot be accessed.*/
+  if (((size_t)offset < (size_t)devp->erase_offset +
+                        (size_t)devp->erase_size) &&
+      ((size_t)offset + n > (size_t)devp->erase_offset)) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* Bus acquired.*/
+  bus_acquire(devp->config->busp, devp->config->buscfg);
+
+  /* Suspending the erase, it could also have just completed.*/
+  serr = snor_device_suspend_erase(devp);
+  if ((serr == FLASH_BUSY_ERASING) || (serr == FLASH_NO_ERROR)) {
+
+    /* Actual read or program implementation.*/
+    if (rp != NULL) {
+      err = snor_device_read(devp, offset, n, rp);
+    }
+    else {
+      err = snor_device_program(devp, offset, n, pp);
+    }
+
+    if (serr == FLASH_BUSY_ERASING) {
+      /* Resuming the suspended erase.*/
+      serr = snor_device_resume_erase(devp);
+      if (err == FLASH_NO_ERROR) {
+        err = serr;
+      }
+    }
+    else {
+      /* The erase is over, nothing to resume.*/
+      devp->state = FLASH_READY;
+    }
+  }
+  else {
+    /* The erase failed, the error is reported by flashQueryErase().*/
+    err = FLASH_BUSY_ERASING;
+  }
+
+  /* Bus released.*/
+  bus_release(devp->config->busp);
+
+  return err;
+}
+#endif /* SNOR_ERASE_SUSPEND == TRUE */
+
 /**
  * @brief   Returns a pointer to the device descriptor.
  *
@@ -96,7 +174,11 @@ static flash_error_t snor_read(void *instance, flash_offset_t offset,
                 "invalid state");
 
   if (devp->state == FLASH_ERASE) {
+#if SNOR_ERASE_SUSPEND == TRUE
+    return snor_suspended_access(devp, offset, n, rp, NULL);
+#else
     return FLASH_BUSY_ERASING;
+#endif
   }
 
   /* Bus acquired.*/
@@ -129,7 +211,11 @@ static flash_error_t snor_program(void *instance, flash_offset_t offset,
                 "invalid state");
 
   if (devp->state == FLASH_ERASE) {
+#if (SNOR_ERASE_SUSPEND == TRUE) && (SNOR_SUSPEND_ERASE_ON_PROGRAM == TRUE)
+    return snor_suspended_access(devp, offset, n, NULL, pp);
+#else
     return FLASH_BUSY_ERASING;
+#endif
   }
 
   /* Bus acquired.*/
@@ -167,6 +253,11 @@ static flash_error_t snor_start_erase_all(void *instance) {
 
   /* FLASH_ERASE state while the operation is performed.*/
   devp->state = FLASH_ERASE;
+#if SNOR_USE_ERASE_SUSPEND == TRUE
+  devp->erase_offset = 0U;
+  devp->erase_size   = snor_descriptor.sectors_count *
+                       snor_descriptor.sectors_size;
+#endif
 
   /* Actual erase implementation.*/
   err = snor_device_start_erase_all(devp);
@@ -196,6 +287,10 @@ static flash_error_t snor_start_erase_sector(void *instance,
 
   /* FLASH_ERASE state while the operation is performed.*/
   devp->state = FLASH_ERASE;
+#if SNOR_USE_ERASE_SUSPEND == TRUE
+  devp->erase_offset = (flash_offset_t)sector * snor_descriptor.sectors_size;
+  devp->erase_size   = snor_descriptor.sectors_size;
+#endif
 
   /* Actual erase implementation.*/
   err = snor_device_start_erase_sector(devp, sector);
@@ -707,6 +802,10 @@ void snorObjectInit(SNORDriver *devp, snor_nocache_buffer_t *nocache) {
 #if SNOR_USE_MUTUAL_EXCLUSION == TRUE
   osalMutexObjectInit(&devp->mutex);
 #endif
+#if SNOR_USE_ERASE_SUSPEND == TRUE
+  devp->erase_offset = 0U;
+  devp->erase_size   = 0U;
+#endif
 }
 
 /**
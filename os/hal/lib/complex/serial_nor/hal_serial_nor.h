@@ -87,6 +87,27 @@
 #if !defined(SNOR_SPI_4BYTES_ADDRESS) || defined(__DOXYGEN__)
 #define SNOR_SPI_4BYTES_ADDRESS             FALSE
 #endif
+
+/**
+ * @brief   Erase suspend switch.
+ * @details If set to @p TRUE then reads falling outside the sector being
+ *          erased suspend the erase operation instead of failing with
+ *          @p FLASH_BUSY_ERASING, the erase is resumed after the read.
+ * @note    Only effective if the device supports erase suspend.
+ */
+#if !defined(SNOR_USE_ERASE_SUSPEND) || defined(__DOXYGEN__)
+#define SNOR_USE_ERASE_SUSPEND              TRUE
+#endif
+
+/**
+ * @brief   Program operations suspend erase switch.
+ * @details If set to @p TRUE then also program operations falling outside
+ *          the sector being erased suspend the erase operation.
+ * @note    Requires @p SNOR_USE_ERASE_SUSPEND.
+ */
+#if !defined(SNOR_SUSPEND_ERASE_ON_PROGRAM) || defined(__DOXYGEN__)
+#define SNOR_SUSPEND_ERASE_ON_PROGRAM       FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -103,6 +124,10 @@
 #error "invalid SNOR_BUS_DRIVER setting"
 #endif
 
+#if (SNOR_SUSPEND_ERASE_ON_PROGRAM == TRUE) && (SNOR_USE_ERASE_SUSPEND == FALSE)
+#error "SNOR_SUSPEND_ERASE_ON_PROGRAM requires SNOR_USE_ERASE_SUSPEND"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -179,6 +204,16 @@ typedef struct {
    */
   mutex_t                       mutex;
 #endif /* EFL_USE_MUTUAL_EXCLUSION == TRUE */
+#if (SNOR_USE_ERASE_SUSPEND == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Offset of the area being erased.
+   */
+  flash_offset_t                erase_offset;
+  /**
+   * @brief   Size of the area being erased.
+   */
+  uint32_t                      erase_size;
+#endif /* SNOR_USE_ERASE_SUSPEND == TRUE */
 } SNORDriver;
 
 /*===========================================================================*/
@@ -125,6 +125,8 @@ struct hal_xsnor_macronix_mx25_vmt {
   flash_error_t (*verify_erase)(void *ip, flash_sector_t sector);
   flash_error_t (*mmap_on)(void *ip, uint8_t **addrp);
   void (*mmap_off)(void *ip);
+  flash_error_t (*suspend_erase)(void *ip);
+  flash_error_t (*resume_erase)(void *ip);
   /* From hal_xsnor_macronix_mx25_c.*/
 };
 
@@ -190,6 +192,8 @@ extern "C" {
   flash_error_t __mx25_verify_erase_impl(void *ip, flash_sector_t sector);
   flash_error_t __mx25_mmap_on_impl(void *ip, uint8_t **addrp);
   void __mx25_mmap_off_impl(void *ip);
+  flash_error_t __mx25_suspend_erase_impl(void *ip);
+  flash_error_t __mx25_resume_erase_impl(void *ip);
   /* Regular functions.*/
 #ifdef __cplusplus
 }
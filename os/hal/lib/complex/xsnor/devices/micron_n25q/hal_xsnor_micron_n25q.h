@@ -120,6 +120,8 @@ struct hal_xsnor_micron_n25q_vmt {
   flash_error_t (*verify_erase)(void *ip, flash_sector_t sector);
   flash_error_t (*mmap_on)(void *ip, uint8_t **addrp);
   void (*mmap_off)(void *ip);
+  flash_error_t (*suspend_erase)(void *ip);
+  flash_error_t (*resume_erase)(void *ip);
   /* From hal_xsnor_micron_n25q_c.*/
 };
 
@@ -185,6 +187,8 @@ extern "C" {
   flash_error_t __n25q_verify_erase_impl(void *ip, flash_sector_t sector);
   flash_error_t __n25q_mmap_on_impl(void *ip, uint8_t **addrp);
   void __n25q_mmap_off_impl(void *ip);
+  flash_error_t __n25q_suspend_erase_impl(void *ip);
+  flash_error_t __n25q_resume_erase_impl(void *ip);
   /* Regular functions.*/
 #ifdef __cplusplus
 }
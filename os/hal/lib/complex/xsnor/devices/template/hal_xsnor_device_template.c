@@ -288,6 +288,42 @@ void __tmpl_mmap_off_impl(void *ip) {
   /* Implementation.*/
   (void)self;
 }
+
+/**
+ * @memberof    hal_device_template_c
+ * @protected
+ *
+ * @brief       Override of method @p xsnor_device_suspend_erase().
+ *
+ * @param[in,out] ip            Pointer to a @p hal_device_template_c instance.
+ * @return                      An error code.
+ */
+flash_error_t __tmpl_suspend_erase_impl(void *ip) {
+  hal_device_template_c *self = (hal_device_template_c *)ip;
+
+  /* Implementation.*/
+  (void)self;
+
+  return FLASH_ERROR_UNIMPLEMENTED;
+}
+
+/**
+ * @memberof    hal_device_template_c
+ * @protected
+ *
+ * @brief       Override of method @p xsnor_device_resume_erase().
+ *
+ * @param[in,out] ip            Pointer to a @p hal_device_template_c instance.
+ * @return                      An error code.
+ */
+flash_error_t __tmpl_resume_erase_impl(void *ip) {
+  hal_device_template_c *self = (hal_device_template_c *)ip;
+
+  /* Implementation.*/
+  (void)self;
+
+  return FLASH_ERROR_UNIMPLEMENTED;
+}
 /** @} */
 
 /**
@@ -304,7 +340,9 @@ const struct hal_device_template_vmt __hal_device_template_vmt = {
   .query_erase              = __tmpl_query_erase_impl,
   .verify_erase             = __tmpl_verify_erase_impl,
   .mmap_on                  = __tmpl_mmap_on_impl,
-  .mmap_off                 = __tmpl_mmap_off_impl
+  .mmap_off                 = __tmpl_mmap_off_impl,
+  .suspend_erase            = __tmpl_suspend_erase_impl,
+  .resume_erase             = __tmpl_resume_erase_impl
 };
 
 /** @} */
@@ -83,6 +83,8 @@ struct hal_device_template_vmt {
   flash_error_t (*verify_erase)(void *ip, flash_sector_t sector);
   flash_error_t (*mmap_on)(void *ip, uint8_t **addrp);
   void (*mmap_off)(void *ip);
+  flash_error_t (*suspend_erase)(void *ip);
+  flash_error_t (*resume_erase)(void *ip);
   /* From hal_device_template_c.*/
 };
 
@@ -148,6 +150,8 @@ extern "C" {
   flash_error_t __tmpl_verify_erase_impl(void *ip, flash_sector_t sector);
   flash_error_t __tmpl_mmap_on_impl(void *ip, uint8_t **addrp);
   void __tmpl_mmap_off_impl(void *ip);
+  flash_error_t __tmpl_suspend_erase_impl(void *ip);
+  flash_error_t __tmpl_resume_erase_impl(void *ip);
   /* Regular functions.*/
 #ifdef __cplusplus
 }
@@ -88,6 +88,27 @@
 #if !defined(XSNOR_SHARED_BUS) || defined(__DOXYGEN__)
 #define XSNOR_SHARED_BUS                    TRUE
 #endif
+
+/**
+ * @brief       Erase suspend enable switch.
+ * @details     If enabled then reads falling outside the sector being erased
+ *              suspend the erase instead of failing with
+ *              @p FLASH_BUSY_ERASING, the erase is resumed after the read.
+ * @note        Only effective on devices with the
+ *              @p FLASH_ATTR_SUSPEND_ERASE_CAPABLE attribute.
+ */
+#if !defined(XSNOR_USE_ERASE_SUSPEND) || defined(__DOXYGEN__)
+#define XSNOR_USE_ERASE_SUSPEND             TRUE
+#endif
+
+/**
+ * @brief       Program operations suspend erase switch.
+ * @details     If enabled then also program operations falling outside the
+ *              sector being erased suspend the erase.
+ */
+#if !defined(XSNOR_SUSPEND_ERASE_ON_PROGRAM) || defined(__DOXYGEN__)
+#define XSNOR_SUSPEND_ERASE_ON_PROGRAM      FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -118,6 +139,16 @@
 #error "XSNOR_SHARED_BUS invalid value"
 #endif
 
+/* Checks on XSNOR_USE_ERASE_SUSPEND configuration.*/
+#if (XSNOR_USE_ERASE_SUSPEND != FALSE) && (XSNOR_USE_ERASE_SUSPEND != TRUE)
+#error "XSNOR_USE_ERASE_SUSPEND invalid value"
+#endif
+
+/* Checks on XSNOR_SUSPEND_ERASE_ON_PROGRAM configuration.*/
+#if (XSNOR_SUSPEND_ERASE_ON_PROGRAM != FALSE) && (XSNOR_SUSPEND_ERASE_ON_PROGRAM != TRUE)
+#error "XSNOR_SUSPEND_ERASE_ON_PROGRAM invalid value"
+#endif
+
 /* Other consistency checks.*/
 #if (XSNOR_USE_SPI == FALSE) && (XSNOR_USE_WSPI == FALSE)
 #error "XSNOR_USE_SPI or XSNOR_USE_WSPI must be enabled"
@@ -128,6 +159,9 @@
 #if (XSNOR_USE_WSPI == TRUE) && (HAL_USE_WSPI == FALSE)
 #error "XSNOR_USE_WSPI requires HAL_USE_WSPI"
 #endif
+#if (XSNOR_SUSPEND_ERASE_ON_PROGRAM == TRUE) && (XSNOR_USE_ERASE_SUSPEND == FALSE)
+#error "XSNOR_SUSPEND_ERASE_ON_PROGRAM requires XSNOR_USE_ERASE_SUSPEND"
+#endif
 
 /**
  * @brief       This switch is @p TRUE if both SPI and WSPI are in use.
@@ -309,6 +343,8 @@ struct hal_xsnor_base_vmt {
   flash_error_t (*verify_erase)(void *ip, flash_sector_t sector);
   flash_error_t (*mmap_on)(void *ip, uint8_t **addrp);
   void (*mmap_off)(void *ip);
+  flash_error_t (*suspend_erase)(void *ip);
+  flash_error_t (*resume_erase)(void *ip);
 };
 
 /**
@@ -349,6 +385,16 @@ struct hal_xsnor_base {
    *              initialization.
    */
   flash_descriptor_t        descriptor;
+#if (XSNOR_USE_ERASE_SUSPEND == TRUE) || defined (__DOXYGEN__)
+  /**
+   * @brief       Offset of the area being erased.
+   */
+  flash_offset_t            erase_offset;
+  /**
+   * @brief       Size of the area being erased.
+   */
+  uint32_t                  erase_size;
+#endif /* XSNOR_USE_ERASE_SUSPEND == TRUE */
 };
 /** @} */
 
@@ -595,6 +641,48 @@ static inline void xsnor_device_mmap_off(void *ip) {
 
   self->vmt->mmap_off(ip);
 }
+
+/**
+ * @memberof    hal_xsnor_base_c
+ * @public
+ *
+ * @brief       Suspends an erase operation in progress.
+ *
+ * @param[in,out] ip            Pointer to a @p hal_xsnor_base_c instance.
+ * @return                      An error code.
+ * @retval FLASH_NO_ERROR       If the erase operation is already over.
+ * @retval FLASH_BUSY_ERASING   If the erase operation has been suspended.
+ * @retval FLASH_ERROR_ERASE    If the erase operation is over and failed.
+ * @retval FLASH_ERROR_HW_FAILURE If access to the memory failed.
+ *
+ * @notapi
+ */
+CC_FORCE_INLINE
+static inline flash_error_t xsnor_device_suspend_erase(void *ip) {
+  hal_xsnor_base_c *self = (hal_xsnor_base_c *)ip;
+
+  return self->vmt->suspend_erase(ip);
+}
+
+/**
+ * @memberof    hal_xsnor_base_c
+ * @public
+ *
+ * @brief       Resumes a suspended erase operation.
+ *
+ * @param[in,out] ip            Pointer to a @p hal_xsnor_base_c instance.
+ * @return                      An error code.
+ * @retval FLASH_NO_ERROR       Operation successful.
+ * @retval FLASH_ERROR_HW_FAILURE If access to the memory failed.
+ *
+ * @notapi
+ */
+CC_FORCE_INLINE
+static inline flash_error_t xsnor_device_resume_erase(void *ip) {
+  hal_xsnor_base_c *self = (hal_xsnor_base_c *)ip;
+
+  return self->vmt->resume_erase(ip);
+}
 /** @} */
 
 #endif /* HAL_XSNOR_BASE_H */
@@ -50,6 +50,76 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (XSNOR_USE_ERASE_SUSPEND == TRUE) || defined (__DOXYGEN__)
+/**
+ * @brief       Read or program operation during an erase.
+ * @details     The erase operation is suspended for the duration of the
+ *              access then resumed, the driver stays in @p FLASH_ERASE
+ *              state. Areas overlapping the area being erased cannot be
+ *              accessed.
+ *
+ * @param[in,out] self          Pointer to a @p hal_xsnor_base_c instance.
+ * @param[in]     offset        Flash offset.
+ * @param[in]     n             Number of bytes to be accessed.
+ * @param[out]    rp            Pointer to the read buffer or @p NULL.
+ * @param[in]     pp            Pointer to the program buffer, used if @p rp
+ *                              is @p NULL.
+ * @return                      An error code.
+ * @retval FLASH_BUSY_ERASING   If the area cannot be accessed.
+ */
+static flash_error_t xsnor_suspended_access(hal_xsnor_base_c *self,
+                                            flash_offset_t offset, size_t n,
+                                            uint8_t *rp, const uint8_t *pp) {
+  flash_error_t err, serr;
+
+  /* The device must be able to suspend and the area being erased cannot
+     be accessed.*/
+  if (((self->descriptor.attributes & FLASH_ATTR_SUSPEND_ERASE_CAPABLE) == 0U) ||
+      (((size_t)offset < (size_t)self->erase_offset +
+                         (size_t)self->erase_size) &&
+       ((size_t)offset + n > (size_t)self->erase_offset))) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* Bus acquired.*/
+  __xsnor_bus_acquire(self);
+
+  /* Suspending the erase, it could also have just completed.*/
+  serr = xsnor_device_suspend_erase(self);
+  if ((serr == FLASH_BUSY_ERASING) || (serr == FLASH_NO_ERROR)) {
+
+    /* Actual read or program implementation.*/
+    if (rp != NULL) {
+      err = xsnor_device_read(self, offset, n, rp);
+    }
+    else {
+      err = xsnor_device_program(self, offset, n, pp);
+    }
+
+    if (serr == FLASH_BUSY_ERASING) {
+      /* Resuming the suspended erase.*/
+      serr = xsnor_device_resume_erase(self);
+      if (err == FLASH_NO_ERROR) {
+        err = serr;
+      }
+    }
+    else {
+      /* The erase is over, nothing to resume.*/
+      self->state = FLASH_READY;
+    }
+  }
+  else {
+    /* The erase failed, the error is reported by flsQueryErase().*/
+    err = FLASH_BUSY_ERASING;
+  }
+
+  /* Bus released.*/
+  __xsnor_bus_release(self);
+
+  return err;
+}
+#endif /* XSNOR_USE_ERASE_SUSPEND == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -101,7 +171,11 @@ static flash_error_t __xsnor_fls_read_impl(void *ip, flash_offset_t offset,
                 "invalid state");
 
   if (self->state == FLASH_ERASE) {
+#if XSNOR_USE_ERASE_SUSPEND == TRUE
+    return xsnor_suspended_access(self, offset, n, rp, NULL);
+#else
     return FLASH_BUSY_ERASING;
+#endif
   }
 
   /* Bus acquired.*/
@@ -145,7 +219,11 @@ static flash_error_t __xsnor_fls_program_impl(void *ip, flash_offset_t offset,
                 "invalid state");
 
   if (self->state == FLASH_ERASE) {
+#if XSNOR_SUSPEND_ERASE_ON_PROGRAM == TRUE
+    return xsnor_suspended_access(self, offset, n, NULL, pp);
+#else
     return FLASH_BUSY_ERASING;
+#endif
   }
 
   /* Bus acquired.*/
@@ -193,6 +271,10 @@ static flash_error_t __xsnor_fls_start_erase_all_impl(void *ip) {
 
   /* FLASH_ERASE state while the operation is performed.*/
   self->state = FLASH_ERASE;
+#if XSNOR_USE_ERASE_SUSPEND == TRUE
+  self->erase_offset = 0U;
+  self->erase_size   = self->descriptor.size;
+#endif
 
   /* Actual erase implementation.*/
   err = xsnor_device_start_erase_all(self);
@@ -232,6 +314,16 @@ static flash_error_t __xsnor_fls_start_erase_sector_impl(void *ip,
 
   /* FLASH_ERASE state while the operation is performed.*/
   self->state = FLASH_ERASE;
+#if XSNOR_USE_ERASE_SUSPEND == TRUE
+  if (self->descriptor.sectors != NULL) {
+    self->erase_offset = self->descriptor.sectors[sector].offset;
+    self->erase_size   = self->descriptor.sectors[sector].size;
+  }
+  else {
+    self->erase_offset = (flash_offset_t)sector * self->descriptor.sectors_size;
+    self->erase_size   = self->descriptor.sectors_size;
+  }
+#endif
 
   /* Actual erase implementation.*/
   err = xsnor_device_start_erase_sector(self, sector);
@@ -408,6 +500,10 @@ void *__xsnor_objinit_impl(void *ip, const void *vmt) {
   self->config   = NULL;
 #if XSNOR_USE_WSPI == TRUE
   self->commands = NULL;
+#endif
+#if XSNOR_USE_ERASE_SUSPEND == TRUE
+  self->erase_offset = 0U;
+  self->erase_size   = 0U;
 #endif
   osalMutexObjectInit(&self->mutex);
 
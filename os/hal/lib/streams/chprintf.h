@@ -36,6 +36,19 @@
 #define CHPRINTF_USE_FLOAT          FALSE
 #endif
 
+/**
+ * @brief   Size of the output buffer used by @p chvprintf().
+ * @details The formatted output is collected in a buffer allocated on the
+ *          stack and written to the stream using @p streamWrite(), this
+ *          reduces the number of calls to the stream and, on streams
+ *          protecting each call, the number of lock acquisitions.
+ * @note    Setting this option to zero makes characters written one at
+ *          time using @p streamPut().
+ */
+#if !defined(CHPRINTF_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define CHPRINTF_BUFFER_SIZE        32
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -0,0 +1,688 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_efl_lld.c
+ * @brief   Posix simulator simulated NOR flash driver code.
+ * @details The flash array is kept in RAM or mapped from a file, erase and
+ *          program operations take the configured times so that storage
+ *          code can be benchmarked on the host. Programming can only clear
+ *          bits, erase cycles are counted per sector and power losses can
+ *          be injected in the middle of program and erase operations.
+ *
+ * @addtogroup POSIX_EFL
+ * @{
+ */
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "hal.h"
+
+#if (HAL_USE_EFL == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define SIM_EFL_SIZE        (SIM_EFL_SECTOR_SIZE * SIM_EFL_SECTORS_COUNT)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   EFL1 driver identifier.
+ */
+EFlashDriver EFLD1;
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+static uint8_t sim_efl_memory[SIM_EFL_SIZE];
+
+static uint32_t sim_efl_erase_counts[SIM_EFL_SECTORS_COUNT];
+
+static const flash_descriptor_t efl_lld_descriptor = {
+ .attributes        = FLASH_ATTR_ERASED_IS_ONE |
+                      FLASH_ATTR_REWRITABLE,
+ .page_size         = SIM_EFL_PAGE_SIZE,
+ .sectors_count     = SIM_EFL_SECTORS_COUNT,
+ .sectors           = NULL,
+ .sectors_size      = SIM_EFL_SECTOR_SIZE,
+ .address           = NULL,
+ .size              = SIM_EFL_SIZE
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Pseudo-random generator used to choose where an operation is cut by a
+ * power loss, sequences are repeatable across runs.
+ */
+static uint32_t sim_efl_random(EFlashDriver *devp) {
+  uint32_t x = devp->rnd;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  devp->rnd = x;
+
+  return x;
+}
+
+/*
+ * Spends the accumulated program time, sub-tick amounts are carried over
+ * to the next operation.
+ */
+static void sim_efl_spend(EFlashDriver *devp, uint32_t us) {
+  uint32_t ms;
+
+  devp->program_debt += us;
+  ms = devp->program_debt / 1000U;
+  if (ms > 0U) {
+    devp->program_debt -= ms * 1000U;
+    osalThreadSleepMilliseconds(ms);
+  }
+}
+
+/*
+ * Counts down the operations before a power loss, returns true if the
+ * current operation is the one interrupted.
+ */
+static bool sim_efl_power_check(EFlashDriver *devp) {
+
+  if (devp->power_loss_ops == 0U) {
+    return false;
+  }
+  if (--devp->power_loss_ops > 0U) {
+    return false;
+  }
+
+  devp->power_lost = true;
+  devp->stats.power_losses++;
+
+  return true;
+}
+
+/*
+ * Size in bytes of the area affected by the current erase operation.
+ */
+static size_t sim_efl_erase_size(EFlashDriver *devp) {
+
+  if (devp->erase_sector >= SIM_EFL_SECTORS_COUNT) {
+    return (size_t)SIM_EFL_SIZE;
+  }
+
+  return (size_t)SIM_EFL_SECTOR_SIZE;
+}
+
+/*
+ * Erases the first @p n bytes of the area affected by the current erase
+ * operation, partial erases leave the remaining bytes untouched.
+ */
+static void sim_efl_erase(EFlashDriver *devp, size_t n) {
+  size_t base = 0U;
+
+  if (devp->erase_sector < SIM_EFL_SECTORS_COUNT) {
+    base = (size_t)devp->erase_sector * SIM_EFL_SECTOR_SIZE;
+  }
+  memset(&devp->memory[base], 0xFF, n);
+}
+
+/*
+ * Common erase start, erase cycles are counted when the operation starts
+ * also if it is later interrupted.
+ */
+static flash_error_t sim_efl_start_erase(EFlashDriver *devp,
+                                         flash_sector_t sector,
+                                         uint32_t ms) {
+
+  devp->erase_sector = sector;
+  if (sector >= SIM_EFL_SECTORS_COUNT) {
+    for (sector = 0U; sector < SIM_EFL_SECTORS_COUNT; sector++) {
+      devp->erase_counts[sector]++;
+    }
+    devp->stats.erases += SIM_EFL_SECTORS_COUNT;
+  }
+  else {
+    devp->erase_counts[sector]++;
+    devp->stats.erases++;
+  }
+
+  if (sim_efl_power_check(devp)) {
+    sim_efl_erase(devp, (size_t)sim_efl_random(devp) %
+                        sim_efl_erase_size(devp));
+    return FLASH_ERROR_HW_FAILURE;
+  }
+
+  devp->state       = FLASH_ERASE;
+  devp->erase_start = osalOsGetSystemTimeX();
+  devp->erase_end   = osalTimeAddX(devp->erase_start, OSAL_MS2I(ms));
+
+  return FLASH_NO_ERROR;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Arms a simulated power loss.
+ * @details The power is lost during the @p ops-th program or erase
+ *          operation from now, the operation is left partially done and
+ *          any access returns @p FLASH_ERROR_HW_FAILURE until
+ *          @p eflSimPowerCycle() is called.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ * @param[in] ops       operations before the power loss, zero disarms
+ *
+ * @api
+ */
+void eflSimSetPowerLoss(EFlashDriver *eflp, uint32_t ops) {
+
+  osalDbgCheck(eflp != NULL);
+
+  osalSysLock();
+  eflp->power_loss_ops = ops;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Restores the power after a simulated power loss.
+ * @note    An erase operation still in progress is interrupted, the erased
+ *          part is proportional to the time elapsed since its start.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ *
+ * @api
+ */
+void eflSimPowerCycle(EFlashDriver *eflp) {
+
+  osalDbgCheck(eflp != NULL);
+
+  osalSysLock();
+  if (eflp->state == FLASH_ERASE) {
+    sysinterval_t elapsed, total;
+    size_t n = sim_efl_erase_size(eflp);
+
+    elapsed = osalTimeDiffX(eflp->erase_start, osalOsGetSystemTimeX());
+    total   = osalTimeDiffX(eflp->erase_start, eflp->erase_end);
+    if (elapsed < total) {
+      n = (size_t)(((uint64_t)n * elapsed) / total);
+      eflp->stats.power_losses++;
+    }
+    sim_efl_erase(eflp, n);
+    eflp->state = FLASH_READY;
+  }
+  eflp->power_lost     = false;
+  eflp->power_loss_ops = 0U;
+  eflp->program_debt   = 0U;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Returns @p true if the simulated device lost power.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ * @return              The power state.
+ *
+ * @api
+ */
+bool eflSimIsPowerLost(EFlashDriver *eflp) {
+
+  osalDbgCheck(eflp != NULL);
+
+  return eflp->power_lost;
+}
+
+/**
+ * @brief   Returns the erase cycles of a sector.
+ * @note    Counters are kept in RAM, they are not stored in the backing
+ *          file.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ * @param[in] sector    sector number
+ * @return              The number of erase cycles since initialization or
+ *                      since the last @p eflSimResetStats().
+ *
+ * @api
+ */
+uint32_t eflSimGetEraseCount(EFlashDriver *eflp, flash_sector_t sector) {
+
+  osalDbgCheck((eflp != NULL) && (sector < SIM_EFL_SECTORS_COUNT));
+
+  return eflp->erase_counts[sector];
+}
+
+/**
+ * @brief   Returns the operations statistics.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ * @param[out] statsp   pointer to the statistics structure to be filled
+ *
+ * @api
+ */
+void eflSimGetStats(EFlashDriver *eflp, sim_efl_stats_t *statsp) {
+
+  osalDbgCheck((eflp != NULL) && (statsp != NULL));
+
+  osalSysLock();
+  *statsp = eflp->stats;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Clears the operations statistics and the erase counters.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ *
+ * @api
+ */
+void eflSimResetStats(EFlashDriver *eflp) {
+
+  osalDbgCheck(eflp != NULL);
+
+  osalSysLock();
+  memset(&eflp->stats, 0, sizeof eflp->stats);
+  memset(eflp->erase_counts, 0, SIM_EFL_SECTORS_COUNT * sizeof (uint32_t));
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Low level Embedded Flash driver initialization.
+ *
+ * @notapi
+ */
+void efl_lld_init(void) {
+
+  /* Driver initialization.*/
+  eflObjectInit(&EFLD1);
+  EFLD1.memory         = sim_efl_memory;
+  EFLD1.fd             = -1;
+  EFLD1.program_debt   = 0U;
+  EFLD1.erase_counts   = sim_efl_erase_counts;
+  EFLD1.power_loss_ops = 0U;
+  EFLD1.power_lost     = false;
+  EFLD1.rnd            = 0x2545F491U;
+  memset(&EFLD1.stats, 0, sizeof EFLD1.stats);
+
+  /* The simulated device starts erased.*/
+  memset(sim_efl_memory, 0xFF, sizeof sim_efl_memory);
+}
+
+/**
+ * @brief   Configures and activates the Embedded Flash peripheral.
+ * @note    Without a configuration the flash array is kept in RAM and
+ *          NOR semantics are enforced. The RAM array content is retained
+ *          across stop and start.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ * @return              The operation status.
+ * @retval HAL_RET_SUCCESS      if the driver has been started.
+ * @retval HAL_RET_HW_FAILURE   if the backing file cannot be mapped.
+ *
+ * @notapi
+ */
+msg_t efl_lld_start(EFlashDriver *eflp) {
+
+  if ((eflp->config != NULL) && (eflp->config->path != NULL) &&
+      (eflp->fd < 0)) {
+    struct stat st;
+    void *p;
+    int fd;
+
+    fd = open(eflp->config->path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+      return HAL_RET_HW_FAILURE;
+    }
+    if ((fstat(fd, &st) < 0) ||
+        ((st.st_size != (off_t)SIM_EFL_SIZE) &&
+         (ftruncate(fd, (off_t)SIM_EFL_SIZE) < 0))) {
+      (void) close(fd);
+      return HAL_RET_HW_FAILURE;
+    }
+    p = mmap(NULL, SIM_EFL_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+      (void) close(fd);
+      return HAL_RET_HW_FAILURE;
+    }
+
+    /* A new or resized file starts erased.*/
+    if (st.st_size != (off_t)SIM_EFL_SIZE) {
+      memset(p, 0xFF, SIM_EFL_SIZE);
+    }
+
+    eflp->memory = (uint8_t *)p;
+    eflp->fd     = fd;
+  }
+
+  eflp->program_debt = 0U;
+  eflp->power_lost   = false;
+
+  return HAL_RET_SUCCESS;
+}
+
+/**
+ * @brief   Deactivates the Embedded Flash peripheral.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ *
+ * @notapi
+ */
+void efl_lld_stop(EFlashDriver *eflp) {
+
+  if (eflp->fd >= 0) {
+    (void) msync(eflp->memory, SIM_EFL_SIZE, MS_SYNC);
+    (void) munmap(eflp->memory, SIM_EFL_SIZE);
+    (void) close(eflp->fd);
+    eflp->memory = sim_efl_memory;
+    eflp->fd     = -1;
+  }
+}
+
+/**
+ * @brief   Gets the flash descriptor structure.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @return                          A flash device descriptor.
+ *
+ * @notapi
+ */
+const flash_descriptor_t *efl_lld_get_descriptor(void *instance) {
+
+  (void)instance;
+
+  return &efl_lld_descriptor;
+}
+
+/**
+ * @brief   Read operation.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @param[in] offset                flash offset
+ * @param[in] n                     number of bytes to be read
+ * @param[out] rp                   pointer to the data buffer
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ * @retval FLASH_ERROR_HW_FAILURE   if the device lost power.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_read(void *instance, flash_offset_t offset,
+                           size_t n, uint8_t *rp) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+
+  osalDbgCheck((instance != NULL) && (rp != NULL) && (n > 0U));
+  osalDbgCheck((size_t)offset + n <= (size_t)efl_lld_descriptor.size);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  if (devp->power_lost) {
+    return FLASH_ERROR_HW_FAILURE;
+  }
+
+  /* No reading while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  memcpy((void *)rp, (const void *)&devp->memory[offset], n);
+  devp->stats.reads++;
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Program operation.
+ * @note    Programming can only clear bits, as on NOR devices. In strict
+ *          mode an attempt to set bits fails without modifying the array.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @param[in] offset                flash offset
+ * @param[in] n                     number of bytes to be programmed
+ * @param[in] pp                    pointer to the data buffer
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ * @retval FLASH_ERROR_PROGRAM      if bits would be set in strict mode.
+ * @retval FLASH_ERROR_HW_FAILURE   if the device lost power.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_program(void *instance, flash_offset_t offset,
+                              size_t n, const uint8_t *pp) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+  uint8_t *p;
+  uint32_t pages;
+  size_t i, done;
+
+  osalDbgCheck((instance != NULL) && (pp != NULL) && (n > 0U));
+  osalDbgCheck((size_t)offset + n <= (size_t)efl_lld_descriptor.size);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  if (devp->power_lost) {
+    return FLASH_ERROR_HW_FAILURE;
+  }
+
+  /* No programming while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  p = &devp->memory[offset];
+
+  /* Bits can only go from one to zero.*/
+  if ((devp->config == NULL) || devp->config->strict) {
+    for (i = 0U; i < n; i++) {
+      if (((uint8_t)~p[i] & pp[i]) != 0U) {
+        devp->stats.violations++;
+        return FLASH_ERROR_PROGRAM;
+      }
+    }
+  }
+
+  /* FLASH_PGM state while the operation is performed.*/
+  devp->state = FLASH_PGM;
+
+  /* On power loss only part of the data is written, the first byte left
+     out is partially programmed.*/
+  done = n;
+  if (sim_efl_power_check(devp)) {
+    done = (size_t)sim_efl_random(devp) % n;
+    p[done] &= pp[done] | (uint8_t)sim_efl_random(devp);
+  }
+
+  for (i = 0U; i < done; i++) {
+    p[i] &= pp[i];
+  }
+  devp->stats.programs++;
+  devp->stats.programmed += (uint32_t)done;
+
+  /* Each touched page costs a page program time.*/
+  pages = (uint32_t)(((offset + n - 1U) / SIM_EFL_PAGE_SIZE) -
+                     (offset / SIM_EFL_PAGE_SIZE) + 1U);
+  sim_efl_spend(devp, pages * SIM_EFL_PROGRAM_TIME_US);
+
+  /* Ready state again.*/
+  devp->state = FLASH_READY;
+
+  return devp->power_lost ? FLASH_ERROR_HW_FAILURE : FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Starts a whole-device erase operation.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ * @retval FLASH_ERROR_HW_FAILURE   if the device lost power.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_start_erase_all(void *instance) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  if (devp->power_lost) {
+    return FLASH_ERROR_HW_FAILURE;
+  }
+
+  /* No erasing while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  return sim_efl_start_erase(devp, SIM_EFL_SECTORS_COUNT,
+                             SIM_EFL_ERASE_TIME_MS * SIM_EFL_SECTORS_COUNT);
+}
+
+/**
+ * @brief   Starts an sector erase operation.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @param[in] sector                sector to be erased
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ * @retval FLASH_ERROR_HW_FAILURE   if the device lost power.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_start_erase_sector(void *instance,
+                                         flash_sector_t sector) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgCheck(sector < efl_lld_descriptor.sectors_count);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  if (devp->power_lost) {
+    return FLASH_ERROR_HW_FAILURE;
+  }
+
+  /* No erasing while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  return sim_efl_start_erase(devp, sector, SIM_EFL_ERASE_TIME_MS);
+}
+
+/**
+ * @brief   Queries the driver for erase operation progress.
+ * @note    The simulated erase takes effect when the erase time has
+ *          elapsed and the operation is queried.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @param[out] msec                 recommended time, in milliseconds, that
+ *                                  should be spent before calling this
+ *                                  function again, can be @p NULL
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ * @retval FLASH_ERROR_HW_FAILURE   if the device lost power.
+ *
+ * @api
+ */
+flash_error_t efl_lld_query_erase(void *instance, uint32_t *msec) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+
+  if (devp->power_lost) {
+    return FLASH_ERROR_HW_FAILURE;
+  }
+
+  if (devp->state != FLASH_ERASE) {
+    return FLASH_NO_ERROR;
+  }
+
+  if (osalTimeIsInRangeX(osalOsGetSystemTimeX(),
+                         devp->erase_start, devp->erase_end)) {
+    if (msec != NULL) {
+      *msec = (uint32_t)SIM_EFL_WAIT_TIME_MS;
+    }
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* Erase time elapsed, performing the erase.*/
+  sim_efl_erase(devp, sim_efl_erase_size(devp));
+  devp->state = FLASH_READY;
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Returns the erase state of a sector.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @param[in] sector                sector to be verified
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if the sector is erased.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ * @retval FLASH_ERROR_VERIFY       if the verify operation failed.
+ * @retval FLASH_ERROR_HW_FAILURE   if the device lost power.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_verify_erase(void *instance, flash_sector_t sector) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+  const uint8_t *p;
+  unsigned i;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgCheck(sector < efl_lld_descriptor.sectors_count);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  if (devp->power_lost) {
+    return FLASH_ERROR_HW_FAILURE;
+  }
+
+  /* No verifying while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  p = &devp->memory[sector * SIM_EFL_SECTOR_SIZE];
+  for (i = 0U; i < SIM_EFL_SECTOR_SIZE; i++) {
+    if (p[i] != 0xFFU) {
+      return FLASH_ERROR_VERIFY;
+    }
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+#endif /* HAL_USE_EFL == TRUE */
+
+/** @} */
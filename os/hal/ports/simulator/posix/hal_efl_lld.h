@@ -0,0 +1,213 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_efl_lld.h
+ * @brief   Posix simulator simulated NOR flash driver header.
+ *
+ * @addtogroup POSIX_EFL
+ * @{
+ */
+
+#ifndef HAL_EFL_LLD_H
+#define HAL_EFL_LLD_H
+
+#if (HAL_USE_EFL == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   The LLD start function returns a status.
+ */
+#define EFL_LLD_ENHANCED_API
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Posix simulator flash configuration options
+ * @{
+ */
+/**
+ * @brief   Size of a simulated flash sector.
+ */
+#if !defined(SIM_EFL_SECTOR_SIZE) || defined(__DOXYGEN__)
+#define SIM_EFL_SECTOR_SIZE                 4096U
+#endif
+
+/**
+ * @brief   Number of simulated flash sectors.
+ */
+#if !defined(SIM_EFL_SECTORS_COUNT) || defined(__DOXYGEN__)
+#define SIM_EFL_SECTORS_COUNT               256U
+#endif
+
+/**
+ * @brief   Size of a simulated program page.
+ */
+#if !defined(SIM_EFL_PAGE_SIZE) || defined(__DOXYGEN__)
+#define SIM_EFL_PAGE_SIZE                   256U
+#endif
+
+/**
+ * @brief   Time required to erase a sector in milliseconds.
+ */
+#if !defined(SIM_EFL_ERASE_TIME_MS) || defined(__DOXYGEN__)
+#define SIM_EFL_ERASE_TIME_MS               40U
+#endif
+
+/**
+ * @brief   Time required to program a page in microseconds.
+ */
+#if !defined(SIM_EFL_PROGRAM_TIME_US) || defined(__DOXYGEN__)
+#define SIM_EFL_PROGRAM_TIME_US             500U
+#endif
+
+/**
+ * @brief   Suggested wait time during erase operations polling.
+ */
+#if !defined(SIM_EFL_WAIT_TIME_MS) || defined(__DOXYGEN__)
+#define SIM_EFL_WAIT_TIME_MS                5U
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (SIM_EFL_SECTOR_SIZE % SIM_EFL_PAGE_SIZE) != 0
+#error "SIM_EFL_SECTOR_SIZE must be a multiple of SIM_EFL_PAGE_SIZE"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulated flash operations statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Number of read operations.
+   */
+  uint32_t                  reads;
+  /**
+   * @brief   Number of program operations.
+   */
+  uint32_t                  programs;
+  /**
+   * @brief   Number of bytes programmed.
+   */
+  uint32_t                  programmed;
+  /**
+   * @brief   Number of sector erases, a whole-device erase counts once
+   *          per sector.
+   */
+  uint32_t                  erases;
+  /**
+   * @brief   Program operations rejected because clearing bits only was
+   *          not possible.
+   */
+  uint32_t                  violations;
+  /**
+   * @brief   Number of simulated power losses.
+   */
+  uint32_t                  power_losses;
+} sim_efl_stats_t;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level fields of the embedded flash driver structure.
+ */
+#define efl_lld_driver_fields                                               \
+  /* Simulated flash array.*/                                               \
+  uint8_t                   *memory;                                        \
+  /* Backing file descriptor or -1 if the array is in RAM.*/                \
+  int                       fd;                                             \
+  /* Erase start and completion times.*/                                    \
+  systime_t                 erase_start;                                    \
+  systime_t                 erase_end;                                      \
+  /* Sector being erased or SIM_EFL_SECTORS_COUNT for erase all.*/          \
+  flash_sector_t            erase_sector;                                   \
+  /* Program time not yet spent, in microseconds.*/                         \
+  uint32_t                  program_debt;                                   \
+  /* Per-sector erase cycles.*/                                             \
+  uint32_t                  *erase_counts;                                  \
+  /* Operations statistics.*/                                               \
+  sim_efl_stats_t           stats;                                          \
+  /* Program or erase operations before a power loss, zero if disabled.*/   \
+  uint32_t                  power_loss_ops;                                 \
+  /* Device unpowered after a simulated power loss.*/                       \
+  bool                      power_lost;                                     \
+  /* Pseudo-random generator state.*/                                       \
+  uint32_t                  rnd
+
+/**
+ * @brief   Low level fields of the embedded flash configuration structure.
+ */
+#define efl_lld_config_fields                                               \
+  /* Backing file path, NULL for a RAM array. A new or resized file is      \
+     erased.*/                                                              \
+  const char                *path;                                          \
+  /* Programming that would set bits back to one fails, as on a real NOR    \
+     device, if false the bits are simply ANDed.*/                          \
+  bool                      strict
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if !defined(__DOXYGEN__)
+extern EFlashDriver EFLD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void eflSimSetPowerLoss(EFlashDriver *eflp, uint32_t ops);
+  void eflSimPowerCycle(EFlashDriver *eflp);
+  bool eflSimIsPowerLost(EFlashDriver *eflp);
+  uint32_t eflSimGetEraseCount(EFlashDriver *eflp, flash_sector_t sector);
+  void eflSimGetStats(EFlashDriver *eflp, sim_efl_stats_t *statsp);
+  void eflSimResetStats(EFlashDriver *eflp);
+  void efl_lld_init(void);
+  msg_t efl_lld_start(EFlashDriver *eflp);
+  void efl_lld_stop(EFlashDriver *eflp);
+  const flash_descriptor_t *efl_lld_get_descriptor(void *instance);
+  flash_error_t efl_lld_read(void *instance, flash_offset_t offset,
+                             size_t n, uint8_t *rp);
+  flash_error_t efl_lld_program(void *instance, flash_offset_t offset,
+                                size_t n, const uint8_t *pp);
+  flash_error_t efl_lld_start_erase_all(void *instance);
+  flash_error_t efl_lld_start_erase_sector(void *instance,
+                                           flash_sector_t sector);
+  flash_error_t efl_lld_query_erase(void *instance, uint32_t *msec);
+  flash_error_t efl_lld_verify_erase(void *instance, flash_sector_t sector);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_EFL == TRUE */
+
+#endif /* HAL_EFL_LLD_H */
+
+/** @} */
@@ -0,0 +1,891 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_sdc_lld.c
+ * @brief   Posix simulator simulated SD card driver code.
+ * @details The driver models a high capacity SD card answering the
+ *          commands of the portable SDC initialization sequence, the card
+ *          content is an image kept in RAM or in a host file accessed
+ *          using pread()/pwrite(). Transfers take the configured access
+ *          latency and bandwidth so that file systems can be benchmarked
+ *          on the host.
+ *
+ * @addtogroup POSIX_SDC
+ * @{
+ */
+
+#define _FILE_OFFSET_BITS 64
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "hal.h"
+
+#if (HAL_USE_SDC == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/* Relative address assigned by the simulated card.*/
+#define SIM_SDC_RCA                 0x5A5AU
+
+/* R1 status bits.*/
+#define R1_OUT_OF_RANGE             0x80000000U
+#define R1_BLOCK_LEN_ERROR          0x20000000U
+#define R1_WP_VIOLATION             0x04000000U
+#define R1_READY_FOR_DATA           0x00000100U
+#define R1_APP_CMD                  0x00000020U
+
+/* OCR of a powered up high capacity card.*/
+#define SIM_SDC_OCR                 0xC0FF8000U
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   SDCD1 driver identifier.
+ */
+SDCDriver SDCD1;
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Default configuration, RAM image without delays.
+ */
+static const SDCConfig sdc_default_cfg = {
+  .bus_width        = SDC_MODE_4BIT,
+  .path             = NULL,
+  .blocks           = SIM_SDC_DEFAULT_BLOCKS,
+  .read_only        = false,
+  .read_latency_us  = 0U,
+  .write_latency_us = 0U,
+  .read_kbps        = 0U,
+  .write_kbps       = 0U
+};
+
+/**
+ * @brief   Zero filled buffer used for erasing file images.
+ */
+static const uint8_t sim_sdc_zero[16 * MMCSD_BLOCK_SIZE];
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Returns true if there is a card in the slot.
+ */
+static bool sim_sdc_is_present(SDCDriver *sdcp) {
+
+  return sdcp->inserted && ((sdcp->memory != NULL) || (sdcp->fd >= 0));
+}
+
+/*
+ * Spends the accumulated busy time, sub-tick amounts are carried over to
+ * the next operation.
+ */
+static void sim_sdc_spend(SDCDriver *sdcp, uint32_t us) {
+  uint32_t ms;
+
+  sdcp->busy_debt += us;
+  ms = sdcp->busy_debt / 1000U;
+  if (ms > 0U) {
+    sdcp->busy_debt -= ms * 1000U;
+    sdcp->stats.busy_ms += ms;
+    osalThreadSleepMilliseconds(ms);
+  }
+}
+
+/*
+ * Time in microseconds taken by a transfer of @p n blocks, the data moves
+ * at the lowest between the card bandwidth and the bus bandwidth.
+ */
+static uint32_t sim_sdc_transfer_time(SDCDriver *sdcp, uint32_t latency,
+                                      uint32_t kbps, uint32_t n) {
+  uint32_t bus;
+
+  bus = sdcp->clk == SDC_CLK_50MHz ? 50000U : 25000U;
+  switch (sdcp->bus) {
+  case SDC_MODE_4BIT:
+    bus /= 2U;
+    break;
+  case SDC_MODE_8BIT:
+    break;
+  default:
+    bus /= 8U;
+    break;
+  }
+  if ((kbps == 0U) || (kbps > bus)) {
+    kbps = bus;
+  }
+
+  return latency +
+         (uint32_t)(((uint64_t)n * MMCSD_BLOCK_SIZE * 1000U) / kbps);
+}
+
+/*
+ * Moves blocks between the image and a buffer.
+ */
+static bool sim_sdc_io(SDCDriver *sdcp, bool write, uint32_t startblk,
+                       uint8_t *buf, uint32_t n) {
+  size_t size = (size_t)n * MMCSD_BLOCK_SIZE;
+  off_t offset = (off_t)startblk * MMCSD_BLOCK_SIZE;
+
+  if (sdcp->memory != NULL) {
+    if (write) {
+      memcpy(&sdcp->memory[offset], buf, size);
+    }
+    else {
+      memcpy(buf, &sdcp->memory[offset], size);
+    }
+    return HAL_SUCCESS;
+  }
+
+  while (size > 0U) {
+    ssize_t done;
+
+    if (write) {
+      done = pwrite(sdcp->fd, buf, size, offset);
+    }
+    else {
+      done = pread(sdcp->fd, buf, size, offset);
+    }
+    if (done <= 0) {
+      return HAL_FAILED;
+    }
+    buf    += done;
+    offset += (off_t)done;
+    size   -= (size_t)done;
+  }
+
+  return HAL_SUCCESS;
+}
+
+/*
+ * Erases blocks, erased blocks read as zeros.
+ */
+static bool sim_sdc_erase(SDCDriver *sdcp, uint32_t startblk, uint32_t n) {
+
+  if (sdcp->memory != NULL) {
+    memset(&sdcp->memory[(size_t)startblk * MMCSD_BLOCK_SIZE], 0,
+           (size_t)n * MMCSD_BLOCK_SIZE);
+    return HAL_SUCCESS;
+  }
+
+  while (n > 0U) {
+    uint32_t chunk = n;
+
+    if (chunk > sizeof sim_sdc_zero / MMCSD_BLOCK_SIZE) {
+      chunk = sizeof sim_sdc_zero / MMCSD_BLOCK_SIZE;
+    }
+    if (sim_sdc_io(sdcp, true, startblk, (uint8_t *)sim_sdc_zero, chunk)) {
+      return HAL_FAILED;
+    }
+    startblk += chunk;
+    n        -= chunk;
+  }
+
+  return HAL_SUCCESS;
+}
+
+/*
+ * Releases the card image.
+ */
+static void sim_sdc_close(SDCDriver *sdcp) {
+
+  if (sdcp->fd >= 0) {
+    (void) close(sdcp->fd);
+    sdcp->fd = -1;
+  }
+  if (sdcp->memory != NULL) {
+    free(sdcp->memory);
+    sdcp->memory = NULL;
+  }
+  sdcp->blocks = 0U;
+}
+
+/*
+ * Builds an R1 response.
+ */
+static uint32_t sim_sdc_r1(SDCDriver *sdcp, uint32_t flags) {
+
+  flags |= (sdcp->card_state << 9) | R1_READY_FOR_DATA;
+  if (sdcp->app_cmd) {
+    flags |= R1_APP_CMD;
+  }
+
+  return flags;
+}
+
+/*
+ * Builds the CID register.
+ */
+static void sim_sdc_cid(uint32_t *resp) {
+
+  resp[3] = 0x00434853U;        /* MID, OID "CH", PNM "SIMSD".          */
+  resp[2] = 0x494D5344U;
+  resp[1] = 0x10000000U;        /* PRV 1.0, PSN.                        */
+  resp[0] = 0x01014001U;        /* PSN, MDT 2020-01, CRC.               */
+}
+
+/*
+ * Builds a version 2.0 CSD register.
+ */
+static void sim_sdc_csd(SDCDriver *sdcp, uint32_t *resp) {
+  uint32_t c_size = (sdcp->blocks / SIM_SDC_CAPACITY_UNIT) - 1U;
+
+  /* CSD_STRUCTURE, TAAC, NSAC, TRAN_SPEED.*/
+  resp[3] = (1U << 30) | (0x0EU << 16) | (0x00U << 8) | 0x32U;
+  /* CCC, READ_BL_LEN, C_SIZE[21:16].*/
+  resp[2] = (0x5B5U << 20) | (9U << 16) | ((c_size >> 16) & 0x3FU);
+  /* C_SIZE[15:0], ERASE_BLK_EN, SECTOR_SIZE.*/
+  resp[1] = ((c_size & 0xFFFFU) << 16) | (1U << 14) | (0x7FU << 7);
+  /* R2W_FACTOR, WRITE_BL_LEN, TMP_WRITE_PROTECT.*/
+  resp[0] = (2U << 26) | (9U << 22) | 1U;
+  if (sdcp->config->read_only) {
+    resp[0] |= 1U << 12;
+  }
+}
+
+/*
+ * Executes a command on the simulated card.
+ */
+static bool sim_sdc_command(SDCDriver *sdcp, uint8_t cmd, uint32_t arg,
+                            uint32_t *resp) {
+  bool app = sdcp->app_cmd;
+
+  sdcp->app_cmd = false;
+  if (!sim_sdc_is_present(sdcp)) {
+    sdcp->errors |= SDC_COMMAND_TIMEOUT;
+    return HAL_FAILED;
+  }
+  sdcp->stats.commands++;
+
+  /* Application commands, the other commands are executed as standard
+     commands.*/
+  if (app) {
+    switch (cmd) {
+    case MMCSD_CMD_SET_BUS_WIDTH:
+      if ((sdcp->card_state != MMCSD_STS_TRAN) || ((arg & ~2U) != 0U)) {
+        break;
+      }
+      sdcp->app_cmd = true;
+      resp[0] = sim_sdc_r1(sdcp, 0U);
+      sdcp->app_cmd = false;
+      return HAL_SUCCESS;
+    case MMCSD_CMD_APP_OP_COND:
+      if (sdcp->card_state != MMCSD_STS_IDLE) {
+        break;
+      }
+      sdcp->card_state = MMCSD_STS_READY;
+      resp[0] = SIM_SDC_OCR;
+      return HAL_SUCCESS;
+    default:
+      break;
+    }
+  }
+
+  switch (cmd) {
+  case MMCSD_CMD_GO_IDLE_STATE:
+    sdcp->card_state = MMCSD_STS_IDLE;
+    return HAL_SUCCESS;
+  case MMCSD_CMD_SEND_IF_COND:
+    if (sdcp->card_state != MMCSD_STS_IDLE) {
+      break;
+    }
+    resp[0] = arg & 0xFFFU;
+    return HAL_SUCCESS;
+  case MMCSD_CMD_APP_CMD:
+    sdcp->app_cmd = true;
+    resp[0] = sim_sdc_r1(sdcp, 0U);
+    return HAL_SUCCESS;
+  case MMCSD_CMD_ALL_SEND_CID:
+    if (sdcp->card_state != MMCSD_STS_READY) {
+      break;
+    }
+    sdcp->card_state = MMCSD_STS_IDENT;
+    sim_sdc_cid(resp);
+    return HAL_SUCCESS;
+  case MMCSD_CMD_SEND_RELATIVE_ADDR:
+    if ((sdcp->card_state != MMCSD_STS_IDENT) &&
+        (sdcp->card_state != MMCSD_STS_STBY)) {
+      break;
+    }
+    sdcp->card_state = MMCSD_STS_STBY;
+    resp[0] = (SIM_SDC_RCA << 16) | (sim_sdc_r1(sdcp, 0U) & 0x1FFFU);
+    return HAL_SUCCESS;
+  case MMCSD_CMD_SEND_CSD:
+  case MMCSD_CMD_SEND_CID:
+    if ((sdcp->card_state != MMCSD_STS_STBY) ||
+        ((arg >> 16) != SIM_SDC_RCA)) {
+      break;
+    }
+    if (cmd == MMCSD_CMD_SEND_CSD) {
+      sim_sdc_csd(sdcp, resp);
+    }
+    else {
+      sim_sdc_cid(resp);
+    }
+    return HAL_SUCCESS;
+  case MMCSD_CMD_SEL_DESEL_CARD:
+    resp[0] = sim_sdc_r1(sdcp, 0U);
+    if ((arg >> 16) == SIM_SDC_RCA) {
+      sdcp->card_state = MMCSD_STS_TRAN;
+    }
+    else {
+      sdcp->card_state = MMCSD_STS_STBY;
+    }
+    return HAL_SUCCESS;
+  case MMCSD_CMD_SEND_STATUS:
+  case MMCSD_CMD_STOP_TRANSMISSION:
+    resp[0] = sim_sdc_r1(sdcp, 0U);
+    return HAL_SUCCESS;
+  case MMCSD_CMD_SET_BLOCKLEN:
+    resp[0] = sim_sdc_r1(sdcp, arg == MMCSD_BLOCK_SIZE ?
+                               0U : R1_BLOCK_LEN_ERROR);
+    return HAL_SUCCESS;
+  case MMCSD_CMD_ERASE_RW_BLK_START:
+    sdcp->erase_start = arg;
+    resp[0] = sim_sdc_r1(sdcp, 0U);
+    return HAL_SUCCESS;
+  case MMCSD_CMD_ERASE_RW_BLK_END:
+    sdcp->erase_end = arg;
+    resp[0] = sim_sdc_r1(sdcp, 0U);
+    return HAL_SUCCESS;
+  case MMCSD_CMD_ERASE:
+    if (sdcp->config->read_only) {
+      resp[0] = sim_sdc_r1(sdcp, R1_WP_VIOLATION);
+      return HAL_SUCCESS;
+    }
+    if ((sdcp->erase_start > sdcp->erase_end) ||
+        (sdcp->erase_end >= sdcp->blocks)) {
+      resp[0] = sim_sdc_r1(sdcp, R1_OUT_OF_RANGE);
+      return HAL_SUCCESS;
+    }
+    resp[0] = sim_sdc_r1(sdcp, 0U);
+    sdcp->stats.erases++;
+    sdcp->stats.blocks_erased += sdcp->erase_end - sdcp->erase_start + 1U;
+    if (sim_sdc_erase(sdcp, sdcp->erase_start,
+                      sdcp->erase_end - sdcp->erase_start + 1U)) {
+      sdcp->errors |= SDC_UNHANDLED_ERROR;
+      return HAL_FAILED;
+    }
+    sim_sdc_spend(sdcp, sdcp->config->write_latency_us);
+    return HAL_SUCCESS;
+  default:
+    break;
+  }
+
+  /* Illegal commands are not answered.*/
+  sdcp->errors |= SDC_COMMAND_TIMEOUT;
+  return HAL_FAILED;
+}
+
+/*
+ * Common checks before a data transfer.
+ */
+static bool sim_sdc_check_transfer(SDCDriver *sdcp,
+                                   uint32_t startblk, uint32_t n) {
+
+  if (!sim_sdc_is_present(sdcp) || (sdcp->card_state != MMCSD_STS_TRAN)) {
+    sdcp->errors |= SDC_COMMAND_TIMEOUT;
+    return HAL_FAILED;
+  }
+  if ((startblk >= sdcp->blocks) || (n > sdcp->blocks - startblk)) {
+    sdcp->errors |= SDC_OVERFLOW_ERROR;
+    return HAL_FAILED;
+  }
+  sdcp->stats.commands++;
+
+  return HAL_SUCCESS;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Inserts or removes the simulated card.
+ * @note    A removed card loses its state, it must be connected again
+ *          after being inserted.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] inserted  the new card state
+ *
+ * @api
+ */
+void sdcSimSetInserted(SDCDriver *sdcp, bool inserted) {
+
+  osalDbgCheck(sdcp != NULL);
+
+  osalSysLock();
+  sdcp->inserted = inserted;
+  if (!inserted) {
+    sdcp->card_state = MMCSD_STS_IDLE;
+    sdcp->app_cmd    = false;
+  }
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Returns the operations statistics.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[out] statsp   pointer to the statistics structure to be filled
+ *
+ * @api
+ */
+void sdcSimGetStats(SDCDriver *sdcp, sim_sdc_stats_t *statsp) {
+
+  osalDbgCheck((sdcp != NULL) && (statsp != NULL));
+
+  osalSysLock();
+  *statsp = sdcp->stats;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Clears the operations statistics.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ *
+ * @api
+ */
+void sdcSimResetStats(SDCDriver *sdcp) {
+
+  osalDbgCheck(sdcp != NULL);
+
+  osalSysLock();
+  memset(&sdcp->stats, 0, sizeof sdcp->stats);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Low level SDC driver initialization.
+ *
+ * @notapi
+ */
+void sdc_lld_init(void) {
+
+  sdcObjectInit(&SDCD1);
+  SDCD1.memory    = NULL;
+  SDCD1.fd        = -1;
+  SDCD1.blocks    = 0U;
+  SDCD1.inserted  = true;
+  SDCD1.busy_debt = 0U;
+  memset(&SDCD1.stats, 0, sizeof SDCD1.stats);
+}
+
+/**
+ * @brief   Configures and activates the SDC peripheral.
+ * @note    Without a configuration a RAM image of
+ *          @p SIM_SDC_DEFAULT_BLOCKS blocks is used. The image content
+ *          is lost when the driver is stopped unless it is a file.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @return              The operation status.
+ * @retval HAL_RET_SUCCESS      if the driver has been started.
+ * @retval HAL_RET_NO_RESOURCE  if the RAM image cannot be allocated.
+ * @retval HAL_RET_HW_FAILURE   if the image file cannot be used.
+ *
+ * @notapi
+ */
+msg_t sdc_lld_start(SDCDriver *sdcp) {
+  const SDCConfig *config;
+  uint32_t blocks;
+
+  if (sdcp->config == NULL) {
+    sdcp->config = &sdc_default_cfg;
+  }
+  config = sdcp->config;
+
+  /* A restart with a new configuration reopens the image.*/
+  sim_sdc_close(sdcp);
+
+  if (config->path != NULL) {
+    struct stat st;
+    int fd;
+
+    fd = open(config->path, config->read_only ? O_RDONLY : O_RDWR | O_CREAT,
+              0644);
+    if (fd < 0) {
+      return HAL_RET_HW_FAILURE;
+    }
+    if (fstat(fd, &st) < 0) {
+      (void) close(fd);
+      return HAL_RET_HW_FAILURE;
+    }
+
+    /* A new file gets the configured size.*/
+    if ((st.st_size == 0) && !config->read_only) {
+      if (ftruncate(fd, (off_t)config->blocks * MMCSD_BLOCK_SIZE) < 0) {
+        (void) close(fd);
+        return HAL_RET_HW_FAILURE;
+      }
+      st.st_size = (off_t)config->blocks * MMCSD_BLOCK_SIZE;
+    }
+    blocks = (uint32_t)(st.st_size / MMCSD_BLOCK_SIZE);
+    sdcp->fd = fd;
+  }
+  else {
+    blocks = config->blocks;
+    sdcp->memory = calloc(blocks, MMCSD_BLOCK_SIZE);
+    if (sdcp->memory == NULL) {
+      return HAL_RET_NO_RESOURCE;
+    }
+  }
+
+  /* The capacity must be representable in the CSD.*/
+  sdcp->blocks = blocks - (blocks % SIM_SDC_CAPACITY_UNIT);
+  if (sdcp->blocks == 0U) {
+    sim_sdc_close(sdcp);
+    return HAL_RET_HW_FAILURE;
+  }
+
+  sdcp->card_state = MMCSD_STS_IDLE;
+  sdcp->app_cmd    = false;
+  sdcp->clk        = SDC_CLK_25MHz;
+  sdcp->bus        = SDC_MODE_1BIT;
+  sdcp->busy_debt  = 0U;
+
+  return HAL_RET_SUCCESS;
+}
+
+/**
+ * @brief   Deactivates the SDC peripheral.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ *
+ * @notapi
+ */
+void sdc_lld_stop(SDCDriver *sdcp) {
+
+  sim_sdc_close(sdcp);
+}
+
+/**
+ * @brief   Starts the SDIO clock and sets it to init mode (400kHz or less).
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ *
+ * @notapi
+ */
+void sdc_lld_start_clk(SDCDriver *sdcp) {
+
+  sdcp->clk = SDC_CLK_25MHz;
+  sdcp->bus = SDC_MODE_1BIT;
+}
+
+/**
+ * @brief   Sets the SDIO clock to data mode (25/50 MHz or less).
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] clk       the clock mode
+ *
+ * @notapi
+ */
+void sdc_lld_set_data_clk(SDCDriver *sdcp, sdcbusclk_t clk) {
+
+  sdcp->clk = clk;
+}
+
+/**
+ * @brief   Stops the SDIO clock.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ *
+ * @notapi
+ */
+void sdc_lld_stop_clk(SDCDriver *sdcp) {
+
+  (void)sdcp;
+}
+
+/**
+ * @brief   Switches the bus to 4 bits mode.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] mode      bus mode
+ *
+ * @notapi
+ */
+void sdc_lld_set_bus_mode(SDCDriver *sdcp, sdcbusmode_t mode) {
+
+  sdcp->bus = mode;
+}
+
+/**
+ * @brief   Sends an SDIO command with no response expected.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] cmd       card command
+ * @param[in] arg       command argument
+ *
+ * @notapi
+ */
+void sdc_lld_send_cmd_none(SDCDriver *sdcp, uint8_t cmd, uint32_t arg) {
+  uint32_t resp[4];
+
+  (void) sim_sdc_command(sdcp, cmd, arg, resp);
+}
+
+/**
+ * @brief   Sends an SDIO command with a short response expected.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] cmd       card command
+ * @param[in] arg       command argument
+ * @param[out] resp     pointer to the response buffer (one word)
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @notapi
+ */
+bool sdc_lld_send_cmd_short(SDCDriver *sdcp, uint8_t cmd, uint32_t arg,
+                            uint32_t *resp) {
+  uint32_t r[4];
+
+  if (sim_sdc_command(sdcp, cmd, arg, r)) {
+    return HAL_FAILED;
+  }
+  *resp = r[0];
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Sends an SDIO command with a short response expected and CRC.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] cmd       card command
+ * @param[in] arg       command argument
+ * @param[out] resp     pointer to the response buffer (one word)
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @notapi
+ */
+bool sdc_lld_send_cmd_short_crc(SDCDriver *sdcp, uint8_t cmd, uint32_t arg,
+                                uint32_t *resp) {
+
+  return sdc_lld_send_cmd_short(sdcp, cmd, arg, resp);
+}
+
+/**
+ * @brief   Sends an SDIO command with a long response expected and CRC.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] cmd       card command
+ * @param[in] arg       command argument
+ * @param[out] resp     pointer to the response buffer (four words)
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @notapi
+ */
+bool sdc_lld_send_cmd_long_crc(SDCDriver *sdcp, uint8_t cmd, uint32_t arg,
+                               uint32_t *resp) {
+
+  return sim_sdc_command(sdcp, cmd, arg, resp);
+}
+
+/**
+ * @brief   Reads special registers using data bus.
+ * @details Only the SD switch function status is supported, the card
+ *          supports the high speed mode.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[out] buf      pointer to the read buffer
+ * @param[in] bytes     number of bytes to read
+ * @param[in] cmd       card command
+ * @param[in] arg       argument for command
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @notapi
+ */
+bool sdc_lld_read_special(SDCDriver *sdcp, uint8_t *buf, size_t bytes,
+                          uint8_t cmd, uint32_t arg) {
+  uint8_t status[64];
+  uint32_t speed;
+
+  if ((cmd != MMCSD_CMD_SWITCH) || (bytes > sizeof status) ||
+      sim_sdc_check_transfer(sdcp, 0U, 1U)) {
+    sdcp->errors |= SDC_COMMAND_TIMEOUT;
+    return HAL_FAILED;
+  }
+
+  /* Access mode group, default and high speed functions supported.*/
+  memset(status, 0, sizeof status);
+  status[1]  = 100U;
+  status[13] = 0x03U;
+
+  /* Function selected or requested in the access mode group.*/
+  speed = arg & 0xFU;
+  if (speed == 0xFU) {
+    speed = sdcp->clk == SDC_CLK_50MHz ? 1U : 0U;
+  }
+  else if (speed > 1U) {
+    speed = 0xFU;
+  }
+  status[16] = (uint8_t)speed;
+  memcpy(buf, status, bytes);
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Reads one or more blocks.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] startblk  first block to read
+ * @param[out] buf      pointer to the read buffer
+ * @param[in] n         number of blocks to read
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @notapi
+ */
+bool sdc_lld_read(SDCDriver *sdcp, uint32_t startblk,
+                  uint8_t *buf, uint32_t n) {
+
+  if (sim_sdc_check_transfer(sdcp, startblk, n)) {
+    return HAL_FAILED;
+  }
+
+  if (sim_sdc_io(sdcp, false, startblk, buf, n)) {
+    sdcp->errors |= SDC_UNHANDLED_ERROR;
+    return HAL_FAILED;
+  }
+  sdcp->stats.reads++;
+  sdcp->stats.blocks_read += n;
+  sim_sdc_spend(sdcp, sim_sdc_transfer_time(sdcp,
+                                            sdcp->config->read_latency_us,
+                                            sdcp->config->read_kbps, n));
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Writes one or more blocks.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] startblk  first block to write
+ * @param[out] buf      pointer to the write buffer
+ * @param[in] n         number of blocks to write
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @notapi
+ */
+bool sdc_lld_write(SDCDriver *sdcp, uint32_t startblk,
+                   const uint8_t *buf, uint32_t n) {
+
+  if (sim_sdc_check_transfer(sdcp, startblk, n)) {
+    return HAL_FAILED;
+  }
+
+  if (sdcp->config->read_only ||
+      sim_sdc_io(sdcp, true, startblk, (uint8_t *)buf, n)) {
+    sdcp->errors |= SDC_UNHANDLED_ERROR;
+    return HAL_FAILED;
+  }
+  sdcp->stats.writes++;
+  sdcp->stats.blocks_written += n;
+  sim_sdc_spend(sdcp, sim_sdc_transfer_time(sdcp,
+                                            sdcp->config->write_latency_us,
+                                            sdcp->config->write_kbps, n));
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Waits for card idle condition.
+ * @note    Writes are performed synchronously, data is in the image
+ *          already.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  the operation succeeded.
+ * @retval HAL_FAILED   the operation failed.
+ *
+ * @api
+ */
+bool sdc_lld_sync(SDCDriver *sdcp) {
+
+  (void)sdcp;
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Card detect.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @return              The card state.
+ * @retval false        card not inserted.
+ * @retval true         card inserted.
+ *
+ * @api
+ */
+bool sdc_lld_is_card_inserted(SDCDriver *sdcp) {
+
+  return sim_sdc_is_present(sdcp);
+}
+
+/**
+ * @brief   Write protect detection.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @return              The write protect state.
+ * @retval false        not write protected.
+ * @retval true         write protected.
+ *
+ * @api
+ */
+bool sdc_lld_is_write_protected(SDCDriver *sdcp) {
+
+  return (sdcp->config != NULL) && sdcp->config->read_only;
+}
+
+#endif /* HAL_USE_SDC == TRUE */
+
+/** @} */
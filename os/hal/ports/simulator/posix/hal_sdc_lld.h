@@ -0,0 +1,317 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_sdc_lld.h
+ * @brief   Posix simulator simulated SD card driver header.
+ *
+ * @addtogroup POSIX_SDC
+ * @{
+ */
+
+#ifndef HAL_SDC_LLD_H
+#define HAL_SDC_LLD_H
+
+#if (HAL_USE_SDC == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   The LLD start function returns a status.
+ */
+#define SDC_LLD_ENHANCED_API
+
+/**
+ * @brief   Card capacity granularity in blocks.
+ * @note    This is the granularity of the C_SIZE field in a version 2.0
+ *          CSD, image sizes are rounded down to a multiple of this value.
+ */
+#define SIM_SDC_CAPACITY_UNIT               1024U
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Posix simulator SD card configuration options
+ * @{
+ */
+/**
+ * @brief   Image size in blocks when the driver is started without a
+ *          configuration.
+ */
+#if !defined(SIM_SDC_DEFAULT_BLOCKS) || defined(__DOXYGEN__)
+#define SIM_SDC_DEFAULT_BLOCKS              8192U
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (SIM_SDC_DEFAULT_BLOCKS % SIM_SDC_CAPACITY_UNIT) != 0
+#error "SIM_SDC_DEFAULT_BLOCKS must be a multiple of SIM_SDC_CAPACITY_UNIT"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of card flags.
+ */
+typedef uint32_t sdcmode_t;
+
+/**
+ * @brief   SDC Driver condition flags type.
+ */
+typedef uint32_t sdcflags_t;
+
+/**
+ * @brief   Type of a structure representing an SDC driver.
+ */
+typedef struct SDCDriver SDCDriver;
+
+/**
+ * @brief   Simulated card operations statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Number of commands, a data transfer counts as one command.
+   */
+  uint32_t                  commands;
+  /**
+   * @brief   Number of read transfers.
+   */
+  uint32_t                  reads;
+  /**
+   * @brief   Number of write transfers.
+   */
+  uint32_t                  writes;
+  /**
+   * @brief   Number of erase operations.
+   */
+  uint32_t                  erases;
+  /**
+   * @brief   Number of blocks read.
+   */
+  uint32_t                  blocks_read;
+  /**
+   * @brief   Number of blocks written.
+   */
+  uint32_t                  blocks_written;
+  /**
+   * @brief   Number of blocks erased.
+   */
+  uint32_t                  blocks_erased;
+  /**
+   * @brief   Simulated busy time in milliseconds.
+   */
+  uint32_t                  busy_ms;
+} sim_sdc_stats_t;
+
+/**
+ * @brief   Driver configuration structure.
+ * @note    Transfers take the access latency plus the time required for
+ *          moving the data at the lowest between the card bandwidth and
+ *          the bus bandwidth, the bus bandwidth depends on the negotiated
+ *          clock and bus width.
+ */
+typedef struct {
+  /**
+   * @brief   Bus width.
+   */
+  sdcbusmode_t              bus_width;
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Image file path, @p NULL for an image in RAM.
+   * @note    A new file is created with a size of @p blocks, an existing
+   *          file keeps its size.
+   */
+  const char                *path;
+  /**
+   * @brief   Image size in blocks for a RAM image or a new file.
+   */
+  uint32_t                  blocks;
+  /**
+   * @brief   The card is write protected.
+   */
+  bool                      read_only;
+  /**
+   * @brief   Read access latency in microseconds.
+   */
+  uint32_t                  read_latency_us;
+  /**
+   * @brief   Write and erase latency in microseconds.
+   */
+  uint32_t                  write_latency_us;
+  /**
+   * @brief   Card read bandwidth in kB/s, zero for no limit.
+   */
+  uint32_t                  read_kbps;
+  /**
+   * @brief   Card write bandwidth in kB/s, zero for no limit.
+   */
+  uint32_t                  write_kbps;
+} SDCConfig;
+
+/**
+ * @brief   @p SDCDriver specific methods.
+ */
+#define _sdc_driver_methods                                                 \
+  _mmcsd_block_device_methods
+
+/**
+ * @extends MMCSDBlockDeviceVMT
+ *
+ * @brief   @p SDCDriver virtual methods table.
+ */
+struct SDCDriverVMT {
+  _sdc_driver_methods
+};
+
+/**
+ * @brief   Structure representing an SDC driver.
+ */
+struct SDCDriver {
+  /**
+   * @brief Virtual Methods Table.
+   */
+  const struct SDCDriverVMT *vmt;
+  _mmcsd_block_device_data
+  /**
+   * @brief Current configuration data.
+   */
+  const SDCConfig           *config;
+  /**
+   * @brief Various flags regarding the mounted card.
+   */
+  sdcmode_t                 cardmode;
+  /**
+   * @brief Errors flags.
+   */
+  sdcflags_t                errors;
+  /**
+   * @brief Card RCA.
+   */
+  uint32_t                  rca;
+  /**
+   * @brief   Buffer for internal operations.
+   */
+  uint8_t                   buf[MMCSD_BLOCK_SIZE];
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   RAM image or @p NULL if the image is a file.
+   */
+  uint8_t                   *memory;
+  /**
+   * @brief   Image file descriptor or -1.
+   */
+  int                       fd;
+  /**
+   * @brief   Card capacity in blocks.
+   */
+  uint32_t                  blocks;
+  /**
+   * @brief   Card inserted in the simulated slot.
+   */
+  bool                      inserted;
+  /**
+   * @brief   Card state as reported in R1 responses.
+   */
+  uint32_t                  card_state;
+  /**
+   * @brief   Next command is an application command.
+   */
+  bool                      app_cmd;
+  /**
+   * @brief   First block of the erase range.
+   */
+  uint32_t                  erase_start;
+  /**
+   * @brief   Last block of the erase range.
+   */
+  uint32_t                  erase_end;
+  /**
+   * @brief   Current data clock.
+   */
+  sdcbusclk_t               clk;
+  /**
+   * @brief   Current bus width.
+   */
+  sdcbusmode_t              bus;
+  /**
+   * @brief   Busy time not yet spent, in microseconds.
+   */
+  uint32_t                  busy_debt;
+  /**
+   * @brief   Operations statistics.
+   */
+  sim_sdc_stats_t           stats;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if !defined(__DOXYGEN__)
+extern SDCDriver SDCD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void sdcSimSetInserted(SDCDriver *sdcp, bool inserted);
+  void sdcSimGetStats(SDCDriver *sdcp, sim_sdc_stats_t *statsp);
+  void sdcSimResetStats(SDCDriver *sdcp);
+  void sdc_lld_init(void);
+  msg_t sdc_lld_start(SDCDriver *sdcp);
+  void sdc_lld_stop(SDCDriver *sdcp);
+  void sdc_lld_start_clk(SDCDriver *sdcp);
+  void sdc_lld_set_data_clk(SDCDriver *sdcp, sdcbusclk_t clk);
+  void sdc_lld_stop_clk(SDCDriver *sdcp);
+  void sdc_lld_set_bus_mode(SDCDriver *sdcp, sdcbusmode_t mode);
+  void sdc_lld_send_cmd_none(SDCDriver *sdcp, uint8_t cmd, uint32_t arg);
+  bool sdc_lld_send_cmd_short(SDCDriver *sdcp, uint8_t cmd, uint32_t arg,
+                              uint32_t *resp);
+  bool sdc_lld_send_cmd_short_crc(SDCDriver *sdcp, uint8_t cmd, uint32_t arg,
+                                  uint32_t *resp);
+  bool sdc_lld_send_cmd_long_crc(SDCDriver *sdcp, uint8_t cmd, uint32_t arg,
+                                 uint32_t *resp);
+  bool sdc_lld_read_special(SDCDriver *sdcp, uint8_t *buf, size_t bytes,
+                            uint8_t cmd, uint32_t argument);
+  bool sdc_lld_read(SDCDriver *sdcp, uint32_t startblk,
+                    uint8_t *buf, uint32_t n);
+  bool sdc_lld_write(SDCDriver *sdcp, uint32_t startblk,
+                     const uint8_t *buf, uint32_t n);
+  bool sdc_lld_sync(SDCDriver *sdcp);
+  bool sdc_lld_is_card_inserted(SDCDriver *sdcp);
+  bool sdc_lld_is_write_protected(SDCDriver *sdcp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_SDC == TRUE */
+
+#endif /* HAL_SDC_LLD_H */
+
+/** @} */
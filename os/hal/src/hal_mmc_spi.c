@@ -55,6 +55,7 @@ static bool mmc_write(void *instance, uint32_t startblk,
                         const uint8_t *buffer, uint32_t n);
 static bool mmc_sync(void *instance);
 static bool mmc_get_info(void *instance, BlockDeviceInfo *bdip);
+static bool mmc_discard(void *instance, uint32_t startblk, uint32_t n);
 
 /**
  * @brief   Virtual methods table.
@@ -68,7 +69,8 @@ static const struct mmc_spi_driver_vmt mmc_vmt = {
   mmc_read,
   mmc_write,
   mmc_sync,
-  mmc_get_info
+  mmc_get_info,
+  mmc_discard
 };
 
 /**
@@ -253,6 +255,23 @@ static bool mmc_get_info(void *instance, BlockDeviceInfo *bdip) {
   return err;
 }
 
+static bool mmc_discard(void *instance, uint32_t startblk, uint32_t n) {
+  MMCDriver *mmcp = (MMCDriver *)instance;
+  bool err;
+
+#if MMC_USE_MUTUAL_EXCLUSION == TRUE
+  spiAcquireBus(mmcp->config->spip);
+#endif
+
+  err = mmcErase(mmcp, startblk, startblk + n - 1U);
+
+#if MMC_USE_MUTUAL_EXCLUSION == TRUE
+  spiReleaseBus(mmcp->config->spip);
+#endif
+
+  return err;
+}
+
 /**
  * @brief Calculate the MMC standard CRC-7 based on a lookup table.
  *
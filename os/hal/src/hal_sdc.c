@@ -68,6 +68,8 @@ typedef enum {
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
+static bool sdc_discard(void *instance, uint32_t startblk, uint32_t n);
+
 /**
  * @brief   Virtual methods table.
  */
@@ -80,12 +82,19 @@ static const struct SDCDriverVMT sdc_vmt = {
   (bool (*)(void *, uint32_t, uint8_t *, uint32_t))sdcRead,
   (bool (*)(void *, uint32_t, const uint8_t *, uint32_t))sdcWrite,
   (bool (*)(void *))sdcSync,
-  (bool (*)(void *, BlockDeviceInfo *))sdcGetInfo
+  (bool (*)(void *, BlockDeviceInfo *))sdcGetInfo,
+  sdc_discard
 };
 
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
+
+static bool sdc_discard(void *instance, uint32_t startblk, uint32_t n) {
+
+  return sdcErase((SDCDriver *)instance, startblk, startblk + n - 1U);
+}
+
 /**
  * @brief   Detects card mode.
  *
@@ -47,6 +47,18 @@
 #define CH_CFG_FACTORY_MAX_NAMES_LENGTH     8
 #endif
 
+/**
+ * @brief   Size of the names hash index of each objects list.
+ * @details If the specified size is zero then names lookups are performed
+ *          by scanning the whole list, else objects are distributed in
+ *          the specified number of chains by hashing their names.
+ * @note    Must be zero or a power of two.
+ * @note    Each list requires one pointer per chain.
+ */
+#if !defined(CH_CFG_FACTORY_HASH_SIZE) || defined(__DOXYGEN__)
+#define CH_CFG_FACTORY_HASH_SIZE            0
+#endif
+
 /**
  * @brief   Enables the registry of generic objects.
  */
@@ -143,6 +155,20 @@
 #error "invalid CH_CFG_FACTORY_MAX_NAMES_LENGTH value"
 #endif
 
+#if (CH_CFG_FACTORY_HASH_SIZE < 0) ||                                       \
+    ((CH_CFG_FACTORY_HASH_SIZE & (CH_CFG_FACTORY_HASH_SIZE - 1)) != 0)
+#error "CH_CFG_FACTORY_HASH_SIZE must be zero or a power of two"
+#endif
+
+/**
+ * @brief   Number of chains in each objects list.
+ */
+#if (CH_CFG_FACTORY_HASH_SIZE > 0) || defined(__DOXYGEN__)
+#define CH_FACTORY_CHAINS                   CH_CFG_FACTORY_HASH_SIZE
+#else
+#define CH_FACTORY_CHAINS                   1
+#endif
+
 #if (CH_CFG_USE_MUTEXES == FALSE) && (CH_CFG_USE_SEMAPHORES == FALSE)
 #error "CH_CFG_USE_FACTORY requires CH_CFG_USE_MUTEXES and/or CH_CFG_USE_SEMAPHORES"
 #endif
@@ -182,11 +208,23 @@ typedef struct ch_dyn_element {
 #endif
 } dyn_element_t;
 
+/**
+ * @brief   Type of a dynamic objects chain.
+ */
+typedef struct ch_dyn_chain {
+  /**
+   * @brief   First dynamic object in the chain.
+   */
+  dyn_element_t         *next;
+} dyn_chain_t;
+
 /**
  * @brief   Type of a dynamic object list.
+ * @note    Objects are distributed among the chains by hashing their
+ *          names, there is a single chain if the hash index is disabled.
  */
 typedef struct ch_dyn_list {
-    dyn_element_t       *next;
+  dyn_chain_t           chains[CH_FACTORY_CHAINS];
 } dyn_list_t;
 
 #if (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) || defined(__DOXYGEN__)
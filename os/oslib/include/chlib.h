@@ -124,6 +124,12 @@
 #error "CH_CFG_USE_JOBS not defined in chconf.h"
 #endif
 
+/* Message ports are optional, configurations not mentioning them keep
+   them disabled.*/
+#if !defined(CH_CFG_USE_MSG_PORTS)
+#define CH_CFG_USE_MSG_PORTS                FALSE
+#endif
+
 /* Objects factory options checks.*/
 #if !defined(CH_CFG_USE_FACTORY)
 #error "CH_CFG_USE_FACTORY not defined in chconf.h"
@@ -190,6 +196,7 @@
 #undef CH_CFG_USE_OBJ_CACHES
 #undef CH_CFG_USE_DELEGATES
 #undef CH_CFG_USE_JOBS
+#undef CH_CFG_USE_MSG_PORTS
 
 #define CH_CFG_USE_HEAP                     FALSE
 #define CH_CFG_USE_MEMPOOLS                 FALSE
@@ -198,6 +205,7 @@
 #define CH_CFG_USE_OBJ_CACHES               FALSE
 #define CH_CFG_USE_DELEGATES                FALSE
 #define CH_CFG_USE_JOBS                     FALSE
+#define CH_CFG_USE_MSG_PORTS                FALSE
 
 #endif /* (CH_CUSTOMER_LIC_OSLIB == FALSE) ||
           (CH_LICENSE_FEATURES == CH_FEATURES_BASIC) */
@@ -242,6 +250,7 @@
 #include "chobjcaches.h"
 #include "chdelegates.h"
 #include "chjobs.h"
+#include "chmsgports.h"
 #include "chfactory.h"
 
 /*===========================================================================*/
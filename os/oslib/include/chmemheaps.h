@@ -160,6 +160,7 @@ extern "C" {
   void chHeapObjectDispose(memory_heap_t *heapp);
   void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align);
   void chHeapFree(void *p);
+  void *chHeapRealloc(void *p, size_t size);
   size_t chHeapStatus(memory_heap_t *heapp, size_t *totalp, size_t *largestp);
   bool chHeapIntegrityCheck(memory_heap_t *heapp);
 #ifdef __cplusplus
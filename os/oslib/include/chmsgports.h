@@ -0,0 +1,286 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    oslib/include/chmsgports.h
+ * @brief   Message ports macros and structures.
+ *
+ * @addtogroup oslib_msg_ports
+ * @{
+ */
+
+#ifndef CHMSGPORTS_H
+#define CHMSGPORTS_H
+
+#if (CH_CFG_USE_MSG_PORTS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a message port.
+ */
+typedef struct ch_msg_port msg_port_t;
+
+/**
+ * @brief   Structure representing a message slot header.
+ * @details Each slot in a message port ring starts with this header, the
+ *          optional inline payload immediately follows it.
+ */
+typedef struct {
+  msg_port_t            *reply;         /**< @brief Reply port or @p NULL.  */
+  msg_t                 msg;            /**< @brief Pointer-sized payload.  */
+  size_t                size;           /**< @brief Inline payload size.    */
+} msg_port_slot_t;
+
+/**
+ * @brief   Structure representing a message port object.
+ */
+struct ch_msg_port {
+  uint8_t               *buffer;        /**< @brief Pointer to the slots
+                                                    buffer base.            */
+  uint8_t               *top;           /**< @brief Pointer to the location
+                                                    after the buffer.       */
+  uint8_t               *wrptr;         /**< @brief Write pointer.          */
+  uint8_t               *rdptr;         /**< @brief Read pointer.           */
+  size_t                slotsize;       /**< @brief Size of a whole slot.   */
+  size_t                cnt;            /**< @brief Posted messages not yet
+                                                    fetched.                */
+  size_t                held;           /**< @brief Fetched messages not yet
+                                                    released.               */
+  bool                  reset;          /**< @brief True in reset state.    */
+  threads_queue_t       qw;             /**< @brief Queued writers.         */
+  threads_queue_t       qr;             /**< @brief Queued readers.         */
+};
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of a message port slot.
+ *
+ * @param[in] size      maximum size of the inline payload, can be zero
+ */
+#define MSG_PORT_SLOT_SIZE(size)                                            \
+  MEM_ALIGN_NEXT(sizeof (msg_port_slot_t) + (size_t)(size),                 \
+                 PORT_NATURAL_ALIGN)
+
+/**
+ * @brief   Size of a message port buffer.
+ *
+ * @param[in] size      maximum size of the inline payload, can be zero
+ * @param[in] n         number of slots in the port
+ */
+#define MSG_PORT_BUFFER_SIZE(size, n)                                       \
+  (MSG_PORT_SLOT_SIZE(size) * (size_t)(n))
+
+/**
+ * @brief   Data part of a static message port initializer.
+ * @details This macro should be used when statically initializing a
+ *          message port that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the message port variable
+ * @param[in] buffer    pointer to the port buffer, it must be aligned to
+ *                      @p PORT_NATURAL_ALIGN and have a size of at least
+ *                      @p MSG_PORT_BUFFER_SIZE(size, n) bytes
+ * @param[in] size      maximum size of the inline payload
+ * @param[in] n         number of slots in the port
+ */
+#define __MSG_PORT_DATA(name, buffer, size, n) {                            \
+  (uint8_t *)(buffer),                                                      \
+  (uint8_t *)(buffer) + MSG_PORT_BUFFER_SIZE(size, n),                      \
+  (uint8_t *)(buffer),                                                      \
+  (uint8_t *)(buffer),                                                      \
+  MSG_PORT_SLOT_SIZE(size),                                                 \
+  (size_t)0,                                                                \
+  (size_t)0,                                                                \
+  false,                                                                    \
+  __THREADS_QUEUE_DATA(name.qw),                                            \
+  __THREADS_QUEUE_DATA(name.qr),                                            \
+}
+
+/**
+ * @brief   Static message port initializer.
+ * @details Statically initialized message ports require no explicit
+ *          initialization using @p chMsgPortObjectInit().
+ *
+ * @param[in] name      the name of the message port variable
+ * @param[in] buffer    pointer to the port buffer, it must be aligned to
+ *                      @p PORT_NATURAL_ALIGN and have a size of at least
+ *                      @p MSG_PORT_BUFFER_SIZE(size, n) bytes
+ * @param[in] size      maximum size of the inline payload
+ * @param[in] n         number of slots in the port
+ */
+#define MSG_PORT_DECL(name, buffer, size, n)                                \
+  msg_port_t name = __MSG_PORT_DATA(name, buffer, size, n)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chMsgPortObjectInit(msg_port_t *mpp, void *buf, size_t size, size_t n);
+  void chMsgPortObjectDispose(msg_port_t *mpp);
+  void chMsgPortReset(msg_port_t *mpp);
+  void chMsgPortResetI(msg_port_t *mpp);
+  msg_t chMsgPortPostTimeout(msg_port_t *mpp, msg_t msg,
+                             const void *data, size_t size,
+                             msg_port_t *rpp, sysinterval_t timeout);
+  msg_t chMsgPortPostTimeoutS(msg_port_t *mpp, msg_t msg,
+                              const void *data, size_t size,
+                              msg_port_t *rpp, sysinterval_t timeout);
+  msg_t chMsgPortPostI(msg_port_t *mpp, msg_t msg,
+                       const void *data, size_t size,
+                       msg_port_t *rpp);
+  msg_t chMsgPortFetchTimeout(msg_port_t *mpp, msg_port_slot_t **slotpp,
+                              sysinterval_t timeout);
+  msg_t chMsgPortFetchTimeoutS(msg_port_t *mpp, msg_port_slot_t **slotpp,
+                               sysinterval_t timeout);
+  msg_t chMsgPortFetchI(msg_port_t *mpp, msg_port_slot_t **slotpp);
+  size_t chMsgPortFetchBatchTimeout(msg_port_t *mpp, msg_port_slot_t **slots,
+                                    size_t n, sysinterval_t timeout);
+  size_t chMsgPortFetchBatchTimeoutS(msg_port_t *mpp, msg_port_slot_t **slots,
+                                     size_t n, sysinterval_t timeout);
+  size_t chMsgPortFetchBatchI(msg_port_t *mpp, msg_port_slot_t **slots,
+                              size_t n);
+  void chMsgPortRelease(msg_port_t *mpp, size_t n);
+  void chMsgPortReleaseI(msg_port_t *mpp, size_t n);
+  msg_t chMsgPortReply(const msg_port_slot_t *slotp, msg_t msg);
+  msg_t chMsgPortReplyI(const msg_port_slot_t *slotp, msg_t msg);
+  size_t chMsgPortReplyBatch(msg_port_t *mpp, msg_port_slot_t **slots,
+                             const msg_t *msgs, size_t n);
+  msg_t chMsgPortCall(msg_port_t *mpp, msg_port_t *rpp, msg_t msg,
+                      msg_t *rmsgp, sysinterval_t timeout);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the message port size as number of slots.
+ *
+ * @param[in] mpp       the pointer to an initialized @p msg_port_t object
+ * @return              The number of slots in the port.
+ *
+ * @xclass
+ */
+static inline size_t chMsgPortGetSizeX(const msg_port_t *mpp) {
+
+  /*lint -save -e9033 [10.8] Perfectly safe pointers
+    arithmetic.*/
+  return (size_t)(mpp->top - mpp->buffer) / mpp->slotsize;
+  /*lint -restore*/
+}
+
+/**
+ * @brief   Returns the maximum size of the inline payload.
+ *
+ * @param[in] mpp       the pointer to an initialized @p msg_port_t object
+ * @return              The inline payload capacity of a slot.
+ *
+ * @xclass
+ */
+static inline size_t chMsgPortGetDataSizeX(const msg_port_t *mpp) {
+
+  return mpp->slotsize - sizeof (msg_port_slot_t);
+}
+
+/**
+ * @brief   Returns the number of posted messages not yet fetched.
+ *
+ * @param[in] mpp       the pointer to an initialized @p msg_port_t object
+ * @return              The number of queued messages.
+ *
+ * @iclass
+ */
+static inline size_t chMsgPortGetUsedCountI(const msg_port_t *mpp) {
+
+  chDbgCheckClassI();
+
+  return mpp->cnt;
+}
+
+/**
+ * @brief   Returns the number of free slots into a message port.
+ * @note    Slots fetched but not yet released are not free.
+ *
+ * @param[in] mpp       the pointer to an initialized @p msg_port_t object
+ * @return              The number of empty slots.
+ *
+ * @iclass
+ */
+static inline size_t chMsgPortGetFreeCountI(const msg_port_t *mpp) {
+
+  chDbgCheckClassI();
+
+  return chMsgPortGetSizeX(mpp) - mpp->cnt - mpp->held;
+}
+
+/**
+ * @brief   Returns a pointer to the inline payload of a slot.
+ *
+ * @param[in] slotp     pointer to a fetched slot
+ * @return              Pointer to the inline payload area.
+ *
+ * @xclass
+ */
+static inline void *chMsgPortGetDataX(const msg_port_slot_t *slotp) {
+
+  /*lint -save -e9005 [11.8] Removing const is fine, the slot is owned
+    by the receiver until released.*/
+  return (void *)((uint8_t *)slotp + sizeof (msg_port_slot_t));
+  /*lint -restore*/
+}
+
+/**
+ * @brief   Terminates the reset state.
+ *
+ * @param[in] mpp       the pointer to an initialized @p msg_port_t object
+ *
+ * @xclass
+ */
+static inline void chMsgPortResumeX(msg_port_t *mpp) {
+
+  mpp->reset = false;
+}
+
+#endif /* CH_CFG_USE_MSG_PORTS == TRUE */
+
+#endif /* CHMSGPORTS_H */
+
+/** @} */
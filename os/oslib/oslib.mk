@@ -34,6 +34,9 @@ endif
 ifneq ($(findstring CH_CFG_USE_DELEGATES TRUE,$(CHLIBCONF)),)
 OSLIBSRC += $(CHIBIOS)/os/oslib/src/chdelegates.c
 endif
+ifneq ($(findstring CH_CFG_USE_MSG_PORTS TRUE,$(CHLIBCONF)),)
+OSLIBSRC += $(CHIBIOS)/os/oslib/src/chmsgports.c
+endif
 ifneq ($(findstring CH_CFG_USE_FACTORY TRUE,$(CHLIBCONF)),)
 OSLIBSRC += $(CHIBIOS)/os/oslib/src/chfactory.c
 endif
@@ -46,6 +49,7 @@ OSLIBSRC := $(CHIBIOS)/os/oslib/src/chmemchecks.c \
             $(CHIBIOS)/os/oslib/src/chpipes.c \
             $(CHIBIOS)/os/oslib/src/chobjcaches.c \
             $(CHIBIOS)/os/oslib/src/chdelegates.c \
+            $(CHIBIOS)/os/oslib/src/chmsgports.c \
             $(CHIBIOS)/os/oslib/src/chfactory.c
 endif
 
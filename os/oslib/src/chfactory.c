@@ -96,14 +96,44 @@ static void copy_name(const char *sp, char *dp) {
 }
 
 static inline void dyn_list_init(dyn_list_t *dlp) {
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)CH_FACTORY_CHAINS; i++) {
+    dlp->chains[i].next = (dyn_element_t *)&dlp->chains[i];
+  }
+}
+
+static dyn_chain_t *dyn_list_chain(const char *name, dyn_list_t *dlp) {
+#if CH_CFG_FACTORY_HASH_SIZE > 0
+  uint32_t hash = 2166136261U;
+#if CH_CFG_FACTORY_MAX_NAMES_LENGTH > 0
+  unsigned i = CH_CFG_FACTORY_MAX_NAMES_LENGTH;
+
+  /* FNV-1a over the stored part of the name, it must match the part
+     compared by dyn_chain_find().*/
+  while ((i > 0U) && (*name != (char)0)) {
+    hash = (hash ^ (uint32_t)(uint8_t)*name++) * 16777619U;
+    i--;
+  }
+#else
+  /* FNV-1a over the whole name.*/
+  while (*name != (char)0) {
+    hash = (hash ^ (uint32_t)(uint8_t)*name++) * 16777619U;
+  }
+#endif
+
+  return &dlp->chains[hash & ((uint32_t)CH_CFG_FACTORY_HASH_SIZE - 1U)];
+#else
+  (void)name;
 
-  dlp->next = (dyn_element_t *)dlp;
+  return &dlp->chains[0];
+#endif
 }
 
-static dyn_element_t *dyn_list_find(const char *name, dyn_list_t *dlp) {
-  dyn_element_t *p = dlp->next;
+static dyn_element_t *dyn_chain_find(const char *name, dyn_chain_t *dcp) {
+  dyn_element_t *p = dcp->next;
 
-  while (p != (dyn_element_t *)dlp) {
+  while (p != (dyn_element_t *)dcp) {
     if (strncmp(p->name, name, CH_CFG_FACTORY_MAX_NAMES_LENGTH) == 0) {
       return p;
     }
@@ -113,24 +143,30 @@ static dyn_element_t *dyn_list_find(const char *name, dyn_list_t *dlp) {
   return NULL;
 }
 
-static dyn_element_t *dyn_list_find_prev(dyn_element_t *element,
-                                      dyn_list_t *dlp) {
-  dyn_element_t *prev = (dyn_element_t *)dlp;
+static dyn_element_t *dyn_chain_find_prev(dyn_element_t *element,
+                                          dyn_chain_t *dcp) {
+  dyn_element_t *prev = (dyn_element_t *)dcp;
 
-  /* Scanning the list.*/
-  while (prev->next != (dyn_element_t *)dlp) {
+  /* Scanning the chain.*/
+  while (prev->next != (dyn_element_t *)dcp) {
     if (prev->next == element) {
       return prev;
     }
 
-    /* Next element in the list.*/
+    /* Next element in the chain.*/
     prev = prev->next;
   }
 
   return NULL;
 }
 
-static dyn_element_t *dyn_list_unlink(dyn_element_t *prev) {
+static void dyn_chain_insert(dyn_element_t *element, dyn_chain_t *dcp) {
+
+  element->next = dcp->next;
+  dcp->next = element;
+}
+
+static dyn_element_t *dyn_chain_unlink(dyn_element_t *prev) {
   dyn_element_t *element = prev->next;
 
   prev->next = element->next;
@@ -143,12 +179,14 @@ static dyn_element_t *dyn_create_object_heap(const char *name,
                                              dyn_list_t *dlp,
                                              size_t size,
                                              unsigned align) {
+  dyn_chain_t *dcp;
   dyn_element_t *dep;
 
   chDbgCheck(name != NULL);
 
   /* Checking if an object with this name has already been created.*/
-  dep = dyn_list_find(name, dlp);
+  dcp = dyn_list_chain(name, dlp);
+  dep = dyn_chain_find(name, dcp);
   if (dep != NULL) {
     return NULL;
   }
@@ -162,10 +200,9 @@ static dyn_element_t *dyn_create_object_heap(const char *name,
   /* Initializing object list element.*/
   copy_name(name, dep->name);
   dep->refs = (ucnt_t)1;
-  dep->next = dlp->next;
 
   /* Updating factory list.*/
-  dlp->next = dep;
+  dyn_chain_insert(dep, dcp);
 
   return dep;
 }
@@ -178,14 +215,14 @@ static ucnt_t dyn_release_object_heap(dyn_element_t *dep,
   chDbgCheck(dep != NULL);
 
   /* Checking 1st if the object is in the list.*/
-  prev = dyn_list_find_prev(dep, dlp);
+  prev = dyn_chain_find_prev(dep, dyn_list_chain(dep->name, dlp));
   if (prev != NULL) {
 
     chDbgAssert(dep->refs > (ucnt_t)0, "invalid references number");
 
     refs = --dep->refs;
     if (refs == (ucnt_t)0) {
-      chHeapFree((void *)dyn_list_unlink(prev));
+      chHeapFree((void *)dyn_chain_unlink(prev));
     }
   }
   else {
@@ -203,12 +240,14 @@ static ucnt_t dyn_release_object_heap(dyn_element_t *dep,
 static dyn_element_t *dyn_create_object_pool(const char *name,
                                              dyn_list_t *dlp,
                                              memory_pool_t *mp) {
+  dyn_chain_t *dcp;
   dyn_element_t *dep;
 
   chDbgCheck(name != NULL);
 
   /* Checking if an object object with this name has already been created.*/
-  dep = dyn_list_find(name, dlp);
+  dcp = dyn_list_chain(name, dlp);
+  dep = dyn_chain_find(name, dcp);
   if (dep != NULL) {
     return NULL;
   }
@@ -222,10 +261,9 @@ static dyn_element_t *dyn_create_object_pool(const char *name,
   /* Initializing object list element.*/
   copy_name(name, dep->name);
   dep->refs = (ucnt_t)1;
-  dep->next = dlp->next;
 
   /* Updating factory list.*/
-  dlp->next = (dyn_element_t *)dep;
+  dyn_chain_insert(dep, dcp);
 
   return dep;
 }
@@ -239,14 +277,14 @@ static ucnt_t dyn_release_object_pool(dyn_element_t *dep,
   chDbgCheck(dep != NULL);
 
   /* Checking 1st if the object is in the list.*/
-  prev = dyn_list_find_prev(dep, dlp);
+  prev = dyn_chain_find_prev(dep, dyn_list_chain(dep->name, dlp));
   if (prev != NULL) {
 
     chDbgAssert(dep->refs > (ucnt_t)0, "invalid references number");
 
     refs = --dep->refs;
     if (refs == (ucnt_t)0) {
-      chPoolFree(mp, (void *)dyn_list_unlink(prev));
+      chPoolFree(mp, (void *)dyn_chain_unlink(prev));
     }
   }
   else {
@@ -266,7 +304,7 @@ static dyn_element_t *dyn_find_object(const char *name, dyn_list_t *dlp) {
   chDbgCheck(name != NULL);
 
   /* Checking if an object with this name has already been created.*/
-  dep = dyn_list_find(name, dlp);
+  dep = dyn_chain_find(name, dyn_list_chain(name, dlp));
   if (dep != NULL) {
     /* Increasing references counter.*/
     dep->refs++;
@@ -391,19 +429,25 @@ registered_object_t *chFactoryFindObject(const char *name) {
  * @api
  */
 registered_object_t *chFactoryFindObjectByPointer(void *objp) {
-  registered_object_t *rop = (registered_object_t *)ch_factory.obj_list.next;
+  unsigned i;
 
   FACTORY_LOCK();
 
-  while ((void *)rop != (void *)&ch_factory.obj_list) {
-    if (rop->objp == objp) {
-      rop->element.refs++;
+  /* The pointer is not indexed, scanning all chains.*/
+  for (i = 0U; i < (unsigned)CH_FACTORY_CHAINS; i++) {
+    dyn_chain_t *dcp = &ch_factory.obj_list.chains[i];
+    registered_object_t *rop = (registered_object_t *)dcp->next;
+
+    while ((void *)rop != (void *)dcp) {
+      if (rop->objp == objp) {
+        rop->element.refs++;
 
-      FACTORY_UNLOCK();
+        FACTORY_UNLOCK();
 
-      return rop;
+        return rop;
+      }
+      rop = (registered_object_t *)rop->element.next;
     }
-    rop = (registered_object_t *)rop->element.next;
   }
 
   FACTORY_UNLOCK();
@@ -25,10 +25,11 @@
  * @details Heap Allocator related APIs.
  *          <h2>Operation mode</h2>
  *          The heap allocator implements a first-fit strategy and its APIs
- *          are functionally equivalent to the usual @p malloc() and @p free()
- *          library functions. The main difference is that the OS heap APIs
- *          are guaranteed to be thread safe and there is the ability to
- *          return memory blocks aligned to arbitrary powers of two.<br>
+ *          are functionally equivalent to the usual @p malloc(),
+ *          @p realloc() and @p free() library functions. The main
+ *          difference is that the OS heap APIs are guaranteed to be thread
+ *          safe and there is the ability to return memory blocks aligned to
+ *          arbitrary powers of two.<br>
  * @pre     In order to use the heap APIs the @p CH_CFG_USE_HEAP option must
  *          be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -99,6 +100,45 @@ static memory_heap_t default_heap;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Inserts a block in the free blocks list.
+ * @details The block is merged with the adjacent free blocks, if any.
+ * @note    The heap mutex must be taken.
+ *
+ * @param[in] heapp     pointer to the heap descriptor
+ * @param[in] hp        pointer to the block header, the size in pages must
+ *                      be already set
+ *
+ * @notapi
+ */
+static void heap_link(memory_heap_t *heapp, heap_header_t *hp) {
+  heap_header_t *qp = &heapp->header;
+
+  while (true) {
+    chDbgAssert((hp < qp) || (hp >= H_FREE_LIMIT(qp)), "within free block");
+
+    if (((qp == &heapp->header) || (hp > qp)) &&
+        ((H_FREE_NEXT(qp) == NULL) || (hp < H_FREE_NEXT(qp)))) {
+      /* Insertion after qp.*/
+      H_FREE_NEXT(hp) = H_FREE_NEXT(qp);
+      H_FREE_NEXT(qp) = hp;
+      /* Verifies if the newly inserted block should be merged.*/
+      if (H_FREE_LIMIT(hp) == H_FREE_NEXT(hp)) {
+        /* Merge with the next block.*/
+        H_FREE_PAGES(hp) += H_FREE_PAGES(H_FREE_NEXT(hp)) + 1U;
+        H_FREE_NEXT(hp) = H_FREE_NEXT(H_FREE_NEXT(hp));
+      }
+      if ((H_FREE_LIMIT(qp) == hp)) {
+        /* Merge with the previous block.*/
+        H_FREE_PAGES(qp) += H_FREE_PAGES(hp) + 1U;
+        H_FREE_NEXT(qp) = H_FREE_NEXT(hp);
+      }
+      break;
+    }
+    qp = H_FREE_NEXT(qp);
+  }
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -322,7 +362,7 @@ void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align) {
  * @api
  */
 void chHeapFree(void *p) {
-  heap_header_t *qp, *hp;
+  heap_header_t *hp;
   memory_heap_t *heapp;
 
   chDbgCheck((p != NULL) && MEM_IS_ALIGNED(p, CH_HEAP_ALIGNMENT));
@@ -331,7 +371,6 @@ void chHeapFree(void *p) {
   hp = (heap_header_t *)p - 1U;
   /*lint -restore*/
   heapp = H_USED_HEAP(hp);
-  qp = &heapp->header;
 
 #if CH_CFG_HARDENING_LEVEL > 0
   memset((void *)p, 0, MEM_ALIGN_NEXT(H_USED_SIZE(hp), CH_HEAP_ALIGNMENT));
@@ -344,34 +383,115 @@ void chHeapFree(void *p) {
   /* Taking heap mutex.*/
   H_LOCK(heapp);
 
-  while (true) {
-    chDbgAssert((hp < qp) || (hp >= H_FREE_LIMIT(qp)), "within free block");
+  /* Returning the block to the free blocks list.*/
+  heap_link(heapp, hp);
 
-    if (((qp == &heapp->header) || (hp > qp)) &&
-        ((H_FREE_NEXT(qp) == NULL) || (hp < H_FREE_NEXT(qp)))) {
-      /* Insertion after qp.*/
-      H_FREE_NEXT(hp) = H_FREE_NEXT(qp);
-      H_FREE_NEXT(qp) = hp;
-      /* Verifies if the newly inserted block should be merged.*/
-      if (H_FREE_LIMIT(hp) == H_FREE_NEXT(hp)) {
-        /* Merge with the next block.*/
-        H_FREE_PAGES(hp) += H_FREE_PAGES(H_FREE_NEXT(hp)) + 1U;
-        H_FREE_NEXT(hp) = H_FREE_NEXT(H_FREE_NEXT(hp));
-      }
-      if ((H_FREE_LIMIT(qp) == hp)) {
-        /* Merge with the previous block.*/
-        H_FREE_PAGES(qp) += H_FREE_PAGES(hp) + 1U;
-        H_FREE_NEXT(qp) = H_FREE_NEXT(hp);
+  /* Releasing heap mutex.*/
+  H_UNLOCK(heapp);
+
+  return;
+}
+
+/**
+ * @brief   Changes the size of a previously allocated memory block.
+ * @details The block is shrunk in place by returning its tail to the heap
+ *          or grown in place by absorbing the adjacent free block, if any.
+ *          Only if the adjacent space is not sufficient a new block is
+ *          allocated from the same heap, the content is copied and the old
+ *          block is freed.
+ * @note    A block is moved only using the @p CH_HEAP_ALIGNMENT alignment,
+ *          a greater alignment requested on allocation is not preserved.
+ *
+ * @param[in] p         pointer to the memory block to be resized or @p NULL
+ *                      in order to allocate a new block from the default
+ *                      heap
+ * @param[in] size      the new size of the block
+ * @return              A pointer to the resized block.
+ * @retval NULL         if the block cannot be resized, the original block
+ *                      is left untouched.
+ *
+ * @api
+ */
+void *chHeapRealloc(void *p, size_t size) {
+  heap_header_t *qp, *hp, *fp;
+  memory_heap_t *heapp;
+  size_t pages, curpages;
+  void *np;
+
+  chDbgCheck(size > 0U);
+
+  if (p == NULL) {
+    return chHeapAlloc(NULL, size);
+  }
+
+  chDbgCheck(MEM_IS_ALIGNED(p, CH_HEAP_ALIGNMENT));
+
+  /*lint -save -e9087 [11.3] Safe cast.*/
+  hp = (heap_header_t *)p - 1U;
+  /*lint -restore*/
+  heapp = H_USED_HEAP(hp);
+
+  /* Sizes are converted in number of elementary allocation units.*/
+  pages    = MEM_ALIGN_NEXT(size, CH_HEAP_ALIGNMENT) / CH_HEAP_ALIGNMENT;
+  curpages = MEM_ALIGN_NEXT(H_USED_SIZE(hp),
+                            CH_HEAP_ALIGNMENT) / CH_HEAP_ALIGNMENT;
+
+  /* Taking heap mutex.*/
+  H_LOCK(heapp);
+
+  if (pages < curpages) {
+    /* Shrinking, the excess becomes a free block.*/
+    fp = H_BLOCK(hp) + pages;
+    H_FREE_PAGES(fp) = (curpages - pages) - 1U;
+#if CH_CFG_HARDENING_LEVEL > 0
+    memset((void *)H_BLOCK(fp), 0, H_FREE_PAGES(fp) * CH_HEAP_ALIGNMENT);
+#endif
+    heap_link(heapp, fp);
+    H_USED_SIZE(hp) = size;
+    H_UNLOCK(heapp);
+
+    return p;
+  }
+
+  if (pages > curpages) {
+    /* Searching for a free block adjacent to the end of this block.*/
+    qp = &heapp->header;
+    while ((H_FREE_NEXT(qp) != NULL) &&
+           (H_FREE_NEXT(qp) < H_BLOCK(hp) + curpages)) {
+      qp = H_FREE_NEXT(qp);
+    }
+    fp = H_FREE_NEXT(qp);
+    if ((fp != H_BLOCK(hp) + curpages) ||
+        (curpages + H_FREE_PAGES(fp) + 1U < pages)) {
+      /* Not enough adjacent space, the block must be moved.*/
+      H_UNLOCK(heapp);
+
+      np = chHeapAllocAligned(heapp, size, CH_HEAP_ALIGNMENT);
+      if (np != NULL) {
+        memcpy(np, p, H_USED_SIZE(hp));
+        chHeapFree(p);
       }
-      break;
+
+      return np;
+    }
+
+    /* Absorbing the adjacent free block, the excess is split again.*/
+    curpages += H_FREE_PAGES(fp) + 1U;
+    H_FREE_NEXT(qp) = H_FREE_NEXT(fp);
+    if (curpages > pages) {
+      heap_header_t *ep = H_BLOCK(hp) + pages;
+
+      H_FREE_PAGES(ep) = (curpages - pages) - 1U;
+      H_FREE_NEXT(ep) = H_FREE_NEXT(qp);
+      H_FREE_NEXT(qp) = ep;
     }
-    qp = H_FREE_NEXT(qp);
   }
 
-  /* Releasing heap mutex.*/
+  /* Same number of pages or grown in place.*/
+  H_USED_SIZE(hp) = size;
   H_UNLOCK(heapp);
 
-  return;
+  return p;
 }
 
 /**
@@ -0,0 +1,790 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    oslib/src/chmsgports.c
+ * @brief   Message ports code.
+ *
+ * @addtogroup oslib_msg_ports
+ * @details Asynchronous zero-copy messages.
+ *          <h2>Operation mode</h2>
+ *          A message port is a bounded ring of message slots, each slot
+ *          carries a pointer-sized message, an optional small inline
+ *          payload and an optional reply port.<br>
+ *          Unlike synchronous messages, see @p chMsgSend(), the sender
+ *          is not suspended until the message has been processed, it
+ *          only waits if the ring is full. Request/response exchanges
+ *          are done by specifying a reply port when posting.<br>
+ *          Operations defined for message ports:
+ *          - <b>Post</b>: Copies a message into a free slot in FIFO order.
+ *          - <b>Fetch</b>: Returns a pointer to the oldest posted slot,
+ *            the slot is read in place and remains owned by the receiver
+ *            until released.
+ *          - <b>Fetch Batch</b>: Fetches all the available slots up to
+ *            a maximum in a single operation.
+ *          - <b>Release</b>: Returns fetched slots to the ring, oldest
+ *            first.
+ *          - <b>Reply</b>: Posts an answer to the reply port specified
+ *            in a fetched slot.
+ *          - <b>Reset</b>: The port is emptied and all the stored messages
+ *            are lost.
+ *          .
+ *          A message port is meant to be served by a single receiver
+ *          thread, any number of threads or ISRs can post into it.
+ * @pre     In order to use the message ports APIs the
+ *          @p CH_CFG_USE_MSG_PORTS option must be enabled in @p chconf.h.
+ * @note    Compatible with RT and NIL.
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+
+#if (CH_CFG_USE_MSG_PORTS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Writes a message in the next free slot.
+ * @pre     There must be at least one free slot.
+ *
+ * @notapi
+ */
+static void mp_write(msg_port_t *mpp, msg_t msg,
+                     const void *data, size_t size,
+                     msg_port_t *rpp) {
+  msg_port_slot_t *slotp = (msg_port_slot_t *)(void *)mpp->wrptr;
+
+  slotp->reply = rpp;
+  slotp->msg   = msg;
+  slotp->size  = size;
+  if (size > (size_t)0) {
+    memcpy(chMsgPortGetDataX(slotp), data, size);
+  }
+
+  mpp->wrptr += mpp->slotsize;
+  if (mpp->wrptr >= mpp->top) {
+    mpp->wrptr = mpp->buffer;
+  }
+  mpp->cnt++;
+}
+
+/**
+ * @brief   Takes the oldest posted slot.
+ * @pre     There must be at least one posted slot.
+ *
+ * @notapi
+ */
+static msg_port_slot_t *mp_read(msg_port_t *mpp) {
+  msg_port_slot_t *slotp = (msg_port_slot_t *)(void *)mpp->rdptr;
+
+  mpp->rdptr += mpp->slotsize;
+  if (mpp->rdptr >= mpp->top) {
+    mpp->rdptr = mpp->buffer;
+  }
+  mpp->cnt--;
+  mpp->held++;
+
+  return slotp;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a @p msg_port_t object.
+ *
+ * @param[out] mpp      pointer to the @p msg_port_t structure to be
+ *                      initialized
+ * @param[in] buf       pointer to the slots buffer, it must be aligned to
+ *                      @p PORT_NATURAL_ALIGN and have a size of at least
+ *                      @p MSG_PORT_BUFFER_SIZE(size, n) bytes
+ * @param[in] size      maximum size of the inline payload, can be zero
+ * @param[in] n         number of slots in the buffer
+ *
+ * @init
+ */
+void chMsgPortObjectInit(msg_port_t *mpp, void *buf, size_t size, size_t n) {
+
+  chDbgCheck((mpp != NULL) && (buf != NULL) && (n > (size_t)0) &&
+             MEM_IS_ALIGNED(buf, PORT_NATURAL_ALIGN));
+
+  mpp->buffer   = (uint8_t *)buf;
+  mpp->top      = (uint8_t *)buf + MSG_PORT_BUFFER_SIZE(size, n);
+  mpp->wrptr    = (uint8_t *)buf;
+  mpp->rdptr    = (uint8_t *)buf;
+  mpp->slotsize = MSG_PORT_SLOT_SIZE(size);
+  mpp->cnt      = (size_t)0;
+  mpp->held     = (size_t)0;
+  mpp->reset    = false;
+  chThdQueueObjectInit(&mpp->qw);
+  chThdQueueObjectInit(&mpp->qr);
+}
+
+/**
+ * @brief   Disposes a @p msg_port_t object.
+ * @note    Objects disposing does not involve freeing memory but just
+ *          performing checks that make sure that the object is in a
+ *          state compatible with operations stop.
+ * @note    If the option @p CH_CFG_HARDENING_LEVEL is greater than zero then
+ *          the object is also cleared, attempts to use the object would likely
+ *          result in a clean memory access violation because dereferencing
+ *          of @p NULL pointers rather than dereferencing previously valid
+ *          pointers.
+ *
+ * @param[in] mpp       pointer to a @p msg_port_t object
+ *
+ * @dispose
+ */
+void chMsgPortObjectDispose(msg_port_t *mpp) {
+
+  chDbgCheck(mpp != NULL);
+
+  chThdQueueObjectDispose(&mpp->qr);
+  chThdQueueObjectDispose(&mpp->qw);
+
+#if CH_CFG_HARDENING_LEVEL > 0
+  memset((void *)mpp, 0, __CH_OFFSETOF(msg_port_t, qw));
+#endif
+}
+
+/**
+ * @brief   Resets a @p msg_port_t object.
+ * @details All the waiting threads are resumed with status @p MSG_RESET and
+ *          the queued messages are lost, slots held by the receiver are
+ *          implicitly released.
+ * @post    The port is in reset state, all operations will fail and
+ *          return @p MSG_RESET until the port is enabled again using
+ *          @p chMsgPortResumeX().
+ *
+ * @param[in] mpp       pointer to a @p msg_port_t object
+ *
+ * @api
+ */
+void chMsgPortReset(msg_port_t *mpp) {
+
+  chSysLock();
+  chMsgPortResetI(mpp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Resets a @p msg_port_t object.
+ * @details All the waiting threads are resumed with status @p MSG_RESET and
+ *          the queued messages are lost, slots held by the receiver are
+ *          implicitly released.
+ * @post    The port is in reset state, all operations will fail and
+ *          return @p MSG_RESET until the port is enabled again using
+ *          @p chMsgPortResumeX().
+ *
+ * @param[in] mpp       pointer to a @p msg_port_t object
+ *
+ * @iclass
+ */
+void chMsgPortResetI(msg_port_t *mpp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(mpp != NULL);
+
+  mpp->wrptr = mpp->buffer;
+  mpp->rdptr = mpp->buffer;
+  mpp->cnt   = (size_t)0;
+  mpp->held  = (size_t)0;
+  mpp->reset = true;
+  chThdDequeueAllI(&mpp->qw, MSG_RESET);
+  chThdDequeueAllI(&mpp->qr, MSG_RESET);
+}
+
+/**
+ * @brief   Posts a message into a message port.
+ * @details The invoking thread waits until a free slot becomes available
+ *          or the specified time runs out, once the message is posted the
+ *          invoking thread continues without waiting for the receiver.
+ *
+ * @param[in] mpp       pointer to a @p msg_port_t object
+ * @param[in] msg       pointer-sized message to be posted
+ * @param[in] data      pointer to the inline payload or @p NULL
+ * @param[in] size      size of the inline payload, it must not exceed the
+ *                      size specified on port initialization
+ * @param[in] rpp       reply port or @p NULL if no reply is expected
+ * @param[in] timeout   number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly posted.
+ * @retval MSG_RESET    if the port has been reset.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+msg_t chMsgPortPostTimeout(msg_port_t *mpp, msg_t msg,
+                           const void *data, size_t size,
+                           msg_port_t *rpp, sysinterval_t timeout) {
+  msg_t rdymsg;
+
+  chSysLock();
+  rdymsg = chMsgPortPostTimeoutS(mpp, msg, data, size, rpp, timeout);
+  chSysUnlock();
+
+  return rdymsg;
+}
+
+/**
+ * @brief   Posts a message into a message port.
+ * @details The invoking thread waits until a free slot becomes available
+ *          or the specified time runs out, once the message is posted the
+ *          invoking thread continues without waiting for the receiver.
+ *
+ * @param[in] mpp       pointer to a @p msg_port_t object
+ * @param[in] msg       pointer-sized message to be posted
+ * @param[in] data      pointer to the inline payload or @p NULL
+ * @param[in] size      size of the inline payload, it must not exceed the
+ *                      size specified on port initialization
+ * @param[in] rpp       reply port or @p NULL if no reply is expected
+ * @param[in] timeout   number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly posted.
+ * @retval MSG_RESET    if the port has been reset.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @sclass
+ */
+msg_t chMsgPortPostTimeoutS(msg_port_t *mpp, msg_t msg,
+                            const void *data, size_t size,
+                            msg_port_t *rpp, sysinterval_t timeout) {
+  msg_t rdymsg;
+
+  chDbgCheckClassS();
+  chDbgCheck((mpp != NULL) && (size <= chMsgPortGetDataSizeX(mpp)) &&
+             ((size == (size_t)0) || (data != NULL)));
+
+  do {
+    /* If the port is in reset state then returns immediately.*/
+    if (mpp->reset) {
+      return MSG_RESET;
+    }
+
+    /* Is there a free slot? if so then post.*/
+    if (chMsgPortGetFreeCountI(mpp) > (size_t)0) {
+      mp_write(mpp, msg, data, size, rpp);
+
+      /* If there is a reader waiting then makes it ready.*/
+      chThdDequeueNextI(&mpp->qr, MSG_OK);
+      chSchRescheduleS();
+
+      return MSG_OK;
+    }
+
+    /* No space in the ring, waiting for a slot to become available.*/
+    rdymsg = chThdEnqueueTimeoutS(&mpp->qw, timeout);
+  } while (rdymsg == MSG_OK);
+
+  return rdymsg;
+}
+
+/**
+ * @brief   Posts a message into a message port.
+ * @details This variant is non-blocking, the function returns a timeout
+ *          condition if the ring is full.
+ *
+ * @param[in] mpp       pointer to a @p msg_port_t object
+ * @param[in] msg       pointer-sized message to be posted
+ * @param[in] data      pointer to the inline payload or @p NULL
+ * @param[in] size      size of the inline payload, it must not exceed the
+ *                      size specified on port initialization
+ * @param[in] rpp       reply port or @p NULL if no reply is expected
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly posted.
+ * @retval MSG_RESET    if the port has been reset.
+ * @retval MSG_TIMEOUT  if the ring is full and the message cannot be
+ *                      posted.
+ *
+ * @iclass
+ */
+msg_t chMsgPortPostI(msg_port_t *mpp, msg_t msg,
+                     const void *data, size_t size,
+                     msg_port_t *rpp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((mpp != NULL) && (size <= chMsgPortGetDataSizeX(mpp)) &&
+             ((size == (size_t)0) || (data != NULL)));
+
+  /* If the port is in reset state then returns immediately.*/
+  if (mpp->reset) {
+    return MSG_RESET;
+  }
+
+  /* Is there a free slot? if so then post.*/
+  if (chMsgPortGetFreeCountI(mpp) > (size_t)0) {
+    mp_write(mpp, msg, data, size, rpp);
+
+    /* If there is a reader waiting then makes it ready.*/
+    chThdDequeueNextI(&mpp->qr, MSG_OK);
+
+    return MSG_OK;
+  }
+
+  /* No space, immediate timeout.*/
+  return MSG_TIMEOUT;
+}
+
+/**
+ * @brief   Fetches a message from a message port.
+ * @details The invoking thread waits until a message is posted or the
+ *          specified time runs out. The returned slot is read in place
+ *          and must be returned to the port using @p chMsgPortRelease().
+ *
+ * @param[in] mpp       pointer to a @p msg_port_t object
+ * @param[out] slotpp   pointer to a slot pointer variable
+ * @param[in] timeout   number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly fetched.
+ * @retval MSG_RESET    if the port has been reset.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+msg_t chMsgPortFetchTimeout(msg_port_t *mpp, msg_port_slot_t **slotpp,
+                            sysinterval_t timeout) {
+  msg_t rdymsg;
+
+  chSysLock();
+  rdymsg = chMsgPortFetchTimeoutS(mpp, slotpp, timeout);
+  chSysUnlock();
+
+  return rdymsg;
+}
+
+/**
+ * @brief   Fetches a message from a message port.
+ * @details The invoking thread waits until a message is posted or the
+ *          specified time runs out. The returned slot is read in place
+ *          and must be returned to the port using @p chMsgPortRelease().
+ *
+ * @param[in] mpp       pointer to a @p msg_port_t object
+ * @param[out] slotpp   pointer to a slot pointer variable
+ * @param[in] timeout   number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly fetched.
+ * @retval MSG_RESET    if the port has been reset.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @sclass
+ */
+msg_t chMsgPortFetchTimeoutS(msg_port_t *mpp, msg_port_slot_t **slotpp,
+                             sysinterval_t timeout) {
+  msg_t rdymsg;
+
+  chDbgCheckClassS();
+  chDbgCheck((mpp != NULL) && (slotpp != NULL));
+
+  do {
+    /* If the port is in reset state then returns immediately.*/
+    if (mpp->reset) {
+      return MSG_RESET;
+    }
+
+    /* Is there a message in queue? if so then fetch.*/
+    if (mpp->cnt > (size_t)0) {
+      *slotpp = mp_read(mpp);
+
+      return MSG_OK;
+    }
+
+    /* No message in the ring, waiting for a message to become available.*/
+    rdymsg = chThdEnqueueTimeoutS(&mpp->qr, timeout);
+  } while (rdymsg == MSG_OK);
+
+  return rdymsg;
+}
+
+/**
+ * @brief   Fetches a message from a message port.
+ * @details This variant is non-blocking, the function returns a timeout
+ *          condition if the ring is empty.
+ *
+ * @param[in] mpp       pointer to a @p msg_port_t object
+ * @param[out] slotpp   pointer to a slot pointer variable
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly fetched.
+ * @retval MSG_RESET    if the port has been reset.
+ * @retval MSG_TIMEOUT  if the ring is empty and a message cannot be
+ *                      fetched.
+ *
+ * @iclass
+ */
+msg_t chMsgPortFetchI(msg_port_t *mpp, msg_port_slot_t **slotpp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((mpp != NULL) && (slotpp != NULL));
+
+  /* If the port is in reset state then returns immediately.*/
+  if (mpp->reset) {
+    return MSG_RESET;
+  }
+
+  /* Is there a message in queue? if so then fetch.*/
+  if (mpp->cnt > (size_t)0) {
+    *slotpp = mp_read(mpp);
+
+    return MSG_OK;
+  }
+
+  /* No message, immediate timeout.*/
+  return MSG_TIMEOUT;
+}
+
+/**
+ * @brief   Fetches a batch of messages from a message port.
+ * @details The invoking thread waits until at least one message is posted
+ *          or the specified time runs out, then all the available messages
+ *          are fetched up to the specified maximum. The returned slots
+ *          must be returned to the port using @p chMsgPortRelease().
+ *
+ * @param[in] mpp       pointer to a @p msg_port_t object
+ * @param[out] slots    array of slot pointers to be filled
+ * @param[in] n         maximum number of slots to be fetched
+ * @param[in] timeout   number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ * @return              The number of fetched slots, zero if the port has
+ *                      been reset or the operation has timed out.
+ *
+ * @api
+ */
+size_t chMsgPortFetchBatchTimeout(msg_port_t *mpp, msg_port_slot_t **slots,
+                                  size_t n, sysinterval_t timeout) {
+  size_t fetched;
+
+  chSysLock();
+  fetched = chMsgPortFetchBatchTimeoutS(mpp, slots, n, timeout);
+  chSysUnlock();
+
+  return fetched;
+}
+
+/**
+ * @brief   Fetches a batch of messages from a message port.
+ * @details The invoking thread waits until at least one message is posted
+ *          or the specified time runs out, then all the available messages
+ *          are fetched up to the specified maximum. The returned slots
+ *          must be returned to the port using @p chMsgPortRelease().
+ *
+ * @param[in] mpp       pointer to a @p msg_port_t object
+ * @param[out] slots    array of slot pointers to be filled
+ * @param[in] n         maximum number of slots to be fetched
+ * @param[in] timeout   number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ * @return              The number of fetched slots, zero if the port has
+ *                      been reset or the operation has timed out.
+ *
+ * @sclass
+ */
+size_t chMsgPortFetchBatchTimeoutS(msg_port_t *mpp, msg_port_slot_t **slots,
+                                   size_t n, sysinterval_t timeout) {
+
+  chDbgCheckClassS();
+  chDbgCheck((mpp != NULL) && (slots != NULL) && (n > (size_t)0));
+
+  do {
+    /* If the port is in reset state then returns immediately.*/
+    if (mpp->reset) {
+      return (size_t)0;
+    }
+
+    /* Taking all the available messages.*/
+    if (mpp->cnt > (size_t)0) {
+      return chMsgPortFetchBatchI(mpp, slots, n);
+    }
+  } while (chThdEnqueueTimeoutS(&mpp->qr, timeout) == MSG_OK);
+
+  return (size_t)0;
+}
+
+/**
+ * @brief   Fetches a batch of messages from a message port.
+ * @details This variant is non-blocking, all the available messages are
+ *          fetched up to the specified maximum.
+ *
+ * @param[in] mpp       pointer to a @p msg_port_t object
+ * @param[out] slots    array of slot pointers to be filled
+ * @param[in] n         maximum number of slots to be fetched
+ * @return              The number of fetched slots, zero if the port is
+ *                      empty or in reset state.
+ *
+ * @iclass
+ */
+size_t chMsgPortFetchBatchI(msg_port_t *mpp, msg_port_slot_t **slots,
+                            size_t n) {
+  size_t i;
+
+  chDbgCheckClassI();
+  chDbgCheck((mpp != NULL) && (slots != NULL));
+
+  if (mpp->reset) {
+    return (size_t)0;
+  }
+
+  i = (size_t)0;
+  while ((i < n) && (mpp->cnt > (size_t)0)) {
+    slots[i++] = mp_read(mpp);
+  }
+
+  return i;
+}
+
+/**
+ * @brief   Releases fetched slots.
+ * @details The oldest @p n slots held by the receiver are returned to the
+ *          port and waiting writers, if any, are made ready.
+ * @note    Slots are always released in the same order they have been
+ *          fetched.
+ *
+ * @param[in] mpp       pointer to a @p msg_port_t object
+ * @param[in] n         number of slots to be released
+ *
+ * @api
+ */
+void chMsgPortRelease(msg_port_t *mpp, size_t n) {
+
+  chSysLock();
+  chMsgPortReleaseI(mpp, n);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Releases fetched slots.
+ * @details The oldest @p n slots held by the receiver are returned to the
+ *          port and waiting writers, if any, are made ready.
+ * @note    Slots are always released in the same order they have been
+ *          fetched.
+ *
+ * @param[in] mpp       pointer to a @p msg_port_t object
+ * @param[in] n         number of slots to be released
+ *
+ * @iclass
+ */
+void chMsgPortReleaseI(msg_port_t *mpp, size_t n) {
+  threads_queue_t *qwp = &mpp->qw;
+
+  chDbgCheckClassI();
+  chDbgCheck(mpp != NULL);
+
+  /* Slots held before a reset have already been reclaimed.*/
+  if (mpp->reset) {
+    return;
+  }
+
+  chDbgAssert(n <= mpp->held, "releasing slots not held");
+
+  /* Waking up one waiting writer for each released slot.*/
+  mpp->held -= n;
+  while ((n > (size_t)0) && !chThdQueueIsEmptyI(qwp)) {
+    chThdDequeueNextI(qwp, MSG_OK);
+    n--;
+  }
+}
+
+/**
+ * @brief   Replies to a fetched message.
+ * @details The answer is posted, without waiting, into the reply port
+ *          specified by the sender. If the sender did not specify a reply
+ *          port then the function does nothing.
+ * @note    The slot must be released separately.
+ *
+ * @param[in] slotp     pointer to a fetched slot
+ * @param[in] msg       answer message
+ * @return              The operation status.
+ * @retval MSG_OK       if the answer has been posted or no reply port
+ *                      has been specified.
+ * @retval MSG_RESET    if the reply port has been reset.
+ * @retval MSG_TIMEOUT  if the reply port is full.
+ *
+ * @api
+ */
+msg_t chMsgPortReply(const msg_port_slot_t *slotp, msg_t msg) {
+  msg_t rdymsg;
+
+  chSysLock();
+  rdymsg = chMsgPortReplyI(slotp, msg);
+  chSchRescheduleS();
+  chSysUnlock();
+
+  return rdymsg;
+}
+
+/**
+ * @brief   Replies to a fetched message.
+ * @details The answer is posted, without waiting, into the reply port
+ *          specified by the sender. If the sender did not specify a reply
+ *          port then the function does nothing.
+ * @note    The slot must be released separately.
+ *
+ * @param[in] slotp     pointer to a fetched slot
+ * @param[in] msg       answer message
+ * @return              The operation status.
+ * @retval MSG_OK       if the answer has been posted or no reply port
+ *                      has been specified.
+ * @retval MSG_RESET    if the reply port has been reset.
+ * @retval MSG_TIMEOUT  if the reply port is full.
+ *
+ * @iclass
+ */
+msg_t chMsgPortReplyI(const msg_port_slot_t *slotp, msg_t msg) {
+
+  chDbgCheckClassI();
+  chDbgCheck(slotp != NULL);
+
+  if (slotp->reply == NULL) {
+    return MSG_OK;
+  }
+
+  return chMsgPortPostI(slotp->reply, msg, NULL, (size_t)0, NULL);
+}
+
+/**
+ * @brief   Replies to and releases a batch of fetched messages.
+ * @details All the answers are posted and the slots released within a
+ *          single critical zone, a single reschedule is performed at the
+ *          end. Answers that cannot be posted because the reply port is
+ *          full or in reset state are dropped, the slots are released
+ *          anyway.
+ *
+ * @param[in] mpp       pointer to a @p msg_port_t object
+ * @param[in] slots     array of fetched slots, in fetch order
+ * @param[in] msgs      array of answers, one for each slot
+ * @param[in] n         number of slots in the batch
+ * @return              The number of answers posted, slots without a
+ *                      reply port are counted as answered. A value
+ *                      lower than @p n means that some answers have
+ *                      been dropped.
+ *
+ * @api
+ */
+size_t chMsgPortReplyBatch(msg_port_t *mpp, msg_port_slot_t **slots,
+                           const msg_t *msgs, size_t n) {
+  size_t i, posted;
+
+  chDbgCheck((slots != NULL) && (msgs != NULL));
+
+  chSysLock();
+  posted = (size_t)0;
+  for (i = (size_t)0; i < n; i++) {
+    if (chMsgPortReplyI(slots[i], msgs[i]) == MSG_OK) {
+      posted++;
+    }
+  }
+  chMsgPortReleaseI(mpp, n);
+  chSchRescheduleS();
+  chSysUnlock();
+
+  return posted;
+}
+
+/**
+ * @brief   Performs a request/response exchange.
+ * @details A message is posted into the port specifying a reply port then
+ *          the answer is fetched from the reply port.
+ * @note    The reply port must be owned by the invoking thread.
+ * @note    If a previous call timed out while waiting for the answer then
+ *          the late answer could still be posted into the reply port
+ *          afterward. Messages already queued in the reply port are
+ *          discarded before posting the request in order to not return
+ *          them as the answer to the new request. An answer arriving
+ *          after that point cannot be told apart from the expected one,
+ *          callers using finite timeouts should reset the reply port or
+ *          use a sequence number in the exchanged messages.
+ *
+ * @param[in] mpp       pointer to the server @p msg_port_t object
+ * @param[in] rpp       pointer to the reply @p msg_port_t object
+ * @param[in] msg       request message
+ * @param[out] rmsgp    pointer to a variable receiving the answer
+ * @param[in] timeout   number of ticks before each phase timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ * @return              The operation status.
+ * @retval MSG_OK       if an answer has been received.
+ * @retval MSG_RESET    if one of the ports has been reset.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+msg_t chMsgPortCall(msg_port_t *mpp, msg_port_t *rpp, msg_t msg,
+                    msg_t *rmsgp, sysinterval_t timeout) {
+  msg_port_slot_t *slotp;
+  msg_t rdymsg;
+
+  chDbgCheck((rpp != NULL) && (rmsgp != NULL));
+
+  chSysLock();
+
+  /* Discarding stale answers left by previously timed out calls.*/
+  while (chMsgPortFetchI(rpp, &slotp) == MSG_OK) {
+    chMsgPortReleaseI(rpp, (size_t)1);
+  }
+
+  rdymsg = chMsgPortPostTimeoutS(mpp, msg, NULL, (size_t)0, rpp, timeout);
+  if (rdymsg == MSG_OK) {
+    rdymsg = chMsgPortFetchTimeoutS(rpp, &slotp, timeout);
+    if (rdymsg == MSG_OK) {
+      *rmsgp = slotp->msg;
+      chMsgPortReleaseI(rpp, (size_t)1);
+      chSchRescheduleS();
+    }
+  }
+  chSysUnlock();
+
+  return rdymsg;
+}
+
+#endif /* CH_CFG_USE_MSG_PORTS == TRUE */
+
+/** @} */
@@ -203,6 +203,14 @@ struct ch_thread {
    * @note    It is the 1st address after the working area.
    */
   stkline_t                    *waend;
+#if (CH_DBG_FILL_THREADS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Stack high-water mark.
+   * @note    Lowest working area address found modified so far, it is
+   *          updated by @p chThdGetStackUnused().
+   */
+  stkline_t                     *wamark;
+#endif
   /**
    * @brief   Current thread state.
    */
@@ -436,6 +436,7 @@ extern "C" {
                                tprio_t prio);
 #if CH_DBG_FILL_THREADS == TRUE
   void __thd_stackfill(uint8_t *startp, uint8_t *endp);
+  size_t chThdGetStackUnused(thread_t *tp);
 #endif
   thread_t *chThdObjectInit(thread_t *tp, const thread_descriptor_t *tdp);
   void chThdObjectDispose(thread_t *tp);
@@ -572,6 +573,23 @@ static inline stkline_t *chThdGetWorkingAreaX(thread_t *tp) {
   return tp->wabase;
 }
 
+/**
+ * @brief   Returns the stack size of the specified thread.
+ * @note    The size is the whole working area size, it includes the
+ *          @p thread_t structure when it is allocated in the working area,
+ *          see @p chThdCreateStatic(). The usable stack is smaller in that
+ *          case.
+ *
+ * @param[in] tp        pointer to the thread
+ * @return              The stack size in bytes.
+ *
+ * @xclass
+ */
+static inline size_t chThdGetStackSizeX(thread_t *tp) {
+
+  return (size_t)((uint8_t *)tp->waend - (uint8_t *)tp->wabase);
+}
+
 /**
  * @brief   Verifies if the specified thread is in the @p CH_STATE_FINAL state.
  *
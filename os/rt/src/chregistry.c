@@ -260,6 +260,8 @@ thread_t *chRegNextThread(thread_t *tp) {
  * @note    The reference counter of the found thread is increased by one so
  *          it cannot be disposed incidentally after the pointer has been
  *          returned.
+ * @note    Threads are scanned in registry order, applications performing
+ *          frequent lookups should keep references to the found threads.
  *
  * @param[in] name      the thread name
  * @return              A pointer to the found thread.
@@ -270,10 +272,16 @@ thread_t *chRegNextThread(thread_t *tp) {
 thread_t *chRegFindThreadByName(const char *name) {
   thread_t *ctp;
 
-  /* Scanning registry.*/
+  chDbgCheck(name != NULL);
+
+  /* Scanning registry, names are usually string literals so the pointer
+     is compared first, unnamed threads are skipped.*/
   ctp = chRegFirstThread();
   do {
-    if (strcmp(chRegGetThreadNameX(ctp), name) == 0) {
+    const char *tname = chRegGetThreadNameX(ctp);
+
+    if ((tname == name) ||
+        ((tname != NULL) && (strcmp(tname, name) == 0))) {
       return ctp;
     }
     ctp = chRegNextThread(ctp);
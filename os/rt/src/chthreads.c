@@ -65,6 +65,21 @@
 #define thd_clear(tdp)
 #endif
 
+/*
+ * Stack scan unit, a 32 bits word if the working areas alignment allows
+ * it else a single byte.
+ */
+#if CH_DBG_FILL_THREADS == TRUE
+#if PORT_WORKING_AREA_ALIGN >= 4U
+typedef uint32_t stkscan_t;
+#define STKSCAN_FILL    ((stkscan_t)0x01010101U *                           \
+                         (stkscan_t)CH_DBG_STACK_FILL_VALUE)
+#else
+typedef uint8_t stkscan_t;
+#define STKSCAN_FILL    ((stkscan_t)CH_DBG_STACK_FILL_VALUE)
+#endif
+#endif /* CH_DBG_FILL_THREADS == TRUE */
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -100,6 +115,48 @@ void __thd_stackfill(uint8_t *startp, uint8_t *endp) {
     *startp++ = CH_DBG_STACK_FILL_VALUE;
   } while (likely(startp < endp));
 }
+
+/**
+ * @brief   Returns the stack space never used by a thread.
+ * @details The working area is scanned from its base up to the first
+ *          location not matching the fill value. The result is cached
+ *          in the thread as a high-water mark, the stack can only grow
+ *          below it so following scans never go past the cached mark.
+ * @note    Stacks are assumed to grow downward.
+ * @note    The result is only meaningful for working areas filled on
+ *          thread creation, threads created using I-class functions are
+ *          reported as having used their whole stack.
+ * @note    The caller must hold a reference to the thread or make sure
+ *          that it has not been disposed.
+ *
+ * @param[in] tp        pointer to the thread
+ * @return              The number of bytes never used.
+ *
+ * @api
+ */
+size_t chThdGetStackUnused(thread_t *tp) {
+  const stkscan_t *p, *mark;
+  size_t unused;
+
+  chDbgCheck(tp != NULL);
+
+  /* Word-wise scan up to the cached mark.*/
+  p    = (const stkscan_t *)(const void *)tp->wabase;
+  mark = (const stkscan_t *)(const void *)tp->wamark;
+  while ((p < mark) && (*p == STKSCAN_FILL)) {
+    p++;
+  }
+
+  /* Updating the cached mark, rounded down to a stack line.*/
+  chSysLock();
+  if ((const void *)p < (const void *)tp->wamark) {
+    tp->wamark = (stkline_t *)MEM_ALIGN_PREV(p, sizeof (stkline_t));
+  }
+  unused = (size_t)((uint8_t *)tp->wamark - (uint8_t *)tp->wabase);
+  chSysUnlock();
+
+  return unused;
+}
 #endif /* CH_DBG_FILL_THREADS */
 
 /**
@@ -122,6 +179,9 @@ thread_t *chThdObjectInit(thread_t *tp,
   /* Stack boundaries.*/
   tp->wabase = (void *)tdp->wbase;
   tp->waend  = (void *)tdp->wend;
+#if CH_DBG_FILL_THREADS == TRUE
+  tp->wamark = tp->waend;
+#endif
 
   /* Thread-related fields.*/
   tp->hdr.pqueue.prio   = tdp->prio;
@@ -489,6 +489,17 @@
 #define CH_CFG_USE_JOBS                     TRUE
 #endif
 
+/**
+ * @brief   Message Ports APIs.
+ * @details If enabled then the asynchronous message ports APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p TRUE.
+ */
+#if !defined(CH_CFG_USE_MSG_PORTS)
+#define CH_CFG_USE_MSG_PORTS                TRUE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -518,6 +529,16 @@
 #define CH_CFG_FACTORY_MAX_NAMES_LENGTH     8
 #endif
 
+/**
+ * @brief   Size of the names hash index of each objects list.
+ * @details If the specified size is zero then names lookups are performed
+ *          by scanning the whole list.
+ * @note    Must be zero or a power of two.
+ */
+#if !defined(CH_CFG_FACTORY_HASH_SIZE)
+#define CH_CFG_FACTORY_HASH_SIZE            0
+#endif
+
 /**
  * @brief   Enables the registry of generic objects.
  */
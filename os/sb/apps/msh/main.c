@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <fcntl.h>
 
 #include "sbuser.h"
 #include "paths.h"
@@ -33,6 +34,7 @@
 #define SHELL_WELCOME_STR           "ChibiOS/SB Mini Shell"
 #define SHELL_DEFAULT_PATH          "/bin"
 #define SHELL_EXECUTABLE_EXTENSION  ".elf"
+#define SHELL_IOBENCH_DEFAULT_OPS   1000
 
 #define CTRL(c) (char)((c) - 0x40)
 
@@ -42,6 +44,7 @@ static struct {
   char              *history_current;
   char              history_buffer[SHELL_HISTORY_DEPTH][SHELL_MAX_LINE_LENGTH];
   char              pathbuf[1024];
+  sb_ioring_t       ioring;
 } state;
 
 static void shell_putc(char c) {
@@ -75,6 +78,18 @@ static void shell_errorln(const char *s) {
   (void) write(STDERR_FILENO, SHELL_NEWLINE_STR, 2);
 }
 
+static void shell_write_number(unsigned long n) {
+  char buf[12];
+  char *p = &buf[sizeof buf - 1];
+
+  *p = '\0';
+  do {
+    *--p = (char)('0' + (n % 10U));
+    n /= 10U;
+  } while (n > 0U);
+  shell_write(p);
+}
+
 static void shell_usage(const char *s) {
 
   shell_error("usage: ");
@@ -358,6 +373,97 @@ static void cmd_dir(int argc, char *argv[]) {
 }
 #endif
 
+static void iobench_report(const char *name, unsigned long ops,
+                           systime_t start) {
+  unsigned long us;
+
+  us = (unsigned long)sbTimeI2US(sbTimeDiffX(start, sbGetSystemTime()));
+  shell_write(name);
+  shell_write(": ");
+  shell_write_number(ops);
+  shell_write(" ops in ");
+  shell_write_number(us);
+  shell_write(" us");
+  if (us > 0U) {
+    shell_write(", ");
+    shell_write_number((unsigned long)(((unsigned long long)ops * 1000000ULL) / us));
+    shell_write(" ops/s");
+  }
+  shell_write(SHELL_NEWLINE_STR);
+}
+
+static void cmd_iobench(int argc, char *argv[]) {
+  const char *path = "/dev/null";
+  unsigned long i, n = SHELL_IOBENCH_DEFAULT_OPS;
+  sb_ioring_t *ringp = &state.ioring;
+  systime_t start;
+  char c = '.';
+  int fd;
+
+  if (argc > 3) {
+    shell_usage("iobench [file] [n]");
+    return;
+  }
+  if (argc > 1) {
+    path = argv[1];
+  }
+  if (argc > 2) {
+    n = strtoul(argv[2], NULL, 10);
+  }
+
+  fd = open(path, O_WRONLY);
+  if (fd == -1) {
+    shell_error(path);
+    shell_errorln(": No such file or directory");
+    return;
+  }
+
+  /* One syscall for each single-byte write.*/
+  start = sbGetSystemTime();
+  for (i = 0U; i < n; i++) {
+    (void) write(fd, &c, 1);
+  }
+  iobench_report("write", n, start);
+
+  /* Same writes queued in the I/O ring, one syscall for each batch.*/
+  if (CH_RET_IS_ERROR(sbIoRingSetup(ringp))) {
+    shell_errorln("iobench: I/O ring not supported");
+    (void) close(fd);
+    return;
+  }
+  start = sbGetSystemTime();
+  i = 0U;
+  while (i < n) {
+    sb_ioring_sqe_t *sqep;
+    sb_ioring_cqe_t *cqep;
+
+    while ((i < n) && ((sqep = sbIoRingGetSQE(ringp)) != NULL)) {
+      sqep->opcode    = SB_POSIX_WRITE;
+      sqep->fd        = fd;
+      sqep->buf       = &c;
+      sqep->count     = 1U;
+      sqep->user_data = (uint32_t)i;
+      sbIoRingQueueSQE(ringp);
+      i++;
+    }
+    /* Stopping if the host executed nothing, the submission ring would
+       stay full.*/
+    if (sbIoRingEnter() <= 0) {
+      shell_errorln("iobench: I/O ring execution failed");
+      (void) sbIoRingSetup(NULL);
+      (void) close(fd);
+      return;
+    }
+    while ((cqep = sbIoRingGetCQE(ringp)) != NULL) {
+      sbIoRingConsumeCQE(ringp);
+    }
+  }
+  iobench_report("ioring", n, start);
+  (void) sbIoRingSetup(NULL);
+
+  (void) close(fd);
+}
+
 static void cmd_mkdir(int argc, char *argv[]) {
   int ret;
 
@@ -446,6 +552,7 @@ static const struct builtins {
   {"env",     cmd_env},
   {"exit",    cmd_exit},
   {"help",    cmd_help},
+  {"iobench", cmd_iobench},
   {"mkdir",   cmd_mkdir},
   {"mv",      cmd_mv},
   {"path",    cmd_path},
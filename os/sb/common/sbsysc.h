@@ -94,8 +94,21 @@
 #define SB_POSIX_MKDIR          14
 #define SB_POSIX_RMDIR          15
 #define SB_POSIX_STAT           16
+#define SB_POSIX_PREAD          17
+#define SB_POSIX_PWRITE         18
+#define SB_POSIX_READV          19
+#define SB_POSIX_WRITEV         20
+#define SB_POSIX_SENDFILE       21
+#define SB_POSIX_IORING_SETUP   22
+#define SB_POSIX_IORING_ENTER   23
 /** @} */
 
+/**
+ * @brief   Number of entries in the I/O submission and completion rings.
+ * @note    Must be a power of two.
+ */
+#define SB_IORING_ENTRIES       16
+
 /**
  * @name    Virtual GPIO syscall sub-codes
  * @{
@@ -156,10 +169,95 @@
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (SB_IORING_ENTRIES & (SB_IORING_ENTRIES - 1)) != 0
+#error "SB_IORING_ENTRIES must be a power of two"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Type of an I/O submission ring entry.
+ */
+typedef struct {
+  /**
+   * @brief   Operation code, one of the @p SB_POSIX_xxx sub-codes.
+   * @note    Only @p SB_POSIX_CLOSE, @p SB_POSIX_READ, @p SB_POSIX_WRITE,
+   *          @p SB_POSIX_PREAD and @p SB_POSIX_PWRITE are accepted.
+   */
+  uint32_t                      opcode;
+  /**
+   * @brief   File descriptor.
+   */
+  int32_t                       fd;
+  /**
+   * @brief   Data buffer.
+   */
+  void                          *buf;
+  /**
+   * @brief   Number of bytes to be transferred.
+   */
+  uint32_t                      count;
+  /**
+   * @brief   File offset for positional operations.
+   */
+  int32_t                       offset;
+  /**
+   * @brief   Opaque value copied in the matching completion entry.
+   */
+  uint32_t                      user_data;
+} sb_ioring_sqe_t;
+
+/**
+ * @brief   Type of an I/O completion ring entry.
+ */
+typedef struct {
+  /**
+   * @brief   Value copied from the matching submission entry.
+   */
+  uint32_t                      user_data;
+  /**
+   * @brief   Operation result, same as the equivalent syscall.
+   */
+  int32_t                       result;
+} sb_ioring_cqe_t;
+
+/**
+ * @brief   Type of an I/O ring shared between a sandbox and the host.
+ * @details The sandbox queues entries in @p sqes and advances @p sq_tail,
+ *          the host consumes them advancing @p sq_head and posts results
+ *          in @p cqes advancing @p cq_tail, the sandbox consumes results
+ *          advancing @p cq_head. Counters are free-running, entries are
+ *          addressed modulo @p SB_IORING_ENTRIES.
+ */
+typedef struct {
+  /**
+   * @brief   Submission ring head, written by the host.
+   */
+  volatile uint32_t             sq_head;
+  /**
+   * @brief   Submission ring tail, written by the sandbox.
+   */
+  volatile uint32_t             sq_tail;
+  /**
+   * @brief   Completion ring head, written by the sandbox.
+   */
+  volatile uint32_t             cq_head;
+  /**
+   * @brief   Completion ring tail, written by the host.
+   */
+  volatile uint32_t             cq_tail;
+  /**
+   * @brief   Submission entries.
+   */
+  sb_ioring_sqe_t               sqes[SB_IORING_ENTRIES];
+  /**
+   * @brief   Completion entries.
+   */
+  sb_ioring_cqe_t               cqes[SB_IORING_ENTRIES];
+} sb_ioring_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -0,0 +1,85 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021,2022 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    sb/common/uio.h
+ * @brief   Replaces the default sys/uio.h file.
+ *
+ * @addtogroup ARM_SANDBOX_UIO
+ * @{
+ */
+
+#ifndef UIO_H
+#define UIO_H
+
+#include <sys/types.h>
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum number of buffers in a vectored I/O call.
+ */
+#if !defined(IOV_MAX) || defined(__DOXYGEN__)
+#define IOV_MAX             16
+#endif
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+struct iovec {
+  void              *iov_base;
+  size_t            iov_len;
+};
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  ssize_t readv(int fd, const struct iovec *iov, int iovcnt);
+  ssize_t writev(int fd, const struct iovec *iov, int iovcnt);
+  ssize_t sendfile(int out_fd, int in_fd, off_t *offset, size_t count);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* UIO_H */
+
+/** @} */
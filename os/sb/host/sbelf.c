@@ -90,6 +90,9 @@ typedef unsigned elf_secnum_t;
 typedef struct {
   elf_secnum_t              section;
   memory_area_t             area;
+  uint32_t                  addr;
+  bool                      mapped;
+  bool                      checked;
   size_t                    rel_size;
   vfs_offset_t              rel_off;
 } elf_section_info_t;
@@ -106,6 +109,14 @@ typedef struct elf_load_context {
   bool                      rel_movw_found;
   uint32_t                  rel_movw_symbol;
   uint32_t                  rel_movw_address;
+  const memory_area_t       *xmap;
+  const uint8_t             *image;
+  size_t                    image_size;
+  const struct elf32_symbol *symbols;
+  unsigned                  symbols_num;
+  unsigned                  mapped_num;
+  elf_secnum_t              delta_section;
+  uint32_t                  delta;
   elf_section_info_t        *next;
   elf_section_info_t        allocated[SB_CFG_ELF_MAX_ALLOCATED];
 } elf_load_context_t;
@@ -148,7 +159,7 @@ typedef struct {
   uint32_t                  r_info;
 } elf32_rel_t;
 
-typedef struct {
+typedef struct elf32_symbol {
   uint32_t                  st_name;
   uint32_t                  st_value;
   uint32_t                  st_size;
@@ -199,6 +210,7 @@ static msg_t allocate_section(elf_load_context_t *ctxp,
   esip->section   = section;
   esip->area.base = ctxp->map->base + (size_t)shp->sh_addr;
   esip->area.size = (size_t)shp->sh_size;
+  esip->addr      = shp->sh_addr;
 
   /* Checking if the section can fit into the destination memory area.*/
   if (!chMemIsAreaWithinX(ctxp->map, &esip->area)) {
@@ -231,6 +243,7 @@ static msg_t allocate_load_section(elf_load_context_t *ctxp,
   esip->section   = section;
   esip->area.base = ctxp->map->base + (size_t)shp->sh_addr;
   esip->area.size = (size_t)shp->sh_size;
+  esip->addr      = shp->sh_addr;
 
   /* Checking if the section can fit into the destination memory area.*/
   if (!chMemIsAreaWithinX(ctxp->map, &esip->area)) {
@@ -242,17 +255,92 @@ static msg_t allocate_load_section(elf_load_context_t *ctxp,
     return CH_RET_ENOEXEC;
   }
 
-  /* Loading section data.*/
-  ret = vfsSetFilePosition(ctxp->fnp, (vfs_offset_t)shp->sh_offset, VFS_SEEK_SET);
-  CH_RETURN_ON_ERROR(ret);
-  ret = vfsReadFile(ctxp->fnp, (void *)esip->area.base, esip->area.size);
-  CH_RETURN_ON_ERROR(ret);
+  /* Loading section data, directly from the file mapping if available.*/
+  if (ctxp->image != NULL) {
+    if (((size_t)shp->sh_offset > ctxp->image_size) ||
+        (esip->area.size > ctxp->image_size - (size_t)shp->sh_offset)) {
+      return CH_RET_ENOEXEC;
+    }
+    memcpy((void *)esip->area.base,
+           (const void *)(ctxp->image + shp->sh_offset),
+           esip->area.size);
+    ret = CH_RET_SUCCESS;
+  }
+  else {
+    ret = vfsReadFileAt(ctxp->fnp, (void *)esip->area.base, esip->area.size,
+                        (vfs_offset_t)shp->sh_offset);
+    CH_RETURN_ON_ERROR(ret);
+  }
 
   ctxp->next++;
 
   return ret;
 }
 
+static msg_t allocate_map_section(elf_load_context_t *ctxp,
+                                  elf_secnum_t section,
+                                  const elf32_section_header_t *shp) {
+  elf_section_info_t *esip;
+  memory_area_t area;
+
+  /* The section data must be inside the file and the mapped range must be
+     accessible to the sandbox, else the section is loaded in RAM.*/
+  if (((size_t)shp->sh_offset > ctxp->image_size) ||
+      ((size_t)shp->sh_size > ctxp->image_size - (size_t)shp->sh_offset)) {
+    return CH_RET_ENOEXEC;
+  }
+  area.base = (uint8_t *)ctxp->image + shp->sh_offset;
+  area.size = (size_t)shp->sh_size;
+  if (!chMemIsAreaWithinX(ctxp->xmap, &area)) {
+    return allocate_load_section(ctxp, section, shp);
+  }
+
+  /* Checking if there is space in the sections table.*/
+  if (ctxp->next >= &ctxp->allocated[SB_CFG_ELF_MAX_ALLOCATED]) {
+    return CH_RET_ENOMEM;
+  }
+
+  /* Adding an entry for this section, it is accessed in place unless
+     relocations make it impossible, this is verified later.*/
+  esip = ctxp->next;
+  esip->section = section;
+  esip->area    = area;
+  esip->addr    = shp->sh_addr;
+  esip->mapped  = true;
+
+  ctxp->mapped_num++;
+  ctxp->next++;
+
+  return CH_RET_SUCCESS;
+}
+
+static msg_t unmap_section(elf_load_context_t *ctxp,
+                           elf_section_info_t *esip) {
+  const uint8_t *src = (const uint8_t *)esip->area.base;
+  elf_section_info_t *p;
+
+  /* Moving the section to its position in the RAM area.*/
+  esip->area.base = ctxp->map->base + (size_t)esip->addr;
+  esip->mapped    = false;
+  ctxp->mapped_num--;
+
+  /* Checking if the section can fit into the destination memory area.*/
+  if (!chMemIsAreaWithinX(ctxp->map, &esip->area)) {
+    return CH_RET_ENOMEM;
+  }
+
+  /* Checking if this section is overlapping some other allocated section.*/
+  for (p = &ctxp->allocated[0]; p < ctxp->next; p++) {
+    if ((p != esip) && chMemIsAreaIntersectingX(&p->area, &esip->area)) {
+      return CH_RET_ENOEXEC;
+    }
+  }
+
+  memcpy((void *)esip->area.base, (const void *)src, esip->area.size);
+
+  return CH_RET_SUCCESS;
+}
+
 static elf_section_info_t *find_allocated_section(elf_load_context_t *ctxp,
                                                   elf_secnum_t section) {
   elf_section_info_t *esip;
@@ -267,6 +355,134 @@ static elf_section_info_t *find_allocated_section(elf_load_context_t *ctxp,
   return NULL;
 }
 
+static elf_section_info_t *find_symbol_section(elf_load_context_t *ctxp,
+                                               uint32_t symbol) {
+
+  /* Undefined, absolute and unknown symbols are not associated to any
+     loaded section.*/
+  if ((symbol == 0U) || (symbol >= ctxp->symbols_num)) {
+    return NULL;
+  }
+
+  return find_allocated_section(ctxp,
+                                (elf_secnum_t)ctxp->symbols[symbol].st_shndx);
+}
+
+static uint32_t get_section_delta(elf_load_context_t *ctxp,
+                                  elf_section_info_t *esip) {
+
+  /* Sections not loaded are assumed to be relative to the RAM area.*/
+  if (esip == NULL) {
+    return (uint32_t)ctxp->map->base;
+  }
+
+  return (uint32_t)esip->area.base - esip->addr;
+}
+
+static uint32_t get_symbol_delta(elf_load_context_t *ctxp, uint32_t symbol) {
+  elf_secnum_t section;
+
+  /* Without mapped sections everything is relative to the RAM area.*/
+  if (ctxp->mapped_num == 0U) {
+    return (uint32_t)ctxp->map->base;
+  }
+
+  /* Undefined, absolute and unknown symbols are relative to the RAM area.*/
+  if ((symbol == 0U) || (symbol >= ctxp->symbols_num)) {
+    return (uint32_t)ctxp->map->base;
+  }
+
+  /* Consecutive relocations usually refer the same section, the last
+     displacement is cached, sections no more change at this point.*/
+  section = (elf_secnum_t)ctxp->symbols[symbol].st_shndx;
+  if (section != ctxp->delta_section) {
+    ctxp->delta_section = section;
+    ctxp->delta = get_section_delta(ctxp,
+                                    find_allocated_section(ctxp, section));
+  }
+
+  return ctxp->delta;
+}
+
+static bool is_absolute(uint32_t type) {
+
+  switch (type) {
+  case R_ARM_ABS32:
+  case R_ARM_THM_MOVW_ABS_NC:
+  case R_ARM_THM_MOVT_ABS:
+    return true;
+  default:
+    return false;
+  }
+}
+
+static msg_t resolve_mapped_sections(elf_load_context_t *ctxp) {
+  elf_section_info_t *esip, *tesip;
+  bool changed;
+  msg_t ret;
+
+  /* Without symbols the relocations targets cannot be identified.*/
+  if (ctxp->symbols == NULL) {
+    for (esip = &ctxp->allocated[0]; esip < ctxp->next; esip++) {
+      if (esip->mapped) {
+        ret = unmap_section(ctxp, esip);
+        CH_RETURN_ON_ERROR(ret);
+      }
+    }
+    return CH_RET_SUCCESS;
+  }
+
+  /* A mapped section cannot be patched so it must not contain absolute
+     relocations and any other relocation must not cross to sections with
+     a different displacement. A RAM section referring a mapped section
+     through a non-absolute relocation would keep a wrong displacement so
+     the target is moved to RAM too. Moving a section to RAM can invalidate
+     other sections so iterating until nothing changes. A RAM section
+     moves its targets immediately so it is checked only once.*/
+  do {
+    changed = false;
+    for (esip = &ctxp->allocated[0]; esip < ctxp->next; esip++) {
+      const elf32_rel_t *rp, *end;
+      bool ram = !esip->mapped;
+
+      if ((esip->rel_size == 0U) || esip->checked) {
+        continue;
+      }
+
+      rp  = (const elf32_rel_t *)(const void *)(ctxp->image + esip->rel_off);
+      end = rp + (esip->rel_size / sizeof (elf32_rel_t));
+      for (; rp < end; rp++) {
+        uint32_t type = ELF32_R_TYPE(rp->r_info);
+
+        /* Absolute relocations are patched in RAM sections, skipping the
+           symbol lookup.*/
+        if (ram && is_absolute(type)) {
+          continue;
+        }
+
+        tesip = find_symbol_section(ctxp, ELF32_R_SYM(rp->r_info));
+        if (esip->mapped) {
+          if (is_absolute(type) ||
+              (get_section_delta(ctxp, tesip) != get_section_delta(ctxp, esip))) {
+            ret = unmap_section(ctxp, esip);
+            CH_RETURN_ON_ERROR(ret);
+            changed = true;
+            break;
+          }
+        }
+        else if ((tesip != NULL) && tesip->mapped) {
+          ret = unmap_section(ctxp, tesip);
+          CH_RETURN_ON_ERROR(ret);
+          changed = true;
+        }
+      }
+      esip->checked = ram;
+    }
+  } while (changed);
+
+  return CH_RET_SUCCESS;
+}
+
 static uint32_t get_const16(uint32_t address) {
   uint32_t ins  = ((uint32_t)(((uint16_t *)address)[0]) << 16) |
                   ((uint32_t)(((uint16_t *)address)[1]) << 0);
@@ -293,7 +509,7 @@ static void set_const16(uint32_t address, uint32_t val16) {
 
 static msg_t reloc_entry(elf_load_context_t *ctxp,
                          elf_section_info_t *esip,
-                         elf32_rel_t *rp) {
+                         const elf32_rel_t *rp) {
   uint32_t relocation_address, offset;
 
   /* Relocation point address.*/
@@ -307,7 +523,8 @@ static msg_t reloc_entry(elf_load_context_t *ctxp,
   /* Handling the various relocation point types.*/
   switch (ELF32_R_TYPE(ELF32_R_TYPE(rp->r_info))) {
   case R_ARM_ABS32:
-    *((uint32_t *)relocation_address) += (uint32_t)ctxp->map->base;
+    *((uint32_t *)relocation_address) += get_symbol_delta(ctxp,
+                                                          ELF32_R_SYM(rp->r_info));
     break;
   case R_ARM_THM_MOVW_ABS_NC:
     /* Checking for consecutive "movw" relocations without a "movt", we
@@ -336,7 +553,7 @@ static msg_t reloc_entry(elf_load_context_t *ctxp,
     /* Relocating both the "movw" and the "movt" instructions.*/
     offset  = (get_const16(relocation_address) << 16) |
               (get_const16(ctxp->rel_movw_address) << 0);
-    offset += (uint32_t)ctxp->map->base;
+    offset += get_symbol_delta(ctxp, ELF32_R_SYM(rp->r_info));
     set_const16(relocation_address, offset >> 16);
     set_const16(ctxp->rel_movw_address, offset & 0xFFFFU);
 
@@ -363,6 +580,21 @@ static msg_t reloc_section(elf_load_context_t *ctxp,
   size_t size, done_size, remaining_size;
   msg_t ret;
 
+  /* Relocations are processed directly from the file mapping if
+     available.*/
+  if (ctxp->image != NULL) {
+    const elf32_rel_t *rp, *end;
+
+    rp  = (const elf32_rel_t *)(const void *)(ctxp->image + esip->rel_off);
+    end = rp + (esip->rel_size / sizeof (elf32_rel_t));
+    for (; rp < end; rp++) {
+      ret = reloc_entry(ctxp, esip, rp);
+      CH_RETURN_ON_ERROR(ret);
+    }
+
+    return CH_RET_SUCCESS;
+  }
+
   shbuf = vfs_buffer_take_wait();
   rbuf = (elf32_rel_t *)(void *)shbuf->buf;
 
@@ -382,11 +614,8 @@ static msg_t reloc_section(elf_load_context_t *ctxp,
     }
 
     /* Reading a buffer-worth of relocation data.*/
-    ret = vfsSetFilePosition(ctxp->fnp,
-                             esip->rel_off + (vfs_offset_t)done_size,
-                             VFS_SEEK_SET);
-    CH_BREAK_ON_ERROR(ret);
-    ret = vfsReadFile(ctxp->fnp, (void *)rbuf, size);
+    ret = vfsReadFileAt(ctxp->fnp, (void *)rbuf, size,
+                        esip->rel_off + (vfs_offset_t)done_size);
     CH_BREAK_ON_ERROR(ret);
 
     /* Number of relocation entries in the buffer.*/
@@ -406,11 +635,9 @@ static msg_t reloc_section(elf_load_context_t *ctxp,
   return ret;
 }
 
-/*===========================================================================*/
-/* Module exported functions.                                                */
-/*===========================================================================*/
-
-msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
+static msg_t elf_load(vfs_file_node_c *fnp,
+                      const memory_area_t *map,
+                      const memory_area_t *xmap) {
   msg_t ret;
   elf_load_context_t ctx;
   elf_section_info_t *esip;
@@ -431,12 +658,34 @@ msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
     /* Initializing the fixed part of the context.*/
     ctx.fnp  = fnp;
     ctx.map  = map;
+    ctx.xmap = xmap;
     ctx.next = &ctx.allocated[0];
 
+    /* Section zero is never allocated, it is relative to the RAM area.*/
+    ctx.delta_section = SHN_UNDEF;
+    ctx.delta         = (uint32_t)map->base;
+
+    /* If in-place execution is requested then the whole file must be
+       directly addressable, else falling back to a normal load.*/
+    if (xmap != NULL) {
+      vfs_stat_t st;
+
+      ret = vfsGetNodeStat((vfs_node_c *)fnp, &st);
+      CH_RETURN_ON_ERROR(ret);
+
+      if ((st.size > (vfs_offset_t)0) &&
+          (vfsGetFileMapping(fnp, (vfs_offset_t)0, (size_t)st.size,
+                             &ctx.image) == CH_RET_SUCCESS)) {
+        ctx.image_size = (size_t)st.size;
+      }
+      else {
+        ctx.image = NULL;
+      }
+    }
+
     /* Reading the main ELF header.*/
-    ret = vfsSetFilePosition(ctx.fnp, (vfs_offset_t)0, VFS_SEEK_SET);
-    CH_RETURN_ON_ERROR(ret);
-    ret = vfsReadFile(ctx.fnp, (void *)&u.h, sizeof (elf32_header_t));
+    ret = vfsReadFileAt(ctx.fnp, (void *)&u.h, sizeof (elf32_header_t),
+                        (vfs_offset_t)0);
     CH_RETURN_ON_ERROR(ret);
 
     /* Checking for the expected header.*/
@@ -464,12 +713,10 @@ msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
     for (i = 0U; i < ctx.sections_num; i++) {
 
       /* Reading the header.*/
-      ret = vfsSetFilePosition(ctx.fnp,
-                               ctx.sections_off + ((vfs_offset_t)i *
-                                                   (vfs_offset_t)sizeof (elf32_section_header_t)),
-                               VFS_SEEK_SET);
-      CH_RETURN_ON_ERROR(ret);
-      ret = vfsReadFile(ctx.fnp, (void *)&u.sh, sizeof (elf32_section_header_t));
+      ret = vfsReadFileAt(ctx.fnp, (void *)&u.sh,
+                          sizeof (elf32_section_header_t),
+                          ctx.sections_off + ((vfs_offset_t)i *
+                                              (vfs_offset_t)sizeof (elf32_section_header_t)));
       CH_RETURN_ON_ERROR(ret);
 
       /* Empty sections are not processed.*/
@@ -483,6 +730,13 @@ msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
         /* Allocatable section type, needs to be loaded.*/
         if ((u.sh.sh_flags & SHF_ALLOC) != 0U) {
 
+          /* Read-only sections are candidates for in-place access.*/
+          if ((ctx.image != NULL) && ((u.sh.sh_flags & SHF_WRITE) == 0U)) {
+            ret = allocate_map_section(&ctx, i, &u.sh);
+            CH_RETURN_ON_ERROR(ret);
+            break;
+          }
+
           /* Allocating and loading, could fail.*/
           ret = allocate_load_section(&ctx, i, &u.sh);
           CH_RETURN_ON_ERROR(ret);
@@ -512,11 +766,31 @@ msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
             return CH_RET_ENOEXEC;
           }
 
+          /* Relocations are accessed in place when the file is mapped.*/
+          if ((ctx.image != NULL) &&
+              (((size_t)u.sh.sh_offset > ctx.image_size) ||
+               ((size_t)u.sh.sh_size > ctx.image_size - (size_t)u.sh.sh_offset) ||
+               ((u.sh.sh_offset & 3U) != 0U))) {
+            return CH_RET_ENOEXEC;
+          }
+
           esip->rel_size = u.sh.sh_size;
           esip->rel_off  = (vfs_offset_t)u.sh.sh_offset;
         }
         break;
 
+      case SHT_SYMTAB:
+        /* Symbols are required to locate the targets of relocations when
+           some sections are accessed in place.*/
+        if ((ctx.image != NULL) &&
+            ((size_t)u.sh.sh_offset <= ctx.image_size) &&
+            ((size_t)u.sh.sh_size <= ctx.image_size - (size_t)u.sh.sh_offset) &&
+            ((u.sh.sh_offset & 3U) == 0U)) {
+          ctx.symbols     = (const elf32_symbol_t *)(const void *)(ctx.image + u.sh.sh_offset);
+          ctx.symbols_num = (unsigned)(u.sh.sh_size / sizeof (elf32_symbol_t));
+        }
+        break;
+
       default:
         /* Ignoring other section types.*/
         break;
@@ -524,9 +798,17 @@ msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
     }
   }
 
-  /* Relocating all sections with an associated relocation table.*/
+  /* Deciding which candidate sections can really be accessed in place,
+     the others are moved to RAM.*/
+  if (ctx.mapped_num > 0U) {
+    ret = resolve_mapped_sections(&ctx);
+    CH_RETURN_ON_ERROR(ret);
+  }
+
+  /* Relocating all sections with an associated relocation table, mapped
+     sections do not need it.*/
   for (esip = &ctx.allocated[0]; esip < ctx.next; esip++) {
-    if (esip->rel_off != (vfs_offset_t)0) {
+    if ((esip->rel_off != (vfs_offset_t)0) && !esip->mapped) {
       ret = reloc_section(&ctx, esip);
       CH_RETURN_ON_ERROR(ret);
     }
@@ -535,9 +817,33 @@ msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
   return ret;
 }
 
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
+
+  return elf_load(fnp, map, NULL);
+}
+
+msg_t sbElfLoadInPlace(vfs_file_node_c *fnp,
+                       const memory_area_t *map,
+                       const memory_area_t *xmap) {
+
+  return elf_load(fnp, map, xmap);
+}
+
 msg_t sbElfLoadFile(vfs_driver_c *drvp,
                     const char *path,
                     const memory_area_t *map) {
+
+  return sbElfLoadFileInPlace(drvp, path, map, NULL);
+}
+
+msg_t sbElfLoadFileInPlace(vfs_driver_c *drvp,
+                           const char *path,
+                           const memory_area_t *map,
+                           const memory_area_t *xmap) {
   vfs_file_node_c *fnp;
   msg_t ret;
 
@@ -545,7 +851,7 @@ msg_t sbElfLoadFile(vfs_driver_c *drvp,
   CH_RETURN_ON_ERROR(ret);
 
   do {
-    ret = sbElfLoad(fnp, map);
+    ret = elf_load(fnp, map, xmap);
     CH_BREAK_ON_ERROR(ret);
 
   } while (false);
@@ -574,9 +880,8 @@ msg_t sbElfGetAllocation(vfs_file_node_c *fnp, size_t *sizep) {
   /* Load context initialization.*/
   {
     /* Reading the main ELF header.*/
-    ret = vfsSetFilePosition(fnp, (vfs_offset_t)0, VFS_SEEK_SET);
-    CH_RETURN_ON_ERROR(ret);
-    ret = vfsReadFile(fnp, (void *)&u.h, sizeof (elf32_header_t));
+    ret = vfsReadFileAt(fnp, (void *)&u.h, sizeof (elf32_header_t),
+                        (vfs_offset_t)0);
     CH_RETURN_ON_ERROR(ret);
 
     /* Checking for the expected header.*/
@@ -602,12 +907,10 @@ msg_t sbElfGetAllocation(vfs_file_node_c *fnp, size_t *sizep) {
     for (i = 0U; i < sections_num; i++) {
 
       /* Reading the header.*/
-      ret = vfsSetFilePosition(fnp,
-                               sections_off + ((vfs_offset_t)i *
-                                               (vfs_offset_t)sizeof (elf32_section_header_t)),
-                               VFS_SEEK_SET);
-      CH_RETURN_ON_ERROR(ret);
-      ret = vfsReadFile(fnp, (void *)&u.sh, sizeof (elf32_section_header_t));
+      ret = vfsReadFileAt(fnp, (void *)&u.sh,
+                          sizeof (elf32_section_header_t),
+                          sections_off + ((vfs_offset_t)i *
+                                          (vfs_offset_t)sizeof (elf32_section_header_t)));
       CH_RETURN_ON_ERROR(ret);
 
       /* Empty sections are not processed.*/
@@ -45,6 +45,23 @@
 #define SB_CFG_ELF_MAX_ALLOCATED        6
 #endif
 
+/**
+ * @brief   Enables in-place access to read-only sections of sandbox files.
+ * @details If enabled, read-only sections of files that can be directly
+ *          addressed are not copied into the sandbox RAM area, those are
+ *          accessed in place if located inside a non-writable executable
+ *          region of the sandbox and not requiring relocation.
+ * @note    With the current sandbox linker scripts @p .text contains
+ *          absolute relocations and is always loaded in RAM, only
+ *          relocation-free read-only data is accessed in place.
+ * @note    The RAM layout of the sandbox is not changed, space is still
+ *          reserved for sections accessed in place, the gain is the load
+ *          time.
+ */
+#if !defined(SB_CFG_ELF_ENABLE_XIP) || defined(__DOXYGEN__)
+#define SB_CFG_ELF_ENABLE_XIP           FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -70,9 +87,16 @@ extern "C" {
 #endif
   msg_t sbElfLoad(vfs_file_node_c *fnp,
                   const memory_area_t *map);
+  msg_t sbElfLoadInPlace(vfs_file_node_c *fnp,
+                         const memory_area_t *map,
+                         const memory_area_t *xmap);
   msg_t sbElfLoadFile(vfs_driver_c *drvp,
                       const char *path,
                       const memory_area_t *map);
+  msg_t sbElfLoadFileInPlace(vfs_driver_c *drvp,
+                             const char *path,
+                             const memory_area_t *map,
+                             const memory_area_t *xmap);
   msg_t sbElfGetAllocation(vfs_file_node_c *fnp, size_t *sizep);
 #ifdef __cplusplus
 }
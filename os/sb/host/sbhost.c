@@ -271,6 +271,23 @@ static const sb_memory_region_t *sb_locate_data_region(sb_class_t *sbp) {
   return NULL;
 }
 
+#if (SB_CFG_ENABLE_VFS == TRUE) && (SB_CFG_ELF_ENABLE_XIP == TRUE)
+static const sb_memory_region_t *sb_locate_xip_region(sb_class_t *sbp) {
+  const sb_memory_region_t *rp = &sbp->regions[1];
+
+  /* Region zero is always the RAM area where the file is loaded.*/
+  while (rp < &sbp->regions[SB_CFG_NUM_REGIONS]) {
+    if (sb_reg_is_memory(rp) && sb_reg_is_executable(rp) &&
+        !sb_reg_is_writable(rp)) {
+      return rp;
+    }
+    rp++;
+  }
+
+  return NULL;
+}
+#endif
+
 static size_t sb_init_environment(sb_class_t *sbp, const memory_area_t *up,
                                   const char *argv[], const char *envp[]) {
   void *usp, *uargv, *uenvp;
@@ -576,6 +593,12 @@ thread_t *sbStart(sb_class_t *sbp, tprio_t prio, stkline_t *stkbase,
  * @note    The file is loaded into region zero of the sandbox which is
  *          assumed to be used for both code and data, extra regions are
  *          not touched by this function.
+ * @note    If @p SB_CFG_ELF_ENABLE_XIP is enabled and the sandbox has a
+ *          non-writable executable region then read-only sections of
+ *          directly addressable files located inside that region are
+ *          accessed in place instead of being copied into region zero,
+ *          unless they require relocation. Region zero must still be
+ *          large enough for the whole image.
  * @note    The size of the privileged stack is assumed to be always
  *          @p SB_CFG_PRIVILEGED_STACK_SIZE.
  *
@@ -594,6 +617,9 @@ msg_t sbExecStatic(sb_class_t *sbp, tprio_t prio,
                    const char *argv[], const char *envp[]) {
   memory_area_t ma = sbp->regions[0].area;
   const sb_header_t *sbhp;
+#if SB_CFG_ELF_ENABLE_XIP == TRUE
+  const sb_memory_region_t *xrp = sb_locate_xip_region(sbp);
+#endif
   size_t totsize;
   msg_t ret;
 
@@ -609,7 +635,12 @@ msg_t sbExecStatic(sb_class_t *sbp, tprio_t prio,
   ma.size -= totsize;
 
   /* Loading sandbox code into the specified memory area.*/
+#if SB_CFG_ELF_ENABLE_XIP == TRUE
+  ret = sbElfLoadFileInPlace(sbp->io.vfs_driver, path, &ma,
+                             xrp != NULL ? &xrp->area : NULL);
+#else
   ret = sbElfLoadFile(sbp->io.vfs_driver, path, &ma);
+#endif
   CH_RETURN_ON_ERROR(ret);
 
   /* Header location.*/
@@ -628,11 +659,23 @@ msg_t sbExecStatic(sb_class_t *sbp, tprio_t prio,
 
   /* Checking header entry point.*/
   if (!chMemIsSpaceWithinX(&ma, (const void *)sbhp->hdr_entry, (size_t)2)) {
+#if SB_CFG_ELF_ENABLE_XIP == TRUE
+    /* The entry point can be in code executed in place.*/
+    if ((xrp == NULL) ||
+        !chMemIsSpaceWithinX(&xrp->area, (const void *)sbhp->hdr_entry,
+                             (size_t)2)) {
+      return CH_RET_EFAULT;
+    }
+#else
     return CH_RET_EFAULT;
+#endif
   }
 
 #if SB_CFG_EXEC_DEBUG == TRUE
-  *((uint16_t *)(sbhp->hdr_entry & ~(uint32_t)1)) = 0xBE00U;
+  /* Code executed in place cannot be patched.*/
+  if (chMemIsSpaceWithinX(&ma, (const void *)sbhp->hdr_entry, (size_t)2)) {
+    *((uint16_t *)(sbhp->hdr_entry & ~(uint32_t)1)) = 0xBE00U;
+  }
 #endif
 
   /* No memory release.*/
@@ -30,6 +30,7 @@
 #if (SB_CFG_ENABLE_VFS == TRUE) || defined(__DOXYGEN__)
 
 #include <dirent.h>
+#include "uio.h"
 
 /*===========================================================================*/
 /* Module local definitions.                                                 */
@@ -260,6 +261,192 @@ static off_t sb_io_lseek(sb_class_t *sbp, int fd, off_t offset, int whence) {
                             whence);;
 }
 
+static ssize_t sb_io_pread(sb_class_t *sbp, int fd, void *buf, size_t count,
+                           off_t offset) {
+
+  if (!sb_is_existing_descriptor(&sbp->io, fd)) {
+    return CH_RET_EBADF;
+  }
+
+  if (VFS_MODE_S_ISDIR(sbp->io.vfs_nodes[fd]->mode)) {
+    return CH_RET_EISDIR;
+  }
+
+  if (!VFS_MODE_S_ISREG(sbp->io.vfs_nodes[fd]->mode)) {
+    return CH_RET_ESPIPE;
+  }
+
+  if (count == (size_t)0) {
+    return 0;
+  }
+
+  if (!sb_is_valid_write_range(sbp, buf, count)) {
+    return CH_RET_EFAULT;
+  }
+
+  return vfsReadFileAt((vfs_file_node_c *)sbp->io.vfs_nodes[fd],
+                       buf, count, (vfs_offset_t)offset);
+}
+
+static ssize_t sb_io_pwrite(sb_class_t *sbp, int fd, const void *buf,
+                            size_t count, off_t offset) {
+
+  if (!sb_is_existing_descriptor(&sbp->io, fd)) {
+    return CH_RET_EBADF;
+  }
+
+  if (VFS_MODE_S_ISDIR(sbp->io.vfs_nodes[fd]->mode)) {
+    return CH_RET_EISDIR;
+  }
+
+  if (!VFS_MODE_S_ISREG(sbp->io.vfs_nodes[fd]->mode)) {
+    return CH_RET_ESPIPE;
+  }
+
+  if (count == (size_t)0) {
+    return 0;
+  }
+
+  if (!sb_is_valid_read_range(sbp, buf, count)) {
+    return CH_RET_EFAULT;
+  }
+
+  return vfsWriteFileAt((vfs_file_node_c *)sbp->io.vfs_nodes[fd],
+                        buf, count, (vfs_offset_t)offset);
+}
+
+static msg_t sb_io_iov_import(sb_class_t *sbp, const struct iovec *iov,
+                              int iovcnt, bool towrite, vfs_iovec_t *viov) {
+  int i;
+
+  if ((iovcnt <= 0) || (iovcnt > IOV_MAX)) {
+    return CH_RET_EINVAL;
+  }
+
+  if (!sb_is_valid_read_range(sbp, (const void *)iov,
+                              (size_t)iovcnt * sizeof (struct iovec))) {
+    return CH_RET_EFAULT;
+  }
+
+  /* Descriptors are validated on a local copy, the sandbox could change
+     them while the call is in progress.*/
+  for (i = 0; i < iovcnt; i++) {
+    viov[i].base = iov[i].iov_base;
+    viov[i].len  = iov[i].iov_len;
+
+    if (viov[i].len > (size_t)0) {
+      bool valid;
+
+      if (towrite) {
+        valid = sb_is_valid_write_range(sbp, viov[i].base, viov[i].len);
+      }
+      else {
+        valid = sb_is_valid_read_range(sbp, viov[i].base, viov[i].len);
+      }
+      if (!valid) {
+        return CH_RET_EFAULT;
+      }
+    }
+  }
+
+  return CH_RET_SUCCESS;
+}
+
+static ssize_t sb_io_readv(sb_class_t *sbp, int fd,
+                           const struct iovec *iov, int iovcnt) {
+  vfs_iovec_t viov[IOV_MAX];
+  msg_t ret;
+
+  if (!sb_is_existing_descriptor(&sbp->io, fd)) {
+    return CH_RET_EBADF;
+  }
+
+  if (VFS_MODE_S_ISDIR(sbp->io.vfs_nodes[fd]->mode)) {
+    return CH_RET_EISDIR;
+  }
+
+  ret = sb_io_iov_import(sbp, iov, iovcnt, true, viov);
+  CH_RETURN_ON_ERROR(ret);
+
+  return vfsReadFileVector((vfs_file_node_c *)sbp->io.vfs_nodes[fd],
+                           viov, (unsigned)iovcnt);
+}
+
+static ssize_t sb_io_writev(sb_class_t *sbp, int fd,
+                            const struct iovec *iov, int iovcnt) {
+  vfs_iovec_t viov[IOV_MAX];
+  msg_t ret;
+
+  if (!sb_is_existing_descriptor(&sbp->io, fd)) {
+    return CH_RET_EBADF;
+  }
+
+  if (VFS_MODE_S_ISDIR(sbp->io.vfs_nodes[fd]->mode)) {
+    return CH_RET_EISDIR;
+  }
+
+  ret = sb_io_iov_import(sbp, iov, iovcnt, false, viov);
+  CH_RETURN_ON_ERROR(ret);
+
+  return vfsWriteFileVector((vfs_file_node_c *)sbp->io.vfs_nodes[fd],
+                            viov, (unsigned)iovcnt);
+}
+
+static ssize_t sb_io_sendfile(sb_class_t *sbp, int outfd, int infd,
+                              off_t *offset, size_t count) {
+  vfs_file_node_c *vfnp;
+  sequential_stream_i *stmp;
+  vfs_offset_t pos;
+  off_t start;
+  ssize_t n;
+  msg_t ret;
+
+  if (!sb_is_existing_descriptor(&sbp->io, outfd) ||
+      !sb_is_existing_descriptor(&sbp->io, infd)) {
+    return CH_RET_EBADF;
+  }
+
+  if (VFS_MODE_S_ISDIR(sbp->io.vfs_nodes[outfd]->mode) ||
+      VFS_MODE_S_ISDIR(sbp->io.vfs_nodes[infd]->mode)) {
+    return CH_RET_EISDIR;
+  }
+
+  if (offset != NULL) {
+    if (!VFS_MODE_S_ISREG(sbp->io.vfs_nodes[infd]->mode)) {
+      return CH_RET_ESPIPE;
+    }
+
+    if (!sb_is_valid_write_range(sbp, (void *)offset, sizeof (off_t))) {
+      return CH_RET_EFAULT;
+    }
+  }
+
+  if (count == (size_t)0) {
+    return 0;
+  }
+
+  vfnp = (vfs_file_node_c *)sbp->io.vfs_nodes[infd];
+  stmp = vfsGetFileStream((vfs_file_node_c *)sbp->io.vfs_nodes[outfd]);
+
+  if (offset == NULL) {
+    return vfsSpliceFile(vfnp, stmp, count);
+  }
+
+  /* Transfer from an explicit offset, the file position is preserved.*/
+  start = *offset;
+  pos = vfsGetFilePosition(vfnp);
+  ret = vfsSetFilePosition(vfnp, (vfs_offset_t)start, VFS_SEEK_SET);
+  CH_RETURN_ON_ERROR(ret);
+
+  n = vfsSpliceFile(vfnp, stmp, count);
+  (void) vfsSetFilePosition(vfnp, pos, VFS_SEEK_SET);
+  if (n > (ssize_t)0) {
+    *offset = start + (off_t)n;
+  }
+
+  return n;
+}
+
 static ssize_t sb_io_getdents(sb_class_t *sbp, int fd, void *buf, size_t count) {
   vfs_shared_buffer_t *shbuf;
   vfs_direntry_info_t *dip;
@@ -371,6 +558,110 @@ static int sb_io_rmdir(sb_class_t *sbp, const char *path) {
   return (int)vfsDrvRmdir(sbp->io.vfs_driver, path);
 }
 
+static int sb_io_ioring_setup(sb_class_t *sbp, sb_ioring_t *ringp) {
+
+  /* A NULL pointer unregisters the current ring, if any.*/
+  if (ringp == NULL) {
+    sbp->io.ioring = NULL;
+    return CH_RET_SUCCESS;
+  }
+
+  /* The ring is validated once here, it has to be entirely inside a
+     writable region of the sandbox.*/
+  if (!MEM_IS_ALIGNED(ringp, sizeof (uint32_t)) ||
+      !sb_is_valid_write_range(sbp, (void *)ringp, sizeof (sb_ioring_t))) {
+    return CH_RET_EFAULT;
+  }
+
+  /* Rings always start empty, the host keeps its own copy of the indexes
+     it owns so the sandbox cannot alter them.*/
+  ringp->sq_head = 0U;
+  ringp->sq_tail = 0U;
+  ringp->cq_head = 0U;
+  ringp->cq_tail = 0U;
+  sbp->io.ioring         = ringp;
+  sbp->io.ioring_sq_head = 0U;
+  sbp->io.ioring_cq_tail = 0U;
+
+  return CH_RET_SUCCESS;
+}
+
+static int sb_io_ioring_enter(sb_class_t *sbp) {
+  sb_ioring_t *ringp = sbp->io.ioring;
+  uint32_t sq_head, sq_tail, cq_tail, cq_head;
+  int n;
+
+  if (ringp == NULL) {
+    return CH_RET_EINVAL;
+  }
+
+  /* Indexes written by the sandbox are sampled once and checked against
+     the host copies of the other indexes.*/
+  sq_head = sbp->io.ioring_sq_head;
+  cq_tail = sbp->io.ioring_cq_tail;
+  sq_tail = ringp->sq_tail;
+  cq_head = ringp->cq_head;
+  if (((sq_tail - sq_head) > (uint32_t)SB_IORING_ENTRIES) ||
+      ((cq_tail - cq_head) > (uint32_t)SB_IORING_ENTRIES)) {
+    return CH_RET_EINVAL;
+  }
+
+  /* Processing queued operations while there is space for results.*/
+  n = 0;
+  while ((sq_head != sq_tail) &&
+         ((cq_tail - cq_head) < (uint32_t)SB_IORING_ENTRIES)) {
+    sb_ioring_sqe_t sqe;
+    sb_ioring_cqe_t *cqep;
+    int32_t result;
+
+    /* Working on a local copy, the sandbox could change the entry while
+       the operation is in progress.*/
+    sqe = ringp->sqes[sq_head & ((uint32_t)SB_IORING_ENTRIES - 1U)];
+
+    switch (sqe.opcode) {
+    case SB_POSIX_CLOSE:
+      result = (int32_t)sb_io_close(sbp, (int)sqe.fd);
+      break;
+    case SB_POSIX_READ:
+      result = (int32_t)sb_io_read(sbp, (int)sqe.fd, sqe.buf,
+                                   (size_t)sqe.count);
+      break;
+    case SB_POSIX_WRITE:
+      result = (int32_t)sb_io_write(sbp, (int)sqe.fd, (const void *)sqe.buf,
+                                    (size_t)sqe.count);
+      break;
+    case SB_POSIX_PREAD:
+      result = (int32_t)sb_io_pread(sbp, (int)sqe.fd, sqe.buf,
+                                    (size_t)sqe.count, (off_t)sqe.offset);
+      break;
+    case SB_POSIX_PWRITE:
+      result = (int32_t)sb_io_pwrite(sbp, (int)sqe.fd, (const void *)sqe.buf,
+                                     (size_t)sqe.count, (off_t)sqe.offset);
+      break;
+    default:
+      result = (int32_t)CH_RET_ENOSYS;
+      break;
+    }
+
+    /* Posting the result.*/
+    cqep = &ringp->cqes[cq_tail & ((uint32_t)SB_IORING_ENTRIES - 1U)];
+    cqep->user_data = sqe.user_data;
+    cqep->result    = result;
+
+    sq_head++;
+    cq_tail++;
+    n++;
+  }
+
+  /* Publishing the new indexes.*/
+  sbp->io.ioring_sq_head = sq_head;
+  sbp->io.ioring_cq_tail = cq_tail;
+  ringp->sq_head = sq_head;
+  ringp->cq_tail = cq_tail;
+
+  return n;
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -385,6 +676,9 @@ void __sb_io_cleanup(sb_class_t *sbp) {
       sbp->io.vfs_nodes[fd] = NULL;
     }
   }
+
+  /* Forgetting the I/O ring, it is part of the terminated program.*/
+  sbp->io.ioring = NULL;
 }
 
 void sb_sysc_stdio(sb_class_t *sbp, struct port_extctx *ectxp) {
@@ -471,6 +765,45 @@ void sb_sysc_stdio(sb_class_t *sbp, struct port_extctx *ectxp) {
                                      (const char *)ectxp->r1,
                                      (struct stat *)ectxp->r2);
     break;
+  case SB_POSIX_PREAD:
+    ectxp->r0 = (uint32_t)sb_io_pread(sbp,
+                                      (int)ectxp->r1,
+                                      (void *)ectxp->r2,
+                                      (size_t)ectxp->r3,
+                                      (off_t)ectxp->r12);
+    break;
+  case SB_POSIX_PWRITE:
+    ectxp->r0 = (uint32_t)sb_io_pwrite(sbp,
+                                       (int)ectxp->r1,
+                                       (const void *)ectxp->r2,
+                                       (size_t)ectxp->r3,
+                                       (off_t)ectxp->r12);
+    break;
+  case SB_POSIX_READV:
+    ectxp->r0 = (uint32_t)sb_io_readv(sbp,
+                                      (int)ectxp->r1,
+                                      (const struct iovec *)ectxp->r2,
+                                      (int)ectxp->r3);
+    break;
+  case SB_POSIX_WRITEV:
+    ectxp->r0 = (uint32_t)sb_io_writev(sbp,
+                                       (int)ectxp->r1,
+                                       (const struct iovec *)ectxp->r2,
+                                       (int)ectxp->r3);
+    break;
+  case SB_POSIX_SENDFILE:
+    ectxp->r0 = (uint32_t)sb_io_sendfile(sbp,
+                                         (int)ectxp->r1,
+                                         (int)ectxp->r2,
+                                         (off_t *)ectxp->r3,
+                                         (size_t)ectxp->r12);
+    break;
+  case SB_POSIX_IORING_SETUP:
+    ectxp->r0 = (uint32_t)sb_io_ioring_setup(sbp, (sb_ioring_t *)ectxp->r1);
+    break;
+  case SB_POSIX_IORING_ENTER:
+    ectxp->r0 = (uint32_t)sb_io_ioring_enter(sbp);
+    break;
   default:
     ectxp->r0 = (uint32_t)CH_RET_ENOSYS;
     break;
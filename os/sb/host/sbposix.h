@@ -66,6 +66,18 @@ typedef struct {
    * @brief   VFS nodes associated to file descriptors.
    */
   vfs_node_c                    *vfs_nodes[SB_CFG_FD_NUM];
+  /**
+   * @brief   I/O ring registered by the sandbox or @p NULL.
+   */
+  sb_ioring_t                   *ioring;
+  /**
+   * @brief   Host copy of the submission ring head.
+   */
+  uint32_t                      ioring_sq_head;
+  /**
+   * @brief   Host copy of the completion ring tail.
+   */
+  uint32_t                      ioring_cq_tail;
 } sb_ioblock_t;
 #endif
 
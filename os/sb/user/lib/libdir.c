@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include <fcntl.h>
 #include <dirent.h>
+#include <uio.h>
 
 #include <reent.h>
 
@@ -80,6 +81,41 @@ struct dirent *readdir (DIR *dirp) {
   }
 }
 
+ssize_t pread(int fd, void *buf, size_t count, off_t offset) {
+  extern ssize_t _pread_r(struct _reent *r, int fd, void *buf, size_t count,
+                          off_t offset);
+
+  return _pread_r(_REENT, fd, buf, count, offset);
+}
+
+ssize_t pwrite(int fd, const void *buf, size_t count, off_t offset) {
+  extern ssize_t _pwrite_r(struct _reent *r, int fd, const void *buf,
+                           size_t count, off_t offset);
+
+  return _pwrite_r(_REENT, fd, buf, count, offset);
+}
+
+ssize_t readv(int fd, const struct iovec *iov, int iovcnt) {
+  extern ssize_t _readv_r(struct _reent *r, int fd, const struct iovec *iov,
+                          int iovcnt);
+
+  return _readv_r(_REENT, fd, iov, iovcnt);
+}
+
+ssize_t writev(int fd, const struct iovec *iov, int iovcnt) {
+  extern ssize_t _writev_r(struct _reent *r, int fd, const struct iovec *iov,
+                           int iovcnt);
+
+  return _writev_r(_REENT, fd, iov, iovcnt);
+}
+
+ssize_t sendfile(int out_fd, int in_fd, off_t *offset, size_t count) {
+  extern ssize_t _sendfile_r(struct _reent *r, int out_fd, int in_fd,
+                             off_t *offset, size_t count);
+
+  return _sendfile_r(_REENT, out_fd, in_fd, offset, count);
+}
+
 int chdir(const char *path) {
   extern int _chdir_r(struct _reent *r, const char *path);
 
@@ -188,6 +188,71 @@ int _getdents_r(struct _reent *r, int fd, void *dp, int count) {
   return n;
 }
 
+ssize_t _pread_r(struct _reent *r, int fd, void *buf, size_t count,
+                 off_t offset) {
+  ssize_t n;
+
+  n = sbPread(fd, buf, count, offset);
+  if (CH_RET_IS_ERROR(n)) {
+    __errno_r(r) = CH_DECODE_ERROR(n);
+    return -1;
+  }
+
+  return n;
+}
+
+ssize_t _pwrite_r(struct _reent *r, int fd, const void *buf, size_t count,
+                  off_t offset) {
+  ssize_t n;
+
+  n = sbPwrite(fd, buf, count, offset);
+  if (CH_RET_IS_ERROR(n)) {
+    __errno_r(r) = CH_DECODE_ERROR(n);
+    return -1;
+  }
+
+  return n;
+}
+
+ssize_t _readv_r(struct _reent *r, int fd, const struct iovec *iov,
+                 int iovcnt) {
+  ssize_t n;
+
+  n = sbReadv(fd, iov, iovcnt);
+  if (CH_RET_IS_ERROR(n)) {
+    __errno_r(r) = CH_DECODE_ERROR(n);
+    return -1;
+  }
+
+  return n;
+}
+
+ssize_t _writev_r(struct _reent *r, int fd, const struct iovec *iov,
+                  int iovcnt) {
+  ssize_t n;
+
+  n = sbWritev(fd, iov, iovcnt);
+  if (CH_RET_IS_ERROR(n)) {
+    __errno_r(r) = CH_DECODE_ERROR(n);
+    return -1;
+  }
+
+  return n;
+}
+
+ssize_t _sendfile_r(struct _reent *r, int out_fd, int in_fd, off_t *offset,
+                    size_t count) {
+  ssize_t n;
+
+  n = sbSendfile(out_fd, in_fd, offset, count);
+  if (CH_RET_IS_ERROR(n)) {
+    __errno_r(r) = CH_DECODE_ERROR(n);
+    return -1;
+  }
+
+  return n;
+}
+
 int _chdir_r(struct _reent *r, const char *path) {
   int err;
 
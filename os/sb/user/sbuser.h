@@ -35,6 +35,7 @@
 
 #include "errcodes.h"
 #include "dirent.h"
+#include "uio.h"
 #include "sbsysc.h"
 
 /*===========================================================================*/
@@ -229,6 +230,16 @@ typedef uint32_t eventflags_t;
   asm volatile ("svc " #x : "=r" (r0), "=r" (r1) :                          \
                             "r" (r0), "r" (r1), "r" (r2), "r" (r3) :        \
                             "memory")
+
+#define __syscall5r(x, p1, p2, p3, p4, p5)                                  \
+  register uint32_t r0 asm ("r0") = (uint32_t)(p1);                         \
+  register uint32_t r1 asm ("r1") = (uint32_t)(p2);                         \
+  register uint32_t r2 asm ("r2") = (uint32_t)(p3);                         \
+  register uint32_t r3 asm ("r3") = (uint32_t)(p4);                         \
+  register uint32_t r12 asm ("r12") = (uint32_t)(p5);                       \
+  asm volatile ("svc " #x : "=r" (r0) : "r" (r0), "r" (r1),                 \
+                                        "r" (r2), "r" (r3), "r" (r12) :     \
+                                        "memory")
 /** @} */
 
 /**
@@ -360,6 +371,166 @@ static inline ssize_t sbWrite(int fd, const void *buf, size_t count) {
   return (ssize_t)r0;
 }
 
+/**
+ * @brief   Posix-style file read at an absolute position.
+ *
+ * @param[in] fd        file descriptor
+ * @param[out] buf      buffer pointer
+ * @param[in] count     number of bytes
+ * @param[in] offset    file offset
+ * @return              The number of bytes really transferred or an error.
+ */
+static inline ssize_t sbPread(int fd, void *buf, size_t count, off_t offset) {
+
+  __syscall5r(128, SB_POSIX_PREAD, fd, buf, count, offset);
+  return (ssize_t)r0;
+}
+
+/**
+ * @brief   Posix-style file write at an absolute position.
+ *
+ * @param[in] fd        file descriptor
+ * @param[in] buf       buffer pointer
+ * @param[in] count     number of bytes
+ * @param[in] offset    file offset
+ * @return              The number of bytes really transferred or an error.
+ */
+static inline ssize_t sbPwrite(int fd, const void *buf, size_t count,
+                               off_t offset) {
+
+  __syscall5r(128, SB_POSIX_PWRITE, fd, buf, count, offset);
+  return (ssize_t)r0;
+}
+
+/**
+ * @brief   Posix-style file scatter read.
+ *
+ * @param[in] fd        file descriptor
+ * @param[in] iov       array of buffer descriptors
+ * @param[in] iovcnt    number of buffer descriptors
+ * @return              The number of bytes really transferred or an error.
+ */
+static inline ssize_t sbReadv(int fd, const struct iovec *iov, int iovcnt) {
+
+  __syscall4r(128, SB_POSIX_READV, fd, iov, iovcnt);
+  return (ssize_t)r0;
+}
+
+/**
+ * @brief   Posix-style file gather write.
+ *
+ * @param[in] fd        file descriptor
+ * @param[in] iov       array of buffer descriptors
+ * @param[in] iovcnt    number of buffer descriptors
+ * @return              The number of bytes really transferred or an error.
+ */
+static inline ssize_t sbWritev(int fd, const struct iovec *iov, int iovcnt) {
+
+  __syscall4r(128, SB_POSIX_WRITEV, fd, iov, iovcnt);
+  return (ssize_t)r0;
+}
+
+/**
+ * @brief   Posix-style file to descriptor transfer.
+ * @details Data is moved from @p in_fd to @p out_fd on the host side
+ *          without passing through sandbox memory.
+ *
+ * @param[in] out_fd    destination file descriptor
+ * @param[in] in_fd     source file descriptor
+ * @param[in,out] offset pointer to the source offset or @p NULL for
+ *                      transferring from the current position
+ * @param[in] count     number of bytes
+ * @return              The number of bytes really transferred or an error.
+ */
+static inline ssize_t sbSendfile(int out_fd, int in_fd,
+                                 off_t *offset, size_t count) {
+
+  __syscall5r(128, SB_POSIX_SENDFILE, out_fd, in_fd, offset, count);
+  return (ssize_t)r0;
+}
+
+/**
+ * @brief   Registers an I/O ring with the host.
+ * @details Operations queued in the ring are executed by the host on the
+ *          next call to @p sbIoRingEnter(), many operations can be
+ *          performed with a single syscall.
+ *
+ * @param[in] ringp     pointer to the ring or @p NULL for unregistering
+ *                      the current one
+ * @return              Operation result.
+ */
+static inline int sbIoRingSetup(sb_ioring_t *ringp) {
+
+  __syscall2r(128, SB_POSIX_IORING_SETUP, ringp);
+  return (int)r0;
+}
+
+/**
+ * @brief   Executes the operations queued in the registered I/O ring.
+ * @note    Operations are executed in order, execution stops early if
+ *          the completion ring becomes full.
+ *
+ * @return              The number of executed operations or an error.
+ */
+static inline int sbIoRingEnter(void) {
+
+  __syscall1r(128, SB_POSIX_IORING_ENTER);
+  return (int)r0;
+}
+
+/**
+ * @brief   Returns the next free submission entry.
+ *
+ * @param[in] ringp     pointer to the ring
+ * @return              Pointer to the entry or @p NULL if the ring is full.
+ */
+static inline sb_ioring_sqe_t *sbIoRingGetSQE(sb_ioring_t *ringp) {
+  uint32_t tail = ringp->sq_tail;
+
+  if ((tail - ringp->sq_head) >= (uint32_t)SB_IORING_ENTRIES) {
+    return NULL;
+  }
+
+  return &ringp->sqes[tail & ((uint32_t)SB_IORING_ENTRIES - 1U)];
+}
+
+/**
+ * @brief   Queues the entry returned by @p sbIoRingGetSQE().
+ *
+ * @param[in] ringp     pointer to the ring
+ */
+static inline void sbIoRingQueueSQE(sb_ioring_t *ringp) {
+
+  ringp->sq_tail = ringp->sq_tail + 1U;
+}
+
+/**
+ * @brief   Returns the next available completion entry.
+ *
+ * @param[in] ringp     pointer to the ring
+ * @return              Pointer to the entry or @p NULL if there are no
+ *                      completions.
+ */
+static inline sb_ioring_cqe_t *sbIoRingGetCQE(sb_ioring_t *ringp) {
+  uint32_t head = ringp->cq_head;
+
+  if (head == ringp->cq_tail) {
+    return NULL;
+  }
+
+  return &ringp->cqes[head & ((uint32_t)SB_IORING_ENTRIES - 1U)];
+}
+
+/**
+ * @brief   Releases the entry returned by @p sbIoRingGetCQE().
+ *
+ * @param[in] ringp     pointer to the ring
+ */
+static inline void sbIoRingConsumeCQE(sb_ioring_t *ringp) {
+
+  ringp->cq_head = ringp->cq_head + 1U;
+}
+
 /**
  * @brief   Posix-style file seek.
  *
@@ -94,6 +94,53 @@
 #define TEST_CFG_SIZE_REPORT                TRUE
 #endif
 
+/**
+ * @brief   Print threads stack usage at the end of the test run.
+ * @details For each registered thread the stack size, the stack high-water
+ *          mark and a suggested @p THD_WORKING_AREA() size are printed.
+ * @note    Requires ChibiOS/RT with @p CH_CFG_USE_REGISTRY and
+ *          @p CH_DBG_FILL_THREADS enabled.
+ */
+#if !defined(TEST_CFG_STACK_REPORT) || defined(__DOXYGEN__)
+#define TEST_CFG_STACK_REPORT               FALSE
+#endif
+
+/**
+ * @brief   Margin added to the stack high-water mark, in percent, for the
+ *          suggested working area sizes.
+ */
+#if !defined(TEST_CFG_STACK_MARGIN) || defined(__DOXYGEN__)
+#define TEST_CFG_STACK_MARGIN               25
+#endif
+
+/**
+ * @brief   Enables the benchmarks harness.
+ * @details Benchmarks can time single operations using the realtime
+ *          counter and report latency distributions in both human and
+ *          machine readable form.
+ * @note    Requires a port supporting the realtime counter.
+ */
+#if !defined(TEST_CFG_BENCHMARKS) || defined(__DOXYGEN__)
+#define TEST_CFG_BENCHMARKS                 FALSE
+#endif
+
+/**
+ * @brief   Number of samples collected by each benchmark.
+ * @note    Each sample requires a @p rtcnt_t in RAM.
+ */
+#if !defined(TEST_CFG_BMK_SAMPLES) || defined(__DOXYGEN__)
+#define TEST_CFG_BMK_SAMPLES                1000
+#endif
+
+/**
+ * @brief   Number of runs the samples are split into.
+ * @details The harness synchronizes with the system tick before each run,
+ *          the spread between the runs averages is reported.
+ */
+#if !defined(TEST_CFG_BMK_RUNS) || defined(__DOXYGEN__)
+#define TEST_CFG_BMK_RUNS                   10
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -114,6 +161,25 @@
 #error "TEST_CFG_DELAY_BETWEEN_TESTS requires TEST_CFG_CHIBIOS_SUPPORT"
 #endif
 
+#if TEST_CFG_STACK_REPORT == TRUE
+#if (TEST_CFG_CHIBIOS_SUPPORT == FALSE) || !defined(__CHIBIOS_RT__)
+#error "TEST_CFG_STACK_REPORT requires TEST_CFG_CHIBIOS_SUPPORT and RT"
+#endif
+#if (CH_CFG_USE_REGISTRY == FALSE) || (CH_DBG_FILL_THREADS == FALSE)
+#error "TEST_CFG_STACK_REPORT requires CH_CFG_USE_REGISTRY and CH_DBG_FILL_THREADS"
+#endif
+#endif
+
+#if TEST_CFG_BENCHMARKS == TRUE
+#if (TEST_CFG_CHIBIOS_SUPPORT == FALSE) || (PORT_SUPPORTS_RT == FALSE)
+#error "TEST_CFG_BENCHMARKS requires TEST_CFG_CHIBIOS_SUPPORT and PORT_SUPPORTS_RT"
+#endif
+#if (TEST_CFG_BMK_RUNS < 1) || (TEST_CFG_BMK_SAMPLES < 100) ||              \
+    ((TEST_CFG_BMK_SAMPLES % TEST_CFG_BMK_RUNS) != 0)
+#error "TEST_CFG_BMK_SAMPLES must be at least 100 and a multiple of TEST_CFG_BMK_RUNS"
+#endif
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -164,6 +230,25 @@ typedef struct {
 #endif
 } ch_test_context_t;
 
+#if (TEST_CFG_BENCHMARKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Benchmark results.
+ * @note    All times are realtime counter cycles with the measurement
+ *          overhead already subtracted.
+ */
+typedef struct {
+  unsigned          samples;    /**< @brief Number of samples.              */
+  rtcnt_t           overhead;   /**< @brief Subtracted overhead.            */
+  rtcnt_t           min;        /**< @brief Minimum.                        */
+  rtcnt_t           median;     /**< @brief Median.                         */
+  rtcnt_t           p99;        /**< @brief 99th percentile.                */
+  rtcnt_t           max;        /**< @brief Maximum.                        */
+  rtcnt_t           mean;       /**< @brief Mean.                           */
+  uint32_t          sd10;       /**< @brief Standard deviation x10.         */
+  uint32_t          runs_sd10;  /**< @brief Runs averages deviation x10.    */
+} test_bmk_result_t;
+#endif
+
 /**
  * @brief   Structure representing a test case.
  */
@@ -318,6 +403,11 @@ extern "C" {
   bool test_execute_stream(BaseSequentialStream *stream,
                            const testsuite_t *tsp);
 #endif
+#if TEST_CFG_BENCHMARKS == TRUE
+  void test_bmk_begin(const char *name);
+  bool test_bmk_sample(rtcnt_t start);
+  void test_bmk_end(test_bmk_result_t *resp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -347,6 +437,20 @@ static inline msg_t test_execute(BaseSequentialStream *stream,
 }
 #endif
 
+#if (TEST_CFG_BENCHMARKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the realtime counter value for benchmarks.
+ *
+ * @return              The realtime counter value.
+ *
+ * @api
+ */
+static inline rtcnt_t test_bmk_now(void) {
+
+  return (rtcnt_t)port_rt_get_counter_value();
+}
+#endif
+
 /**
  * @brief   Prints a decimal unsigned number.
  *
@@ -116,6 +116,52 @@ static void test_print_fat_line(void) {
   test_print_string(TEST_CFG_EOL_STRING);
 }
 
+#if (TEST_CFG_STACK_REPORT == TRUE) || defined(__DOXYGEN__)
+static void test_print_stack_report(void) {
+  thread_t *tp;
+
+  test_printf(TEST_CFG_EOL_STRING);
+  test_printf("*** Stack usage (suggested sizes include a %u%% margin)"
+              TEST_CFG_EOL_STRING, (unsigned)TEST_CFG_STACK_MARGIN);
+  test_printf("***"TEST_CFG_EOL_STRING);
+  test_printf("*** name             size     used suggested"
+              TEST_CFG_EOL_STRING);
+  tp = chRegFirstThread();
+  do {
+    size_t size, used, stack, suggested;
+
+    size = chThdGetStackSizeX(tp);
+    used = size - chThdGetStackUnused(tp);
+
+    /* The thread_t structure, if allocated at the top of the working area,
+       is not stack and it is added back by THD_WORKING_AREA().*/
+    stack = used;
+    if (((uint8_t *)tp >= (uint8_t *)tp->wabase) &&
+        ((uint8_t *)tp < (uint8_t *)tp->waend)) {
+      size_t tsize = MEM_ALIGN_NEXT(sizeof (thread_t), PORT_STACK_ALIGN);
+
+      stack = stack > tsize ? stack - tsize : 0U;
+    }
+
+    /* Suggested size as THD_WORKING_AREA() parameter, the port overhead
+       is added back by the macro.*/
+    suggested = MEM_ALIGN_NEXT(stack + ((stack * TEST_CFG_STACK_MARGIN) / 100U),
+                               PORT_STACK_ALIGN);
+    if (suggested > PORT_WA_SIZE(0)) {
+      suggested -= PORT_WA_SIZE(0);
+    }
+    else {
+      suggested = 0U;
+    }
+
+    test_printf("*** %-12s %8u %8u %9u"TEST_CFG_EOL_STRING,
+                tp->name == NULL ? "" : tp->name,
+                (unsigned)size, (unsigned)used, (unsigned)suggested);
+    tp = chRegNextThread(tp);
+  } while (tp != NULL);
+}
+#endif
+
 /**
  * @brief   Test execution.
  *
@@ -199,6 +245,10 @@ static bool test_execute_inner(const testsuite_t *tsp) {
   test_printf("Final result: %s"TEST_CFG_EOL_STRING,
               chtest.global_fail ? "FAILURE" : "SUCCESS");
 
+#if TEST_CFG_STACK_REPORT == TRUE
+  test_print_stack_report();
+#endif
+
 #if defined(TEST_REPORT_HOOK_END)
   TEST_REPORT_HOOK_END();
 #endif
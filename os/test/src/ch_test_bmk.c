@@ -0,0 +1,286 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    ch_test_bmk.c
+ * @brief   Unit Tests Engine benchmarks harness code.
+ * @details Benchmarks time single operations using the realtime counter,
+ *          the typical usage is:
+ *          @code
+ *          rtcnt_t start;
+ *
+ *          test_bmk_begin("Semaphore wait/signal");
+ *          do {
+ *            start = test_bmk_now();
+ *            chSemWait(&sem);
+ *            chSemSignal(&sem);
+ *          } while (!test_bmk_sample(start));
+ *          test_bmk_end(NULL);
+ *          @endcode
+ *          Results are printed as a human readable summary followed by a
+ *          line starting with <tt>--- BMK </tt> and containing a JSON
+ *          object, those lines can be compared against a stored baseline.
+ *
+ * @addtogroup CH_TEST
+ * @{
+ */
+
+#include "ch_test.h"
+
+#if (TEST_CFG_BENCHMARKS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of empty measurements used for overhead calibration.
+ */
+#define BMK_CALIBRATION_ROUNDS      64U
+
+/**
+ * @brief   Samples per run.
+ */
+#define BMK_RUN_SAMPLES             (TEST_CFG_BMK_SAMPLES / TEST_CFG_BMK_RUNS)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Benchmark being executed.
+ */
+static struct {
+  const char        *name;
+  rtcnt_t           overhead;
+  unsigned          n;
+  rtcnt_t           samples[TEST_CFG_BMK_SAMPLES];
+} bmk;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static void bmk_sort(rtcnt_t *a, unsigned n) {
+  static const unsigned gaps[] = {701U, 301U, 132U, 57U, 23U, 10U, 4U, 1U};
+  unsigned g, i, j;
+
+  /* Shell sort, no recursion and no additional memory.*/
+  for (g = 0U; g < sizeof gaps / sizeof gaps[0]; g++) {
+    unsigned gap = gaps[g];
+
+    for (i = gap; i < n; i++) {
+      rtcnt_t x = a[i];
+
+      for (j = i; (j >= gap) && (a[j - gap] > x); j -= gap) {
+        a[j] = a[j - gap];
+      }
+      a[j] = x;
+    }
+  }
+}
+
+static uint32_t bmk_isqrt(uint64_t x) {
+  uint64_t r, y;
+
+  if (x == 0U) {
+    return 0U;
+  }
+
+  /* Newton iterations starting from above the root.*/
+  r = x;
+  y = (r + 1U) / 2U;
+  while (y < r) {
+    r = y;
+    y = (r + (x / r)) / 2U;
+  }
+
+  return (uint32_t)r;
+}
+
+/* Standard deviation x10 of n values, two passes over the deviations in
+   order to keep the squares small.*/
+static uint32_t bmk_sd10(const rtcnt_t *a, unsigned n) {
+  uint64_t sum10, sq100;
+  unsigned i;
+
+  sum10 = 0U;
+  for (i = 0U; i < n; i++) {
+    sum10 += (uint64_t)a[i] * 10U;
+  }
+  sum10 /= n;
+
+  sq100 = 0U;
+  for (i = 0U; i < n; i++) {
+    uint64_t x10 = (uint64_t)a[i] * 10U;
+    uint64_t d10 = x10 > sum10 ? x10 - sum10 : sum10 - x10;
+
+    sq100 += d10 * d10;
+  }
+
+  return bmk_isqrt(sq100 / n);
+}
+
+static void bmk_print_decimal(const char *label, uint32_t x10) {
+
+  test_printf("%s%u.%u", label, (unsigned)(x10 / 10U), (unsigned)(x10 % 10U));
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Starts a benchmark.
+ * @details The measurement overhead is calibrated as the minimum time
+ *          between two consecutive realtime counter reads.
+ *
+ * @param[in] name      benchmark name, it must not contain quotes
+ *
+ * @api
+ */
+void test_bmk_begin(const char *name) {
+  unsigned i;
+
+  bmk.name     = name;
+  bmk.n        = 0U;
+  bmk.overhead = (rtcnt_t)-1;
+  for (i = 0U; i < BMK_CALIBRATION_ROUNDS; i++) {
+    rtcnt_t start = test_bmk_now();
+    rtcnt_t t = test_bmk_now() - start;
+
+    if (t < bmk.overhead) {
+      bmk.overhead = t;
+    }
+  }
+
+  /* First run synchronized with the system tick.*/
+  osalThreadSleep((sysinterval_t)1);
+}
+
+/**
+ * @brief   Records a sample.
+ * @details The time elapsed since @p start, minus the calibrated overhead,
+ *          is recorded. The caller is put to sleep for one system tick at
+ *          the end of each run except the last one.
+ * @note    The function must not be called from within a critical zone.
+ *
+ * @param[in] start     realtime counter value returned by
+ *                      @p test_bmk_now() before the timed operation
+ * @return              The benchmark completion status.
+ * @retval false        if more samples are required.
+ * @retval true         if all samples have been collected.
+ *
+ * @api
+ */
+bool test_bmk_sample(rtcnt_t start) {
+  rtcnt_t t = test_bmk_now() - start;
+
+  bmk.samples[bmk.n++] = t > bmk.overhead ? t - bmk.overhead : (rtcnt_t)0;
+  if (bmk.n >= (unsigned)TEST_CFG_BMK_SAMPLES) {
+    return true;
+  }
+  if ((bmk.n % (unsigned)BMK_RUN_SAMPLES) == 0U) {
+    osalThreadSleep((sysinterval_t)1);
+  }
+
+  return false;
+}
+
+/**
+ * @brief   Ends a benchmark and prints its results.
+ *
+ * @param[out] resp     pointer to a @p test_bmk_result_t structure for the
+ *                      results or @p NULL
+ *
+ * @api
+ */
+void test_bmk_end(test_bmk_result_t *resp) {
+  test_bmk_result_t res;
+  rtcnt_t avgs[TEST_CFG_BMK_RUNS];
+  uint64_t sum;
+  unsigned i, runs, n = bmk.n;
+
+  if (n == 0U) {
+    return;
+  }
+
+  /* Statistics requiring the samples in acquisition order, a partial last
+     run is not considered for the runs averages.*/
+  sum = 0U;
+  for (i = 0U; i < n; i++) {
+    sum += bmk.samples[i];
+  }
+  runs = n / (unsigned)BMK_RUN_SAMPLES;
+  for (i = 0U; i < runs; i++) {
+    uint64_t runsum = 0U;
+    unsigned j;
+
+    for (j = 0U; j < (unsigned)BMK_RUN_SAMPLES; j++) {
+      runsum += bmk.samples[(i * (unsigned)BMK_RUN_SAMPLES) + j];
+    }
+    avgs[i] = (rtcnt_t)(runsum / (unsigned)BMK_RUN_SAMPLES);
+  }
+  res.sd10      = bmk_sd10(bmk.samples, n);
+  res.runs_sd10 = runs > 0U ? bmk_sd10(avgs, runs) : 0U;
+
+  bmk_sort(bmk.samples, n);
+
+  res.samples   = n;
+  res.overhead  = bmk.overhead;
+  res.min       = bmk.samples[0];
+  res.median    = bmk.samples[n / 2U];
+  res.p99       = bmk.samples[(((n * 99U) + 99U) / 100U) - 1U];
+  res.max       = bmk.samples[n - 1U];
+  res.mean      = (rtcnt_t)(sum / n);
+
+  test_printf("--- %s" TEST_CFG_EOL_STRING, bmk.name);
+  test_printf("--- Latency : min %u, median %u, p99 %u, max %u cycles"
+              TEST_CFG_EOL_STRING,
+              res.min, res.median, res.p99, res.max);
+  bmk_print_decimal("--- Spread  : sd ", res.sd10);
+  bmk_print_decimal(", runs sd ", res.runs_sd10);
+  test_printf(", overhead %u, %u samples" TEST_CFG_EOL_STRING,
+              res.overhead, res.samples);
+
+  /* Machine readable line.*/
+  test_printf("--- BMK {\"name\":\"%s\",\"samples\":%u,\"overhead\":%u,"
+              "\"min\":%u,\"median\":%u,\"p99\":%u,\"max\":%u,\"mean\":%u",
+              bmk.name, res.samples, res.overhead,
+              res.min, res.median, res.p99, res.max, res.mean);
+  bmk_print_decimal(",\"sd\":", res.sd10);
+  bmk_print_decimal(",\"runs_sd\":", res.runs_sd10);
+  test_printf("}" TEST_CFG_EOL_STRING);
+
+  if (resp != NULL) {
+    *resp = res;
+  }
+}
+
+#endif /* TEST_CFG_BENCHMARKS == TRUE */
+
+/** @} */
@@ -1,6 +1,7 @@
 # List of all the test runtime files.
 TESTSRC += ${CHIBIOS}/os/test/src/ch_test.c \
-           ${CHIBIOS}/os/test/src/ch_test_printf.c
+           ${CHIBIOS}/os/test/src/ch_test_printf.c \
+           ${CHIBIOS}/os/test/src/ch_test_bmk.c
 
 # Required include directories
 TESTINC += ${CHIBIOS}/os/test/include
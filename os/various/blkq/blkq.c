@@ -0,0 +1,599 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    blkq.c
+ * @brief   Block requests queue code.
+ *
+ * @addtogroup BLKQ
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "blkq.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static bool overlaps(const blkq_request_t *rqp, uint32_t startblk,
+                     uint32_t n) {
+
+  return (rqp->op != BLKQ_OP_SYNC) &&
+         (startblk < rqp->startblk + rqp->n) &&
+         (rqp->startblk < startblk + n);
+}
+
+static void list_append(blkq_request_t **headp, blkq_request_t **tailp,
+                        blkq_request_t *rqp) {
+
+  rqp->next = NULL;
+  if (*headp == NULL) {
+    *headp = rqp;
+  }
+  else {
+    (*tailp)->next = rqp;
+  }
+  *tailp = rqp;
+}
+
+static void list_remove(blkq_request_t **headp, blkq_request_t **tailp,
+                        blkq_request_t *prevp, blkq_request_t *rqp) {
+
+  if (prevp == NULL) {
+    *headp = rqp->next;
+  }
+  else {
+    prevp->next = rqp->next;
+  }
+  if (*tailp == rqp) {
+    *tailp = prevp;
+  }
+}
+
+/*
+ * Moves the pending reads overlapping a write or discard into the ordered
+ * list so that they are served before it.
+ */
+static void order_reads(BlockQueue *bqp, const blkq_request_t *rqp) {
+  blkq_request_t *prevp = NULL, *rdp = bqp->rdhead;
+
+  while (rdp != NULL) {
+    blkq_request_t *nextp = rdp->next;
+
+    if (overlaps(rdp, rqp->startblk, rqp->n)) {
+      list_remove(&bqp->rdhead, &bqp->rdtail, prevp, rdp);
+      list_append(&bqp->wrhead, &bqp->wrtail, rdp);
+    }
+    else {
+      prevp = rdp;
+    }
+    rdp = nextp;
+  }
+}
+
+/*
+ * Checks if a request can be moved ahead of the requests preceding it in
+ * the list, syncs are barriers and only reads can pass each other.
+ */
+static bool can_advance(const blkq_request_t *headp,
+                        const blkq_request_t *rqp) {
+
+  while (headp != rqp) {
+    if ((headp->op == BLKQ_OP_SYNC) ||
+        (((headp->op != BLKQ_OP_READ) || (rqp->op != BLKQ_OP_READ)) &&
+         overlaps(headp, rqp->startblk, rqp->n))) {
+      return false;
+    }
+    headp = headp->next;
+  }
+
+  return true;
+}
+
+/*
+ * Picks the next request and merges into it the queued requests of the
+ * same kind covering the following blocks, the merged requests are
+ * returned as a chain.
+ */
+static blkq_request_t *pick_chain(BlockQueue *bqp) {
+  const BlockQueueConfig *cfgp = bqp->config;
+  blkq_request_t **headp, **tailp;
+  blkq_request_t *firstp, *lastp;
+  uint32_t total;
+  bool contiguous = true, found;
+
+  /* Reads have priority over the ordered list, up to a burst limit.*/
+  if ((bqp->rdhead != NULL) &&
+      ((bqp->wrhead == NULL) || (bqp->reads < cfgp->read_burst))) {
+    headp = &bqp->rdhead;
+    tailp = &bqp->rdtail;
+    if (bqp->wrhead != NULL) {
+      bqp->reads++;
+    }
+  }
+  else if (bqp->wrhead != NULL) {
+    headp = &bqp->wrhead;
+    tailp = &bqp->wrtail;
+    bqp->reads = 0U;
+  }
+  else {
+    return NULL;
+  }
+
+  firstp = *headp;
+  list_remove(headp, tailp, NULL, firstp);
+  lastp = firstp;
+  total = firstp->n;
+  bqp->stats.transfers++;
+
+  /* Syncs are never merged.*/
+  if (firstp->op == BLKQ_OP_SYNC) {
+    firstp->next = NULL;
+    return firstp;
+  }
+
+  do {
+    blkq_request_t *prevp = NULL, *rqp;
+
+    found = false;
+    for (rqp = *headp; rqp != NULL; prevp = rqp, rqp = rqp->next) {
+      bool cont;
+
+      if ((rqp->op != firstp->op) ||
+          (rqp->startblk != firstp->startblk + total) ||
+          (total + rqp->n > BLKQ_MAX_MERGE_BLOCKS)) {
+        continue;
+      }
+
+      /* Data transfers are done in place if the buffers are contiguous,
+         else through the merge buffer.*/
+      cont = true;
+      if (firstp->op != BLKQ_OP_DISCARD) {
+        cont = contiguous &&
+               (rqp->buf == lastp->buf + (lastp->n * bqp->blk_size));
+        if (!cont && ((cfgp->buffer == NULL) ||
+                      (total + rqp->n > cfgp->buffer_blocks))) {
+          continue;
+        }
+      }
+
+      if (!can_advance(*headp, rqp)) {
+        continue;
+      }
+
+      list_remove(headp, tailp, prevp, rqp);
+      lastp->next = rqp;
+      lastp = rqp;
+      total += rqp->n;
+      contiguous = cont;
+      bqp->stats.merged++;
+      found = true;
+      break;
+    }
+  } while (found);
+  lastp->next = NULL;
+
+  if (firstp->op == BLKQ_OP_READ) {
+    bqp->stats.blocks_read += total;
+  }
+  else if (firstp->op == BLKQ_OP_WRITE) {
+    bqp->stats.blocks_written += total;
+  }
+  else {
+    bqp->stats.blocks_discarded += total;
+  }
+
+  return firstp;
+}
+
+/*
+ * Performs a chain of merged requests on the device and completes them.
+ */
+static void execute_chain(BlockQueue *bqp, blkq_request_t *chainp) {
+  BaseBlockDevice *bdp = bqp->config->bdp;
+  uint8_t *mbuf = bqp->config->buffer;
+  blkq_request_t *rqp;
+  uint32_t total = 0U;
+  bool contiguous = true, err;
+  uint8_t *p;
+
+  for (rqp = chainp; rqp != NULL; rqp = rqp->next) {
+    if ((chainp->op <= BLKQ_OP_WRITE) && (rqp != chainp) &&
+        (rqp->buf != chainp->buf + (total * bqp->blk_size))) {
+      contiguous = false;
+    }
+    total += rqp->n;
+  }
+
+  switch (chainp->op) {
+  case BLKQ_OP_READ:
+    if (contiguous) {
+      err = blkRead(bdp, chainp->startblk, chainp->buf, total);
+    }
+    else {
+      err = blkRead(bdp, chainp->startblk, mbuf, total);
+      for (p = mbuf, rqp = chainp; rqp != NULL; rqp = rqp->next) {
+        memcpy(rqp->buf, p, rqp->n * bqp->blk_size);
+        p += rqp->n * bqp->blk_size;
+      }
+    }
+    break;
+  case BLKQ_OP_WRITE:
+    if (contiguous) {
+      err = blkWrite(bdp, chainp->startblk, chainp->buf, total);
+    }
+    else {
+      for (p = mbuf, rqp = chainp; rqp != NULL; rqp = rqp->next) {
+        memcpy(p, rqp->buf, rqp->n * bqp->blk_size);
+        p += rqp->n * bqp->blk_size;
+      }
+      err = blkWrite(bdp, chainp->startblk, mbuf, total);
+    }
+    break;
+  case BLKQ_OP_DISCARD:
+    err = blkDiscard(bdp, chainp->startblk, total);
+    break;
+  default:
+    err = blkSync(bdp);
+    break;
+  }
+
+  /* Completing the requests, a request can be reused by its callback so
+     the link is fetched first.*/
+  rqp = chainp;
+  while (rqp != NULL) {
+    blkq_request_t *nextp = rqp->next;
+
+    rqp->error = err;
+    if (rqp->callback != NULL) {
+      rqp->callback(rqp);
+    }
+    else {
+      chBSemSignal(&rqp->done);
+    }
+    rqp = nextp;
+  }
+}
+
+static bool blkq_transfer(BlockQueue *bqp, unsigned op, uint32_t startblk,
+                          uint8_t *buf, uint32_t n) {
+  blkq_request_t rq;
+
+  blkqRequestObjectInit(&rq, NULL, NULL);
+  blkqSubmit(bqp, &rq, op, startblk, buf, n);
+
+  return blkqWait(&rq);
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a @p BlockQueue object.
+ *
+ * @param[out] bqp      pointer to the @p BlockQueue object
+ *
+ * @init
+ */
+void blkqObjectInit(BlockQueue *bqp) {
+
+  chDbgCheck(bqp != NULL);
+
+  bqp->config   = NULL;
+  bqp->blk_size = 0U;
+  bqp->rdhead   = NULL;
+  bqp->rdtail   = NULL;
+  bqp->wrhead   = NULL;
+  bqp->wrtail   = NULL;
+  bqp->reads    = 0U;
+  bqp->stopping = false;
+  chMtxObjectInit(&bqp->mtx);
+  chBSemObjectInit(&bqp->work, true);
+  memset(&bqp->stats, 0, sizeof bqp->stats);
+}
+
+/**
+ * @brief   Configures a block queue.
+ * @details The underlying block device must be connected, requests are
+ *          served by a thread running @p blkqThread().
+ *
+ * @param[in] bqp       pointer to the @p BlockQueue object
+ * @param[in] config    pointer to the configuration
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   the device information could not be obtained.
+ *
+ * @api
+ */
+bool blkqStart(BlockQueue *bqp, const BlockQueueConfig *config) {
+  BlockDeviceInfo bdi;
+
+  chDbgCheck((bqp != NULL) && (config != NULL) && (config->bdp != NULL));
+
+  if (blkGetInfo(config->bdp, &bdi) != HAL_SUCCESS) {
+    return HAL_FAILED;
+  }
+
+  chMtxLock(&bqp->mtx);
+  bqp->config   = config;
+  bqp->blk_size = bdi.blk_size;
+  bqp->stopping = false;
+  chMtxUnlock(&bqp->mtx);
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Stops a block queue.
+ * @details The queue thread terminates after serving the pending requests,
+ *          the caller can then wait for it using @p chThdWait().
+ *
+ * @param[in] bqp       pointer to the @p BlockQueue object
+ *
+ * @api
+ */
+void blkqStop(BlockQueue *bqp) {
+
+  chDbgCheck(bqp != NULL);
+
+  chMtxLock(&bqp->mtx);
+  bqp->stopping = true;
+  chMtxUnlock(&bqp->mtx);
+  chBSemSignal(&bqp->work);
+}
+
+/**
+ * @brief   Initializes a @p blkq_request_t object.
+ *
+ * @param[out] rqp      pointer to the @p blkq_request_t object
+ * @param[in] callback  completion callback, if @p NULL the completion is
+ *                      waited using @p blkqWait()
+ * @param[in] arg       callback argument
+ *
+ * @init
+ */
+void blkqRequestObjectInit(blkq_request_t *rqp,
+                           blkq_callback_t callback, void *arg) {
+
+  chDbgCheck(rqp != NULL);
+
+  rqp->next     = NULL;
+  rqp->callback = callback;
+  rqp->arg      = arg;
+  rqp->error    = HAL_SUCCESS;
+  chBSemObjectInit(&rqp->done, true);
+}
+
+/**
+ * @brief   Submits a request.
+ * @details Reads are served ahead of writes unless they overlap a pending
+ *          write or discard. Requests of the same kind covering adjacent
+ *          blocks are merged into a single device operation.
+ * @note    The request and its buffer must stay valid until completion.
+ *
+ * @param[in] bqp       pointer to the @p BlockQueue object
+ * @param[in] rqp       pointer to an initialized @p blkq_request_t object
+ * @param[in] op        request operation
+ * @param[in] startblk  first block
+ * @param[in] buf       data buffer, not used by discards and syncs
+ * @param[in] n         number of blocks, not used by syncs
+ *
+ * @api
+ */
+void blkqSubmit(BlockQueue *bqp, blkq_request_t *rqp, unsigned op,
+                uint32_t startblk, uint8_t *buf, uint32_t n) {
+  blkq_request_t *wrp;
+  bool ordered;
+
+  chDbgCheck((bqp != NULL) && (rqp != NULL) && (op <= BLKQ_OP_SYNC) &&
+             ((op == BLKQ_OP_SYNC) || (n > 0U)) &&
+             ((op >= BLKQ_OP_DISCARD) || (buf != NULL)));
+
+  rqp->op       = op;
+  rqp->startblk = startblk;
+  rqp->buf      = buf;
+  rqp->n        = op == BLKQ_OP_SYNC ? 0U : n;
+
+  chMtxLock(&bqp->mtx);
+
+  chDbgAssert(bqp->config != NULL, "not started");
+
+  bqp->stats.requests++;
+  if (op == BLKQ_OP_READ) {
+    ordered = bqp->config->read_burst == 0U;
+    for (wrp = bqp->wrhead; (wrp != NULL) && !ordered; wrp = wrp->next) {
+      ordered = overlaps(wrp, startblk, n);
+    }
+    if (ordered) {
+      list_append(&bqp->wrhead, &bqp->wrtail, rqp);
+    }
+    else {
+      list_append(&bqp->rdhead, &bqp->rdtail, rqp);
+    }
+  }
+  else {
+    if (op != BLKQ_OP_SYNC) {
+      order_reads(bqp, rqp);
+    }
+    list_append(&bqp->wrhead, &bqp->wrtail, rqp);
+  }
+
+  chMtxUnlock(&bqp->mtx);
+
+  chBSemSignal(&bqp->work);
+}
+
+/**
+ * @brief   Waits for the completion of a request without callback.
+ *
+ * @param[in] rqp       pointer to the @p blkq_request_t object
+ * @return              The request result.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool blkqWait(blkq_request_t *rqp) {
+
+  chDbgCheck((rqp != NULL) && (rqp->callback == NULL));
+
+  (void) chBSemWait(&rqp->done);
+
+  return rqp->error;
+}
+
+/**
+ * @brief   Reads blocks through the queue and waits for completion.
+ *
+ * @param[in] bqp       pointer to the @p BlockQueue object
+ * @param[in] startblk  first block
+ * @param[out] buf      data buffer
+ * @param[in] n         number of blocks
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool blkqRead(BlockQueue *bqp, uint32_t startblk, uint8_t *buf, uint32_t n) {
+
+  return blkq_transfer(bqp, BLKQ_OP_READ, startblk, buf, n);
+}
+
+/**
+ * @brief   Writes blocks through the queue and waits for completion.
+ *
+ * @param[in] bqp       pointer to the @p BlockQueue object
+ * @param[in] startblk  first block
+ * @param[in] buf       data buffer
+ * @param[in] n         number of blocks
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool blkqWrite(BlockQueue *bqp, uint32_t startblk,
+               const uint8_t *buf, uint32_t n) {
+
+  return blkq_transfer(bqp, BLKQ_OP_WRITE, startblk, (uint8_t *)buf, n);
+}
+
+/**
+ * @brief   Discards blocks through the queue and waits for completion.
+ *
+ * @param[in] bqp       pointer to the @p BlockQueue object
+ * @param[in] startblk  first block
+ * @param[in] n         number of blocks
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool blkqDiscard(BlockQueue *bqp, uint32_t startblk, uint32_t n) {
+
+  return blkq_transfer(bqp, BLKQ_OP_DISCARD, startblk, NULL, n);
+}
+
+/**
+ * @brief   Synchronizes the device after the previously submitted
+ *          requests.
+ *
+ * @param[in] bqp       pointer to the @p BlockQueue object
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool blkqSync(BlockQueue *bqp) {
+
+  return blkq_transfer(bqp, BLKQ_OP_SYNC, 0U, NULL, 0U);
+}
+
+/**
+ * @brief   Returns the queue statistics.
+ *
+ * @param[in] bqp       pointer to the @p BlockQueue object
+ * @param[out] statsp   pointer to the statistics structure to be filled
+ *
+ * @api
+ */
+void blkqGetStats(BlockQueue *bqp, blkq_stats_t *statsp) {
+
+  chDbgCheck((bqp != NULL) && (statsp != NULL));
+
+  chMtxLock(&bqp->mtx);
+  *statsp = bqp->stats;
+  chMtxUnlock(&bqp->mtx);
+}
+
+/**
+ * @brief   Block queue thread function.
+ * @details The thread serves the queued requests on the underlying device
+ *          and returns after @p blkqStop() once the queue is empty.
+ *
+ * @param[in] p         pointer to a started @p BlockQueue object
+ */
+THD_FUNCTION(blkqThread, p) {
+  BlockQueue *bqp = (BlockQueue *)p;
+
+  chRegSetThreadName("blkq");
+
+  while (true) {
+    blkq_request_t *chainp;
+    bool stopping;
+
+    chMtxLock(&bqp->mtx);
+    chainp = pick_chain(bqp);
+    stopping = bqp->stopping;
+    chMtxUnlock(&bqp->mtx);
+
+    if (chainp != NULL) {
+      execute_chain(bqp, chainp);
+    }
+    else if (stopping) {
+      break;
+    }
+    else {
+      (void) chBSemWait(&bqp->work);
+    }
+  }
+}
+
+/** @} */
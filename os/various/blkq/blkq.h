@@ -0,0 +1,188 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    blkq.h
+ * @brief   Block requests queue macros and structures.
+ *
+ * @addtogroup BLKQ
+ * @{
+ */
+
+#ifndef BLKQ_H
+#define BLKQ_H
+
+#include "hal.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Request operations
+ * @{
+ */
+#define BLKQ_OP_READ                0U
+#define BLKQ_OP_WRITE               1U
+#define BLKQ_OP_DISCARD             2U
+#define BLKQ_OP_SYNC                3U
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum number of blocks in a merged transfer.
+ */
+#if !defined(BLKQ_MAX_MERGE_BLOCKS) || defined(__DOXYGEN__)
+#define BLKQ_MAX_MERGE_BLOCKS       64U
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !CH_CFG_USE_MUTEXES || !CH_CFG_USE_SEMAPHORES
+#error "BLKQ requires CH_CFG_USE_MUTEXES and CH_CFG_USE_SEMAPHORES"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a block request.
+ */
+typedef struct blkq_request blkq_request_t;
+
+/**
+ * @brief   Type of a request completion callback.
+ * @note    Callbacks are invoked by the queue thread, the request can be
+ *          submitted again from within the callback.
+ */
+typedef void (*blkq_callback_t)(blkq_request_t *rqp);
+
+/**
+ * @brief   Structure representing a block request.
+ */
+struct blkq_request {
+  blkq_request_t        *next;          /**< @brief Next queued request.    */
+  unsigned              op;             /**< @brief Request operation.      */
+  uint32_t              startblk;       /**< @brief First block.            */
+  uint32_t              n;              /**< @brief Number of blocks.       */
+  uint8_t               *buf;           /**< @brief Data buffer.            */
+  blkq_callback_t       callback;       /**< @brief Completion callback or
+                                                    @p NULL.                */
+  void                  *arg;           /**< @brief Callback argument.      */
+  bool                  error;          /**< @brief Request result.         */
+  binary_semaphore_t    done;           /**< @brief Signaled on completion
+                                                    if there is no
+                                                    callback.               */
+};
+
+/**
+ * @brief   Block queue configuration.
+ */
+typedef struct {
+  /**
+   * @brief   Underlying block device.
+   */
+  BaseBlockDevice       *bdp;
+  /**
+   * @brief   Buffer used for merging requests whose buffers are not
+   *          contiguous, can be @p NULL.
+   */
+  uint8_t               *buffer;
+  /**
+   * @brief   Buffer size in blocks.
+   */
+  uint32_t              buffer_blocks;
+  /**
+   * @brief   Reads dispatched ahead of pending writes before a write is
+   *          let through, zero serves all requests in order.
+   */
+  unsigned              read_burst;
+} BlockQueueConfig;
+
+/**
+ * @brief   Block queue statistics.
+ */
+typedef struct {
+  uint32_t              requests;       /**< @brief Submitted requests.     */
+  uint32_t              transfers;      /**< @brief Device operations.      */
+  uint32_t              merged;         /**< @brief Requests merged into
+                                                    another transfer.       */
+  uint32_t              blocks_read;    /**< @brief Blocks read.            */
+  uint32_t              blocks_written; /**< @brief Blocks written.         */
+  uint32_t              blocks_discarded; /**< @brief Blocks discarded.     */
+} blkq_stats_t;
+
+/**
+ * @brief   Structure representing a block queue.
+ */
+typedef struct {
+  const BlockQueueConfig *config;       /**< @brief Current configuration.  */
+  uint32_t              blk_size;       /**< @brief Device block size.      */
+  blkq_request_t        *rdhead;        /**< @brief Reads list head.        */
+  blkq_request_t        *rdtail;        /**< @brief Reads list tail.        */
+  blkq_request_t        *wrhead;        /**< @brief Ordered list head.      */
+  blkq_request_t        *wrtail;        /**< @brief Ordered list tail.      */
+  unsigned              reads;          /**< @brief Reads dispatched ahead
+                                                    of pending writes.      */
+  bool                  stopping;       /**< @brief Stop requested.         */
+  mutex_t               mtx;            /**< @brief Lists mutex.            */
+  binary_semaphore_t    work;           /**< @brief New work signal.        */
+  blkq_stats_t          stats;          /**< @brief Statistics.             */
+} BlockQueue;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void blkqObjectInit(BlockQueue *bqp);
+  bool blkqStart(BlockQueue *bqp, const BlockQueueConfig *config);
+  void blkqStop(BlockQueue *bqp);
+  void blkqRequestObjectInit(blkq_request_t *rqp,
+                             blkq_callback_t callback, void *arg);
+  void blkqSubmit(BlockQueue *bqp, blkq_request_t *rqp, unsigned op,
+                  uint32_t startblk, uint8_t *buf, uint32_t n);
+  bool blkqWait(blkq_request_t *rqp);
+  bool blkqRead(BlockQueue *bqp, uint32_t startblk, uint8_t *buf, uint32_t n);
+  bool blkqWrite(BlockQueue *bqp, uint32_t startblk,
+                 const uint8_t *buf, uint32_t n);
+  bool blkqDiscard(BlockQueue *bqp, uint32_t startblk, uint32_t n);
+  bool blkqSync(BlockQueue *bqp);
+  void blkqGetStats(BlockQueue *bqp, blkq_stats_t *statsp);
+  THD_FUNCTION(blkqThread, p);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* BLKQ_H */
+
+/** @} */
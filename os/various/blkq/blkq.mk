@@ -0,0 +1,8 @@
+# Block requests queue files.
+BLKQSRC = $(CHIBIOS)/os/various/blkq/blkq.c
+
+BLKQINC = $(CHIBIOS)/os/various/blkq
+
+# Shared variables
+ALLCSRC += $(BLKQSRC)
+ALLINC  += $(BLKQINC)
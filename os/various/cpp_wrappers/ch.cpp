@@ -23,8 +23,23 @@
 
 #include "ch.hpp"
 
+#if defined(__cpp_exceptions)
+#include <new>
+#endif
+
 namespace chibios_rt {
 
+  void _mem_exhausted(void) {
+
+#if defined(__cpp_exceptions)
+    throw std::bad_alloc();
+#else
+    chSysHalt("out of memory");
+    while (true) {
+    }
+#endif
+  }
+
 #if (CH_CFG_NO_IDLE_THREAD == FALSE) || defined(__DOXYGEN__)
   ThreadReference System::getIdleThreadX(void) {
 
@@ -40,6 +55,311 @@ namespace chibios_rt {
 
     ((BaseThread *)arg)->main();
   }
+
+#if (CH_CPP_USE_MEMORY_RESOURCES == TRUE) || defined(__DOXYGEN__)
+#if (CH_CFG_USE_MEMCORE == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::ArenaResource                                              *
+   *------------------------------------------------------------------------*/
+
+  size_t ArenaResource::getCapacity(void) const noexcept {
+    size_t n = 0U;
+
+    for (const chunk *cp = head; cp != nullptr; cp = cp->next) {
+      n += sizeof (chunk) + cp->size;
+    }
+    return n;
+  }
+
+  void *ArenaResource::do_allocate(size_t bytes, size_t alignment) {
+    uint8_t *p;
+    chunk *cp;
+    size_t size;
+
+    chDbgCheck(MEM_IS_VALID_ALIGNMENT(alignment));
+
+    /* Fast path, the request fits the current chunk.*/
+    if (current != nullptr) {
+      p = (uint8_t *)MEM_ALIGN_NEXT(ptr, alignment);
+      if ((p <= limit) && (bytes <= (size_t)(limit - p))) {
+        ptr = p + bytes;
+        return p;
+      }
+      cp = current->next;
+    }
+    else {
+      cp = head;
+    }
+
+    /* Searching the following chunks, chunks too small for the request are
+       skipped and remain unused until the next release().*/
+    while (cp != nullptr) {
+      uint8_t *base = (uint8_t *)(cp + 1);
+
+      p = (uint8_t *)MEM_ALIGN_NEXT(base, alignment);
+      if (((size_t)(p - base) <= cp->size) &&
+          (bytes <= cp->size - (size_t)(p - base))) {
+        current = cp;
+        ptr     = p + bytes;
+        limit   = base + cp->size;
+        return p;
+      }
+      cp = cp->next;
+    }
+
+    /* A new chunk is appended to the list, it is large enough for the
+       request whatever the alignment.*/
+    size = MEM_ALIGN_NEXT(bytes + alignment, PORT_NATURAL_ALIGN);
+    if (size < chunk_size) {
+      size = chunk_size;
+    }
+    cp = (chunk *)chCoreAllocFromBase(sizeof (chunk) + size,
+                                      PORT_NATURAL_ALIGN, 0U);
+    if (cp == nullptr) {
+      _mem_exhausted();
+    }
+    cp->next = nullptr;
+    cp->size = size;
+    if (tail == nullptr) {
+      head = cp;
+    }
+    else {
+      tail->next = cp;
+    }
+    tail    = cp;
+    current = cp;
+    p       = (uint8_t *)MEM_ALIGN_NEXT((uint8_t *)(cp + 1), alignment);
+    ptr     = p + bytes;
+    limit   = (uint8_t *)(cp + 1) + size;
+    return p;
+  }
+#endif /* CH_CFG_USE_MEMCORE == TRUE */
+#endif /* CH_CPP_USE_MEMORY_RESOURCES == TRUE */
+
+#if (CH_CPP_USE_COROUTINES == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::CoTask                                                     *
+   *------------------------------------------------------------------------*/
+
+#if CH_CFG_USE_MEMPOOLS == TRUE
+  static memory_pool_t *co_frames_pool = nullptr;
+#endif
+  static size_t co_max_frame = 0U;
+
+  void *CoTask::promise_type::operator new(size_t size) noexcept {
+
+    if (size > co_max_frame) {
+      co_max_frame = size;
+    }
+
+#if CH_CFG_USE_MEMPOOLS == TRUE
+    if ((co_frames_pool != nullptr) &&
+        (size <= co_frames_pool->object_size)) {
+      return chPoolAlloc(co_frames_pool);
+    }
+#endif
+
+#if CH_CFG_USE_HEAP == TRUE
+    return chHeapAlloc(nullptr, size);
+#else
+    return nullptr;
+#endif
+  }
+
+  void CoTask::promise_type::operator delete(void *p, size_t size) noexcept {
+
+#if CH_CFG_USE_MEMPOOLS == TRUE
+    if ((co_frames_pool != nullptr) &&
+        (size <= co_frames_pool->object_size)) {
+      chPoolFree(co_frames_pool, p);
+      return;
+    }
+#endif
+
+#if CH_CFG_USE_HEAP == TRUE
+    (void)size;
+    chHeapFree(p);
+#else
+    (void)p;
+    (void)size;
+#endif
+  }
+
+#if CH_CFG_USE_MEMPOOLS == TRUE
+  void CoTask::setFramesPool(MemoryPool *mp) noexcept {
+
+    co_frames_pool = mp != nullptr ? &mp->pool : nullptr;
+  }
+#endif
+
+  size_t CoTask::getMaxFrameSize(void) noexcept {
+
+    return co_max_frame;
+  }
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::CoAwaiter                                                  *
+   *------------------------------------------------------------------------*/
+
+  void CoAwaiter::await_suspend(CoTask::handle_type h) noexcept {
+    CoTask::promise_type *pp = &h.promise();
+
+    pp->sched->suspend(pp, this);
+  }
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::CoroutineScheduler                                         *
+   *------------------------------------------------------------------------*/
+
+  CoroutineScheduler::CoroutineScheduler(void) noexcept :
+    owner(nullptr), ready_head(nullptr), ready_tail(nullptr),
+    waiting(nullptr), waiting_tail(nullptr), tasks(0U),
+    free_events(ALL_EVENTS & ~wakeup_event), pending_events((eventmask_t)0) {
+  }
+
+  void CoroutineScheduler::makeReady(CoTask::promise_type *pp) noexcept {
+
+    pp->next   = nullptr;
+    pp->waiter = nullptr;
+    if (ready_tail == nullptr) {
+      ready_head = pp;
+    }
+    else {
+      ready_tail->next = pp;
+    }
+    ready_tail = pp;
+  }
+
+  void CoroutineScheduler::suspend(CoTask::promise_type *pp,
+                                   CoAwaiter *awp) noexcept {
+
+    pp->next   = nullptr;
+    pp->waiter = awp;
+    pp->start  = chVTGetSystemTimeX();
+    if (waiting_tail == nullptr) {
+      waiting = pp;
+    }
+    else {
+      waiting_tail->next = pp;
+    }
+    waiting_tail = pp;
+  }
+
+  sysinterval_t CoroutineScheduler::pollWaiting(void) noexcept {
+    CoTask::promise_type **ppp = &waiting, *pp;
+    sysinterval_t next = TIME_INFINITE;
+    systime_t now = chVTGetSystemTimeX();
+
+    waiting_tail = nullptr;
+    while ((pp = *ppp) != nullptr) {
+      CoAwaiter *awp = pp->waiter;
+      bool resume = awp->poll(*this);
+
+      if (!resume) {
+        if (awp->timeout != TIME_INFINITE) {
+          sysinterval_t elapsed = chTimeDiffX(pp->start, now);
+
+          if (elapsed >= awp->timeout) {
+            awp->result = MSG_TIMEOUT;
+            resume = true;
+          }
+          else if (awp->timeout - elapsed < next) {
+            next = awp->timeout - elapsed;
+          }
+        }
+      }
+
+      if (resume) {
+        *ppp = pp->next;
+        makeReady(pp);
+      }
+      else {
+        waiting_tail = pp;
+        ppp = &pp->next;
+      }
+    }
+
+    return next;
+  }
+
+  eventmask_t CoroutineScheduler::allocEvent(void) noexcept {
+    eventmask_t event = free_events & (eventmask_t)(0U - free_events);
+
+    chDbgAssert(event != (eventmask_t)0, "no free events");
+
+    free_events &= ~event;
+    return event;
+  }
+
+  void CoroutineScheduler::freeEvent(eventmask_t event) noexcept {
+
+    /* Discarding an event received after the awaiter has been satisfied
+       by a timeout.*/
+    (void) chEvtGetAndClearEvents(event);
+    pending_events &= ~event;
+    free_events |= event;
+  }
+
+  bool CoroutineScheduler::takeEvent(eventmask_t event) noexcept {
+
+    if ((pending_events & event) != (eventmask_t)0) {
+      pending_events &= ~event;
+      return true;
+    }
+    return false;
+  }
+
+  bool CoroutineScheduler::spawn(CoTask &&task) noexcept {
+    CoTask::promise_type *pp;
+
+    if (!task.handle) {
+      return false;
+    }
+
+    pp = &task.handle.promise();
+    task.handle = nullptr;
+    pp->sched = this;
+    tasks++;
+    makeReady(pp);
+
+    return true;
+  }
+
+  void CoroutineScheduler::run(void) noexcept {
+
+    owner = chThdGetSelfX();
+
+    while (tasks > 0U) {
+      CoTask::promise_type *pp;
+      sysinterval_t timeout;
+
+      /* Running the ready coroutines until they suspend or terminate.*/
+      while ((pp = ready_head) != nullptr) {
+        CoTask::handle_type h = CoTask::handle_type::from_promise(*pp);
+
+        ready_head = pp->next;
+        if (ready_head == nullptr) {
+          ready_tail = nullptr;
+        }
+
+        h.resume();
+        if (h.done()) {
+          h.destroy();
+          tasks--;
+        }
+      }
+
+      /* Checking the suspended coroutines, sleeping if none can run.*/
+      timeout = pollWaiting();
+      if ((ready_head == nullptr) && (waiting != nullptr)) {
+        pending_events |= chEvtWaitAnyTimeout(ALL_EVENTS, timeout);
+        pending_events &= ~wakeup_event;
+      }
+    }
+
+    owner = nullptr;
+  }
+#endif /* CH_CPP_USE_COROUTINES == TRUE */
 }
 
 /** @} */
@@ -27,6 +27,94 @@
 #ifndef _CH_HPP_
 #define _CH_HPP_
 
+/**
+ * @name    C++ wrappers configuration options
+ * @{
+ */
+/**
+ * @brief   Enables the @p std::pmr memory resources.
+ * @note    Enabled by default if the compiler supports C++17 and the library
+ *          provides the @p <memory_resource> header.
+ */
+#if !defined(CH_CPP_USE_MEMORY_RESOURCES) || defined(__DOXYGEN__)
+#if defined(__has_include)
+#if (__cplusplus >= 201703L) && __has_include(<memory_resource>)
+#define CH_CPP_USE_MEMORY_RESOURCES         TRUE
+#else
+#define CH_CPP_USE_MEMORY_RESOURCES         FALSE
+#endif
+#else
+#define CH_CPP_USE_MEMORY_RESOURCES         FALSE
+#endif
+#endif
+
+/**
+ * @brief   Default size of the chunks allocated by @p ArenaResource.
+ */
+#if !defined(CH_CPP_ARENA_CHUNK_SIZE) || defined(__DOXYGEN__)
+#define CH_CPP_ARENA_CHUNK_SIZE             1024U
+#endif
+
+/**
+ * @brief   Enables the coroutines scheduler and awaitable types.
+ * @note    Enabled by default if the compiler supports C++20 coroutines and
+ *          the library provides the @p <coroutine> header.
+ */
+#if !defined(CH_CPP_USE_COROUTINES) || defined(__DOXYGEN__)
+#if defined(__has_include)
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define CH_CPP_USE_COROUTINES               TRUE
+#else
+#define CH_CPP_USE_COROUTINES               FALSE
+#endif
+#else
+#define CH_CPP_USE_COROUTINES               FALSE
+#endif
+#endif
+
+/**
+ * @brief   Enables the lock-free queues.
+ * @note    Enabled by default if the compiler provides lock-free atomic
+ *          operations on integers.
+ */
+#if !defined(CH_CPP_USE_LOCKFREE_QUEUES) || defined(__DOXYGEN__)
+#if defined(__GCC_ATOMIC_INT_LOCK_FREE)
+#if __GCC_ATOMIC_INT_LOCK_FREE == 2
+#define CH_CPP_USE_LOCKFREE_QUEUES          TRUE
+#else
+#define CH_CPP_USE_LOCKFREE_QUEUES          FALSE
+#endif
+#else
+#define CH_CPP_USE_LOCKFREE_QUEUES          FALSE
+#endif
+#endif
+
+/**
+ * @brief   Cache line size used for padding the lock-free queues indexes.
+ */
+#if !defined(CH_CPP_CACHE_LINE_SIZE) || defined(__DOXYGEN__)
+#define CH_CPP_CACHE_LINE_SIZE              32
+#endif
+/** @} */
+
+#if (CH_CPP_USE_COROUTINES == TRUE) && (CH_CFG_USE_EVENTS == FALSE)
+#error "CH_CPP_USE_COROUTINES requires CH_CFG_USE_EVENTS"
+#endif
+
+#if CH_CPP_USE_MEMORY_RESOURCES == TRUE
+#include <memory_resource>
+#endif
+
+#if CH_CPP_USE_COROUTINES == TRUE
+#include <coroutine>
+#endif
+
+#if CH_CPP_USE_LOCKFREE_QUEUES == TRUE
+#include <atomic>
+#include <new>
+#include <utility>
+#endif
+
 /**
  * @brief   ChibiOS-RT kernel-related classes and interfaces.
  */
@@ -35,6 +123,22 @@ namespace chibios_rt {
   /* Forward declaration of some classes.*/
   class ThreadReference;
 
+  /**
+   * @brief   Handles a memory allocation failure in allocators and memory
+   *          resources.
+   * @details Throws @p std::bad_alloc if exceptions are enabled else the
+   *          system is halted.
+   */
+  [[noreturn]] void _mem_exhausted(void);
+
+#if (CH_CPP_USE_COROUTINES == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE)
+  template <class S> class CoSemaphoreAwaiter;
+#endif
+
+#if (CH_CPP_USE_COROUTINES == TRUE) && (CH_CFG_USE_MAILBOXES == TRUE)
+  template <typename T> class MailboxFetchAwaiter;
+#endif
+
   /*------------------------------------------------------------------------*
    * chibios_rt::System                                                     *
    *------------------------------------------------------------------------*/
@@ -1547,6 +1651,26 @@ namespace chibios_rt {
      * @brief   Embedded @p semaphore_t structure.
      */
     semaphore_t sem;
+#if CH_CPP_USE_COROUTINES == TRUE
+    friend class CoSemaphoreAwaiter<CounterSemaphore>;
+
+    /**
+     * @brief   Source waking up the coroutines awaiting the semaphore.
+     */
+    event_source_t co_source;
+#endif
+
+    /**
+     * @brief   Wakes up the coroutines awaiting the semaphore.
+     *
+     * @iclass
+     */
+    void notifyI(void) {
+
+#if CH_CPP_USE_COROUTINES == TRUE
+      chEvtBroadcastI(&co_source);
+#endif
+    }
 
   public:
     /**
@@ -1561,6 +1685,9 @@ namespace chibios_rt {
     CounterSemaphore(cnt_t n) {
 
       chSemObjectInit(&sem, n);
+#if CH_CPP_USE_COROUTINES == TRUE
+      chEvtObjectInit(&co_source);
+#endif
     }
 
     /**
@@ -1579,7 +1706,11 @@ namespace chibios_rt {
      */
     void reset(cnt_t n) {
 
-      chSemReset(&sem, n);
+      chSysLock();
+      chSemResetI(&sem, n);
+      notifyI();
+      chSchRescheduleS();
+      chSysUnlock();
     }
 
     /**
@@ -1603,6 +1734,7 @@ namespace chibios_rt {
     void resetI(cnt_t n) {
 
       chSemResetI(&sem, n);
+      notifyI();
     }
 
     /**
@@ -1696,7 +1828,11 @@ namespace chibios_rt {
      */
     void signal(void) {
 
-      chSemSignal(&sem);
+      chSysLock();
+      chSemSignalI(&sem);
+      notifyI();
+      chSchRescheduleS();
+      chSysUnlock();
     }
 
     /**
@@ -1711,6 +1847,7 @@ namespace chibios_rt {
     void signalI(void) {
 
       chSemSignalI(&sem);
+      notifyI();
     }
 
     /**
@@ -1728,6 +1865,7 @@ namespace chibios_rt {
     void addCounterI(cnt_t n) {
 
       chSemAddCounterI(&sem, n);
+      notifyI();
     }
 
     /**
@@ -1758,8 +1896,23 @@ namespace chibios_rt {
      */
     static msg_t signalWait(CounterSemaphore *ssem,
                             CounterSemaphore *wsem) {
+#if CH_CPP_USE_COROUTINES == TRUE
+      msg_t msg;
+
+      /* Coroutines are notified in the same critical zone of the signal
+         operation, same as chSemSignalWait().*/
+      chSysLock();
+      chSemSignalI(&ssem->sem);
+      ssem->notifyI();
+      msg = chSemWaitS(&wsem->sem);
+      chSchRescheduleS();
+      chSysUnlock();
+
+      return msg;
+#else
 
       return chSemSignalWait(&ssem->sem, &wsem->sem);
+#endif
     }
   };
 
@@ -1774,6 +1927,26 @@ namespace chibios_rt {
      * @brief   Embedded @p binary_semaphore_t structure.
      */
     binary_semaphore_t bsem;
+#if CH_CPP_USE_COROUTINES == TRUE
+    friend class CoSemaphoreAwaiter<BinarySemaphore>;
+
+    /**
+     * @brief   Source waking up the coroutines awaiting the semaphore.
+     */
+    event_source_t co_source;
+#endif
+
+    /**
+     * @brief   Wakes up the coroutines awaiting the semaphore.
+     *
+     * @iclass
+     */
+    void notifyI(void) {
+
+#if CH_CPP_USE_COROUTINES == TRUE
+      chEvtBroadcastI(&co_source);
+#endif
+    }
 
   public:
     /**
@@ -1790,6 +1963,9 @@ namespace chibios_rt {
     BinarySemaphore(bool taken) {
 
       chBSemObjectInit(&bsem, taken);
+#if CH_CPP_USE_COROUTINES == TRUE
+      chEvtObjectInit(&co_source);
+#endif
     }
 
     /**
@@ -1889,7 +2065,11 @@ namespace chibios_rt {
      */
     void reset(bool taken) {
 
-      chBSemReset(&bsem, taken);
+      chSysLock();
+      chBSemResetI(&bsem, taken);
+      notifyI();
+      chSchRescheduleS();
+      chSysUnlock();
     }
 
     /**
@@ -1909,6 +2089,7 @@ namespace chibios_rt {
     void resetI(bool taken) {
 
       chBSemResetI(&bsem, taken);
+      notifyI();
     }
 
     /**
@@ -1918,7 +2099,11 @@ namespace chibios_rt {
      */
     void signal(void) {
 
-      chBSemSignal(&bsem);
+      chSysLock();
+      chBSemSignalI(&bsem);
+      notifyI();
+      chSchRescheduleS();
+      chSysUnlock();
     }
 
     /**
@@ -1930,6 +2115,7 @@ namespace chibios_rt {
     void signalI(void) {
 
       chBSemSignalI(&bsem);
+      notifyI();
     }
 
     /**
@@ -2357,6 +2543,9 @@ namespace chibios_rt {
      * @brief   Embedded @p event_source_t structure.
      */
     event_source_t ev_source;
+#if CH_CPP_USE_COROUTINES == TRUE
+    friend class CoEventAwaiter;
+#endif
 
    public:
    /**
@@ -2463,6 +2652,26 @@ namespace chibios_rt {
      * @brief   Embedded @p mailbox_t structure.
      */
     mailbox_t mb;
+#if CH_CPP_USE_COROUTINES == TRUE
+    friend class MailboxFetchAwaiter<T>;
+
+    /**
+     * @brief   Source waking up the coroutines awaiting the mailbox.
+     */
+    event_source_t co_source;
+#endif
+
+    /**
+     * @brief   Wakes up the coroutines awaiting the mailbox.
+     *
+     * @iclass
+     */
+    void notifyI(void) {
+
+#if CH_CPP_USE_COROUTINES == TRUE
+      chEvtBroadcastI(&co_source);
+#endif
+    }
 
    public:
    /**
@@ -2478,6 +2687,9 @@ namespace chibios_rt {
     MailboxBase(msg_t *buf, cnt_t n) {
 
       chMBObjectInit(&mb, buf, n);
+#if CH_CPP_USE_COROUTINES == TRUE
+      chEvtObjectInit(&co_source);
+#endif
     }
 
     /**
@@ -2489,7 +2701,11 @@ namespace chibios_rt {
      */
     void reset(void) {
 
-      chMBReset(&mb);
+      chSysLock();
+      chMBResetI(&mb);
+      notifyI();
+      chSchRescheduleS();
+      chSysUnlock();
     }
 
     /**
@@ -2521,8 +2737,13 @@ namespace chibios_rt {
      * @api
      */
     msg_t post(T msg, sysinterval_t timeout) {
+      msg_t rdymsg;
+
+      chSysLock();
+      rdymsg = postS(msg, timeout);
+      chSysUnlock();
 
-      return chMBPostTimeout(&mb, reinterpret_cast<msg_t>(msg), timeout);
+      return rdymsg;
     }
 
     /**
@@ -2544,8 +2765,15 @@ namespace chibios_rt {
      * @sclass
      */
     msg_t postS(T msg, sysinterval_t timeout) {
+      msg_t rdymsg;
 
-      return chMBPostTimeoutS(&mb, reinterpret_cast<msg_t>(msg), timeout);
+      rdymsg = chMBPostTimeoutS(&mb, reinterpret_cast<msg_t>(msg), timeout);
+      if (rdymsg == MSG_OK) {
+        notifyI();
+        chSchRescheduleS();
+      }
+
+      return rdymsg;
     }
 
     /**
@@ -2562,8 +2790,14 @@ namespace chibios_rt {
      * @iclass
      */
     msg_t postI(T msg) {
+      msg_t rdymsg;
+
+      rdymsg = chMBPostI(&mb, reinterpret_cast<msg_t>(msg));
+      if (rdymsg == MSG_OK) {
+        notifyI();
+      }
 
-      return chMBPostI(&mb, reinterpret_cast<msg_t>(msg));
+      return rdymsg;
     }
 
     /**
@@ -2585,8 +2819,13 @@ namespace chibios_rt {
      * @api
      */
     msg_t postAhead(T msg, sysinterval_t timeout) {
+      msg_t rdymsg;
 
-      return chMBPostAheadTimeout(&mb, reinterpret_cast<msg_t>(msg), timeout);
+      chSysLock();
+      rdymsg = postAheadS(msg, timeout);
+      chSysUnlock();
+
+      return rdymsg;
     }
 
     /**
@@ -2608,8 +2847,15 @@ namespace chibios_rt {
      * @sclass
      */
     msg_t postAheadS(T msg, sysinterval_t timeout) {
+      msg_t rdymsg;
+
+      rdymsg = chMBPostAheadTimeoutS(&mb, reinterpret_cast<msg_t>(msg), timeout);
+      if (rdymsg == MSG_OK) {
+        notifyI();
+        chSchRescheduleS();
+      }
 
-      return chMBPostAheadTimeoutS(&mb, reinterpret_cast<msg_t>(msg), timeout);
+      return rdymsg;
     }
 
     /**
@@ -2626,8 +2872,14 @@ namespace chibios_rt {
      * @iclass
      */
     msg_t postAheadI(T msg) {
+      msg_t rdymsg;
+
+      rdymsg = chMBPostAheadI(&mb, reinterpret_cast<msg_t>(msg));
+      if (rdymsg == MSG_OK) {
+        notifyI();
+      }
 
-      return chMBPostAheadI(&mb, reinterpret_cast<msg_t>(msg));
+      return rdymsg;
     }
 
     /**
@@ -2695,6 +2947,23 @@ namespace chibios_rt {
       return chMBFetchI(&mb, reinterpret_cast<msg_t*>(msgp));
     }
 
+#if (CH_CPP_USE_COROUTINES == TRUE) || defined(__DOXYGEN__)
+    /**
+     * @brief   Retrieves a message from a mailbox in a coroutine.
+     * @details The returned object is awaited using @p co_await, the
+     *          coroutine is suspended until a message is available, the
+     *          value of the @p co_await expression is the message.
+     *
+     * @return              The awaitable object.
+     *
+     * @api
+     */
+    MailboxFetchAwaiter<T> fetch(void) {
+
+      return MailboxFetchAwaiter<T>(*this);
+    }
+#endif
+
     /**
      * @brief   Returns the next message in the queue without removing it.
      * @pre     A message must be waiting in the queue for this function to work
@@ -2773,292 +3042,1946 @@ namespace chibios_rt {
   };
 #endif /* CH_CFG_USE_MAILBOXES == TRUE */
 
-#if (CH_CFG_USE_MEMPOOLS == TRUE) || defined(__DOXYGEN__)
+#if (CH_CPP_USE_LOCKFREE_QUEUES == TRUE) || defined(__DOXYGEN__)
   /*------------------------------------------------------------------------*
-   * chibios_rt::MemoryPool                                                 *
+   * chibios_rt::SPSCQueue                                                  *
    *------------------------------------------------------------------------*/
   /**
-   * @brief   Class encapsulating a memory pool.
+   * @brief   Lock-free single producer single consumer queue.
+   * @details Elements are stored by value, no kernel lock is taken. The
+   *          producer and the consumer can be threads or ISRs.
+   * @note    Move-only element types are supported.
+   *
+   * @param T               type of the elements
+   * @param N               capacity of the queue, must be a power of two
    */
-  class MemoryPool {
+  template <typename T, size_t N>
+  class SPSCQueue {
+    static_assert((N >= 2U) && ((N & (N - 1U)) == 0U),
+                  "SPSCQueue capacity is not a power of two");
+
+  public:
+    typedef T value_type;
+
     /**
-     * @brief   Embedded @p memory_pool_t structure.
+     * @brief   Capacity of the queue.
      */
-    memory_pool_t pool;
+    static constexpr size_t capacity = N;
+
+  private:
+    static constexpr size_t mask = N - 1U;
 
-  public:
     /**
-     * @brief   MemoryPool constructor.
-     *
-     * @param[in] size      the size of the objects contained in this memory
-     *                      pool, the minimum accepted size is the size of
-     *                      a pointer to void.
-     * @param[in] provider  memory provider function for the memory pool or
-     *                      @p nullptr if the pool is not allowed to grow
-     *                      automatically
-     *
-     * @init
+     * @brief   Read counter, written by the consumer only.
      */
-    MemoryPool(size_t size, memgetfunc_t provider=0) : pool() {
+    alignas(CH_CPP_CACHE_LINE_SIZE) std::atomic<size_t> head;
+    /**
+     * @brief   Write counter, written by the producer only.
+     */
+    alignas(CH_CPP_CACHE_LINE_SIZE) std::atomic<size_t> tail;
+    /**
+     * @brief   Elements storage.
+     */
+    alignas(CH_CPP_CACHE_LINE_SIZE) alignas(T) uint8_t slots[N][sizeof (T)];
 
-      chPoolObjectInit(&pool, size, provider);
+    T *slot(size_t i) noexcept {
+
+      return reinterpret_cast<T *>(slots[i & mask]);
     }
 
+  public:
     /**
-     * @brief   MemoryPool constructor.
-     *
-     * @param[in] size      the size of the objects contained in this memory
-     *                      pool, the minimum accepted size is the size of
-     *                      a pointer to void.
-     * @param[in] provider  memory provider function for the memory pool or
-     *                      @p nullptr if the pool is not allowed to grow
-     *                      automatically
-     * @param[in] p         pointer to the array first element
-     * @param[in] n         number of elements in the array
+     * @brief   SPSCQueue constructor.
      *
      * @init
      */
-    MemoryPool(size_t size, void* p, size_t n,
-               memgetfunc_t provider=0) : pool() {
-
-      chPoolObjectInit(&pool, size, provider);
-      chPoolLoadArray(&pool, p, n);
+    SPSCQueue(void) noexcept : head(0U), tail(0U) {
     }
 
-    /* Prohibit copy construction and assignment, but allow move.*/
-    MemoryPool(const MemoryPool &) = delete;
-    MemoryPool &operator=(const MemoryPool &) = delete;
-    MemoryPool(MemoryPool &&) = default;
-    MemoryPool &operator=(MemoryPool &&) = default;
+    /* Prohibit copy construction and assignment.*/
+    SPSCQueue(const SPSCQueue &) = delete;
+    SPSCQueue &operator=(const SPSCQueue &) = delete;
 
     /**
-     * @brief   Loads a memory pool with an array of static objects.
-     * @pre     The memory pool must be already been initialized.
-     * @pre     The array elements must be of the right size for the specified
-     *          memory pool.
-     * @post    The memory pool contains the elements of the input array.
+     * @brief   SPSCQueue destructor.
+     * @details The elements still in the queue are destroyed.
+     */
+    ~SPSCQueue() {
+      size_t t = tail.load(std::memory_order_relaxed);
+
+      for (size_t h = head.load(std::memory_order_relaxed); h != t; h++) {
+        slot(h)->~T();
+      }
+    }
+
+    /**
+     * @brief   Constructs an element at the end of the queue.
+     * @note    Must be invoked by the producer only.
      *
-     * @param[in] p         pointer to the array first element
-     * @param[in] n         number of elements in the array
+     * @param[in] args      the element constructor arguments
+     * @return              The operation status.
+     * @retval false        if the queue is full.
      *
-     * @api
+     * @xclass
      */
-    void loadArray(void *p, size_t n) {
+    template <typename... A>
+    bool tryEmplace(A&&... args) {
+      size_t t = tail.load(std::memory_order_relaxed);
 
-      chPoolLoadArray(&pool, p, n);
+      if (t - head.load(std::memory_order_acquire) >= N) {
+        return false;
+      }
+      new (slot(t)) T(std::forward<A>(args)...);
+      tail.store(t + 1U, std::memory_order_release);
+      return true;
     }
 
     /**
-     * @brief   Allocates an object from a memory pool.
-     * @pre     The memory pool must be already been initialized.
+     * @brief   Moves an element at the end of the queue.
+     * @note    Must be invoked by the producer only.
      *
-     * @return              The pointer to the allocated object.
-     * @retval nullptr      if pool is empty.
+     * @param[in] v         the element
+     * @return              The operation status.
+     * @retval false        if the queue is full, @p v is left untouched.
      *
-     * @iclass
+     * @xclass
      */
-    void *allocI(void) {
+    bool tryPush(T &&v) {
 
-      return chPoolAllocI(&pool);
+      return tryEmplace(std::move(v));
     }
 
     /**
-     * @brief   Allocates an object from a memory pool.
-     * @pre     The memory pool must be already been initialized.
+     * @brief   Copies an element at the end of the queue.
+     * @note    Must be invoked by the producer only.
      *
-     * @return              The pointer to the allocated object.
-     * @retval nullptr      if pool is empty.
+     * @param[in] v         the element
+     * @return              The operation status.
+     * @retval false        if the queue is full.
      *
-     * @api
+     * @xclass
      */
-    void *alloc(void) {
+    bool tryPush(const T &v) {
 
-      return chPoolAlloc(&pool);
+      return tryEmplace(v);
     }
 
     /**
-     * @brief   Releases an object into a memory pool.
-     * @pre     The memory pool must be already been initialized.
-     * @pre     The freed object must be of the right size for the specified
-     *          memory pool.
-     * @pre     The object must be properly aligned to contain a pointer to
-     *          void.
+     * @brief   Removes the element at the front of the queue.
+     * @note    Must be invoked by the consumer only.
      *
-     * @param[in] objp      the pointer to the object to be released
+     * @param[out] v        the element moved out of the queue
+     * @return              The operation status.
+     * @retval false        if the queue is empty.
      *
-     * @iclass
+     * @xclass
      */
-    void free(void *objp) {
+    bool tryPop(T &v) {
+      size_t h = head.load(std::memory_order_relaxed);
+      T *p;
 
-      chPoolFree(&pool, objp);
+      if (h == tail.load(std::memory_order_acquire)) {
+        return false;
+      }
+      p = slot(h);
+      v = std::move(*p);
+      p->~T();
+      head.store(h + 1U, std::memory_order_release);
+      return true;
     }
 
     /**
-     * @brief   Adds an object to a memory pool.
-     * @pre     The memory pool must be already been initialized.
-     * @pre     The added object must be of the right size for the specified
-     *          memory pool.
-     * @pre     The added object must be memory aligned to the size of
-     *          @p stkline_t type.
-     * @note    This function is just an alias for @p chPoolFree() and has been
-     *          added for clarity.
+     * @brief   Returns the number of elements in the queue.
+     * @note    The value is approximated if the queue is in use.
      *
-     * @param[in] objp      the pointer to the object to be added
+     * @return              The number of elements.
      *
-     * @iclass
+     * @xclass
      */
-    void freeI(void *objp) {
+    size_t getUsed(void) const noexcept {
 
-      chPoolFreeI(&pool, objp);
+      return tail.load(std::memory_order_acquire) -
+             head.load(std::memory_order_acquire);
     }
   };
 
   /*------------------------------------------------------------------------*
-   * chibios_rt::ObjectsPool                                                *
+   * chibios_rt::MPSCQueue                                                  *
    *------------------------------------------------------------------------*/
   /**
-   * @brief   Template class encapsulating a memory pool and its elements.
+   * @brief   Lock-free multiple producers single consumer queue.
+   * @details Elements are stored by value, no kernel lock is taken. The
+   *          producers reserve slots using a compare and swap on the write
+   *          counter, each slot has a sequence number marking it as ready
+   *          for the consumer or for the next round of producers.
+   * @note    Move-only element types are supported.
+   * @note    An element whose producer has been preempted between the slot
+   *          reservation and the element construction delays the consumer
+   *          until the producer resumes.
+   *
+   * @param T               type of the elements
+   * @param N               capacity of the queue, must be a power of two
    */
-  template<class T, size_t N>
-  class ObjectsPool : public MemoryPool {
-    /* The buffer is declared as an array of pointers to void for two
-       reasons:
-       1) The objects must be properly aligned to hold a pointer as
-          first field.
-       2) Objects are dirtied when loaded in the pool.*/
-    void *pool_buf[(N * sizeof (T)) / sizeof (void *)];
+  template <typename T, size_t N>
+  class MPSCQueue {
+    static_assert((N >= 2U) && ((N & (N - 1U)) == 0U),
+                  "MPSCQueue capacity is not a power of two");
 
   public:
+    typedef T value_type;
+
     /**
-     * @brief   ObjectsPool constructor.
-     *
-     * @init
+     * @brief   Capacity of the queue.
      */
-    ObjectsPool(void) : MemoryPool(sizeof (T), nullptr) {
+    static constexpr size_t capacity = N;
 
-      loadArray(pool_buf, N);
-    }
-  };
+  private:
+    static constexpr size_t mask = N - 1U;
 
-  /*------------------------------------------------------------------------*
-   * chibios_rt::ThreadsPool                                                *
-   *------------------------------------------------------------------------*/
-  /**
-   * @brief   Template class encapsulating a pool of threads.
-   */
-  template<size_t S, size_t N, const char *C>
-  class ThreadsPool : public BaseDynamicThread {
-    THD_WORKING_AREA(working_areas, S)[N];
-    MemoryPool threads_pool;
+    /**
+     * @brief   Queue slot.
+     */
+    struct cell {
+      std::atomic<size_t>       seq;
+      alignas(T) uint8_t        data[sizeof (T)];
+    };
+
+    /**
+     * @brief   Read counter, written by the consumer only.
+     */
+    alignas(CH_CPP_CACHE_LINE_SIZE) std::atomic<size_t> head;
+    /**
+     * @brief   Write counter, shared by the producers.
+     */
+    alignas(CH_CPP_CACHE_LINE_SIZE) std::atomic<size_t> tail;
+    /**
+     * @brief   Slots.
+     */
+    alignas(CH_CPP_CACHE_LINE_SIZE) cell cells[N];
 
   public:
     /**
-     * @brief   ThreadsPool constructor.
+     * @brief   MPSCQueue constructor.
      *
      * @init
      */
-    ThreadsPool(void) : threads_pool(THD_WORKING_AREA_SIZE(S)) {
+    MPSCQueue(void) noexcept : head(0U), tail(0U) {
 
-      threads_pool.loadArray(working_areas, N);
+      for (size_t i = 0U; i < N; i++) {
+        cells[i].seq.store(i, std::memory_order_relaxed);
+      }
     }
 
+    /* Prohibit copy construction and assignment.*/
+    MPSCQueue(const MPSCQueue &) = delete;
+    MPSCQueue &operator=(const MPSCQueue &) = delete;
+
     /**
-     * @brief   Starts a dynamic thread from the pool.
+     * @brief   MPSCQueue destructor.
+     * @details The elements still in the queue are destroyed.
+     */
+    ~MPSCQueue() {
+      size_t pos = head.load(std::memory_order_relaxed);
+
+      while (cells[pos & mask].seq.load(std::memory_order_relaxed) ==
+             pos + 1U) {
+        reinterpret_cast<T *>(cells[pos & mask].data)->~T();
+        pos++;
+      }
+    }
+
+    /**
+     * @brief   Constructs an element at the end of the queue.
      *
-     * @param[in] prio          thread priority
-     * @return                  A reference to the created thread with
-     *                          reference counter set to one.
+     * @param[in] args      the element constructor arguments
+     * @return              The operation status.
+     * @retval false        if the queue is full.
      *
-     * @api
+     * @xclass
      */
-    ThreadReference start(tprio_t prio) override {
-      void _thd_start(void *arg);
+    template <typename... A>
+    bool tryEmplace(A&&... args) {
+      size_t pos = tail.load(std::memory_order_relaxed);
+      cell *cp;
+
+      while (true) {
+        size_t seq;
+
+        cp  = &cells[pos & mask];
+        seq = cp->seq.load(std::memory_order_acquire);
+        if (seq == pos) {
+          /* Slot free, trying to reserve it.*/
+          if (tail.compare_exchange_weak(pos, pos + 1U,
+                                         std::memory_order_relaxed)) {
+            break;
+          }
+        }
+        else if ((ptrdiff_t)(seq - pos) < 0) {
+          /* Slot still holding an element of the previous round.*/
+          return false;
+        }
+        else {
+          /* Another producer reserved the slot.*/
+          pos = tail.load(std::memory_order_relaxed);
+        }
+      }
 
-      return ThreadReference(chThdCreateFromMemoryPool(&threads_pool.pool,
-                                                       C,
-                                                       prio,
-                                                       _thd_start,
-                                                       this));
-     }
-   };
-#endif /* CH_CFG_USE_MEMPOOLS == TRUE */
+      new (cp->data) T(std::forward<A>(args)...);
+      cp->seq.store(pos + 1U, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * @brief   Moves an element at the end of the queue.
+     *
+     * @param[in] v         the element
+     * @return              The operation status.
+     * @retval false        if the queue is full, @p v is left untouched.
+     *
+     * @xclass
+     */
+    bool tryPush(T &&v) {
+
+      return tryEmplace(std::move(v));
+    }
+
+    /**
+     * @brief   Copies an element at the end of the queue.
+     *
+     * @param[in] v         the element
+     * @return              The operation status.
+     * @retval false        if the queue is full.
+     *
+     * @xclass
+     */
+    bool tryPush(const T &v) {
+
+      return tryEmplace(v);
+    }
+
+    /**
+     * @brief   Removes the element at the front of the queue.
+     * @note    Must be invoked by the consumer only.
+     *
+     * @param[out] v        the element moved out of the queue
+     * @return              The operation status.
+     * @retval false        if the queue is empty.
+     *
+     * @xclass
+     */
+    bool tryPop(T &v) {
+      size_t pos = head.load(std::memory_order_relaxed);
+      cell *cp = &cells[pos & mask];
+      T *p;
+
+      if (cp->seq.load(std::memory_order_acquire) != pos + 1U) {
+        return false;
+      }
+      p = reinterpret_cast<T *>(cp->data);
+      v = std::move(*p);
+      p->~T();
+      cp->seq.store(pos + N, std::memory_order_release);
+      head.store(pos + 1U, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * @brief   Returns the number of elements in the queue.
+     * @note    The value is approximated if the queue is in use, slots
+     *          reserved by producers are counted.
+     *
+     * @return              The number of elements.
+     *
+     * @xclass
+     */
+    size_t getUsed(void) const noexcept {
+
+      return tail.load(std::memory_order_acquire) -
+             head.load(std::memory_order_acquire);
+    }
+  };
 
-#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
   /*------------------------------------------------------------------------*
-   * chibios_rt::Heap                                                       *
+   * chibios_rt::BlockingQueue                                              *
    *------------------------------------------------------------------------*/
   /**
-   * @brief   Class encapsulating a heap.
+   * @brief   Blocking wrapper of a lock-free queue.
+   * @details Operations on a queue neither empty nor full do not take the
+   *          kernel lock, threads are suspended on a @p ThreadsQueue only
+   *          when the queue is empty or full. A counter of the suspended
+   *          threads tells the other side when a wakeup is needed.
+   * @note    The single producer and single consumer constraints of the
+   *          wrapped queue still apply.
+   *
+   * @param Q               the wrapped queue, @p SPSCQueue or @p MPSCQueue
    */
-  class Heap {
+  template <class Q>
+  class BlockingQueue : public Q {
+  public:
+    typedef typename Q::value_type T;
+
+  private:
     /**
-     * @brief   Embedded @p memory_heap_t structure.
+     * @brief   Threads waiting for an element.
      */
-    memory_heap_t heap;
+    ThreadsQueue            readers;
+    /**
+     * @brief   Threads waiting for a free slot.
+     */
+    ThreadsQueue            writers;
+    /**
+     * @brief   Number of threads in @p readers.
+     */
+    std::atomic<unsigned>   nreaders;
+    /**
+     * @brief   Number of threads in @p writers.
+     */
+    std::atomic<unsigned>   nwriters;
+
+    static void wakeup(ThreadsQueue &tq, std::atomic<unsigned> &n) {
+
+      /* Ordering the queue update before the counter read, the waiting
+         side orders the counter update before checking the queue.*/
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (n.load(std::memory_order_relaxed) > 0U) {
+        chSysLock();
+        tq.dequeueNextI(MSG_OK);
+        chSchRescheduleS();
+        chSysUnlock();
+      }
+    }
+
+    static void wakeupI(ThreadsQueue &tq, std::atomic<unsigned> &n) {
+
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (n.load(std::memory_order_relaxed) > 0U) {
+        tq.dequeueNextI(MSG_OK);
+      }
+    }
+
+    template <typename F>
+    static msg_t waitFor(ThreadsQueue &tq, std::atomic<unsigned> &n,
+                         sysinterval_t timeout, F op) {
+      msg_t msg = MSG_OK;
+
+      chSysLock();
+      n.fetch_add(1U, std::memory_order_seq_cst);
+      while (!op()) {
+        msg = tq.enqueueSelfS(timeout);
+        if (msg != MSG_OK) {
+          break;
+        }
+      }
+      n.fetch_sub(1U, std::memory_order_relaxed);
+      chSysUnlock();
+
+      return msg;
+    }
 
   public:
     /**
-     * @brief   Heap constructor.
-     * @pre     Both the heap buffer base and the heap size must be aligned to
-     *          the @p stkline_t type size.
+     * @brief   BlockingQueue constructor.
      *
-     * @param[in] buffer    heap buffer base
-     * @param[in] size      the size of the memory area located at \e buffer
      * @init
      */
-    Heap(void *buffer, const size_t size) : heap() {
-
-      chHeapObjectInit(&heap, buffer, size);
+    BlockingQueue(void) noexcept : Q(), nreaders(0U), nwriters(0U) {
     }
 
-    /* Prohibit copy construction and assignment, but allow move.*/
-    Heap(const Heap &) = delete;
-    Heap &operator=(const Heap &) = delete;
-    Heap(Heap &&) = default;
-    Heap &operator=(Heap &&) = default;
-
     /**
-     * @brief   Allocates an object from a heap.
-     * @pre     The heap must be already been initialized.
+     * @brief   Moves an element at the end of the queue.
+     * @details The invoking thread waits until a free slot becomes
+     *          available or the specified time runs out.
      *
-     * @return              The pointer to the allocated object.
-     * @retval nullptr      if pool is empty.
+     * @param[in] v         the element
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval MSG_OK       if the element has been queued.
+     * @retval MSG_TIMEOUT  if the operation has timed out.
      *
      * @api
      */
-    void *alloc(const size_t size) {
+    msg_t push(T &&v, sysinterval_t timeout) {
+      msg_t msg = MSG_OK;
+
+      if (!Q::tryPush(std::move(v))) {
+        if (timeout == TIME_IMMEDIATE) {
+          return MSG_TIMEOUT;
+        }
+        msg = waitFor(writers, nwriters, timeout,
+                      [&]() { return Q::tryPush(std::move(v)); });
+        if (msg != MSG_OK) {
+          return msg;
+        }
+      }
+      wakeup(readers, nreaders);
 
-      return chHeapAlloc(&heap, size);
+      return MSG_OK;
     }
 
     /**
-     * @brief   Releases an object into the heap.
+     * @brief   Copies an element at the end of the queue.
+     * @details The invoking thread waits until a free slot becomes
+     *          available or the specified time runs out.
      *
-     * @param[in] objp      the pointer to the object to be released
+     * @param[in] v         the element
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval MSG_OK       if the element has been queued.
+     * @retval MSG_TIMEOUT  if the operation has timed out.
      *
      * @api
      */
-    void free(void *objp) {
+    msg_t push(const T &v, sysinterval_t timeout) {
+      T tmp(v);
 
-      chHeapFree(objp);
+      return push(std::move(tmp), timeout);
     }
 
     /**
-     * @brief   Reports the heap status.
+     * @brief   Moves an element at the end of the queue.
+     * @details This variant is non-blocking, a waiting consumer is
+     *          awakened.
      *
-     * @param[out] frag     the size of total fragmented free space
-     * @param[in] largestp  pointer to a variable that will receive the largest
-     *                      free free block found space or @p nullptr
-     * @return              the number of fragments in the heap
+     * @param[in] v         the element
+     * @return              The operation status.
+     * @retval false        if the queue is full.
+     *
+     * @iclass
+     */
+    bool pushI(T &&v) {
+
+      if (!Q::tryPush(std::move(v))) {
+        return false;
+      }
+      wakeupI(readers, nreaders);
+      return true;
+    }
+
+    /**
+     * @brief   Removes the element at the front of the queue.
+     * @details The invoking thread waits until an element becomes available
+     *          or the specified time runs out.
+     *
+     * @param[out] v        the element moved out of the queue
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval MSG_OK       if an element has been removed.
+     * @retval MSG_TIMEOUT  if the operation has timed out.
      *
      * @api
      */
-    size_t status(size_t &frag, size_t *largestp=0) {
+    msg_t pop(T &v, sysinterval_t timeout) {
+      msg_t msg = MSG_OK;
+
+      if (!Q::tryPop(v)) {
+        if (timeout == TIME_IMMEDIATE) {
+          return MSG_TIMEOUT;
+        }
+        msg = waitFor(readers, nreaders, timeout,
+                      [&]() { return Q::tryPop(v); });
+        if (msg != MSG_OK) {
+          return msg;
+        }
+      }
+      wakeup(writers, nwriters);
 
-      return chHeapStatus(&heap, &frag, largestp);
+      return MSG_OK;
+    }
+
+    /**
+     * @brief   Removes the element at the front of the queue.
+     * @details This variant is non-blocking, a waiting producer is
+     *          awakened.
+     *
+     * @param[out] v        the element moved out of the queue
+     * @return              The operation status.
+     * @retval false        if the queue is empty.
+     *
+     * @iclass
+     */
+    bool popI(T &v) {
+
+      if (!Q::tryPop(v)) {
+        return false;
+      }
+      wakeupI(writers, nwriters);
+      return true;
     }
   };
-#endif /* CH_CFG_USE_MEMPOOLS == TRUE */
+#endif /* CH_CPP_USE_LOCKFREE_QUEUES == TRUE */
+
+#if (CH_CFG_USE_MEMPOOLS == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::MemoryPool                                                 *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Class encapsulating a memory pool.
+   */
+  class MemoryPool {
+#if (CH_CPP_USE_MEMORY_RESOURCES == TRUE) || defined(__DOXYGEN__)
+    friend class PoolResource;
+#endif
+#if (CH_CPP_USE_COROUTINES == TRUE) || defined(__DOXYGEN__)
+    friend class CoTask;
+#endif
+
+    /**
+     * @brief   Embedded @p memory_pool_t structure.
+     */
+    memory_pool_t pool;
+
+  public:
+    /**
+     * @brief   MemoryPool constructor.
+     *
+     * @param[in] size      the size of the objects contained in this memory
+     *                      pool, the minimum accepted size is the size of
+     *                      a pointer to void.
+     * @param[in] provider  memory provider function for the memory pool or
+     *                      @p nullptr if the pool is not allowed to grow
+     *                      automatically
+     *
+     * @init
+     */
+    MemoryPool(size_t size, memgetfunc_t provider=0) : pool() {
+
+      chPoolObjectInit(&pool, size, provider);
+    }
+
+    /**
+     * @brief   MemoryPool constructor.
+     *
+     * @param[in] size      the size of the objects contained in this memory
+     *                      pool, the minimum accepted size is the size of
+     *                      a pointer to void.
+     * @param[in] provider  memory provider function for the memory pool or
+     *                      @p nullptr if the pool is not allowed to grow
+     *                      automatically
+     * @param[in] p         pointer to the array first element
+     * @param[in] n         number of elements in the array
+     *
+     * @init
+     */
+    MemoryPool(size_t size, void* p, size_t n,
+               memgetfunc_t provider=0) : pool() {
+
+      chPoolObjectInit(&pool, size, provider);
+      chPoolLoadArray(&pool, p, n);
+    }
+
+    /* Prohibit copy construction and assignment, but allow move.*/
+    MemoryPool(const MemoryPool &) = delete;
+    MemoryPool &operator=(const MemoryPool &) = delete;
+    MemoryPool(MemoryPool &&) = default;
+    MemoryPool &operator=(MemoryPool &&) = default;
+
+    /**
+     * @brief   Loads a memory pool with an array of static objects.
+     * @pre     The memory pool must be already been initialized.
+     * @pre     The array elements must be of the right size for the specified
+     *          memory pool.
+     * @post    The memory pool contains the elements of the input array.
+     *
+     * @param[in] p         pointer to the array first element
+     * @param[in] n         number of elements in the array
+     *
+     * @api
+     */
+    void loadArray(void *p, size_t n) {
+
+      chPoolLoadArray(&pool, p, n);
+    }
+
+    /**
+     * @brief   Allocates an object from a memory pool.
+     * @pre     The memory pool must be already been initialized.
+     *
+     * @return              The pointer to the allocated object.
+     * @retval nullptr      if pool is empty.
+     *
+     * @iclass
+     */
+    void *allocI(void) {
+
+      return chPoolAllocI(&pool);
+    }
+
+    /**
+     * @brief   Allocates an object from a memory pool.
+     * @pre     The memory pool must be already been initialized.
+     *
+     * @return              The pointer to the allocated object.
+     * @retval nullptr      if pool is empty.
+     *
+     * @api
+     */
+    void *alloc(void) {
+
+      return chPoolAlloc(&pool);
+    }
+
+    /**
+     * @brief   Releases an object into a memory pool.
+     * @pre     The memory pool must be already been initialized.
+     * @pre     The freed object must be of the right size for the specified
+     *          memory pool.
+     * @pre     The object must be properly aligned to contain a pointer to
+     *          void.
+     *
+     * @param[in] objp      the pointer to the object to be released
+     *
+     * @iclass
+     */
+    void free(void *objp) {
+
+      chPoolFree(&pool, objp);
+    }
+
+    /**
+     * @brief   Adds an object to a memory pool.
+     * @pre     The memory pool must be already been initialized.
+     * @pre     The added object must be of the right size for the specified
+     *          memory pool.
+     * @pre     The added object must be memory aligned to the size of
+     *          @p stkline_t type.
+     * @note    This function is just an alias for @p chPoolFree() and has been
+     *          added for clarity.
+     *
+     * @param[in] objp      the pointer to the object to be added
+     *
+     * @iclass
+     */
+    void freeI(void *objp) {
+
+      chPoolFreeI(&pool, objp);
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::ObjectsPool                                                *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Template class encapsulating a memory pool and its elements.
+   */
+  template<class T, size_t N>
+  class ObjectsPool : public MemoryPool {
+    /* The buffer is declared as an array of pointers to void for two
+       reasons:
+       1) The objects must be properly aligned to hold a pointer as
+          first field.
+       2) Objects are dirtied when loaded in the pool.*/
+    void *pool_buf[(N * sizeof (T)) / sizeof (void *)];
+
+  public:
+    /**
+     * @brief   ObjectsPool constructor.
+     *
+     * @init
+     */
+    ObjectsPool(void) : MemoryPool(sizeof (T), nullptr) {
+
+      loadArray(pool_buf, N);
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::ThreadsPool                                                *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Template class encapsulating a pool of threads.
+   */
+  template<size_t S, size_t N, const char *C>
+  class ThreadsPool : public BaseDynamicThread {
+    THD_WORKING_AREA(working_areas, S)[N];
+    MemoryPool threads_pool;
+
+  public:
+    /**
+     * @brief   ThreadsPool constructor.
+     *
+     * @init
+     */
+    ThreadsPool(void) : threads_pool(THD_WORKING_AREA_SIZE(S)) {
+
+      threads_pool.loadArray(working_areas, N);
+    }
+
+    /**
+     * @brief   Starts a dynamic thread from the pool.
+     *
+     * @param[in] prio          thread priority
+     * @return                  A reference to the created thread with
+     *                          reference counter set to one.
+     *
+     * @api
+     */
+    ThreadReference start(tprio_t prio) override {
+      void _thd_start(void *arg);
+
+      return ThreadReference(chThdCreateFromMemoryPool(&threads_pool.pool,
+                                                       C,
+                                                       prio,
+                                                       _thd_start,
+                                                       this));
+     }
+   };
+#endif /* CH_CFG_USE_MEMPOOLS == TRUE */
+
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::Heap                                                       *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Class encapsulating a heap.
+   */
+  class Heap {
+#if (CH_CPP_USE_MEMORY_RESOURCES == TRUE) || defined(__DOXYGEN__)
+    friend class HeapResource;
+#endif
+    template<class T> friend class HeapAllocator;
+
+    /**
+     * @brief   Embedded @p memory_heap_t structure.
+     */
+    memory_heap_t heap;
+
+  public:
+    /**
+     * @brief   Heap constructor.
+     * @pre     Both the heap buffer base and the heap size must be aligned to
+     *          the @p stkline_t type size.
+     *
+     * @param[in] buffer    heap buffer base
+     * @param[in] size      the size of the memory area located at \e buffer
+     * @init
+     */
+    Heap(void *buffer, const size_t size) : heap() {
+
+      chHeapObjectInit(&heap, buffer, size);
+    }
+
+    /* Prohibit copy construction and assignment, but allow move.*/
+    Heap(const Heap &) = delete;
+    Heap &operator=(const Heap &) = delete;
+    Heap(Heap &&) = default;
+    Heap &operator=(Heap &&) = default;
+
+    /**
+     * @brief   Allocates an object from a heap.
+     * @pre     The heap must be already been initialized.
+     *
+     * @return              The pointer to the allocated object.
+     * @retval nullptr      if pool is empty.
+     *
+     * @api
+     */
+    void *alloc(const size_t size) {
+
+      return chHeapAlloc(&heap, size);
+    }
+
+    /**
+     * @brief   Releases an object into the heap.
+     *
+     * @param[in] objp      the pointer to the object to be released
+     *
+     * @api
+     */
+    void free(void *objp) {
+
+      chHeapFree(objp);
+    }
+
+    /**
+     * @brief   Reports the heap status.
+     *
+     * @param[out] frag     the size of total fragmented free space
+     * @param[in] largestp  pointer to a variable that will receive the largest
+     *                      free free block found space or @p nullptr
+     * @return              the number of fragments in the heap
+     *
+     * @api
+     */
+    size_t status(size_t &frag, size_t *largestp=0) {
+
+      return chHeapStatus(&heap, &frag, largestp);
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::HeapAllocator                                              *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   STL-compatible allocator allocating from a heap.
+   * @details Allows standard containers to use the default heap or an
+   *          @p Heap object instead of the library @p operator @p new.
+   * @note    Allocators using the same heap compare equal, memory allocated
+   *          by one of them can be released by any of the others.
+   */
+  template<class T>
+  class HeapAllocator {
+    template<class U> friend class HeapAllocator;
+
+    /**
+     * @brief   Heap used for allocations, @p nullptr for the default heap.
+     */
+    memory_heap_t *heapp;
+
+  public:
+    typedef T value_type;
+
+    /**
+     * @brief   Allocator constructor using the default heap.
+     *
+     * @init
+     */
+    HeapAllocator(void) noexcept : heapp(nullptr) {
+    }
+
+    /**
+     * @brief   Allocator constructor using a @p Heap object.
+     *
+     * @param[in] h         the heap object
+     *
+     * @init
+     */
+    HeapAllocator(Heap &h) noexcept : heapp(&h.heap) {
+    }
+
+    /**
+     * @brief   Allocator constructor using a @p memory_heap_t structure.
+     *
+     * @param[in] heapp     pointer to the heap or @p nullptr for the default
+     *                      heap
+     *
+     * @init
+     */
+    explicit HeapAllocator(memory_heap_t *heapp) noexcept : heapp(heapp) {
+    }
+
+    /**
+     * @brief   Rebinding constructor.
+     *
+     * @param[in] other     allocator of another type using the same heap
+     *
+     * @init
+     */
+    template<class U>
+    HeapAllocator(const HeapAllocator<U> &other) noexcept :
+      heapp(other.heapp) {
+    }
+
+    /**
+     * @brief   Allocates an array of objects.
+     *
+     * @param[in] n         number of objects
+     * @return              The pointer to the allocated memory.
+     *
+     * @api
+     */
+    T *allocate(size_t n) {
+      void *p;
+
+      if (n > SIZE_MAX / sizeof (T)) {
+        _mem_exhausted();
+      }
+      p = chHeapAllocAligned(heapp, n > 0U ? n * sizeof (T) : 1U,
+                             (unsigned)alignof (T));
+      if (p == nullptr) {
+        _mem_exhausted();
+      }
+      return static_cast<T *>(p);
+    }
+
+    /**
+     * @brief   Releases an array of objects.
+     *
+     * @param[in] p         pointer to the memory to be released
+     * @param[in] n         number of objects, ignored
+     *
+     * @api
+     */
+    void deallocate(T *p, size_t n) noexcept {
+
+      (void)n;
+      chHeapFree(static_cast<void *>(p));
+    }
+
+    /**
+     * @brief   Allocators equality.
+     *
+     * @api
+     */
+    template<class U>
+    bool operator==(const HeapAllocator<U> &other) const noexcept {
+
+      return heapp == other.heapp;
+    }
+
+    /**
+     * @brief   Allocators inequality.
+     *
+     * @api
+     */
+    template<class U>
+    bool operator!=(const HeapAllocator<U> &other) const noexcept {
+
+      return heapp != other.heapp;
+    }
+  };
+#endif /* CH_CFG_USE_HEAP == TRUE */
+
+#if (CH_CPP_USE_MEMORY_RESOURCES == TRUE) || defined(__DOXYGEN__)
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::HeapResource                                               *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Memory resource allocating from a heap.
+   * @note    The resource is thread safe, the heap is protected by its own
+   *          mutex.
+   */
+  class HeapResource : public std::pmr::memory_resource {
+    /**
+     * @brief   Heap used for allocations, @p nullptr for the default heap.
+     */
+    memory_heap_t *heapp;
+
+  public:
+    /**
+     * @brief   HeapResource constructor.
+     *
+     * @param[in] heapp     pointer to the heap or @p nullptr for the default
+     *                      heap
+     *
+     * @init
+     */
+    explicit HeapResource(memory_heap_t *heapp = nullptr) noexcept :
+      heapp(heapp) {
+    }
+
+    /**
+     * @brief   HeapResource constructor using a @p Heap object.
+     *
+     * @param[in] h         the heap object
+     *
+     * @init
+     */
+    explicit HeapResource(Heap &h) noexcept : heapp(&h.heap) {
+    }
+
+  protected:
+    void *do_allocate(size_t bytes, size_t alignment) override {
+      void *p;
+
+      p = chHeapAllocAligned(heapp, bytes > 0U ? bytes : 1U,
+                             (unsigned)alignment);
+      if (p == nullptr) {
+        _mem_exhausted();
+      }
+      return p;
+    }
+
+    void do_deallocate(void *p, size_t bytes,
+                       size_t alignment) override {
+
+      (void)bytes;
+      (void)alignment;
+      chHeapFree(p);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other)
+      const noexcept override {
+
+      return this == &other;
+    }
+  };
+#endif /* CH_CFG_USE_HEAP == TRUE */
+
+#if (CH_CFG_USE_MEMPOOLS == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::PoolResource                                               *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Memory resource allocating from a memory pool.
+   * @details Requests fitting the pool objects size and alignment are
+   *          served by the pool, all the others are forwarded to an upstream
+   *          resource. Node-based containers like @p std::pmr::list and
+   *          @p std::pmr::map allocate nodes of a single size, a pool sized
+   *          on the node makes allocation and release constant time.
+   * @note    The choice between pool and upstream only depends on the request
+   *          size and alignment so memory is always returned to its origin,
+   *          an exhausted pool is not backed by the upstream resource.
+   * @note    The resource is thread safe if the upstream resource is.
+   */
+  class PoolResource : public std::pmr::memory_resource {
+    /**
+     * @brief   Pool used for small allocations.
+     */
+    memory_pool_t *mp;
+    /**
+     * @brief   Resource used for allocations not fitting the pool.
+     */
+    std::pmr::memory_resource *upstream;
+
+    bool fits(size_t bytes, size_t alignment) const noexcept {
+
+      return (bytes <= mp->object_size) && (alignment <= mp->align);
+    }
+
+  public:
+    /**
+     * @brief   PoolResource constructor.
+     *
+     * @param[in] mp        pointer to the memory pool
+     * @param[in] upstream  resource for requests not fitting the pool
+     *
+     * @init
+     */
+    PoolResource(memory_pool_t *mp,
+                 std::pmr::memory_resource *upstream =
+                   std::pmr::null_memory_resource()) noexcept :
+      mp(mp), upstream(upstream) {
+    }
+
+    /**
+     * @brief   PoolResource constructor using a @p MemoryPool object.
+     *
+     * @param[in] pool      the memory pool object
+     * @param[in] upstream  resource for requests not fitting the pool
+     *
+     * @init
+     */
+    PoolResource(MemoryPool &pool,
+                 std::pmr::memory_resource *upstream =
+                   std::pmr::null_memory_resource()) noexcept :
+      mp(&pool.pool), upstream(upstream) {
+    }
+
+  protected:
+    void *do_allocate(size_t bytes, size_t alignment) override {
+      void *p;
+
+      if (!fits(bytes, alignment)) {
+        return upstream->allocate(bytes, alignment);
+      }
+      p = chPoolAlloc(mp);
+      if (p == nullptr) {
+        _mem_exhausted();
+      }
+      return p;
+    }
+
+    void do_deallocate(void *p, size_t bytes,
+                       size_t alignment) override {
+
+      if (!fits(bytes, alignment)) {
+        upstream->deallocate(p, bytes, alignment);
+      }
+      else {
+        chPoolFree(mp, p);
+      }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other)
+      const noexcept override {
+
+      return this == &other;
+    }
+  };
+#endif /* CH_CFG_USE_MEMPOOLS == TRUE */
+
+#if (CH_CFG_USE_MEMCORE == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::ArenaResource                                              *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Monotonic memory resource allocating chunks from the core
+   *          allocator.
+   * @details Allocations are served by advancing a pointer inside the
+   *          current chunk, deallocation does nothing. Chunks are taken
+   *          from the bottom of the core memory and, because the core
+   *          allocator cannot release memory, are kept for reuse after
+   *          @p release().
+   * @note    The resource is not thread safe.
+   */
+  class ArenaResource : public std::pmr::memory_resource {
+    /**
+     * @brief   Header of a chunk.
+     */
+    struct chunk {
+      chunk         *next;
+      size_t   size;
+    };
+
+    /**
+     * @brief   Minimum chunk size.
+     */
+    size_t chunk_size;
+    /**
+     * @brief   Chunks list in allocation order.
+     */
+    chunk *head;
+    /**
+     * @brief   Last chunk in the list.
+     */
+    chunk *tail;
+    /**
+     * @brief   Chunk currently used for allocations or @p nullptr.
+     */
+    chunk *current;
+    /**
+     * @brief   Free space in the current chunk.
+     */
+    uint8_t *ptr, *limit;
+
+  public:
+    /**
+     * @brief   ArenaResource constructor.
+     * @note    No memory is taken from the core allocator until the first
+     *          allocation.
+     *
+     * @param[in] chunk_size    minimum size of the chunks, larger requests
+     *                          get a chunk of their own
+     *
+     * @init
+     */
+    explicit ArenaResource(size_t chunk_size =
+                             CH_CPP_ARENA_CHUNK_SIZE) noexcept :
+      chunk_size(chunk_size), head(nullptr), tail(nullptr),
+      current(nullptr), ptr(nullptr), limit(nullptr) {
+    }
+
+    /* Prohibit copy construction and assignment.*/
+    ArenaResource(const ArenaResource &) = delete;
+    ArenaResource &operator=(const ArenaResource &) = delete;
+
+    /**
+     * @brief   Releases all the allocated memory.
+     * @details The chunks are kept and reused by the following allocations.
+     * @pre     None of the memory allocated from the resource is still in
+     *          use.
+     *
+     * @api
+     */
+    void release(void) noexcept {
+
+      current = nullptr;
+      ptr     = nullptr;
+      limit   = nullptr;
+    }
+
+    /**
+     * @brief   Returns the total size of the chunks owned by the resource.
+     *
+     * @return              The size of the chunks, headers included.
+     *
+     * @api
+     */
+    size_t getCapacity(void) const noexcept;
+
+  protected:
+    void *do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void *p, size_t bytes,
+                       size_t alignment) override {
+
+      (void)p;
+      (void)bytes;
+      (void)alignment;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other)
+      const noexcept override {
+
+      return this == &other;
+    }
+  };
+#endif /* CH_CFG_USE_MEMCORE == TRUE */
+#endif /* CH_CPP_USE_MEMORY_RESOURCES == TRUE */
+
+#if (CH_CPP_USE_COROUTINES == TRUE) || defined(__DOXYGEN__)
+  class CoroutineScheduler;
+  class CoAwaiter;
+  class CoSleepAwaiter;
+  class CoYieldAwaiter;
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::CoTask                                                     *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Class encapsulating a coroutine run by a @p CoroutineScheduler.
+   * @details A function returning @p CoTask is a coroutine, calling it
+   *          creates the coroutine frame in a suspended state, the returned
+   *          object is then passed to @p CoroutineScheduler::spawn().
+   * @note    Frames are allocated from the pool set using
+   *          @p setFramesPool() if they fit its objects, from the default
+   *          heap otherwise.
+   */
+  class CoTask {
+  public:
+    /**
+     * @brief   Coroutine promise.
+     */
+    struct promise_type {
+      /**
+       * @brief   Scheduler running the coroutine.
+       */
+      CoroutineScheduler  *sched = nullptr;
+      /**
+       * @brief   Next coroutine in the scheduler lists.
+       */
+      promise_type        *next = nullptr;
+      /**
+       * @brief   Awaiter the coroutine is suspended on or @p nullptr.
+       */
+      CoAwaiter           *waiter = nullptr;
+      /**
+       * @brief   Time of the suspension.
+       */
+      systime_t           start = (systime_t)0;
+
+      CoTask get_return_object(void) noexcept {
+
+        return CoTask(std::coroutine_handle<promise_type>::from_promise(*this));
+      }
+
+      std::suspend_always initial_suspend(void) const noexcept {
+
+        return {};
+      }
+
+      std::suspend_always final_suspend(void) const noexcept {
+
+        return {};
+      }
+
+      void return_void(void) const noexcept {
+      }
+
+      void unhandled_exception(void) const noexcept {
+
+        chSysHalt("coroutine exception");
+      }
+
+      static CoTask get_return_object_on_allocation_failure(void) noexcept {
+
+        return CoTask(nullptr);
+      }
+
+      static void *operator new(size_t size) noexcept;
+      static void operator delete(void *p, size_t size) noexcept;
+    };
+
+    /**
+     * @brief   Type of the coroutine handle.
+     */
+    typedef std::coroutine_handle<promise_type> handle_type;
+
+  private:
+    friend class CoroutineScheduler;
+
+    /**
+     * @brief   Coroutine handle, @p nullptr if the frame allocation failed
+     *          or the coroutine has been spawned.
+     */
+    handle_type handle;
+
+    explicit CoTask(handle_type h) noexcept : handle(h) {
+    }
+
+    explicit CoTask(std::nullptr_t) noexcept : handle(nullptr) {
+    }
+
+  public:
+    /* Prohibit copy construction and assignment, but allow move
+       construction.*/
+    CoTask(const CoTask &) = delete;
+    CoTask &operator=(const CoTask &) = delete;
+    CoTask &operator=(CoTask &&) = delete;
+    CoTask(CoTask &&other) noexcept : handle(other.handle) {
+
+      other.handle = nullptr;
+    }
+
+    /**
+     * @brief   CoTask destructor.
+     * @details A coroutine never spawned is destroyed with its frame.
+     */
+    ~CoTask() {
+
+      if (handle) {
+        handle.destroy();
+      }
+    }
+
+    /**
+     * @brief   Reports if the coroutine frame has been allocated.
+     *
+     * @return              The coroutine state.
+     * @retval false        if the frame allocation failed.
+     *
+     * @api
+     */
+    bool isValid(void) const noexcept {
+
+      return (bool)handle;
+    }
+
+#if (CH_CFG_USE_MEMPOOLS == TRUE) || defined(__DOXYGEN__)
+    /**
+     * @brief   Sets the pool used for the coroutines frames.
+     * @pre     No coroutine frames are allocated.
+     * @note    A frame is allocated from the pool if it fits the pool
+     *          objects, see @p getMaxFrameSize() for sizing the objects.
+     *
+     * @param[in] mp        the memory pool or @p nullptr for always using
+     *                      the heap
+     *
+     * @init
+     */
+    static void setFramesPool(MemoryPool *mp) noexcept;
+#endif
+
+    /**
+     * @brief   Returns the size of the largest frame allocated so far.
+     *
+     * @return              The frame size.
+     *
+     * @api
+     */
+    static size_t getMaxFrameSize(void) noexcept;
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::CoAwaiter                                                  *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Base class of the objects awaited by coroutines.
+   * @details The scheduler keeps the suspended coroutines in a list and
+   *          checks their awaiters each time it wakes up, an awaiter is
+   *          satisfied when @p poll() returns @p true or when its timeout
+   *          expires. The scheduler thread only wakes up on events and
+   *          timeouts, awaited objects must signal it.
+   */
+  class CoAwaiter {
+    friend class CoroutineScheduler;
+
+  protected:
+    /**
+     * @brief   Wait timeout.
+     */
+    sysinterval_t   timeout;
+    /**
+     * @brief   Wait result.
+     */
+    msg_t           result;
+
+    CoAwaiter(sysinterval_t timeout) noexcept :
+      timeout(timeout), result(MSG_OK) {
+    }
+
+    /**
+     * @brief   Checks the awaited condition.
+     *
+     * @param[in] sched     the scheduler
+     * @return              The condition state.
+     * @retval true         if the coroutine can be resumed.
+     */
+    virtual bool poll(CoroutineScheduler &sched) noexcept = 0;
+
+  public:
+    void await_suspend(CoTask::handle_type h) noexcept;
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::CoroutineScheduler                                         *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Scheduler running coroutines in a single thread.
+   * @details Coroutines run in the thread invoking @p run() until they
+   *          suspend on a @p co_await expression, all the coroutines share
+   *          the thread stack. The thread sleeps when no coroutine can run
+   *          and is awakened by the awaited objects, timeouts or
+   *          @p wakeupI().
+   * @note    The events of the thread running the scheduler are reserved
+   *          to the scheduler.
+   * @note    Coroutines waiting on a semaphore or mailbox have lower
+   *          priority than threads waiting on the same object.
+   * @note    Semaphores and mailboxes wake up the scheduler when signaled
+   *          using the wrapper classes methods, code using the underlying
+   *          C objects directly must call @p wakeup() or @p wakeupI().
+   */
+  class CoroutineScheduler {
+    friend class CoAwaiter;
+    friend class CoSourceAwaiter;
+
+    /**
+     * @brief   Thread running the scheduler or @p nullptr.
+     */
+    thread_t                    *owner;
+    /**
+     * @brief   Coroutines ready to run.
+     */
+    CoTask::promise_type        *ready_head, *ready_tail;
+    /**
+     * @brief   Suspended coroutines.
+     */
+    CoTask::promise_type        *waiting, *waiting_tail;
+    /**
+     * @brief   Number of spawned coroutines not yet terminated.
+     */
+    unsigned                    tasks;
+    /**
+     * @brief   Events not yet assigned to awaiters.
+     */
+    eventmask_t                 free_events;
+    /**
+     * @brief   Events received and not yet consumed by awaiters.
+     */
+    eventmask_t                 pending_events;
+
+    void makeReady(CoTask::promise_type *pp) noexcept;
+    void suspend(CoTask::promise_type *pp, CoAwaiter *awp) noexcept;
+    sysinterval_t pollWaiting(void) noexcept;
+    eventmask_t allocEvent(void) noexcept;
+    void freeEvent(eventmask_t event) noexcept;
+    bool takeEvent(eventmask_t event) noexcept;
+
+  public:
+    /**
+     * @brief   Event reserved to @p wakeup() and @p wakeupI().
+     */
+    static constexpr eventmask_t wakeup_event = EVENT_MASK(0);
+
+    /**
+     * @brief   CoroutineScheduler constructor.
+     *
+     * @init
+     */
+    CoroutineScheduler(void) noexcept;
+
+    /* Prohibit copy construction and assignment.*/
+    CoroutineScheduler(const CoroutineScheduler &) = delete;
+    CoroutineScheduler &operator=(const CoroutineScheduler &) = delete;
+
+    /**
+     * @brief   Adds a coroutine to the scheduler.
+     * @details The coroutine starts running when the scheduler runs.
+     * @note    Must be invoked before @p run() or from a coroutine of the
+     *          same scheduler.
+     *
+     * @param[in] task      the coroutine, ownership is transferred to the
+     *                      scheduler
+     * @return              The operation status.
+     * @retval false        if the coroutine frame allocation failed.
+     *
+     * @api
+     */
+    bool spawn(CoTask &&task) noexcept;
+
+    /**
+     * @brief   Runs the coroutines.
+     * @details The function returns when all the coroutines terminated.
+     *
+     * @api
+     */
+    void run(void) noexcept;
+
+    /**
+     * @brief   Returns the number of coroutines not yet terminated.
+     *
+     * @return              The number of coroutines.
+     *
+     * @api
+     */
+    unsigned getTasks(void) const noexcept {
+
+      return tasks;
+    }
+
+    /**
+     * @brief   Wakes up the scheduler.
+     * @details Suspended coroutines are checked again.
+     *
+     * @iclass
+     */
+    void wakeupI(void) noexcept {
+
+      if (owner != nullptr) {
+        chEvtSignalI(owner, wakeup_event);
+      }
+    }
+
+    /**
+     * @brief   Wakes up the scheduler.
+     * @details Suspended coroutines are checked again.
+     *
+     * @api
+     */
+    void wakeup(void) noexcept {
+
+      chSysLock();
+      wakeupI();
+      chSchRescheduleS();
+      chSysUnlock();
+    }
+
+    /**
+     * @brief   Suspends the invoking coroutine for the specified interval.
+     * @details The returned object is awaited using @p co_await.
+     *
+     * @param[in] interval  the sleep interval
+     * @return              The awaitable object.
+     *
+     * @api
+     */
+    static CoSleepAwaiter sleep(sysinterval_t interval) noexcept;
+
+    /**
+     * @brief   Lets the other ready coroutines run.
+     * @details The returned object is awaited using @p co_await.
+     *
+     * @return              The awaitable object.
+     *
+     * @api
+     */
+    static CoYieldAwaiter yield(void) noexcept;
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::CoSleepAwaiter                                             *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Awaiter of @p CoroutineScheduler::sleep().
+   */
+  class CoSleepAwaiter : public CoAwaiter {
+  protected:
+    bool poll(CoroutineScheduler &sched) noexcept override {
+
+      (void)sched;
+      return false;
+    }
+
+  public:
+    explicit CoSleepAwaiter(sysinterval_t interval) noexcept :
+      CoAwaiter(interval) {
+    }
+
+    bool await_ready(void) const noexcept {
+
+      return timeout == TIME_IMMEDIATE;
+    }
+
+    void await_resume(void) const noexcept {
+    }
+  };
+
+  inline CoSleepAwaiter CoroutineScheduler::sleep(sysinterval_t interval)
+    noexcept {
+
+    return CoSleepAwaiter(interval);
+  }
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::CoYieldAwaiter                                             *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Awaiter of @p CoroutineScheduler::yield().
+   */
+  class CoYieldAwaiter : public CoAwaiter {
+  protected:
+    bool poll(CoroutineScheduler &sched) noexcept override {
+
+      (void)sched;
+      return true;
+    }
+
+  public:
+    CoYieldAwaiter(void) noexcept : CoAwaiter(TIME_INFINITE) {
+    }
+
+    bool await_ready(void) const noexcept {
+
+      return false;
+    }
+
+    void await_resume(void) const noexcept {
+    }
+  };
+
+  inline CoYieldAwaiter CoroutineScheduler::yield(void) noexcept {
+
+    return CoYieldAwaiter();
+  }
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::CoSourceAwaiter                                            *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Base class of the awaiters woken up by an event source.
+   * @details The awaiter registers on the source using an event of the
+   *          scheduler thread, a broadcast on the source wakes up the
+   *          scheduler which then checks the awaiter.
+   * @note    Up to 31 coroutines of a scheduler can wait on event sources,
+   *          semaphores and mailboxes at the same time.
+   */
+  class CoSourceAwaiter : public CoAwaiter {
+    event_source_t      *esp;
+    event_listener_t    listener;
+    eventmask_t         event;
+    CoroutineScheduler  *sched;
+
+  protected:
+    CoSourceAwaiter(event_source_t *esp, sysinterval_t timeout) noexcept :
+      CoAwaiter(timeout), esp(esp), listener(), event((eventmask_t)0),
+      sched(nullptr) {
+    }
+
+    /**
+     * @brief   Consumes the event signaled by the source.
+     *
+     * @param[in] sched     the scheduler
+     * @return              The event state.
+     * @retval true         if the source has been broadcasted.
+     */
+    bool takeEvent(CoroutineScheduler &sched) noexcept {
+
+      return sched.takeEvent(event);
+    }
+
+    /**
+     * @brief   Unregisters from the source.
+     *
+     * @return              The flags broadcasted by the source, zero if
+     *                      the coroutine has not been suspended.
+     */
+    eventflags_t release(void) noexcept {
+
+      if (sched == nullptr) {
+        return (eventflags_t)0;
+      }
+      chEvtUnregister(esp, &listener);
+      sched->freeEvent(event);
+      sched = nullptr;
+      return chEvtGetAndClearFlags(&listener);
+    }
+
+  public:
+    void await_suspend(CoTask::handle_type h) noexcept {
+
+      sched = h.promise().sched;
+      event = sched->allocEvent();
+      chEvtRegisterMask(esp, &listener, event);
+      CoAwaiter::await_suspend(h);
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::CoEventAwaiter                                             *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Awaiter of an event source.
+   * @details The value of the @p co_await expression is the flags
+   *          broadcasted by the source, zero on timeout.
+   */
+  class CoEventAwaiter : public CoSourceAwaiter {
+  protected:
+    bool poll(CoroutineScheduler &sched) noexcept override {
+
+      return takeEvent(sched);
+    }
+
+  public:
+    /**
+     * @brief   CoEventAwaiter constructor.
+     *
+     * @param[in] source    the event source
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     */
+    CoEventAwaiter(EventSource &source,
+                   sysinterval_t timeout = TIME_INFINITE) noexcept :
+      CoSourceAwaiter(&source.ev_source, timeout) {
+    }
+
+    bool await_ready(void) const noexcept {
+
+      return timeout == TIME_IMMEDIATE;
+    }
+
+    eventflags_t await_resume(void) noexcept {
+
+      return release();
+    }
+  };
+
+  /**
+   * @brief   Awaits an event source with no timeout.
+   *
+   * @param[in] source      the event source
+   * @return                The awaitable object.
+   *
+   * @api
+   */
+  inline CoEventAwaiter operator co_await(EventSource &source) noexcept {
+
+    return CoEventAwaiter(source);
+  }
+
+#if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::CoSemaphoreAwaiter                                         *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Awaiter of a counter or binary semaphore.
+   * @details The value of the @p co_await expression is @p MSG_OK or
+   *          @p MSG_TIMEOUT.
+   * @note    The semaphore is also checked when the scheduler is awakened
+   *          for other reasons, signals lost to threads waiting on the
+   *          same semaphore are not an issue.
+   *
+   * @param S               semaphore class
+   */
+  template <class S>
+  class CoSemaphoreAwaiter : public CoSourceAwaiter {
+    S               &sem;
+
+  protected:
+    bool poll(CoroutineScheduler &sched) noexcept override {
+
+      (void)takeEvent(sched);
+      return sem.wait(TIME_IMMEDIATE) == MSG_OK;
+    }
+
+  public:
+    /**
+     * @brief   CoSemaphoreAwaiter constructor.
+     *
+     * @param[in] sem       the semaphore
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     */
+    CoSemaphoreAwaiter(S &sem, sysinterval_t timeout = TIME_INFINITE) noexcept :
+      CoSourceAwaiter(&sem.co_source, timeout), sem(sem) {
+    }
+
+    bool await_ready(void) noexcept {
+
+      if (sem.wait(TIME_IMMEDIATE) == MSG_OK) {
+        return true;
+      }
+      if (timeout == TIME_IMMEDIATE) {
+        result = MSG_TIMEOUT;
+        return true;
+      }
+      return false;
+    }
+
+    msg_t await_resume(void) noexcept {
+
+      (void)release();
+      return result;
+    }
+  };
+
+  /**
+   * @brief   Awaits a counter semaphore with no timeout.
+   *
+   * @param[in] sem         the semaphore
+   * @return                The awaitable object.
+   *
+   * @api
+   */
+  inline CoSemaphoreAwaiter<CounterSemaphore>
+  operator co_await(CounterSemaphore &sem) noexcept {
+
+    return CoSemaphoreAwaiter<CounterSemaphore>(sem);
+  }
+
+  /**
+   * @brief   Awaits a binary semaphore with no timeout.
+   *
+   * @param[in] sem         the semaphore
+   * @return                The awaitable object.
+   *
+   * @api
+   */
+  inline CoSemaphoreAwaiter<BinarySemaphore>
+  operator co_await(BinarySemaphore &sem) noexcept {
+
+    return CoSemaphoreAwaiter<BinarySemaphore>(sem);
+  }
+#endif /* CH_CFG_USE_SEMAPHORES == TRUE */
+
+#if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::MailboxFetchAwaiter                                        *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Awaiter of @p MailboxBase::fetch().
+   * @details The value of the @p co_await expression is the message, zero
+   *          converted to @p T if the mailbox has been reset.
+   *
+   * @param T               type of objects that mailbox able to handle
+   */
+  template <typename T>
+  class MailboxFetchAwaiter : public CoSourceAwaiter {
+    MailboxBase<T>  &mb;
+    union {
+      msg_t         raw;
+      T             msg;
+    };
+
+    bool tryFetch(void) noexcept {
+
+      result = mb.fetch(&msg, TIME_IMMEDIATE);
+      return result != MSG_TIMEOUT;
+    }
+
+  protected:
+    bool poll(CoroutineScheduler &sched) noexcept override {
+
+      (void)takeEvent(sched);
+      return tryFetch();
+    }
+
+  public:
+    explicit MailboxFetchAwaiter(MailboxBase<T> &mb) noexcept :
+      CoSourceAwaiter(&mb.co_source, TIME_INFINITE), mb(mb), raw((msg_t)0) {
+    }
+
+    bool await_ready(void) noexcept {
+
+      return tryFetch();
+    }
+
+    T await_resume(void) noexcept {
+
+      (void)release();
+      return result == MSG_OK ? msg : T();
+    }
+  };
+#endif /* CH_CFG_USE_MAILBOXES == TRUE */
+#endif /* CH_CPP_USE_COROUTINES == TRUE */
 
   /*------------------------------------------------------------------------*
    * chibios_rt::BaseSequentialStreamInterface                              *
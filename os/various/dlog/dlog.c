@@ -0,0 +1,418 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    dlog.c
+ * @brief   Deferred logger code.
+ *
+ * @addtogroup DLOG
+ * @{
+ */
+
+#include <stdarg.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "dlog.h"
+#include "chprintf.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Logger state.
+ */
+dlog_t dlog;
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static const char levels[] = "EWID";
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Ring indexes are exchanged between the producer and the consumer without
+ * locks, the producer publishes a record after filling it and the consumer
+ * frees a slot after reading it. Compilers without atomic built-ins fall
+ * back to a short critical zone.
+ */
+static inline size_t index_load(const volatile size_t *p) {
+#if defined(__GNUC__)
+
+  return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#else
+  syssts_t sts;
+  size_t idx;
+
+  sts = chSysGetStatusAndLockX();
+  idx = *p;
+  chSysRestoreStatusX(sts);
+
+  return idx;
+#endif
+}
+
+static inline void index_store(volatile size_t *p, size_t idx) {
+#if defined(__GNUC__)
+
+  __atomic_store_n(p, idx, __ATOMIC_RELEASE);
+#else
+  syssts_t sts;
+
+  sts = chSysGetStatusAndLockX();
+  *p = idx;
+  chSysRestoreStatusX(sts);
+#endif
+}
+
+static void write_frame(BaseSequentialStream *chp, uint8_t type,
+                        const void *p, size_t n) {
+  uint8_t hdr[3];
+
+  hdr[0] = (uint8_t)DLOG_FRAME_SYNC;
+  hdr[1] = type;
+  hdr[2] = (uint8_t)n;
+  (void) streamWrite(chp, hdr, sizeof hdr);
+  (void) streamWrite(chp, p, n);
+}
+
+static void emit_record(BaseSequentialStream *chp, const char *name,
+                        const dlog_record_t *recp, bool binary) {
+  dlog_arg_t a[8] = {0};
+  unsigned i;
+
+  if (binary) {
+    write_frame(chp, DLOG_FRAME_RECORD, recp, sizeof (dlog_record_t));
+    return;
+  }
+
+  for (i = 0U; i < recp->nargs; i++) {
+    a[i] = recp->args[i];
+  }
+  chprintf(chp, "%8lu %c %s: ", (unsigned long)recp->time,
+           levels[recp->level & 3U], name);
+  chprintf(chp, recp->fmt, a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+  chprintf(chp, "\r\n");
+}
+
+static void emit_drops(BaseSequentialStream *chp, dlog_ring_t *rp,
+                       bool binary) {
+  uint32_t full, rate;
+
+  full = rp->dropped_full;
+  rate = rp->dropped_rate;
+  if ((full == rp->reported_full) && (rate == rp->reported_rate)) {
+    return;
+  }
+
+  if (binary) {
+    uint32_t drops[2] = {full - rp->reported_full, rate - rp->reported_rate};
+
+    write_frame(chp, DLOG_FRAME_DROPS, drops, sizeof drops);
+  }
+  else {
+    chprintf(chp, "%8lu W %s: dropped %lu full, %lu rate limited\r\n",
+             (unsigned long)chVTGetSystemTimeX(), rp->name,
+             (unsigned long)(full - rp->reported_full),
+             (unsigned long)(rate - rp->reported_rate));
+  }
+  rp->reported_full = full;
+  rp->reported_rate = rate;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Logger initialization.
+ * @note    Records of all levels are accepted after initialization.
+ */
+void dlogInit(void) {
+
+  dlog.rings = NULL;
+  dlog.level = DLOG_LEVEL_DEBUG;
+  chMtxObjectInit(&dlog.mtx);
+}
+
+/**
+ * @brief   Initializes a @p dlog_ring_t object.
+ * @note    A ring of @p n records can hold @p n - 1 pending records.
+ *
+ * @param[out] rp       pointer to the @p dlog_ring_t object
+ * @param[in] name      ring name, printed in text records
+ * @param[in] buf       pointer to the records buffer
+ * @param[in] n         number of records in the buffer
+ */
+void dlogRingObjectInit(dlog_ring_t *rp, const char *name,
+                        dlog_record_t *buf, size_t n) {
+
+  chDbgCheck((rp != NULL) && (buf != NULL) && (n > 1U));
+
+  rp->next          = NULL;
+  rp->name          = name;
+  rp->records       = buf;
+  rp->size          = n;
+  rp->wridx         = 0U;
+  rp->rdidx         = 0U;
+  rp->period        = (sysinterval_t)0;
+  rp->burst         = 0U;
+  rp->tokens        = 0U;
+  rp->last          = (systime_t)0;
+  rp->dropped_full  = 0U;
+  rp->dropped_rate  = 0U;
+  rp->reported_full = 0U;
+  rp->reported_rate = 0U;
+}
+
+/**
+ * @brief   Sets the rate limit of a ring.
+ * @details At most @p burst records are accepted each @p period, the
+ *          exceeding records are dropped and counted.
+ * @note    Must be called by the ring producer.
+ *
+ * @param[in] rp        pointer to the @p dlog_ring_t object
+ * @param[in] period    rate limit period
+ * @param[in] burst     records allowed each period, zero disables the
+ *                      rate limiter
+ */
+void dlogRingSetRateLimit(dlog_ring_t *rp, sysinterval_t period,
+                          unsigned burst) {
+
+  chDbgCheck(rp != NULL);
+
+  rp->period = period;
+  rp->burst  = burst;
+  rp->tokens = burst;
+  rp->last   = chVTGetSystemTimeX();
+}
+
+/**
+ * @brief   Registers a ring into the logger.
+ *
+ * @param[in] rp        pointer to the @p dlog_ring_t object
+ */
+void dlogRegister(dlog_ring_t *rp) {
+
+  chDbgCheck(rp != NULL);
+
+  chMtxLock(&dlog.mtx);
+  rp->next = dlog.rings;
+  dlog.rings = rp;
+  chMtxUnlock(&dlog.mtx);
+}
+
+/**
+ * @brief   Removes a ring from the logger.
+ * @note    Pending records in the ring are discarded.
+ *
+ * @param[in] rp        pointer to the @p dlog_ring_t object
+ */
+void dlogUnregister(dlog_ring_t *rp) {
+  dlog_ring_t **rpp;
+
+  chDbgCheck(rp != NULL);
+
+  chMtxLock(&dlog.mtx);
+  for (rpp = &dlog.rings; *rpp != NULL; rpp = &(*rpp)->next) {
+    if (*rpp == rp) {
+      *rpp = rp->next;
+      break;
+    }
+  }
+  chMtxUnlock(&dlog.mtx);
+}
+
+/**
+ * @brief   Records a log entry.
+ * @details Only the format pointer, the time stamp and the raw arguments
+ *          are stored, formatting is deferred to the consumer.
+ * @note    This function is meant to be invoked through the @p DLOG()
+ *          macros.
+ * @note    This function can be called from any context as long each ring
+ *          is only used by a single thread or ISR.
+ *
+ * @param[in] rp        pointer to the @p dlog_ring_t owned by the caller
+ * @param[in] level     record level
+ * @param[in] nargs     number of arguments after @p fmt, arguments beyond
+ *                      @p DLOG_MAX_ARGS are ignored
+ * @param[in] fmt       format string, must be constant
+ * @param[in] ...       arguments, each one must be of type @p dlog_arg_t
+ * @return              The operation status.
+ * @retval true         if the record has been stored.
+ * @retval false        if the record has been discarded or dropped.
+ *
+ * @xclass
+ */
+bool dlogPostX(dlog_ring_t *rp, unsigned level, unsigned nargs,
+               const char *fmt, ...) {
+  dlog_record_t *recp;
+  size_t wridx, next;
+  systime_t now;
+  va_list ap;
+  unsigned i;
+
+  chDbgCheck((rp != NULL) && (fmt != NULL) && (nargs <= DLOG_MAX_ARGS));
+
+  /* Excess arguments are not stored, the record has no room for them.*/
+  if (nargs > DLOG_MAX_ARGS) {
+    nargs = DLOG_MAX_ARGS;
+  }
+
+  if (level > dlog.level) {
+    return false;
+  }
+
+  now = chVTGetSystemTimeX();
+
+  /* Rate limiter, the tokens are refilled at each period.*/
+  if (rp->burst > 0U) {
+    if (chTimeDiffX(rp->last, now) >= rp->period) {
+      rp->last   = now;
+      rp->tokens = rp->burst;
+    }
+    if (rp->tokens == 0U) {
+      rp->dropped_rate++;
+      return false;
+    }
+    rp->tokens--;
+  }
+
+  /* Space check, one slot is always left empty.*/
+  wridx = rp->wridx;
+  next = wridx + 1U;
+  if (next >= rp->size) {
+    next = 0U;
+  }
+  if (next == index_load(&rp->rdidx)) {
+    rp->dropped_full++;
+    return false;
+  }
+
+  recp = &rp->records[wridx];
+  recp->fmt   = fmt;
+  recp->time  = now;
+  recp->level = (uint8_t)level;
+  recp->nargs = (uint8_t)nargs;
+  va_start(ap, fmt);
+  for (i = 0U; i < nargs; i++) {
+    recp->args[i] = va_arg(ap, dlog_arg_t);
+  }
+  va_end(ap);
+
+  /* Publishing the record.*/
+  index_store(&rp->wridx, next);
+
+  return true;
+}
+
+/**
+ * @brief   Writes the pending records of a ring on a stream.
+ * @details In text mode records are formatted using @p chprintf(), in
+ *          binary mode each record is written as a frame made of
+ *          @p DLOG_FRAME_SYNC, the frame type, the payload size and the raw
+ *          payload. Binary frames are meant to be decoded on a host
+ *          resolving the format pointers against the application image.
+ * @note    Drops are reported after the pending records.
+ * @note    Only one consumer at time is allowed, use @p dlogFlush() for
+ *          registered rings.
+ *
+ * @param[in] rp        pointer to the @p dlog_ring_t object
+ * @param[in] chp       pointer to the output stream
+ * @param[in] binary    binary frames output if @p true
+ * @return              The number of records written.
+ */
+size_t dlogRingFlush(dlog_ring_t *rp, BaseSequentialStream *chp,
+                     bool binary) {
+  size_t rdidx, wridx, n = 0U;
+
+  chDbgCheck((rp != NULL) && (chp != NULL));
+
+  rdidx = rp->rdidx;
+  wridx = index_load(&rp->wridx);
+  while (rdidx != wridx) {
+    emit_record(chp, rp->name, &rp->records[rdidx], binary);
+    n++;
+
+    /* Freeing the slot.*/
+    rdidx++;
+    if (rdidx >= rp->size) {
+      rdidx = 0U;
+    }
+    index_store(&rp->rdidx, rdidx);
+  }
+
+  emit_drops(chp, rp, binary);
+
+  return n;
+}
+
+/**
+ * @brief   Writes the pending records of all registered rings on a stream.
+ *
+ * @param[in] chp       pointer to the output stream
+ * @param[in] binary    binary frames output if @p true
+ * @return              The number of records written.
+ */
+size_t dlogFlush(BaseSequentialStream *chp, bool binary) {
+  dlog_ring_t *rp;
+  size_t n = 0U;
+
+  chMtxLock(&dlog.mtx);
+  for (rp = dlog.rings; rp != NULL; rp = rp->next) {
+    n += dlogRingFlush(rp, chp, binary);
+  }
+  chMtxUnlock(&dlog.mtx);
+
+  return n;
+}
+
+/**
+ * @brief   Logger thread function.
+ * @details The thread periodically writes the pending records of all the
+ *          registered rings on the configured stream, it should be
+ *          created at low priority. Any stream can be used, including
+ *          files opened through VFS.
+ *
+ * @param[in] p         pointer to a @p DLogConfig structure
+ */
+THD_FUNCTION(dlogThread, p) {
+  const DLogConfig *cfgp = (const DLogConfig *)p;
+
+  chRegSetThreadName("dlog");
+
+  while (!chThdShouldTerminateX()) {
+    (void) dlogFlush(cfgp->stream, cfgp->binary);
+    chThdSleep(cfgp->period);
+  }
+
+  (void) dlogFlush(cfgp->stream, cfgp->binary);
+}
+
+/** @} */
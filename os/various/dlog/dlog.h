@@ -0,0 +1,284 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    dlog.h
+ * @brief   Deferred logger macros and structures.
+ *
+ * @addtogroup DLOG
+ * @{
+ */
+
+#ifndef DLOG_H
+#define DLOG_H
+
+#include "hal.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Log levels
+ * @{
+ */
+#define DLOG_LEVEL_ERROR            0U
+#define DLOG_LEVEL_WARNING          1U
+#define DLOG_LEVEL_INFO             2U
+#define DLOG_LEVEL_DEBUG            3U
+/** @} */
+
+/**
+ * @name    Binary frame types
+ * @{
+ */
+#define DLOG_FRAME_SYNC             0xD7U
+#define DLOG_FRAME_RECORD           0U
+#define DLOG_FRAME_DROPS            1U
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum number of arguments in a log record.
+ */
+#if !defined(DLOG_MAX_ARGS) || defined(__DOXYGEN__)
+#define DLOG_MAX_ARGS               4
+#endif
+
+/**
+ * @brief   Highest log level compiled in.
+ * @details Log calls with a level above this setting are removed at compile
+ *          time.
+ */
+#if !defined(DLOG_COMPILE_LEVEL) || defined(__DOXYGEN__)
+#define DLOG_COMPILE_LEVEL          DLOG_LEVEL_DEBUG
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (DLOG_MAX_ARGS < 1) || (DLOG_MAX_ARGS > 8)
+#error "DLOG_MAX_ARGS must be within 1 and 8"
+#endif
+
+#if !CH_CFG_USE_MUTEXES
+#error "DLOG requires CH_CFG_USE_MUTEXES"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a log record argument.
+ * @note    Arguments are stored raw, only integers and pointers to
+ *          constant strings can be logged.
+ * @note    The @p DLOG() macros convert each argument to this type, format
+ *          strings must use @p long conversions for integers, for example
+ *          @p %ld, @p %lu or @p %lX.
+ */
+typedef long dlog_arg_t;
+
+/**
+ * @brief   Type of a log record.
+ */
+typedef struct {
+  const char            *fmt;           /**< @brief Format string.          */
+  systime_t             time;           /**< @brief Record time stamp.      */
+  uint8_t               level;          /**< @brief Record level.           */
+  uint8_t               nargs;          /**< @brief Number of arguments.    */
+  dlog_arg_t            args[DLOG_MAX_ARGS]; /**< @brief Raw arguments.     */
+} dlog_record_t;
+
+/**
+ * @brief   Type of a log ring.
+ */
+typedef struct dlog_ring dlog_ring_t;
+
+/**
+ * @brief   Structure representing a log ring.
+ * @details A ring has a single producer, a thread or an ISR, and is emptied
+ *          by the logger consumer. The producer side does not use locks.
+ */
+struct dlog_ring {
+  dlog_ring_t           *next;          /**< @brief Next registered ring.   */
+  const char            *name;          /**< @brief Ring name.              */
+  dlog_record_t         *records;       /**< @brief Records buffer.         */
+  size_t                size;           /**< @brief Records in the buffer.  */
+  volatile size_t       wridx;          /**< @brief Write index, producer
+                                                    owned.                  */
+  volatile size_t       rdidx;          /**< @brief Read index, consumer
+                                                    owned.                  */
+  sysinterval_t         period;         /**< @brief Rate limit period.      */
+  unsigned              burst;          /**< @brief Records allowed each
+                                                    period, zero if rate
+                                                    limiting is disabled.   */
+  unsigned              tokens;         /**< @brief Records left in the
+                                                    current period.         */
+  systime_t             last;           /**< @brief Current period start.   */
+  volatile uint32_t     dropped_full;   /**< @brief Records dropped because
+                                                    the ring was full.      */
+  volatile uint32_t     dropped_rate;   /**< @brief Records dropped by the
+                                                    rate limiter.           */
+  uint32_t              reported_full;  /**< @brief Full drops already
+                                                    reported.               */
+  uint32_t              reported_rate;  /**< @brief Rate drops already
+                                                    reported.               */
+};
+
+/**
+ * @brief   Logger thread configuration.
+ */
+typedef struct {
+  BaseSequentialStream  *stream;        /**< @brief Output stream.          */
+  bool                  binary;         /**< @brief Binary frames output.   */
+  sysinterval_t         period;         /**< @brief Polling period.         */
+} DLogConfig;
+
+/**
+ * @brief   Type of the logger state.
+ */
+typedef struct {
+  dlog_ring_t           *rings;         /**< @brief Registered rings.       */
+  unsigned              level;          /**< @brief Runtime log level.      */
+  mutex_t               mtx;            /**< @brief Consumer side mutex.    */
+} dlog_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of arguments after the format string.
+ * @note    Up to 8 arguments are supported.
+ */
+#define __DLOG_NARGS(...)                                                   \
+  __DLOG_NARGS_(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define __DLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+
+/**
+ * @brief   Format string followed by the arguments converted to
+ *          @p dlog_arg_t.
+ * @note    Up to 8 arguments are supported.
+ */
+#define __DLOG_ARGS(...)                                                    \
+  __DLOG_CAT(__DLOG_ARGS_, __DLOG_NARGS(__VA_ARGS__))(__VA_ARGS__)
+#define __DLOG_CAT(a, b)            __DLOG_CAT_(a, b)
+#define __DLOG_CAT_(a, b)           a##b
+#define __DLOG_A(x)                 ((dlog_arg_t)(x))
+#define __DLOG_ARGS_0(f)            f
+#define __DLOG_ARGS_1(f, a)                                                 \
+  f, __DLOG_A(a)
+#define __DLOG_ARGS_2(f, a, b)                                              \
+  __DLOG_ARGS_1(f, a), __DLOG_A(b)
+#define __DLOG_ARGS_3(f, a, b, c)                                           \
+  __DLOG_ARGS_2(f, a, b), __DLOG_A(c)
+#define __DLOG_ARGS_4(f, a, b, c, d)                                        \
+  __DLOG_ARGS_3(f, a, b, c), __DLOG_A(d)
+#define __DLOG_ARGS_5(f, a, b, c, d, e)                                     \
+  __DLOG_ARGS_4(f, a, b, c, d), __DLOG_A(e)
+#define __DLOG_ARGS_6(f, a, b, c, d, e, g)                                  \
+  __DLOG_ARGS_5(f, a, b, c, d, e), __DLOG_A(g)
+#define __DLOG_ARGS_7(f, a, b, c, d, e, g, h)                               \
+  __DLOG_ARGS_6(f, a, b, c, d, e, g), __DLOG_A(h)
+#define __DLOG_ARGS_8(f, a, b, c, d, e, g, h, i)                            \
+  __DLOG_ARGS_7(f, a, b, c, d, e, g, h), __DLOG_A(i)
+
+/**
+ * @brief   Compile-time check on the number of arguments.
+ * @details Fails to compile with a negative array size if more than
+ *          @p DLOG_MAX_ARGS arguments are passed.
+ */
+#define __DLOG_CHECK_NARGS(n)                                               \
+  (void)sizeof (char[((n) <= DLOG_MAX_ARGS) ? 1 : -1])
+
+/**
+ * @brief   Records a log entry.
+ * @note    The format string and any string argument must stay valid until
+ *          the record is consumed, use constant strings only.
+ *
+ * @param[in] rp        pointer to the @p dlog_ring_t owned by the caller
+ * @param[in] level     record level
+ * @param[in] ...       format string followed by at most
+ *                      @p DLOG_MAX_ARGS arguments
+ */
+#define DLOG(rp, level, ...) do {                                           \
+  __DLOG_CHECK_NARGS(__DLOG_NARGS(__VA_ARGS__));                            \
+  if ((level) <= DLOG_COMPILE_LEVEL) {                                      \
+    (void) dlogPostX(rp, level, (unsigned)__DLOG_NARGS(__VA_ARGS__),        \
+                     __DLOG_ARGS(__VA_ARGS__));                             \
+  }                                                                         \
+} while (false)
+
+/**
+ * @name    Log levels shortcuts
+ * @{
+ */
+#define DLOG_ERROR(rp, ...)         DLOG(rp, DLOG_LEVEL_ERROR, __VA_ARGS__)
+#define DLOG_WARNING(rp, ...)       DLOG(rp, DLOG_LEVEL_WARNING, __VA_ARGS__)
+#define DLOG_INFO(rp, ...)          DLOG(rp, DLOG_LEVEL_INFO, __VA_ARGS__)
+#define DLOG_DEBUG(rp, ...)         DLOG(rp, DLOG_LEVEL_DEBUG, __VA_ARGS__)
+/** @} */
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern dlog_t dlog;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void dlogInit(void);
+  void dlogRingObjectInit(dlog_ring_t *rp, const char *name,
+                          dlog_record_t *buf, size_t n);
+  void dlogRingSetRateLimit(dlog_ring_t *rp, sysinterval_t period,
+                            unsigned burst);
+  void dlogRegister(dlog_ring_t *rp);
+  void dlogUnregister(dlog_ring_t *rp);
+  bool dlogPostX(dlog_ring_t *rp, unsigned level, unsigned nargs,
+                 const char *fmt, ...);
+  size_t dlogRingFlush(dlog_ring_t *rp, BaseSequentialStream *chp,
+                       bool binary);
+  size_t dlogFlush(BaseSequentialStream *chp, bool binary);
+  THD_FUNCTION(dlogThread, p);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Sets the runtime log level.
+ * @details Records with a level above the specified one are discarded by
+ *          @p dlogPostX() without being counted as dropped.
+ *
+ * @param[in] level     the new log level
+ */
+static inline void dlogSetLevel(unsigned level) {
+
+  dlog.level = level;
+}
+
+#endif /* DLOG_H */
+
+/** @} */
@@ -1,10 +1,12 @@
 # FATFS files.
 FATFSSRC = $(CHIBIOS)/os/various/fatfs_bindings/fatfs_diskio.c \
+           $(CHIBIOS)/os/various/fatfs_bindings/fatfs_cache.c \
            $(CHIBIOS)/os/various/fatfs_bindings/fatfs_syscall.c \
            $(CHIBIOS)/ext/fatfs/source/ff.c \
            $(CHIBIOS)/ext/fatfs/source/ffunicode.c
 
-FATFSINC = $(CHIBIOS)/ext/fatfs/source
+FATFSINC = $(CHIBIOS)/os/various/fatfs_bindings \
+           $(CHIBIOS)/ext/fatfs/source
 
 # Shared variables
 ALLCSRC += $(FATFSSRC)
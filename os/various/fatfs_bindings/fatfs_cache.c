@@ -0,0 +1,798 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    fatfs_cache.c
+ * @brief   FatFS sectors cache code.
+ * @details Write-back sectors cache for the FatFS disk I/O binding, built
+ *          on the OSLIB objects cache. Single sector transfers, which are
+ *          FatFS metadata and its sector window, are served from the
+ *          cache while large multi-sector transfers go to the device.
+ *          Dirty sectors are written back on eviction or on sync, on sync
+ *          adjacent dirty sectors are coalesced into multi-sector writes.
+ *          The FAT region is detected from the volume boot sector and its
+ *          sectors are pinned in the cache up to a configured limit.
+ * @note    Calls are assumed to be serialized by FatFS, this is the case
+ *          with a single volume on the drive.
+ *
+ * @addtogroup FATFS_CACHE
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "fatfs_cache.h"
+
+#if (FATFS_HAL_USE_CACHE == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a cached sector.
+ */
+typedef struct {
+  /**
+   * @brief   Cached object header.
+   */
+  oc_object_t           obj;
+  /**
+   * @brief   Sector data.
+   */
+  uint8_t               data[FF_MAX_SS];
+} fatfs_cache_sector_t;
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Sectors cache state.
+ */
+static struct {
+  /**
+   * @brief   Cached block device or @p NULL if not initialized.
+   */
+  BaseBlockDevice       *bdp;
+  /**
+   * @brief   Sector size.
+   */
+  uint32_t              ss;
+  /**
+   * @brief   Cache disabled at run time.
+   */
+  bool                  disabled;
+  /**
+   * @brief   Write back error to be reported on the next sync.
+   */
+  bool                  error;
+  /**
+   * @brief   First sector of the pinnable region.
+   */
+  uint32_t              pin_start;
+  /**
+   * @brief   First sector after the pinnable region.
+   */
+  uint32_t              pin_end;
+  /**
+   * @brief   Number of pinned sectors.
+   */
+  unsigned              pin_n;
+#if (FATFS_HAL_CACHE_PINNED > 0U) || defined(__DOXYGEN__)
+  /**
+   * @brief   Pinned sectors, these are permanently owned by the cache.
+   */
+  fatfs_cache_sector_t  *pinned[FATFS_HAL_CACHE_PINNED];
+#endif
+  /**
+   * @brief   Objects cache.
+   */
+  objects_cache_t       cache;
+  /**
+   * @brief   Hash table.
+   */
+  oc_hash_element_t     hash[FATFS_HAL_CACHE_HASH_SIZE];
+  /**
+   * @brief   Cached sectors.
+   */
+  fatfs_cache_sector_t  sectors[FATFS_HAL_CACHE_SECTORS];
+#if (FATFS_HAL_CACHE_COALESCE > 1U) || defined(__DOXYGEN__)
+  /**
+   * @brief   Sync coalescing buffer.
+   */
+  uint8_t               buffer[FATFS_HAL_CACHE_COALESCE * FF_MAX_SS];
+#endif
+  /**
+   * @brief   Statistics.
+   */
+  fatfs_cache_stats_t   stats;
+} fc;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Loads a little endian 16 bits value.
+ *
+ * @notapi
+ */
+static uint32_t ld_word(const uint8_t *p) {
+
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+/**
+ * @brief   Loads a little endian 32 bits value.
+ *
+ * @notapi
+ */
+static uint32_t ld_dword(const uint8_t *p) {
+
+  return ld_word(p) | (ld_word(p + 2) << 16);
+}
+
+/**
+ * @brief   Checks if a cached sector needs to be written back.
+ *
+ * @notapi
+ */
+static bool sector_is_dirty(const fatfs_cache_sector_t *csp) {
+
+  return (csp->obj.obj_flags & OC_FLAG_LAZYWRITE) != 0U;
+}
+
+/**
+ * @brief   Object read function.
+ *
+ * @notapi
+ */
+static bool sector_read(objects_cache_t *ocp, oc_object_t *objp, bool async) {
+  fatfs_cache_sector_t *csp = (fatfs_cache_sector_t *)objp;
+  bool err;
+
+  err = blkRead(fc.bdp, objp->obj_key, csp->data, 1U);
+  if (!err) {
+    objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+  }
+  if (async) {
+    chCacheReleaseObject(ocp, objp);
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Object write function.
+ * @note    The asynchronous case is the write back of an evicted dirty
+ *          sector, the write is performed synchronously anyway. If it
+ *          fails the sector is dropped and the error is reported on the
+ *          next sync.
+ *
+ * @notapi
+ */
+static bool sector_write(objects_cache_t *ocp, oc_object_t *objp,
+                         bool async) {
+  fatfs_cache_sector_t *csp = (fatfs_cache_sector_t *)objp;
+  bool err;
+
+  err = blkWrite(fc.bdp, objp->obj_key, csp->data, 1U);
+  if (err) {
+    fc.error = true;
+  }
+  if (async) {
+    fc.stats.evictions++;
+    if (err) {
+      objp->obj_flags |= OC_FLAG_NOTSYNC;
+    }
+    chCacheReleaseObject(ocp, objp);
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Returns a cached sector without acquiring it.
+ * @note    This function does not allocate sectors, a missing sector is
+ *          not loaded.
+ *
+ * @param[in] sector    sector number
+ * @return              The cached sector.
+ * @retval NULL         if the sector is not in cache.
+ *
+ * @notapi
+ */
+static fatfs_cache_sector_t *sector_lookup(uint32_t sector) {
+  unsigned i;
+
+  for (i = 0U; i < FATFS_HAL_CACHE_SECTORS; i++) {
+    fatfs_cache_sector_t *csp = &fc.sectors[i];
+
+    if (((csp->obj.obj_flags & OC_FLAG_INHASH) != 0U) &&
+        (csp->obj.obj_owner == (void *)fc.bdp) &&
+        (csp->obj.obj_key == sector)) {
+      return csp;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Returns the lowest numbered dirty sector not below @p sector.
+ *
+ * @param[in] sector    first sector to be considered
+ * @return              The dirty sector.
+ * @retval NULL         if there are no dirty sectors.
+ *
+ * @notapi
+ */
+static fatfs_cache_sector_t *sector_next_dirty(uint32_t sector) {
+  fatfs_cache_sector_t *found = NULL;
+  unsigned i;
+
+  for (i = 0U; i < FATFS_HAL_CACHE_SECTORS; i++) {
+    fatfs_cache_sector_t *csp = &fc.sectors[i];
+
+    if (((csp->obj.obj_flags & OC_FLAG_INHASH) != 0U) &&
+        sector_is_dirty(csp) &&
+        (csp->obj.obj_owner == (void *)fc.bdp) &&
+        (csp->obj.obj_key >= sector) &&
+        ((found == NULL) || (csp->obj.obj_key < found->obj.obj_key))) {
+      found = csp;
+    }
+  }
+
+  return found;
+}
+
+/**
+ * @brief   Returns the pinned sector slot, if pinned.
+ *
+ * @notapi
+ */
+static int sector_pin_index(const fatfs_cache_sector_t *csp) {
+#if FATFS_HAL_CACHE_PINNED > 0U
+  unsigned i;
+
+  for (i = 0U; i < fc.pin_n; i++) {
+    if (fc.pinned[i] == csp) {
+      return (int)i;
+    }
+  }
+#else
+  (void)csp;
+#endif
+
+  return -1;
+}
+
+/**
+ * @brief   Acquires a sector.
+ * @note    Pinned sectors are already owned and are returned directly.
+ *
+ * @param[in] sector    sector number
+ * @return              The cached sector, if the sector was not in cache
+ *                      then it is marked as @p OC_FLAG_NOTSYNC.
+ *
+ * @notapi
+ */
+static fatfs_cache_sector_t *sector_get(uint32_t sector) {
+#if FATFS_HAL_CACHE_PINNED > 0U
+  unsigned i;
+
+  for (i = 0U; i < fc.pin_n; i++) {
+    if (fc.pinned[i]->obj.obj_key == sector) {
+      return fc.pinned[i];
+    }
+  }
+#endif
+
+  return (fatfs_cache_sector_t *)chCacheGetObject(&fc.cache,
+                                                  (void *)fc.bdp, sector);
+}
+
+/**
+ * @brief   Releases a sector.
+ * @note    Valid sectors within the FAT region are pinned while there are
+ *          free pinning slots.
+ *
+ * @param[in] csp       the cached sector
+ *
+ * @notapi
+ */
+static void sector_release(fatfs_cache_sector_t *csp) {
+
+  if (sector_pin_index(csp) >= 0) {
+    return;
+  }
+
+#if FATFS_HAL_CACHE_PINNED > 0U
+  if (((csp->obj.obj_flags & OC_FLAG_NOTSYNC) == 0U) &&
+      (fc.pin_n < FATFS_HAL_CACHE_PINNED) &&
+      (csp->obj.obj_key >= fc.pin_start) &&
+      (csp->obj.obj_key < fc.pin_end)) {
+    fc.pinned[fc.pin_n++] = csp;
+    return;
+  }
+#endif
+
+  chCacheReleaseObject(&fc.cache, &csp->obj);
+}
+
+/**
+ * @brief   Unpins all the pinned sectors, dirty sectors stay dirty.
+ *
+ * @notapi
+ */
+static void sectors_unpin(void) {
+
+  while (fc.pin_n > 0U) {
+    fc.pin_n--;
+#if FATFS_HAL_CACHE_PINNED > 0U
+    chCacheReleaseObject(&fc.cache, &fc.pinned[fc.pin_n]->obj);
+#endif
+  }
+}
+
+/**
+ * @brief   Drops a sector from the cache.
+ *
+ * @param[in] csp       the acquired cached sector
+ *
+ * @notapi
+ */
+static void sector_drop(fatfs_cache_sector_t *csp) {
+  int i = sector_pin_index(csp);
+
+#if FATFS_HAL_CACHE_PINNED > 0U
+  if (i >= 0) {
+    fc.pin_n--;
+    fc.pinned[i] = fc.pinned[fc.pin_n];
+  }
+#else
+  (void)i;
+#endif
+
+  csp->obj.obj_flags &= ~OC_FLAG_LAZYWRITE;
+  csp->obj.obj_flags |= OC_FLAG_NOTSYNC;
+  chCacheReleaseObject(&fc.cache, &csp->obj);
+}
+
+/**
+ * @brief   Detects the FAT region from a volume boot sector.
+ * @details Both FAT and exFAT boot sectors are recognized, for FAT12 and
+ *          FAT16 volumes the root directory is part of the region.
+ *
+ * @param[in] sector    sector number
+ * @param[in] p         sector data
+ *
+ * @notapi
+ */
+static void check_boot_sector(uint32_t sector, const uint8_t *p) {
+  uint32_t start, n;
+
+  if ((p[510] != 0x55U) || (p[511] != 0xAAU)) {
+    return;
+  }
+
+  if (memcmp(&p[3], "EXFAT   ", 8) == 0) {
+    start = ld_dword(&p[80]);
+    n     = ld_dword(&p[84]) * (uint32_t)p[110];
+  }
+  else if (((p[0] == 0xEBU) || (p[0] == 0xE9U) || (p[0] == 0xE8U)) &&
+           (ld_word(&p[11]) == fc.ss) &&
+           (ld_word(&p[14]) != 0U) &&
+           ((p[16] == 1U) || (p[16] == 2U))) {
+    n = ld_word(&p[22]);
+    if (n == 0U) {
+      n = ld_dword(&p[36]);
+    }
+    start = ld_word(&p[14]);
+    n     = (n * (uint32_t)p[16]) +
+            (((ld_word(&p[17]) * 32U) + fc.ss - 1U) / fc.ss);
+  }
+  else {
+    return;
+  }
+
+  if ((fc.pin_start != sector + start) || (fc.pin_end != sector + start + n)) {
+    sectors_unpin();
+    fc.pin_start = sector + start;
+    fc.pin_end   = sector + start + n;
+  }
+}
+
+/**
+ * @brief   Reads a multi-sector transfer directly from the device.
+ * @note    Dirty cached copies are newer than the device content.
+ *
+ * @notapi
+ */
+static bool bypass_read(uint8_t *buf, uint32_t sector, uint32_t n) {
+  unsigned i;
+
+  if (blkRead(fc.bdp, sector, buf, n)) {
+    return HAL_FAILED;
+  }
+
+  fc.stats.bypassed += n;
+  for (i = 0U; i < FATFS_HAL_CACHE_SECTORS; i++) {
+    fatfs_cache_sector_t *csp = &fc.sectors[i];
+    uint32_t key = csp->obj.obj_key;
+
+    if (((csp->obj.obj_flags & OC_FLAG_INHASH) != 0U) &&
+        sector_is_dirty(csp) &&
+        (csp->obj.obj_owner == (void *)fc.bdp) &&
+        (key >= sector) && (key - sector < n)) {
+      memcpy(buf + ((key - sector) * fc.ss), csp->data, fc.ss);
+    }
+  }
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Writes a multi-sector transfer directly to the device.
+ * @note    Cached copies are updated and become clean.
+ *
+ * @notapi
+ */
+static bool bypass_write(const uint8_t *buf, uint32_t sector, uint32_t n) {
+  uint32_t i;
+
+  if (blkWrite(fc.bdp, sector, buf, n)) {
+    return HAL_FAILED;
+  }
+
+  fc.stats.bypassed += n;
+  for (i = 0U; i < n; i++) {
+    fatfs_cache_sector_t *csp = sector_lookup(sector + i);
+
+    if (csp != NULL) {
+      csp = sector_get(sector + i);
+      memcpy(csp->data, buf + (i * fc.ss), fc.ss);
+      csp->obj.obj_flags &= ~(OC_FLAG_NOTSYNC | OC_FLAG_LAZYWRITE);
+      sector_release(csp);
+    }
+  }
+
+  return HAL_SUCCESS;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes the sectors cache for a block device.
+ * @note    Any cached content is dropped including dirty sectors, this
+ *          function is invoked by @p disk_initialize() on mount so files
+ *          must be synchronized before a volume is mounted again.
+ *
+ * @param[in] bdp       pointer to the @p BaseBlockDevice object
+ *
+ * @api
+ */
+void fatfsCacheInit(BaseBlockDevice *bdp) {
+  BlockDeviceInfo bdi;
+
+  chDbgCheck(bdp != NULL);
+
+  fc.bdp       = bdp;
+  fc.error     = false;
+  fc.pin_n     = 0U;
+  fc.pin_start = 0U;
+  fc.pin_end   = 0U;
+
+  /* The cache is bypassed if the sector size cannot be handled.*/
+  fc.ss = 0U;
+  if ((blkGetInfo(bdp, &bdi) == HAL_SUCCESS) &&
+      (bdi.blk_size > 0U) && (bdi.blk_size <= FF_MAX_SS)) {
+    fc.ss = bdi.blk_size;
+  }
+
+  chCacheObjectInit(&fc.cache,
+                    (ucnt_t)FATFS_HAL_CACHE_HASH_SIZE, fc.hash,
+                    (ucnt_t)FATFS_HAL_CACHE_SECTORS,
+                    sizeof (fatfs_cache_sector_t), fc.sectors,
+                    sector_read, sector_write);
+}
+
+/**
+ * @brief   Enables or disables the cache at run time.
+ * @note    Disabling the cache writes back all dirty sectors then drops
+ *          the cache content, transfers then go directly to the device.
+ *
+ * @param[in] enabled   the new cache state
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the operation succeeded.
+ * @retval HAL_FAILED   if the write back failed.
+ *
+ * @api
+ */
+bool fatfsCacheSetEnabled(bool enabled) {
+  bool err = HAL_SUCCESS;
+
+  if (!enabled && !fc.disabled && (fc.bdp != NULL)) {
+    err = fatfsCacheSync();
+    fatfsCacheInit(fc.bdp);
+  }
+  fc.disabled = !enabled;
+
+  return err;
+}
+
+/**
+ * @brief   Reads sectors through the cache.
+ *
+ * @param[out] buf      pointer to the read buffer
+ * @param[in] sector    first sector
+ * @param[in] n         number of sectors
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the operation succeeded.
+ * @retval HAL_FAILED   if the operation failed.
+ *
+ * @api
+ */
+bool fatfsCacheRead(uint8_t *buf, uint32_t sector, uint32_t n) {
+  fatfs_cache_sector_t *run[FATFS_HAL_CACHE_BYPASS - 1U];
+  bool err = HAL_SUCCESS;
+  uint32_t i, j;
+
+  chDbgCheck((fc.bdp != NULL) && (buf != NULL) && (n > 0U));
+
+  if (fc.disabled || (fc.ss == 0U)) {
+    return blkRead(fc.bdp, sector, buf, n);
+  }
+
+  fc.stats.reads += n;
+  if (n >= FATFS_HAL_CACHE_BYPASS) {
+    return bypass_read(buf, sector, n);
+  }
+
+  /* Acquiring all the sectors, cached sectors are copied right away.*/
+  for (i = 0U; i < n; i++) {
+    run[i] = sector_get(sector + i);
+    if ((run[i]->obj.obj_flags & OC_FLAG_NOTSYNC) == 0U) {
+      fc.stats.read_hits++;
+      memcpy(buf + (i * fc.ss), run[i]->data, fc.ss);
+    }
+  }
+
+  /* Missing sectors are read with a single transfer for each run of
+     adjacent sectors then copied in the cache.*/
+  i = 0U;
+  while ((i < n) && !err) {
+    if ((run[i]->obj.obj_flags & OC_FLAG_NOTSYNC) == 0U) {
+      i++;
+      continue;
+    }
+    j = i + 1U;
+    while ((j < n) && ((run[j]->obj.obj_flags & OC_FLAG_NOTSYNC) != 0U)) {
+      j++;
+    }
+    err = blkRead(fc.bdp, sector + i, buf + (i * fc.ss), j - i);
+    while (!err && (i < j)) {
+      memcpy(run[i]->data, buf + (i * fc.ss), fc.ss);
+      run[i]->obj.obj_flags &= ~OC_FLAG_NOTSYNC;
+      i++;
+    }
+  }
+
+  /* Sectors still marked as OC_FLAG_NOTSYNC are dropped by the release.*/
+  for (i = 0U; i < n; i++) {
+    sector_release(run[i]);
+  }
+
+  /* Checking for a boot sector after releasing, a change of the FAT
+     region unpins sectors.*/
+  for (i = 0U; !err && (i < n); i++) {
+    check_boot_sector(sector + i, buf + (i * fc.ss));
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Writes sectors through the cache.
+ * @note    Sectors written through the cache are written back to the
+ *          device on eviction or by @p fatfsCacheSync().
+ *
+ * @param[in] buf       pointer to the write buffer
+ * @param[in] sector    first sector
+ * @param[in] n         number of sectors
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the operation succeeded.
+ * @retval HAL_FAILED   if the operation failed.
+ *
+ * @api
+ */
+bool fatfsCacheWrite(const uint8_t *buf, uint32_t sector, uint32_t n) {
+  uint32_t i;
+
+  chDbgCheck((fc.bdp != NULL) && (buf != NULL) && (n > 0U));
+
+  if (fc.disabled || (fc.ss == 0U)) {
+    return blkWrite(fc.bdp, sector, buf, n);
+  }
+
+  fc.stats.writes += n;
+  if (n >= FATFS_HAL_CACHE_BYPASS) {
+    return bypass_write(buf, sector, n);
+  }
+
+  for (i = 0U; i < n; i++) {
+    fatfs_cache_sector_t *csp = sector_get(sector + i);
+
+    if ((csp->obj.obj_flags & OC_FLAG_NOTSYNC) == 0U) {
+      fc.stats.write_hits++;
+    }
+    memcpy(csp->data, buf + (i * fc.ss), fc.ss);
+    csp->obj.obj_flags &= ~OC_FLAG_NOTSYNC;
+    csp->obj.obj_flags |= OC_FLAG_LAZYWRITE;
+    sector_release(csp);
+  }
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Writes back all the dirty sectors.
+ * @details Dirty sectors are written in ascending order, runs of adjacent
+ *          sectors are written with a single device write.
+ * @note    Errors occurred while writing back evicted sectors are
+ *          reported here.
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the operation succeeded.
+ * @retval HAL_FAILED   if the operation failed.
+ *
+ * @api
+ */
+bool fatfsCacheSync(void) {
+  fatfs_cache_sector_t *run[FATFS_HAL_CACHE_COALESCE];
+  fatfs_cache_sector_t *csp;
+  uint32_t next = 0U;
+  bool err;
+
+  chDbgCheck(fc.bdp != NULL);
+
+  err = fc.error;
+  fc.error = false;
+  if (fc.disabled || (fc.ss == 0U)) {
+    return err;
+  }
+
+  while ((csp = sector_next_dirty(next)) != NULL) {
+    uint32_t start = csp->obj.obj_key;
+    const uint8_t *p;
+    unsigned i, n = 0U;
+
+    /* Collecting a run of adjacent dirty sectors.*/
+    do {
+      run[n] = sector_get(start + n);
+      n++;
+      csp = sector_lookup(start + n);
+    } while ((n < FATFS_HAL_CACHE_COALESCE) &&
+             (csp != NULL) && sector_is_dirty(csp));
+
+#if FATFS_HAL_CACHE_COALESCE > 1U
+    if (n > 1U) {
+      for (i = 0U; i < n; i++) {
+        memcpy(&fc.buffer[i * fc.ss], run[i]->data, fc.ss);
+      }
+      p = fc.buffer;
+    }
+    else
+#endif
+    {
+      p = run[0]->data;
+    }
+
+    /* On failure the sectors are left dirty.*/
+    if (blkWrite(fc.bdp, start, p, n)) {
+      err = HAL_FAILED;
+    }
+    else {
+      fc.stats.flushed += n;
+      for (i = 0U; i < n; i++) {
+        run[i]->obj.obj_flags &= ~OC_FLAG_LAZYWRITE;
+      }
+    }
+    fc.stats.flush_writes++;
+
+    for (i = 0U; i < n; i++) {
+      sector_release(run[i]);
+    }
+    next = start + n;
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Discards sectors.
+ * @details Cached copies are dropped without writing them back then the
+ *          device discard operation is invoked.
+ *
+ * @param[in] sector    first sector
+ * @param[in] n         number of sectors
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the operation succeeded.
+ * @retval HAL_FAILED   if the operation failed.
+ *
+ * @api
+ */
+bool fatfsCacheDiscard(uint32_t sector, uint32_t n) {
+  unsigned i;
+
+  chDbgCheck(fc.bdp != NULL);
+
+  if (!fc.disabled && (fc.ss != 0U)) {
+    for (i = 0U; i < FATFS_HAL_CACHE_SECTORS; i++) {
+      fatfs_cache_sector_t *csp = &fc.sectors[i];
+      uint32_t key = csp->obj.obj_key;
+
+      if (((csp->obj.obj_flags & OC_FLAG_INHASH) != 0U) &&
+          (csp->obj.obj_owner == (void *)fc.bdp) &&
+          (key >= sector) && (key - sector < n)) {
+        sector_drop(sector_get(key));
+      }
+    }
+  }
+
+  return blkDiscard(fc.bdp, sector, n);
+}
+
+/**
+ * @brief   Returns the cache statistics.
+ *
+ * @param[out] statsp   pointer to a @p fatfs_cache_stats_t structure
+ *
+ * @api
+ */
+void fatfsCacheGetStats(fatfs_cache_stats_t *statsp) {
+
+  chDbgCheck(statsp != NULL);
+
+  *statsp = fc.stats;
+  statsp->pinned = (uint32_t)fc.pin_n;
+}
+
+/**
+ * @brief   Resets the cache statistics.
+ *
+ * @api
+ */
+void fatfsCacheResetStats(void) {
+
+  memset(&fc.stats, 0, sizeof fc.stats);
+}
+
+#endif /* FATFS_HAL_USE_CACHE == TRUE */
+
+/** @} */
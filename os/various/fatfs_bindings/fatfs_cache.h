@@ -0,0 +1,178 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    fatfs_cache.h
+ * @brief   FatFS sectors cache macros and structures.
+ *
+ * @addtogroup FATFS_CACHE
+ * @{
+ */
+
+#ifndef FATFS_CACHE_H
+#define FATFS_CACHE_H
+
+#include "hal.h"
+#include "ffconf.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Enables the write-back sectors cache in the disk I/O binding.
+ */
+#if !defined(FATFS_HAL_USE_CACHE) || defined(__DOXYGEN__)
+#define FATFS_HAL_USE_CACHE                 FALSE
+#endif
+
+/**
+ * @brief   Number of cached sectors.
+ */
+#if !defined(FATFS_HAL_CACHE_SECTORS) || defined(__DOXYGEN__)
+#define FATFS_HAL_CACHE_SECTORS             16U
+#endif
+
+/**
+ * @brief   Number of elements in the cache hash table.
+ * @note    Must be a power of two not lower than
+ *          @p FATFS_HAL_CACHE_SECTORS.
+ */
+#if !defined(FATFS_HAL_CACHE_HASH_SIZE) || defined(__DOXYGEN__)
+#define FATFS_HAL_CACHE_HASH_SIZE           32U
+#endif
+
+/**
+ * @brief   Maximum number of FAT region sectors pinned in the cache.
+ * @note    Pinned sectors are never evicted, they are still written back
+ *          on sync.
+ */
+#if !defined(FATFS_HAL_CACHE_PINNED) || defined(__DOXYGEN__)
+#define FATFS_HAL_CACHE_PINNED              4U
+#endif
+
+/**
+ * @brief   Transfers of at least this number of sectors bypass the cache.
+ * @note    FatFS uses multi-sector transfers for file data aligned to
+ *          sectors, caching it would just flush the metadata out of the
+ *          cache.
+ */
+#if !defined(FATFS_HAL_CACHE_BYPASS) || defined(__DOXYGEN__)
+#define FATFS_HAL_CACHE_BYPASS              4U
+#endif
+
+/**
+ * @brief   Maximum number of adjacent dirty sectors coalesced in a single
+ *          device write on sync.
+ * @note    A buffer of this size is allocated statically, a value of one
+ *          disables coalescing.
+ */
+#if !defined(FATFS_HAL_CACHE_COALESCE) || defined(__DOXYGEN__)
+#define FATFS_HAL_CACHE_COALESCE            8U
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (FATFS_HAL_USE_CACHE == TRUE) || defined(__DOXYGEN__)
+
+#if CH_CFG_USE_OBJ_CACHES != TRUE
+#error "FATFS_HAL_USE_CACHE requires CH_CFG_USE_OBJ_CACHES"
+#endif
+
+#if (FATFS_HAL_CACHE_HASH_SIZE & (FATFS_HAL_CACHE_HASH_SIZE - 1U)) != 0U
+#error "FATFS_HAL_CACHE_HASH_SIZE is not a power of two"
+#endif
+
+#if FATFS_HAL_CACHE_HASH_SIZE < FATFS_HAL_CACHE_SECTORS
+#error "FATFS_HAL_CACHE_HASH_SIZE lower than FATFS_HAL_CACHE_SECTORS"
+#endif
+
+#if FATFS_HAL_CACHE_BYPASS < 2U
+#error "invalid FATFS_HAL_CACHE_BYPASS value"
+#endif
+
+#if (FATFS_HAL_CACHE_PINNED + FATFS_HAL_CACHE_BYPASS) > FATFS_HAL_CACHE_SECTORS
+#error "FATFS_HAL_CACHE_SECTORS too low for pinned and transferred sectors"
+#endif
+
+#if FATFS_HAL_CACHE_COALESCE < 1U
+#error "invalid FATFS_HAL_CACHE_COALESCE value"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Sectors cache statistics.
+ */
+typedef struct {
+  uint32_t              reads;          /**< @brief Sectors read.           */
+  uint32_t              read_hits;      /**< @brief Sectors read from the
+                                                    cache.                  */
+  uint32_t              writes;         /**< @brief Sectors written.        */
+  uint32_t              write_hits;     /**< @brief Sectors written while
+                                                    already cached.         */
+  uint32_t              bypassed;       /**< @brief Sectors transferred
+                                                    bypassing the cache.    */
+  uint32_t              evictions;      /**< @brief Dirty sectors written
+                                                    back on eviction.       */
+  uint32_t              flushed;        /**< @brief Dirty sectors written
+                                                    back on sync.           */
+  uint32_t              flush_writes;   /**< @brief Device writes performed
+                                                    on sync.                */
+  uint32_t              pinned;         /**< @brief Currently pinned
+                                                    sectors.                */
+} fatfs_cache_stats_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void fatfsCacheInit(BaseBlockDevice *bdp);
+  bool fatfsCacheSetEnabled(bool enabled);
+  bool fatfsCacheRead(uint8_t *buf, uint32_t sector, uint32_t n);
+  bool fatfsCacheWrite(const uint8_t *buf, uint32_t sector, uint32_t n);
+  bool fatfsCacheSync(void);
+  bool fatfsCacheDiscard(uint32_t sector, uint32_t n);
+  void fatfsCacheGetStats(fatfs_cache_stats_t *statsp);
+  void fatfsCacheResetStats(void);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* FATFS_HAL_USE_CACHE == TRUE */
+
+#endif /* FATFS_CACHE_H */
+
+/** @} */
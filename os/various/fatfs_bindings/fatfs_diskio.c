@@ -9,6 +9,7 @@
 #include "ffconf.h"
 #include "ff.h"
 #include "diskio.h"
+#include "fatfs_cache.h"
 
 #if !defined(FATFS_HAL_DEVICE)
 #if HAL_USE_SDC
@@ -18,7 +19,9 @@
 #endif
 #endif
 
-#if HAL_USE_MMC_SPI
+#if defined(FATFS_HAL_DEVICE_TYPE)
+extern FATFS_HAL_DEVICE_TYPE FATFS_HAL_DEVICE;
+#elif HAL_USE_MMC_SPI
 extern MMCDriver FATFS_HAL_DEVICE;
 #elif HAL_USE_SDC
 extern SDCDriver FATFS_HAL_DEVICE;
@@ -51,6 +54,11 @@ DSTATUS disk_initialize (
       stat |= STA_NOINIT;
     if (blkIsWriteProtected(&FATFS_HAL_DEVICE))
       stat |= STA_PROTECT;
+#if FATFS_HAL_USE_CACHE == TRUE
+    /* The volume is being mounted, the cache content is stale.*/
+    if ((stat & STA_NOINIT) == 0U)
+      fatfsCacheInit((BaseBlockDevice *)&FATFS_HAL_DEVICE);
+#endif
     return stat;
   }
   return STA_NOINIT;
@@ -96,8 +104,13 @@ DRESULT disk_read (
   case 0:
     if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
       return RES_NOTRDY;
+#if FATFS_HAL_USE_CACHE == TRUE
+    if (fatfsCacheRead(buff, sector, count))
+      return RES_ERROR;
+#else
     if (blkRead(&FATFS_HAL_DEVICE, sector, buff, count))
       return RES_ERROR;
+#endif
     return RES_OK;
   }
   return RES_PARERR;
@@ -120,8 +133,13 @@ DRESULT disk_write (
   case 0:
     if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
       return RES_NOTRDY;
+#if FATFS_HAL_USE_CACHE == TRUE
+    if (fatfsCacheWrite(buff, sector, count))
+      return RES_ERROR;
+#else
     if (blkWrite(&FATFS_HAL_DEVICE, sector, buff, count))
       return RES_ERROR;
+#endif
     return RES_OK;
   }
   return RES_PARERR;
@@ -147,6 +165,11 @@ DRESULT disk_ioctl (
   case 0:
     switch (cmd) {
     case CTRL_SYNC:
+#if FATFS_HAL_USE_CACHE == TRUE
+      if (fatfsCacheSync()) {
+        return RES_ERROR;
+      }
+#endif
       return RES_OK;
     case GET_SECTOR_COUNT:
       if (blkGetInfo(&FATFS_HAL_DEVICE, &bdi)) {
@@ -167,8 +190,16 @@ DRESULT disk_ioctl (
       /* unsupported */
       break;
     case CTRL_TRIM:
-      /* unsupported */
-      break;
+#if FATFS_HAL_USE_CACHE == TRUE
+      if (fatfsCacheDiscard(((LBA_t *)buff)[0],
+                            (((LBA_t *)buff)[1] - ((LBA_t *)buff)[0]) + 1U)) {
+#else
+      if (blkDiscard(&FATFS_HAL_DEVICE, ((LBA_t *)buff)[0],
+                     (((LBA_t *)buff)[1] - ((LBA_t *)buff)[0]) + 1U)) {
+#endif
+        return RES_ERROR;
+      }
+      return RES_OK;
 #endif
     default:
       return RES_PARERR;
@@ -92,6 +92,20 @@ int fs_read_custom(struct fs_file *file, char *buffer, int count) {
       break;
     }
 
+    /* Trimming the transfer on sector boundaries, this way whole sectors are
+       moved by f_read() directly into the server buffer without going
+       through the file window.*/
+    if (count >= (int)FF_MIN_SS) {
+      int misalign = (int)(f_tell(fil) % (FSIZE_t)FF_MIN_SS);
+
+      if (misalign > 0) {
+        count = (int)FF_MIN_SS - misalign;
+      }
+      else {
+        count &= ~((int)FF_MIN_SS - 1);
+      }
+    }
+
     res = f_read(fil, buffer, count, &br);
     if (res != FR_OK) {
       return 0;
@@ -42,6 +42,16 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Enables the fast CRC implementation.
+ * @details The CRC is computed four bytes at time using four 256 entries
+ *          tables (4kB), when disabled a 16 entries table is used and the
+ *          CRC is computed a nibble at time.
+ */
+#if !defined(LFS_HAL_USE_FAST_CRC) || defined(__DOXYGEN__)
+#define LFS_HAL_USE_FAST_CRC                TRUE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -50,6 +60,44 @@
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Pre-erase manager object.
+ * @details The manager tracks the blocks used by LFS and erases free blocks
+ *          in background, erase requests from LFS on already erased blocks
+ *          then complete immediately.
+ * @note    The block size must be equal to the flash sector size.
+ */
+typedef struct hal_lfs_preerase {
+  /**
+   * @brief   Number of blocks.
+   */
+  lfs_size_t                blocks;
+  /**
+   * @brief   Bitmap of blocks in use.
+   */
+  uint32_t                  *used;
+  /**
+   * @brief   Bitmap of free blocks already erased.
+   */
+  uint32_t                  *erased;
+  /**
+   * @brief   Next block to be considered for erase.
+   */
+  lfs_block_t               next;
+  /**
+   * @brief   The used blocks bitmap is valid.
+   */
+  bool                      valid;
+  /**
+   * @brief   Erase requests served by pre-erased blocks.
+   */
+  uint32_t                  hits;
+  /**
+   * @brief   Erase requests that required an actual erase.
+   */
+  uint32_t                  misses;
+} hal_lfs_preerase_t;
+
 /**
  * @brief   Binding object between LFS and HAL.
  */
@@ -63,12 +111,23 @@ typedef struct hal_lfs_binding {
    * @brief   Pointer to a flash interface.
    */
   BaseFlash                 *flp;
+  /**
+   * @brief   Pointer to a pre-erase manager or @p NULL.
+   */
+  hal_lfs_preerase_t        *preerase;
 } hal_lfs_binding_t;
 
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Size of a pre-erase manager bitmap as number of words.
+ *
+ * @param[in] blocks    number of blocks in the LFS area
+ */
+#define LFS_HAL_PREERASE_MAP_SIZE(blocks)   (((blocks) + 31U) / 32U)
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -84,6 +143,11 @@ extern "C" {
   int __lfs_sync(const struct lfs_config *c);
   int __lfs_lock(const struct lfs_config *c);
   int __lfs_unlock(const struct lfs_config *c);
+  void lfsPreEraseObjectInit(hal_lfs_preerase_t *pep,
+                             uint32_t *used, uint32_t *erased,
+                             lfs_size_t blocks);
+  int lfsPreEraseScan(lfs_t *lfsp);
+  int lfsPreEraseStep(lfs_t *lfsp);
 #ifdef __cplusplus
 }
 #endif
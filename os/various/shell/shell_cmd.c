@@ -31,7 +31,6 @@
 #include "chprintf.h"
 
 #if (SHELL_CMD_FILES_ENABLED == TRUE) || defined(__DOXYGEN__)
-#include <fcntl.h>
 #include "vfs.h"
 #endif
 
@@ -161,7 +160,11 @@ static void cmd_threads(BaseSequentialStream *chp, int argc, char *argv[]) {
     shellUsage(chp, "threads");
     return;
   }
+#if !defined(__CHIBIOS_NIL__) && (CH_DBG_FILL_THREADS == TRUE)
+  chprintf(chp, "core stklimit    stack     addr refs prio     state  stkfree         name" SHELL_NEWLINE_STR);
+#else
   chprintf(chp, "core stklimit    stack     addr refs prio     state         name" SHELL_NEWLINE_STR);
+#endif
   tp = chRegFirstThread();
   do {
     core_id_t core_id;
@@ -176,6 +179,18 @@ static void cmd_threads(BaseSequentialStream *chp, int argc, char *argv[]) {
 #else
     uint32_t stklimit = 0U;
 #endif
+#if !defined(__CHIBIOS_NIL__) && (CH_DBG_FILL_THREADS == TRUE)
+    chprintf(chp, "%4lu %08lx %08lx %08lx %4lu %4lu %9s %8lu %12s" SHELL_NEWLINE_STR,
+             core_id,
+             stklimit,
+             (uint32_t)tp->ctx.sp,
+             (uint32_t)tp,
+             (uint32_t)tp->refs - 1,
+             (uint32_t)tp->hdr.pqueue.prio,
+             states[tp->state],
+             (uint32_t)chThdGetStackUnused(tp),
+             tp->name == NULL ? "" : tp->name);
+#else
     chprintf(chp, "%4lu %08lx %08lx %08lx %4lu %4lu %9s %12s" SHELL_NEWLINE_STR,
              core_id,
              stklimit,
@@ -185,6 +200,7 @@ static void cmd_threads(BaseSequentialStream *chp, int argc, char *argv[]) {
              (uint32_t)tp->hdr.pqueue.prio,
              states[tp->state],
              tp->name == NULL ? "" : tp->name);
+#endif
     tp = chRegNextThread(tp);
   } while (tp != NULL);
 }
@@ -301,40 +317,29 @@ static void cmd_tree(BaseSequentialStream *chp, int argc, char *argv[]) {
 }
 
 static void cmd_cat(BaseSequentialStream *chp, int argc, char *argv[]) {
-  char *buf = NULL;
+  vfs_file_node_c *vfnp;
+  ssize_t n;
+  msg_t ret;
 
   if (argc != 1) {
     chprintf(chp, "Usage: cat <filename>" SHELL_NEWLINE_STR);
     return;
   }
 
-  do {
-    int fd, n;
-
-    buf = (char *)chHeapAlloc(NULL, 2048);
-    if (buf == NULL) {
-      chprintf(chp, "Out of memory" SHELL_NEWLINE_STR);
-     break;
-    }
-
-    fd = open(argv[0], O_RDONLY);
-    if(fd == -1) {
-      chprintf(chp, "Cannot open file" SHELL_NEWLINE_STR);
-      break;
-    }
-
-    while ((n = read(fd, buf, sizeof (2048))) > 0) {
-      streamWrite(chp, (const uint8_t *)buf, n);
-    }
-    chprintf(chp, SHELL_NEWLINE_STR);
-
-    (void) close(fd);
+  ret = vfsOpenFile(argv[0], VO_RDONLY, &vfnp);
+  if (CH_RET_IS_ERROR(ret)) {
+    chprintf(chp, "Cannot open file" SHELL_NEWLINE_STR);
+    return;
   }
-  while (false);
 
-  if (buf != NULL) {
-    chHeapFree((void *)buf);
-  }
+  /* File data is moved to the shell stream by the file system driver, no
+     intermediate buffer is required here.*/
+  do {
+    n = vfsSpliceFile(vfnp, (sequential_stream_i *)chp, 4096U);
+  } while (n > (ssize_t)0);
+  chprintf(chp, SHELL_NEWLINE_STR);
+
+  vfsClose((vfs_node_c *)vfnp);
 }
 
 static void cmd_cd(BaseSequentialStream *chp, int argc, char *argv[]) {
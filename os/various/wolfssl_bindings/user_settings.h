@@ -80,7 +80,8 @@ int custom_rand_generate_block(unsigned char* output, unsigned int sz);
 #define NO_RC4
 
 
-/* Realloc (to use without USE_FAST_MATH) */
+/* Realloc (to use without USE_FAST_MATH), provided by the OS heap */
 
-void *chHeapRealloc (void *addr, uint32_t size);
+#include <stddef.h>
+void *chHeapRealloc(void *p, size_t size);
 #define XREALLOC(p,n,h,t) chHeapRealloc( (p) , (n) )
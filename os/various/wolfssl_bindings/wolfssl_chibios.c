@@ -58,11 +58,20 @@ sslconn *sslconn_accept(sslconn *sk)
       return NULL;
   }
   new = chHeapAlloc(NULL, sizeof(sslconn));
-  if (!new)
+  if (!new) {
+      netconn_delete(newconn);
       return NULL;
+  }
   new->conn = newconn;
   new->ctx = sk->ctx;
+  new->rx_buf = NULL;
+  new->rx_off = 0;
   new->ssl = wolfSSL_new(new->ctx);
+  if (!new->ssl) {
+      netconn_delete(newconn);
+      chHeapFree(new);
+      return NULL;
+  }
   wolfSSL_SetIOReadCtx(new->ssl, new);
   wolfSSL_SetIOWriteCtx(new->ssl, new);
 
@@ -71,8 +80,7 @@ sslconn *sslconn_accept(sslconn *sk)
     newconn->pcb.tcp->mss = 1480;
     return new;
   } else {
-    wolfSSL_free(new->ssl);
-    chHeapFree(new);
+    sslconn_close(new);
     return NULL;
   }
 }
@@ -108,6 +116,8 @@ error:
 
 void sslconn_close(sslconn *sk)
 {
+    if (sk->rx_buf)
+        netbuf_delete(sk->rx_buf);
     netconn_delete(sk->conn);
     wolfSSL_free(sk->ssl);
     chHeapFree(sk);
@@ -115,15 +125,15 @@ void sslconn_close(sslconn *sk)
 
 
 /* IO Callbacks */
-int wolfssl_send_cb(WOLFSSL* ssl, char *buf, int sz, void *ctx)
+
+/*
+ * Translates an lwIP error into a wolfSSL I/O callback error, "want" is
+ * returned when the operation would block and "other" for errors not
+ * related to the connection state.
+ */
+static int wolfssl_io_error(err_t err, int want, int other)
 {
-  sslconn *sk = (sslconn *)ctx;
-  int err;
-  (void)ssl;
-  err = netconn_write(sk->conn, buf, sz, NETCONN_COPY);
-  if (err == ERR_OK)
-    return sz;
-  else if (err == ERR_CLSD || err == ERR_ABRT || err == ERR_CONN)
+  if (err == ERR_CLSD || err == ERR_ABRT || err == ERR_CONN)
     return WOLFSSL_CBIO_ERR_CONN_CLOSE;
   else if (err == ERR_RST)
     return WOLFSSL_CBIO_ERR_CONN_RST;
@@ -131,68 +141,77 @@ int wolfssl_send_cb(WOLFSSL* ssl, char *buf, int sz, void *ctx)
     return WOLFSSL_CBIO_ERR_GENERAL;
   else if (err == ERR_TIMEOUT)
     return WOLFSSL_CBIO_ERR_TIMEOUT;
+  else if (err == ERR_WOULDBLOCK)
+    return want;
   else
-    return WOLFSSL_CBIO_ERR_WANT_WRITE;
+    return other;
 }
 
+/*
+ * The record buffer passed by wolfSSL is reused as soon as the callback
+ * returns while lwIP keeps referencing non-copied data until it is
+ * acknowledged, so the data is copied once into the TCP send buffer.
+ * Partial writes are reported to wolfSSL which retries with the remaining
+ * data.
+ */
+int wolfssl_send_cb(WOLFSSL* ssl, char *buf, int sz, void *ctx)
+{
+  sslconn *sk = (sslconn *)ctx;
+  size_t written = 0;
+  err_t err;
+  (void)ssl;
 
-#define MAX_SSL_BUF 1460
-static uint8_t ssl_recv_buffer[MAX_SSL_BUF];
-static int ssl_rb_len = 0;
-static int ssl_rb_off = 0;
+  err = netconn_write_partly(sk->conn, buf, (size_t)sz, NETCONN_COPY,
+                             &written);
+  if (err == ERR_OK || written > 0)
+    return (int)written;
+  return wolfssl_io_error(err, WOLFSSL_CBIO_ERR_WANT_WRITE,
+                          WOLFSSL_CBIO_ERR_WANT_WRITE);
+}
 
+/*
+ * Received data is copied to wolfSSL directly from the netbuf chain of the
+ * connection, fragments are consumed in place and the chain is released
+ * when exhausted. A new netbuf is only waited for when nothing is pending
+ * so a call never blocks while data is available.
+ */
 int wolfssl_recv_cb(WOLFSSL *ssl, char *buf, int sz, void *ctx)
 {
     sslconn *sk = (sslconn *)ctx;
-    struct netbuf *inbuf = NULL;
     uint8_t *net_buf;
-    uint16_t buflen;
+    uint16_t buflen, n;
+    int copied = 0;
     (void)ssl;
     err_t err;
 
-    if (ssl_rb_len > 0) {
-        if (sz > ssl_rb_len - ssl_rb_off)
-            sz = ssl_rb_len - ssl_rb_off;
-        memcpy(buf, ssl_recv_buffer + ssl_rb_off, sz);
-        ssl_rb_off += sz;
-        if (ssl_rb_off >= ssl_rb_len) {
-            ssl_rb_len = 0;
-            ssl_rb_off = 0;
+    if (!sk->rx_buf) {
+        err = netconn_recv(sk->conn, &sk->rx_buf);
+        if (err != ERR_OK) {
+            sk->rx_buf = NULL;
+            return wolfssl_io_error(err, WOLFSSL_CBIO_ERR_WANT_READ,
+                                    WOLFSSL_CBIO_ERR_CONN_CLOSE);
         }
-        return sz;
+        sk->rx_off = 0;
     }
 
-
-    err = netconn_recv(sk->conn, &inbuf);
-    if (err == ERR_OK) {
-        netbuf_data(inbuf, (void **)&net_buf, &buflen);
-        ssl_rb_len = buflen;
-        if (ssl_rb_len > MAX_SSL_BUF)
-            ssl_rb_len = MAX_SSL_BUF;
-        memcpy(ssl_recv_buffer, net_buf, ssl_rb_len);
-        ssl_rb_off = 0;
-        if (sz > ssl_rb_len)
-            sz = ssl_rb_len;
-        memcpy(buf, ssl_recv_buffer, sz);
-        ssl_rb_off += sz;
-        if (ssl_rb_off >= ssl_rb_len) {
-            ssl_rb_len = 0;
-            ssl_rb_off = 0;
+    while (copied < sz) {
+        netbuf_data(sk->rx_buf, (void **)&net_buf, &buflen);
+        n = buflen - sk->rx_off;
+        if ((int)n > sz - copied)
+            n = (uint16_t)(sz - copied);
+        memcpy(buf + copied, net_buf + sk->rx_off, n);
+        copied += n;
+        sk->rx_off += n;
+        if (sk->rx_off >= buflen) {
+            sk->rx_off = 0;
+            if (netbuf_next(sk->rx_buf) < 0) {
+                netbuf_delete(sk->rx_buf);
+                sk->rx_buf = NULL;
+                break;
+            }
         }
-        netbuf_delete(inbuf);
-        return sz;
     }
-    else if (err == ERR_CLSD || err == ERR_ABRT || err == ERR_CONN)
-        return WOLFSSL_CBIO_ERR_CONN_CLOSE;
-    else if (err == ERR_RST)
-        return WOLFSSL_CBIO_ERR_CONN_RST;
-    else if (err == ERR_MEM)
-        return WOLFSSL_CBIO_ERR_GENERAL;
-    else if (err == ERR_TIMEOUT)
-        return WOLFSSL_CBIO_ERR_TIMEOUT;
-    else
-        return 0;
-    //return WOLFSSL_CBIO_ERR_WANT_READ;
+    return copied;
 }
 
 #ifndef ST2S
@@ -216,45 +235,6 @@ uint32_t TimeNowInMilliseconds(void)
     return ST2MS(t);
 }
 
-void *chHeapRealloc (void *addr, uint32_t size)
-{
-    union heap_header *hp;
-    uint32_t prev_size, new_size;
-
-    void *ptr;
-
-    if(addr == NULL) {
-        return chHeapAlloc(NULL, size);
-    }
-
-    /* previous allocated segment is preceded by an heap_header */
-    hp = addr - sizeof(union heap_header);
-    prev_size = hp->used.size; /* size is always multiple of 8 */
-
-    /* check new size memory alignment */
-    if(size % 8 == 0) {
-        new_size = size;
-    }
-    else {
-        new_size = ((int) (size / 8)) * 8 + 8;
-    }
-
-    if(prev_size >= new_size) {
-        return addr;
-    }
-
-    ptr = chHeapAlloc(NULL, size);
-    if(ptr == NULL) {
-        return NULL;
-    }
-
-    memcpy(ptr, addr, prev_size);
-
-    chHeapFree(addr);
-
-    return ptr;
-}
-
 void *chibios_alloc(void *heap, int size)
 {
     return chHeapAlloc(heap, size);
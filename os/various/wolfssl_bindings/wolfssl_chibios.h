@@ -52,6 +52,10 @@ struct sslconn {
     WOLFSSL_CTX *ctx;
     WOLFSSL *ssl;
     struct netconn *conn;
+    /* Received netbuf chain not yet consumed by wolfSSL, NULL if none.*/
+    struct netbuf *rx_buf;
+    /* Offset of the first unconsumed byte in the current fragment.*/
+    uint16_t rx_off;
 };
 
 typedef struct sslconn sslconn;
@@ -38,6 +38,40 @@
 #define b32(x)      (b16(x) | (b16(x) >>16))
 #define np2(x)      (b32(x-1) + 1)
 
+/* On-media format identification.*/
+#define CHFS_MAGIC                  0x53464843U
+#define CHFS_VERSION                1U
+
+/* Page types, an erased page header reads as 0xFF.*/
+#define CHFS_PAGE_NODE              0x4EU
+#define CHFS_PAGE_DATA              0x44U
+#define CHFS_PAGE_DELETE            0x58U
+
+/* Node types in the nodes table.*/
+#define CHFS_NODE_FREE              0U
+#define CHFS_NODE_FILE              1U
+#define CHFS_NODE_DIR               2U
+#define CHFS_NODE_DELETED           3U
+
+#define CHFS_ROOT_NODE              0U
+#define CHFS_NO_NODE                0xFFFFU
+#define CHFS_NO_BLOCK               0xFFFFFFFFU
+#define CHFS_NO_PAGE                0xFFFFFFFFU
+#define CHFS_NO_CHUNK               0xFFFFFFFFU
+
+/* Maximum number of chunks in a file.*/
+#define CHFS_MAX_FILE_CHUNKS        0x10000U
+
+/* Blocks always kept free for the garbage collector.*/
+#define CHFS_RESERVED_BLOCKS        1U
+
+/* Free blocks below which each write performs an incremental GC step.*/
+#define CHFS_GC_LOW_BLOCKS          (CHFS_RESERVED_BLOCKS + 2U)
+
+/* Usable entries in the chunks index.*/
+#define CHFS_CHUNKS_LIMIT           (DRV_CFG_CHFS_MAX_CHUNKS -              \
+                                     (DRV_CFG_CHFS_MAX_CHUNKS / 8))
+
 /*===========================================================================*/
 /* Module local macros.                                                      */
 /*===========================================================================*/
@@ -55,6 +89,153 @@ struct vfs_chfs_driver_static_struct vfs_chfs_driver_static;
 /* Module local types.                                                       */
 /*===========================================================================*/
 
+/**
+ * @brief       Type of a block header.
+ */
+typedef struct chfs_block_header chfs_block_header_t;
+
+/**
+ * @brief       Structure representing a block header.
+ * @details     The block header is stored in the first page of each block.
+ */
+struct chfs_block_header {
+  /**
+   * @brief       Format identifier, @p CHFS_MAGIC.
+   */
+  uint32_t                  magic;
+  /**
+   * @brief       Format version.
+   */
+  uint16_t                  version;
+  /**
+   * @brief       Page size.
+   */
+  uint16_t                  page_size;
+  /**
+   * @brief       Block size.
+   */
+  uint32_t                  block_size;
+  /**
+   * @brief       Blocks in the volume.
+   */
+  uint32_t                  blocks;
+  /**
+   * @brief       Erase cycles of the block.
+   */
+  uint32_t                  erase_count;
+  /**
+   * @brief       Reserved, written as zero.
+   */
+  uint32_t                  reserved[2];
+  /**
+   * @brief       CRC of the previous fields.
+   */
+  uint32_t                  crc;
+};
+
+/**
+ * @brief       Type of a page header.
+ */
+typedef struct chfs_page_header chfs_page_header_t;
+
+/**
+ * @brief       Structure representing a page header.
+ * @details     The header is programmed after the payload, a page is
+ *              committed when its header CRC is valid.
+ */
+struct chfs_page_header {
+  /**
+   * @brief       Page type.
+   */
+  uint8_t                   type;
+  /**
+   * @brief       Node type, for node pages.
+   */
+  uint8_t                   mode;
+  /**
+   * @brief       Node owning the page.
+   */
+  uint16_t                  node;
+  /**
+   * @brief       Chunk number for data pages, parent node for node pages.
+   */
+  uint16_t                  index;
+  /**
+   * @brief       Payload length.
+   */
+  uint16_t                  len;
+  /**
+   * @brief       Sequence number of the page.
+   */
+  uint32_t                  seq;
+  /**
+   * @brief       File size after this page has been written.
+   */
+  uint32_t                  size;
+  /**
+   * @brief       Sequence number of the node creation or truncation.
+   */
+  uint32_t                  base;
+  /**
+   * @brief       Hash of the node name, for node pages.
+   */
+  uint32_t                  hash;
+  /**
+   * @brief       CRC of the payload.
+   */
+  uint32_t                  dcrc;
+  /**
+   * @brief       CRC of the previous header fields.
+   */
+  uint32_t                  hcrc;
+};
+
+/**
+ * @brief       Type of a path lookup result.
+ */
+typedef struct chfs_lookup chfs_lookup_t;
+
+/**
+ * @brief       Structure representing a path lookup result.
+ */
+struct chfs_lookup {
+  /**
+   * @brief       Parent directory of the last path element.
+   */
+  uint16_t                  parent;
+  /**
+   * @brief       Node of the last path element or @p CHFS_NO_NODE.
+   */
+  uint16_t                  node;
+  /**
+   * @brief       Last path element name, not terminated.
+   */
+  const char                *name;
+  /**
+   * @brief       Length of the last path element name.
+   */
+  size_t                    namelen;
+};
+
+/**
+ * @brief       Type of a pages cache buffer.
+ */
+typedef struct chfs_cache_buffer chfs_cache_buffer_t;
+
+/**
+ * @brief       Structure representing a pages cache buffer.
+ */
+struct chfs_cache_buffer {
+  /**
+   * @brief       Cached object header.
+   */
+  oc_object_t               obj;
+  /**
+   * @brief       Raw page content.
+   */
+  uint8_t                   data[DRV_CFG_CHFS_PAGE_SIZE];
+};
+
 /**
  * @class       vfs_chfs_dir_node_c
  * @extends     base_object_c, referenced_object_c, vfs_node_c,
@@ -107,6 +288,14 @@ struct vfs_chfs_dir_node {
    * @brief       Node mode information.
    */
   vfs_mode_t                mode;
+  /**
+   * @brief       Directory node in the nodes table.
+   */
+  uint16_t                  node;
+  /**
+   * @brief       Next node to be examined while reading entries.
+   */
+  uint16_t                  cursor;
 };
 /** @} */
 
@@ -143,6 +332,14 @@ struct vfs_chfs_file_node_vmt {
   msg_t (*setpos)(void *ip, vfs_offset_t offset, vfs_seekmode_t whence);
   vfs_offset_t (*getpos)(void *ip);
   sequential_stream_i * (*getstream)(void *ip);
+  ssize_t (*pread)(void *ip, uint8_t *buf, size_t n, vfs_offset_t offset);
+  ssize_t (*pwrite)(void *ip, const uint8_t *buf, size_t n,
+                    vfs_offset_t offset);
+  ssize_t (*readv)(void *ip, const vfs_iovec_t *iov, unsigned iovcnt);
+  ssize_t (*writev)(void *ip, const vfs_iovec_t *iov, unsigned iovcnt);
+  ssize_t (*splice)(void *ip, sequential_stream_i *stmp, size_t n);
+  msg_t (*getmap)(void *ip, vfs_offset_t offset, size_t n,
+                  const uint8_t **pp);
   /* From vfs_chfs_file_node_c.*/
 };
 
@@ -170,6 +367,34 @@ struct vfs_chfs_file_node {
    * @brief       Implemented interface @p sequential_stream_i.
    */
   sequential_stream_i       stm;
+  /**
+   * @brief       File node in the nodes table.
+   */
+  uint16_t                  node;
+  /**
+   * @brief       File open flags.
+   */
+  int                       oflag;
+  /**
+   * @brief       Current file position.
+   */
+  uint32_t                  position;
+  /**
+   * @brief       Chunk in the buffer or @p CHFS_NO_CHUNK.
+   */
+  uint32_t                  chunk;
+  /**
+   * @brief       Buffer modified and not yet written.
+   */
+  bool                      dirty;
+  /**
+   * @brief       A page is reserved for a chunk not yet in the index.
+   */
+  bool                      reserved;
+  /**
+   * @brief       Buffer of the current data chunk.
+   */
+  uint8_t                   buf[CHFS_CHUNK_SIZE];
 };
 /** @} */
 
@@ -177,10 +402,6 @@ struct vfs_chfs_file_node {
  * @brief       Global state of @p vfs_chfs_driver_c.
  */
 struct vfs_chfs_driver_static_struct {
-  /**
-   * @brief       Pool of file info objects.
-   */
-  memory_pool_t             info_nodes_pool;
   /**
    * @brief       Pool of directory nodes.
    */
@@ -206,9 +427,9 @@ struct vfs_chfs_driver_static_struct {
    */
   oc_hash_element_t         cache_headers[np2(DRV_CFG_CHFS_CACHE_BUFFERS_NUM * 2)];
   /**
-   * @brief       Array of cached objects.
+   * @brief       Array of cached pages.
    */
-  oc_object_t               cache_objects[DRV_CFG_CHFS_CACHE_BUFFERS_NUM];
+  chfs_cache_buffer_t       cache_objects[DRV_CFG_CHFS_CACHE_BUFFERS_NUM];
 };
 
 /*===========================================================================*/
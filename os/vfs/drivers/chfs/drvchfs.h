@@ -28,6 +28,7 @@
 
 #if (VFS_CFG_ENABLE_DRV_CHFS == TRUE) || defined(__DOXYGEN__)
 
+#include "hal.h"
 #include "oop_sequential_stream.h"
 
 /*===========================================================================*/
@@ -57,11 +58,73 @@
 #endif
 
 /**
- * @brief       Number of file nodes pre-allocated in the pool.
+ * @brief       Number of page buffers in the shared pages cache.
  */
 #if !defined(DRV_CFG_CHFS_CACHE_BUFFERS_NUM) || defined(__DOXYGEN__)
 #define DRV_CFG_CHFS_CACHE_BUFFERS_NUM      2
 #endif
+
+/**
+ * @brief       Size of a ChibiFS page.
+ * @details     Pages are the allocation and programming unit, each page
+ *              holds a 32 bytes header and a payload.
+ * @note        Must be a power of two and a divider of the flash sector size.
+ */
+#if !defined(DRV_CFG_CHFS_PAGE_SIZE) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_PAGE_SIZE              256
+#endif
+
+/**
+ * @brief       Flash programming granularity.
+ * @details     Program operations are aligned to and sized as multiples of
+ *              this value.
+ */
+#if !defined(DRV_CFG_CHFS_PROGRAM_SIZE) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_PROGRAM_SIZE           8
+#endif
+
+/**
+ * @brief       Maximum number of flash blocks in a volume.
+ */
+#if !defined(DRV_CFG_CHFS_MAX_BLOCKS) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_MAX_BLOCKS             64
+#endif
+
+/**
+ * @brief       Maximum number of files and directories in a volume.
+ * @note        The root directory is included in the count.
+ */
+#if !defined(DRV_CFG_CHFS_MAX_NODES) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_MAX_NODES              32
+#endif
+
+/**
+ * @brief       Size of the in-RAM data chunks index.
+ * @details     One entry is required for each page of file data present
+ *              in the volume, 1/8 of the entries are kept free in order to
+ *              keep lookups fast.
+ * @note        Must be a power of two.
+ */
+#if !defined(DRV_CFG_CHFS_MAX_CHUNKS) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_MAX_CHUNKS             512
+#endif
+
+/**
+ * @brief       Pages moved by each incremental garbage collection step.
+ */
+#if !defined(DRV_CFG_CHFS_GC_STEP_PAGES) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_GC_STEP_PAGES          4
+#endif
+
+/**
+ * @brief       Erase cycles difference triggering static wear leveling.
+ * @details     When the least erased block holding data falls behind the
+ *              most erased block by more than this value, its content is
+ *              moved in order to put the block back in rotation.
+ */
+#if !defined(DRV_CFG_CHFS_WEAR_DELTA) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_WEAR_DELTA             32
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -83,6 +146,60 @@
 #error "invalid DRV_CFG_CHFS_CACHE_BUFFERS_NUM value"
 #endif
 
+/* Checks on DRV_CFG_CHFS_PAGE_SIZE configuration.*/
+#if (DRV_CFG_CHFS_PAGE_SIZE < 64) ||                                        \
+    ((DRV_CFG_CHFS_PAGE_SIZE & (DRV_CFG_CHFS_PAGE_SIZE - 1)) != 0)
+#error "invalid DRV_CFG_CHFS_PAGE_SIZE value"
+#endif
+
+/* Checks on DRV_CFG_CHFS_PROGRAM_SIZE configuration.*/
+#if (DRV_CFG_CHFS_PROGRAM_SIZE < 1) || (DRV_CFG_CHFS_PROGRAM_SIZE > 32) ||   \
+    ((DRV_CFG_CHFS_PROGRAM_SIZE & (DRV_CFG_CHFS_PROGRAM_SIZE - 1)) != 0)
+#error "invalid DRV_CFG_CHFS_PROGRAM_SIZE value"
+#endif
+
+/* Checks on DRV_CFG_CHFS_MAX_BLOCKS configuration.*/
+#if DRV_CFG_CHFS_MAX_BLOCKS < 4
+#error "invalid DRV_CFG_CHFS_MAX_BLOCKS value"
+#endif
+
+/* Checks on DRV_CFG_CHFS_MAX_NODES configuration.*/
+#if (DRV_CFG_CHFS_MAX_NODES < 2) || (DRV_CFG_CHFS_MAX_NODES > 65535)
+#error "invalid DRV_CFG_CHFS_MAX_NODES value"
+#endif
+
+/* Checks on DRV_CFG_CHFS_MAX_CHUNKS configuration.*/
+#if (DRV_CFG_CHFS_MAX_CHUNKS < 16) ||                                       \
+    ((DRV_CFG_CHFS_MAX_CHUNKS & (DRV_CFG_CHFS_MAX_CHUNKS - 1)) != 0)
+#error "invalid DRV_CFG_CHFS_MAX_CHUNKS value"
+#endif
+
+/* Checks on DRV_CFG_CHFS_GC_STEP_PAGES configuration.*/
+#if DRV_CFG_CHFS_GC_STEP_PAGES < 1
+#error "invalid DRV_CFG_CHFS_GC_STEP_PAGES value"
+#endif
+
+/* Checks on DRV_CFG_CHFS_WEAR_DELTA configuration.*/
+#if DRV_CFG_CHFS_WEAR_DELTA < 1
+#error "invalid DRV_CFG_CHFS_WEAR_DELTA value"
+#endif
+
+/**
+ * @brief       Size of the header of a ChibiFS page.
+ */
+#define CHFS_PAGE_HEADER_SIZE               32U
+
+/**
+ * @brief       Size of the payload of a ChibiFS page.
+ */
+#define CHFS_CHUNK_SIZE                     ((uint32_t)DRV_CFG_CHFS_PAGE_SIZE - \
+                                             CHFS_PAGE_HEADER_SIZE)
+
+/* Names are stored in the payload of a single page.*/
+#if VFS_CFG_NAMELEN_MAX > DRV_CFG_CHFS_PAGE_SIZE - 32
+#error "VFS_CFG_NAMELEN_MAX too large for DRV_CFG_CHFS_PAGE_SIZE"
+#endif
+
 #if CH_CFG_USE_OBJ_CACHES != TRUE
 #error "VFS CHFS driver requires CH_CFG_USE_OBJ_CACHES"
 #endif
@@ -105,9 +222,155 @@ typedef struct chfs_config chfs_config_t;
  */
 struct chfs_config {
   /**
-   * @brief       Block device associated to this ChibiFS instance.
+   * @brief       Flash device associated to this ChibiFS instance.
+   */
+  BaseFlash                 *flashp;
+  /**
+   * @brief       First flash sector of the volume.
+   */
+  flash_sector_t            sector_start;
+  /**
+   * @brief       Number of flash sectors in the volume.
+   * @note        All sectors must have the same size.
+   */
+  flash_sector_t            sectors_count;
+};
+
+/**
+ * @brief       Type of a ChibiFS block state.
+ */
+typedef struct chfs_block chfs_block_t;
+
+/**
+ * @brief       Structure representing a ChibiFS block state.
+ */
+struct chfs_block {
+  /**
+   * @brief       Erase cycles of the block.
+   */
+  uint32_t                  erase_count;
+  /**
+   * @brief       Written pages including the block header page.
+   * @note        Zero if the block header is not valid.
    */
-  const void                *blkdev;
+  uint16_t                  used;
+  /**
+   * @brief       Pages still holding valid data.
+   */
+  uint16_t                  valid;
+};
+
+/**
+ * @brief       Type of a ChibiFS node state.
+ */
+typedef struct chfs_node chfs_node_t;
+
+/**
+ * @brief       Structure representing a ChibiFS node state.
+ */
+struct chfs_node {
+  /**
+   * @brief       Size of the file.
+   */
+  uint32_t                  size;
+  /**
+   * @brief       Sequence number of the node creation or truncation.
+   */
+  uint32_t                  base;
+  /**
+   * @brief       Sequence number of the most recent page of the node.
+   */
+  uint32_t                  seq;
+  /**
+   * @brief       Hash of the node name.
+   */
+  uint32_t                  hash;
+  /**
+   * @brief       Page holding the node descriptor or its deletion mark.
+   */
+  uint32_t                  page;
+  /**
+   * @brief       Parent directory node.
+   */
+  uint16_t                  parent;
+  /**
+   * @brief       Pages of this node physically present in the volume.
+   */
+  uint16_t                  pages;
+  /**
+   * @brief       Node type.
+   */
+  uint8_t                   type;
+  /**
+   * @brief       Number of open file nodes referring this node.
+   */
+  uint8_t                   opened;
+};
+
+/**
+ * @brief       Type of a ChibiFS data chunks index entry.
+ */
+typedef struct chfs_chunk chfs_chunk_t;
+
+/**
+ * @brief       Structure representing a ChibiFS data chunks index entry.
+ */
+struct chfs_chunk {
+  /**
+   * @brief       Node and chunk number, zero for free entries.
+   */
+  uint32_t                  key;
+  /**
+   * @brief       Page holding the chunk.
+   */
+  uint32_t                  page;
+};
+
+/**
+ * @brief       Type of a ChibiFS usage report.
+ */
+typedef struct chfs_usage chfs_usage_t;
+
+/**
+ * @brief       Structure representing a ChibiFS usage report.
+ */
+struct chfs_usage {
+  /**
+   * @brief       Total blocks in the volume.
+   */
+  uint32_t                  blocks;
+  /**
+   * @brief       Blocks with no valid pages.
+   */
+  uint32_t                  free_blocks;
+  /**
+   * @brief       Pages per block.
+   */
+  uint32_t                  block_pages;
+  /**
+   * @brief       Pages holding valid data.
+   */
+  uint32_t                  live_pages;
+  /**
+   * @brief       Lowest erase count among blocks.
+   */
+  uint32_t                  erase_min;
+  /**
+   * @brief       Highest erase count among blocks.
+   */
+  uint32_t                  erase_max;
+  /**
+   * @brief       Pages written since mount, including moved pages.
+   */
+  uint32_t                  pages_written;
+  /**
+   * @brief       Pages moved by the garbage collector since mount.
+   */
+  uint32_t                  pages_moved;
+  /**
+   * @brief       Blocks erased since mount.
+   */
+  uint32_t                  blocks_erased;
 };
 
 /**
@@ -159,14 +422,70 @@ struct vfs_chfs_driver {
    * @brief       Associated ChibiFS configuration.
    */
   const struct chfs_config  *cfgp;
-  /**
-   * @brief       Current working directory node.
-   */
-  struct vfs_chfs_dir_node  *cwd;
   /**
    * @brief       Current working directory path.
    */
   char                      path_cwd[VFS_CFG_PATHLEN_MAX + 1];
+  /**
+   * @brief       Path scratch pad.
+   */
+  char                      scratch[VFS_CFG_PATHLEN_MAX + 1];
+  /**
+   * @brief       Pages per block.
+   */
+  uint32_t                  block_pages;
+  /**
+   * @brief       Next page sequence number.
+   */
+  uint32_t                  seq;
+  /**
+   * @brief       Block being written.
+   */
+  uint32_t                  head;
+  /**
+   * @brief       Block being collected.
+   */
+  uint32_t                  gc_block;
+  /**
+   * @brief       Next page to be examined in the block being collected.
+   */
+  uint32_t                  gc_page;
+  /**
+   * @brief       Pages holding valid data.
+   */
+  uint32_t                  live_pages;
+  /**
+   * @brief       Pages reserved by file buffers holding new chunks.
+   */
+  uint32_t                  reserved_pages;
+  /**
+   * @brief       Used entries in the data chunks index.
+   */
+  uint32_t                  chunks_used;
+  /**
+   * @brief       Pages written since mount.
+   */
+  uint32_t                  pages_written;
+  /**
+   * @brief       Pages moved by the garbage collector since mount.
+   */
+  uint32_t                  pages_moved;
+  /**
+   * @brief       Blocks erased since mount.
+   */
+  uint32_t                  blocks_erased;
+  /**
+   * @brief       Blocks state.
+   */
+  chfs_block_t              blocks[DRV_CFG_CHFS_MAX_BLOCKS];
+  /**
+   * @brief       Nodes table, the node zero is the root directory.
+   */
+  chfs_node_t               nodes[DRV_CFG_CHFS_MAX_NODES];
+  /**
+   * @brief       Data chunks index.
+   */
+  chfs_chunk_t              chunks[DRV_CFG_CHFS_MAX_CHUNKS];
 };
 /** @} */
 
@@ -198,6 +517,8 @@ extern "C" {
   msg_t chfsdrvMount(void *ip);
   msg_t chfsdrvUnmount(void *ip);
   msg_t chfsdrvFormat(void *ip);
+  msg_t chfsdrvGarbageCollect(void *ip);
+  msg_t chfsdrvGetUsage(void *ip, chfs_usage_t *up);
   /* Regular functions.*/
   void __drv_chfs_init(void);
 #ifdef __cplusplus
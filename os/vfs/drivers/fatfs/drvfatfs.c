@@ -147,6 +147,14 @@ struct vfs_fatfs_file_node_vmt {
   msg_t (*setpos)(void *ip, vfs_offset_t offset, vfs_seekmode_t whence);
   vfs_offset_t (*getpos)(void *ip);
   sequential_stream_i * (*getstream)(void *ip);
+  ssize_t (*pread)(void *ip, uint8_t *buf, size_t n, vfs_offset_t offset);
+  ssize_t (*pwrite)(void *ip, const uint8_t *buf, size_t n,
+                    vfs_offset_t offset);
+  ssize_t (*readv)(void *ip, const vfs_iovec_t *iov, unsigned iovcnt);
+  ssize_t (*writev)(void *ip, const vfs_iovec_t *iov, unsigned iovcnt);
+  ssize_t (*splice)(void *ip, sequential_stream_i *stmp, size_t n);
+  msg_t (*getmap)(void *ip, vfs_offset_t offset, size_t n,
+                  const uint8_t **pp);
   /* From vfs_fatfs_file_node_c.*/
 };
 
@@ -178,6 +186,16 @@ struct vfs_fatfs_file_node {
    * @brief       FatFS inner @p FIL structure.
    */
   FIL                       file;
+  /**
+   * @brief       Logical file position to be restored.
+   * @note        Only meaningful when @p detached is @p true.
+   */
+  FSIZE_t                   cursor;
+  /**
+   * @brief       The @p FIL position has been moved by a positional
+   *              transfer and is not the logical file position.
+   */
+  bool                      detached;
 };
 /** @} */
 
@@ -142,6 +142,14 @@ struct vfs_littlefs_file_node_vmt {
   msg_t (*setpos)(void *ip, vfs_offset_t offset, vfs_seekmode_t whence);
   vfs_offset_t (*getpos)(void *ip);
   sequential_stream_i * (*getstream)(void *ip);
+  ssize_t (*pread)(void *ip, uint8_t *buf, size_t n, vfs_offset_t offset);
+  ssize_t (*pwrite)(void *ip, const uint8_t *buf, size_t n,
+                    vfs_offset_t offset);
+  ssize_t (*readv)(void *ip, const vfs_iovec_t *iov, unsigned iovcnt);
+  ssize_t (*writev)(void *ip, const vfs_iovec_t *iov, unsigned iovcnt);
+  ssize_t (*splice)(void *ip, sequential_stream_i *stmp, size_t n);
+  msg_t (*getmap)(void *ip, vfs_offset_t offset, size_t n,
+                  const uint8_t **pp);
   /* From vfs_littlefs_file_node_c.*/
 };
 
@@ -31,6 +31,12 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+/* Cache entry target for paths handled by the overlaid driver.*/
+#define OVL_CACHE_OVERLAID          0xFFFFU
+
+/* Cache entry flag, the path is known to not exist.*/
+#define OVL_CACHE_NEGATIVE          1U
+
 /*===========================================================================*/
 /* Module local macros.                                                      */
 /*===========================================================================*/
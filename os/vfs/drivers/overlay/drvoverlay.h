@@ -55,6 +55,16 @@
 #if !defined(DRV_CFG_OVERLAY_DIR_NODES_NUM) || defined(__DOXYGEN__)
 #define DRV_CFG_OVERLAY_DIR_NODES_NUM       1
 #endif
+
+/**
+ * @brief       Maximum length of a path in the path-resolution cache.
+ * @details     Normalized absolute paths longer than this are resolved
+ *              normally but are not cached, it determines the size of each
+ *              cache entry.
+ */
+#if !defined(DRV_CFG_OVERLAY_CACHE_PATHLEN_MAX) || defined(__DOXYGEN__)
+#define DRV_CFG_OVERLAY_CACHE_PATHLEN_MAX   63
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -71,6 +81,11 @@
 #error "invalid DRV_CFG_OVERLAY_DIR_NODES_NUM value"
 #endif
 
+/* Checks on DRV_CFG_OVERLAY_CACHE_PATHLEN_MAX configuration.*/
+#if (DRV_CFG_OVERLAY_CACHE_PATHLEN_MAX < 1) || (DRV_CFG_OVERLAY_CACHE_PATHLEN_MAX > VFS_CFG_PATHLEN_MAX)
+#error "invalid DRV_CFG_OVERLAY_CACHE_PATHLEN_MAX value"
+#endif
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -79,6 +94,50 @@
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief       Type of an overlay path-resolution cache entry.
+ */
+typedef struct ovl_cache_entry ovl_cache_entry_t;
+
+/**
+ * @brief       Structure representing an overlay path-resolution cache
+ *              entry.
+ */
+struct ovl_cache_entry {
+  /**
+   * @brief       Hash of the cached path.
+   */
+  uint32_t                  hash;
+  /**
+   * @brief       Cache clock value at last use, zero if the entry is free.
+   */
+  uint32_t                  stamp;
+  /**
+   * @brief       Global cache generation of a negative entry.
+   */
+  uint32_t                  generation;
+  /**
+   * @brief       Length of the cached path.
+   */
+  uint16_t                  length;
+  /**
+   * @brief       Offset of the driver-relative part of the path.
+   */
+  uint16_t                  offset;
+  /**
+   * @brief       Index of the registered driver handling the path.
+   */
+  uint16_t                  target;
+  /**
+   * @brief       Entry flags.
+   */
+  uint16_t                  flags;
+  /**
+   * @brief       Normalized absolute path, zero terminated.
+   */
+  char                      path[DRV_CFG_OVERLAY_CACHE_PATHLEN_MAX + 1];
+};
+
 /**
  * @class       vfs_overlay_dir_node_c
  * @extends     base_object_c, referenced_object_c, vfs_node_c,
@@ -190,6 +249,18 @@ struct vfs_overlay_driver {
   const char                *names[DRV_CFG_OVERLAY_DRV_MAX];
   vfs_driver_c              *drivers[DRV_CFG_OVERLAY_DRV_MAX];
   char                      buf[VFS_CFG_PATHLEN_MAX + 1];
+  /**
+   * @brief       Path-resolution cache entries or @p NULL.
+   */
+  ovl_cache_entry_t         *cache;
+  /**
+   * @brief       Number of path-resolution cache entries.
+   */
+  unsigned                  cache_size;
+  /**
+   * @brief       Path-resolution cache LRU clock.
+   */
+  uint32_t                  cache_clock;
 };
 /** @} */
 
@@ -206,6 +277,12 @@ struct vfs_overlay_driver_static_struct {
    * @brief       Static storage of directory nodes.
    */
   vfs_overlay_dir_node_c    dir_nodes[DRV_CFG_OVERLAY_DIR_NODES_NUM];
+  /**
+   * @brief       Generation of path-resolution caches negative entries.
+   * @details     It is increased each time a node is created through any
+   *              overlay, negative entries of older generations are ignored.
+   */
+  uint32_t                  cache_generation;
 };
 
 /*===========================================================================*/
@@ -241,6 +318,8 @@ extern "C" {
   msg_t __ovldrv_rmdir_impl(void *ip, const char *path);
   msg_t ovldrvRegisterDriver(void *ip, vfs_driver_c *vdp, const char *name);
   msg_t ovldrvUnregisterDriver(void *ip, const char *name);
+  void ovldrvSetPathCache(void *ip, ovl_cache_entry_t *cache, unsigned n);
+  void ovldrvFlushPathCache(void *ip);
   /* Regular functions.*/
   void __drv_overlay_init(void);
 #ifdef __cplusplus
@@ -0,0 +1,271 @@
+/*
+    ChibiOS - Copyright (C) 2006..2025 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file        drvtmpfs.c
+ * @brief       Generated VFS RAM FS Driver source.
+ * @note        This is a generated file, do not edit directly.
+ *
+ * @addtogroup  DRVTMPFS
+ * @{
+ */
+
+#include "vfs.h"
+
+#if (VFS_CFG_ENABLE_DRV_TMPFS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/* Maximum file size, positions are kept in 32 bits.*/
+#define TMPFS_SIZE_MAX              ((uint32_t)INT32_MAX)
+
+/*===========================================================================*/
+/* Module local macros.                                                      */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief       Global state of @p vfs_tmpfs_driver_c.
+ */
+struct vfs_tmpfs_driver_static_struct vfs_tmpfs_driver_static;
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/**
+ * @brief       Type of a path lookup result.
+ */
+typedef struct tmpfs_lookup tmpfs_lookup_t;
+
+/**
+ * @brief       Structure representing a path lookup result.
+ */
+struct tmpfs_lookup {
+  /**
+   * @brief       Parent directory of the last path element.
+   */
+  tmpfs_inode_t             *parent;
+  /**
+   * @brief       Node of the last path element or @p NULL.
+   */
+  tmpfs_inode_t             *node;
+  /**
+   * @brief       Last path element name, not terminated.
+   */
+  const char                *name;
+  /**
+   * @brief       Length of the last path element name.
+   */
+  size_t                    namelen;
+};
+
+/**
+ * @class       vfs_tmpfs_dir_node_c
+ * @extends     base_object_c, referenced_object_c, vfs_node_c,
+ *              vfs_directory_node_c.
+ *
+ *
+ * @name        Class @p vfs_tmpfs_dir_node_c structures
+ * @{
+ */
+
+/**
+ * @brief       Type of a VFS RAM FS directory node class.
+ */
+typedef struct vfs_tmpfs_dir_node vfs_tmpfs_dir_node_c;
+
+/**
+ * @brief       Class @p vfs_tmpfs_dir_node_c virtual methods table.
+ */
+struct vfs_tmpfs_dir_node_vmt {
+  /* From base_object_c.*/
+  void (*dispose)(void *ip);
+  /* From referenced_object_c.*/
+  void * (*addref)(void *ip);
+  object_references_t (*release)(void *ip);
+  /* From vfs_node_c.*/
+  msg_t (*stat)(void *ip, vfs_stat_t *sp);
+  /* From vfs_directory_node_c.*/
+  msg_t (*first)(void *ip, vfs_direntry_info_t *dip);
+  msg_t (*next)(void *ip, vfs_direntry_info_t *dip);
+  /* From vfs_tmpfs_dir_node_c.*/
+};
+
+/**
+ * @brief       Structure representing a VFS RAM FS directory node class.
+ */
+struct vfs_tmpfs_dir_node {
+  /**
+   * @brief       Virtual Methods Table.
+   */
+  const struct vfs_tmpfs_dir_node_vmt *vmt;
+  /**
+   * @brief       Number of references to the object.
+   */
+  object_references_t       references;
+  /**
+   * @brief       Driver handling this node.
+   */
+  vfs_driver_c              *driver;
+  /**
+   * @brief       Node mode information.
+   */
+  vfs_mode_t                mode;
+  /**
+   * @brief       Directory being read.
+   */
+  tmpfs_inode_t             *inode;
+  /**
+   * @brief       Hash bucket being read.
+   */
+  uint32_t                  bucket;
+  /**
+   * @brief       Next entry to be read in the current bucket.
+   */
+  uint32_t                  index;
+};
+/** @} */
+
+/**
+ * @class       vfs_tmpfs_file_node_c
+ * @extends     base_object_c, referenced_object_c, vfs_node_c,
+ *              vfs_file_node_c.
+ * @implements  sequential_stream_i
+ *
+ *
+ * @name        Class @p vfs_tmpfs_file_node_c structures
+ * @{
+ */
+
+/**
+ * @brief       Type of a VFS RAM FS file node class.
+ */
+typedef struct vfs_tmpfs_file_node vfs_tmpfs_file_node_c;
+
+/**
+ * @brief       Class @p vfs_tmpfs_file_node_c virtual methods table.
+ */
+struct vfs_tmpfs_file_node_vmt {
+  /* From base_object_c.*/
+  void (*dispose)(void *ip);
+  /* From referenced_object_c.*/
+  void * (*addref)(void *ip);
+  object_references_t (*release)(void *ip);
+  /* From vfs_node_c.*/
+  msg_t (*stat)(void *ip, vfs_stat_t *sp);
+  /* From vfs_file_node_c.*/
+  ssize_t (*read)(void *ip, uint8_t *buf, size_t n);
+  ssize_t (*write)(void *ip, const uint8_t *buf, size_t n);
+  msg_t (*setpos)(void *ip, vfs_offset_t offset, vfs_seekmode_t whence);
+  vfs_offset_t (*getpos)(void *ip);
+  sequential_stream_i * (*getstream)(void *ip);
+  ssize_t (*pread)(void *ip, uint8_t *buf, size_t n, vfs_offset_t offset);
+  ssize_t (*pwrite)(void *ip, const uint8_t *buf, size_t n,
+                    vfs_offset_t offset);
+  ssize_t (*readv)(void *ip, const vfs_iovec_t *iov, unsigned iovcnt);
+  ssize_t (*writev)(void *ip, const vfs_iovec_t *iov, unsigned iovcnt);
+  ssize_t (*splice)(void *ip, sequential_stream_i *stmp, size_t n);
+  msg_t (*getmap)(void *ip, vfs_offset_t offset, size_t n,
+                  const uint8_t **pp);
+  /* From vfs_tmpfs_file_node_c.*/
+};
+
+/**
+ * @brief       Structure representing a VFS RAM FS file node class.
+ */
+struct vfs_tmpfs_file_node {
+  /**
+   * @brief       Virtual Methods Table.
+   */
+  const struct vfs_tmpfs_file_node_vmt *vmt;
+  /**
+   * @brief       Number of references to the object.
+   */
+  object_references_t       references;
+  /**
+   * @brief       Driver handling this node.
+   */
+  vfs_driver_c              *driver;
+  /**
+   * @brief       Node mode information.
+   */
+  vfs_mode_t                mode;
+  /**
+   * @brief       Implemented interface @p sequential_stream_i.
+   */
+  sequential_stream_i       stm;
+  /**
+   * @brief       File being accessed.
+   */
+  tmpfs_inode_t             *inode;
+  /**
+   * @brief       File open flags.
+   */
+  int                       oflag;
+  /**
+   * @brief       Current file position.
+   */
+  uint32_t                  position;
+  /**
+   * @brief       Last accessed extent or @p NULL.
+   */
+  tmpfs_extent_t            *extent;
+  /**
+   * @brief       Index of the last accessed extent in the file.
+   */
+  uint32_t                  extent_index;
+};
+/** @} */
+
+/**
+ * @brief       Global state of @p vfs_tmpfs_driver_c.
+ */
+struct vfs_tmpfs_driver_static_struct {
+  /**
+   * @brief       Pool of directory nodes.
+   */
+  memory_pool_t             dir_nodes_pool;
+  /**
+   * @brief       Pool of file nodes.
+   */
+  memory_pool_t             file_nodes_pool;
+  /**
+   * @brief       Static storage of directory nodes.
+   */
+  vfs_tmpfs_dir_node_c      dir_nodes[DRV_CFG_TMPFS_DIR_NODES_NUM];
+  /**
+   * @brief       Static storage of file nodes.
+   */
+  vfs_tmpfs_file_node_c     file_nodes[DRV_CFG_TMPFS_FILE_NODES_NUM];
+};
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/* Module code has been generated into an hand-editable file and included
+   here.*/
+#include "drvtmpfs_impl.inc"
+
+#endif /* VFS_CFG_ENABLE_DRV_TMPFS == TRUE */
+
+/** @} */
@@ -0,0 +1,386 @@
+/*
+    ChibiOS - Copyright (C) 2006..2025 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file        drvtmpfs.h
+ * @brief       Generated VFS RAM FS Driver header.
+ * @note        This is a generated file, do not edit directly.
+ *
+ * @addtogroup  DRVTMPFS
+ * @{
+ */
+
+#ifndef DRVTMPFS_H
+#define DRVTMPFS_H
+
+#if (VFS_CFG_ENABLE_DRV_TMPFS == TRUE) || defined(__DOXYGEN__)
+
+#include "oop_sequential_stream.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief       Number of directory nodes pre-allocated in the pool.
+ */
+#if !defined(DRV_CFG_TMPFS_DIR_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_TMPFS_DIR_NODES_NUM         1
+#endif
+
+/**
+ * @brief       Number of file nodes pre-allocated in the pool.
+ */
+#if !defined(DRV_CFG_TMPFS_FILE_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_TMPFS_FILE_NODES_NUM        2
+#endif
+
+/**
+ * @brief       Size of the data area of a file extent.
+ * @details     File data is stored in chained extents of this size
+ *              allocated from the heap, larger extents reduce the
+ *              allocation and chaining overhead, smaller extents reduce
+ *              the memory wasted in the last extent of each file.
+ */
+#if !defined(DRV_CFG_TMPFS_EXTENT_SIZE) || defined(__DOXYGEN__)
+#define DRV_CFG_TMPFS_EXTENT_SIZE           256
+#endif
+
+/**
+ * @brief       Number of hash buckets in each directory.
+ * @note        Must be a power of two.
+ */
+#if !defined(DRV_CFG_TMPFS_DIR_BUCKETS) || defined(__DOXYGEN__)
+#define DRV_CFG_TMPFS_DIR_BUCKETS           8
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/* Checks on DRV_CFG_TMPFS_DIR_NODES_NUM configuration.*/
+#if DRV_CFG_TMPFS_DIR_NODES_NUM < 1
+#error "invalid DRV_CFG_TMPFS_DIR_NODES_NUM value"
+#endif
+
+/* Checks on DRV_CFG_TMPFS_FILE_NODES_NUM configuration.*/
+#if DRV_CFG_TMPFS_FILE_NODES_NUM < 1
+#error "invalid DRV_CFG_TMPFS_FILE_NODES_NUM value"
+#endif
+
+/* Checks on DRV_CFG_TMPFS_EXTENT_SIZE configuration.*/
+#if (DRV_CFG_TMPFS_EXTENT_SIZE < 16) || ((DRV_CFG_TMPFS_EXTENT_SIZE % 8) != 0)
+#error "invalid DRV_CFG_TMPFS_EXTENT_SIZE value"
+#endif
+
+/* Checks on DRV_CFG_TMPFS_DIR_BUCKETS configuration.*/
+#if (DRV_CFG_TMPFS_DIR_BUCKETS < 1) ||                                      \
+    ((DRV_CFG_TMPFS_DIR_BUCKETS & (DRV_CFG_TMPFS_DIR_BUCKETS - 1)) != 0)
+#error "invalid DRV_CFG_TMPFS_DIR_BUCKETS value"
+#endif
+
+#if CH_CFG_USE_HEAP != TRUE
+#error "VFS TMPFS driver requires CH_CFG_USE_HEAP"
+#endif
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief       Type of a RAM FS configuration structure.
+ */
+typedef struct tmpfs_config tmpfs_config_t;
+
+/**
+ * @brief       Structure representing a RAM FS configuration.
+ */
+struct tmpfs_config {
+  /**
+   * @brief       Heap used for nodes and file data.
+   * @note        If @p NULL then the default heap is used.
+   */
+  memory_heap_t             *heapp;
+  /**
+   * @brief       Maximum memory used by the file system, in bytes.
+   * @details     All allocations are accounted, including directories,
+   *              names and the unused part of the last extent of each file.
+   * @note        Zero means no limit other than the heap size.
+   */
+  size_t                    size_max;
+};
+
+/**
+ * @brief       Type of a RAM FS file extent.
+ */
+typedef struct tmpfs_extent tmpfs_extent_t;
+
+/**
+ * @brief       Structure representing a RAM FS file extent.
+ */
+struct tmpfs_extent {
+  /**
+   * @brief       Next extent of the file or @p NULL.
+   */
+  tmpfs_extent_t            *next;
+  /**
+   * @brief       Extent data.
+   */
+  uint8_t                   data[DRV_CFG_TMPFS_EXTENT_SIZE];
+};
+
+/**
+ * @brief       Type of a RAM FS node.
+ */
+typedef struct tmpfs_inode tmpfs_inode_t;
+
+/**
+ * @brief       Structure representing a RAM FS node.
+ */
+struct tmpfs_inode {
+  /**
+   * @brief       Next node in the parent directory hash bucket.
+   */
+  tmpfs_inode_t             *next;
+  /**
+   * @brief       Parent directory or @p NULL for the root.
+   */
+  tmpfs_inode_t             *parent;
+  /**
+   * @brief       Node name, zero terminated.
+   */
+  char                      *name;
+  /**
+   * @brief       Hash of the node name.
+   */
+  uint32_t                  hash;
+  /**
+   * @brief       Size of the file.
+   */
+  uint32_t                  size;
+  /**
+   * @brief       Node mode, file or directory.
+   */
+  vfs_mode_t                mode;
+  /**
+   * @brief       Number of open VFS nodes referring this node.
+   */
+  uint16_t                  opened;
+  /**
+   * @brief       Data extents chain, files only.
+   */
+  tmpfs_extent_t            *extents;
+  /**
+   * @brief       Children hash buckets, directories only.
+   */
+  tmpfs_inode_t             **buckets;
+};
+
+/**
+ * @brief       Type of a RAM FS usage report.
+ */
+typedef struct tmpfs_usage tmpfs_usage_t;
+
+/**
+ * @brief       Structure representing a RAM FS usage report.
+ */
+struct tmpfs_usage {
+  /**
+   * @brief       Configured size limit, zero if unlimited.
+   */
+  size_t                    size_max;
+  /**
+   * @brief       Memory currently allocated by the file system.
+   */
+  size_t                    used;
+  /**
+   * @brief       Number of files.
+   */
+  uint32_t                  files;
+  /**
+   * @brief       Number of directories, excluding the root.
+   */
+  uint32_t                  dirs;
+  /**
+   * @brief       Number of allocated data extents.
+   */
+  uint32_t                  extents;
+};
+
+/**
+ * @class       vfs_tmpfs_driver_c
+ * @extends     base_object_c, vfs_driver_c.
+ *
+ *
+ * @name        Class @p vfs_tmpfs_driver_c structures
+ * @{
+ */
+
+/**
+ * @brief       Type of a VFS RAM FS driver class.
+ */
+typedef struct vfs_tmpfs_driver vfs_tmpfs_driver_c;
+
+/**
+ * @brief       Class @p vfs_tmpfs_driver_c virtual methods table.
+ */
+struct vfs_tmpfs_driver_vmt {
+  /* From base_object_c.*/
+  void (*dispose)(void *ip);
+  /* From vfs_driver_c.*/
+  msg_t (*setcwd)(void *ip, const char *path);
+  msg_t (*getcwd)(void *ip, char *buf, size_t size);
+  msg_t (*stat)(void *ip, const char *path, vfs_stat_t *sp);
+  msg_t (*opendir)(void *ip, const char *path, vfs_directory_node_c **vdnpp);
+  msg_t (*openfile)(void *ip, const char *path, int flags, vfs_file_node_c **vfnpp);
+  msg_t (*unlink)(void *ip, const char *path);
+  msg_t (*rename)(void *ip, const char *oldpath, const char *newpath);
+  msg_t (*mkdir)(void *ip, const char *path, vfs_mode_t mode);
+  msg_t (*rmdir)(void *ip, const char *path);
+  /* From vfs_tmpfs_driver_c.*/
+};
+
+/**
+ * @brief       Structure representing a VFS RAM FS driver class.
+ */
+struct vfs_tmpfs_driver {
+  /**
+   * @brief       Virtual Methods Table.
+   */
+  const struct vfs_tmpfs_driver_vmt *vmt;
+  /**
+   * @brief       Associated RAM FS configuration.
+   */
+  const struct tmpfs_config *cfgp;
+  /**
+   * @brief       Current working directory path.
+   */
+  char                      path_cwd[VFS_CFG_PATHLEN_MAX + 1];
+  /**
+   * @brief       Path scratch pad.
+   */
+  char                      scratch[VFS_CFG_PATHLEN_MAX + 1];
+  /**
+   * @brief       Memory currently allocated by the file system.
+   */
+  size_t                    used;
+  /**
+   * @brief       Number of files.
+   */
+  uint32_t                  files;
+  /**
+   * @brief       Number of directories, excluding the root.
+   */
+  uint32_t                  dirs;
+  /**
+   * @brief       Number of allocated data extents.
+   */
+  uint32_t                  extents;
+  /**
+   * @brief       Number of open VFS nodes.
+   */
+  uint32_t                  opened;
+  /**
+   * @brief       Root directory node.
+   */
+  tmpfs_inode_t             root;
+  /**
+   * @brief       Root directory hash buckets.
+   */
+  tmpfs_inode_t             *root_buckets[DRV_CFG_TMPFS_DIR_BUCKETS];
+};
+/** @} */
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern struct vfs_tmpfs_driver_static_struct vfs_tmpfs_driver_static;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  /* Methods of vfs_tmpfs_driver_c.*/
+  void *__tmpfsdrv_objinit_impl(void *ip, const void *vmt,
+                                const tmpfs_config_t *cfgp);
+  void __tmpfsdrv_dispose_impl(void *ip);
+  msg_t __tmpfsdrv_setcwd_impl(void *ip, const char *path);
+  msg_t __tmpfsdrv_getcwd_impl(void *ip, char *buf, size_t size);
+  msg_t __tmpfsdrv_stat_impl(void *ip, const char *path, vfs_stat_t *sp);
+  msg_t __tmpfsdrv_opendir_impl(void *ip, const char *path,
+                                vfs_directory_node_c **vdnpp);
+  msg_t __tmpfsdrv_openfile_impl(void *ip, const char *path, int flags,
+                                 vfs_file_node_c **vfnpp);
+  msg_t __tmpfsdrv_unlink_impl(void *ip, const char *path);
+  msg_t __tmpfsdrv_rename_impl(void *ip, const char *oldpath,
+                               const char *newpath);
+  msg_t __tmpfsdrv_mkdir_impl(void *ip, const char *path, vfs_mode_t mode);
+  msg_t __tmpfsdrv_rmdir_impl(void *ip, const char *path);
+  msg_t tmpfsdrvErase(void *ip);
+  void tmpfsdrvGetUsage(void *ip, tmpfs_usage_t *up);
+  /* Regular functions.*/
+  void __drv_tmpfs_init(void);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @name        Default constructor of vfs_tmpfs_driver_c
+ * @{
+ */
+/**
+ * @memberof    vfs_tmpfs_driver_c
+ *
+ * @brief       Default initialization function of @p vfs_tmpfs_driver_c.
+ *
+ * @param[out]    self          Pointer to a @p vfs_tmpfs_driver_c instance to
+ *                              be initialized.
+ * @param[in]     cfgp          Pointer to @p tmpfs_config_t configuration.
+ * @return                      Pointer to the initialized object.
+ *
+ * @objinit
+ */
+CC_FORCE_INLINE
+static inline vfs_tmpfs_driver_c *tmpfsdrvObjectInit(vfs_tmpfs_driver_c *self,
+                                                     const tmpfs_config_t *cfgp) {
+  extern const struct vfs_tmpfs_driver_vmt __vfs_tmpfs_driver_vmt;
+
+  return __tmpfsdrv_objinit_impl(self, &__vfs_tmpfs_driver_vmt, cfgp);
+}
+/** @} */
+
+#endif /* VFS_CFG_ENABLE_DRV_TMPFS == TRUE */
+
+#endif /* DRVTMPFS_H */
+
+/** @} */
@@ -99,6 +99,14 @@
 #include "drvstreams.h"
 #endif
 
+#if VFS_CFG_ENABLE_DRV_TMPFS == TRUE
+#include "drvtmpfs.h"
+#endif
+
+#if VFS_CFG_ENABLE_DRV_ROMFS == TRUE
+#include "drvromfs.h"
+#endif
+
 #if VFS_CFG_ENABLE_DRV_CHFS == TRUE
 #include "drvchfs.h"
 #endif
@@ -145,6 +153,23 @@ extern "C" {
                              vfs_direntry_info_t *dip);
   ssize_t vfsReadFile(vfs_file_node_c *vfnp, uint8_t *buf, size_t n);
   ssize_t vfsWriteFile(vfs_file_node_c *vfnp, const uint8_t *buf, size_t n);
+  ssize_t vfsReadFileAt(vfs_file_node_c *vfnp, uint8_t *buf, size_t n,
+                        vfs_offset_t offset);
+  ssize_t vfsWriteFileAt(vfs_file_node_c *vfnp, const uint8_t *buf, size_t n,
+                         vfs_offset_t offset);
+  ssize_t vfsReadFileVector(vfs_file_node_c *vfnp,
+                            const vfs_iovec_t *iov,
+                            unsigned iovcnt);
+  ssize_t vfsWriteFileVector(vfs_file_node_c *vfnp,
+                             const vfs_iovec_t *iov,
+                             unsigned iovcnt);
+  ssize_t vfsSpliceFile(vfs_file_node_c *vfnp,
+                        sequential_stream_i *stmp,
+                        size_t n);
+  msg_t vfsGetFileMapping(vfs_file_node_c *vfnp,
+                          vfs_offset_t offset,
+                          size_t n,
+                          const uint8_t **pp);
   msg_t vfsSetFilePosition(vfs_file_node_c *vfnp,
                            vfs_offset_t offset,
                            vfs_seekmode_t whence);
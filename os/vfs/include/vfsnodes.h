@@ -108,6 +108,11 @@ typedef int32_t vfs_mode_t;
  */
 typedef int vfs_seekmode_t;
 
+/**
+ * @brief       Type of a scatter-gather buffer descriptor.
+ */
+typedef struct vfs_iovec vfs_iovec_t;
+
 /**
  * @brief       Type of a directory entry structure.
  */
@@ -119,6 +124,21 @@ typedef struct vfs_direntry_info vfs_direntry_info_t;
  */
 typedef struct vfs_stat vfs_stat_t;
 
+/**
+ * @brief       Structure representing a scatter-gather buffer descriptor.
+ * @note        The layout is compatible with the Posix @p iovec structure.
+ */
+struct vfs_iovec {
+  /**
+   * @brief       Pointer to the buffer.
+   */
+  void                      *base;
+  /**
+   * @brief       Size of the buffer.
+   */
+  size_t                    len;
+};
+
 /**
  * @brief       Structure representing a directory entry.
  */
@@ -288,6 +308,14 @@ struct vfs_file_node_vmt {
   msg_t (*setpos)(void *ip, vfs_offset_t offset, vfs_seekmode_t whence);
   vfs_offset_t (*getpos)(void *ip);
   sequential_stream_i * (*getstream)(void *ip);
+  ssize_t (*pread)(void *ip, uint8_t *buf, size_t n, vfs_offset_t offset);
+  ssize_t (*pwrite)(void *ip, const uint8_t *buf, size_t n,
+                    vfs_offset_t offset);
+  ssize_t (*readv)(void *ip, const vfs_iovec_t *iov, unsigned iovcnt);
+  ssize_t (*writev)(void *ip, const vfs_iovec_t *iov, unsigned iovcnt);
+  ssize_t (*splice)(void *ip, sequential_stream_i *stmp, size_t n);
+  msg_t (*getmap)(void *ip, vfs_offset_t offset, size_t n,
+                  const uint8_t **pp);
 };
 
 /**
@@ -341,6 +369,18 @@ extern "C" {
                               vfs_seekmode_t whence);
   vfs_offset_t __vfsfile_getpos_impl(void *ip);
   sequential_stream_i *__vfsfile_getstream_impl(void *ip);
+  ssize_t __vfsfile_pread_impl(void *ip, uint8_t *buf, size_t n,
+                               vfs_offset_t offset);
+  ssize_t __vfsfile_pwrite_impl(void *ip, const uint8_t *buf, size_t n,
+                                vfs_offset_t offset);
+  ssize_t __vfsfile_readv_impl(void *ip, const vfs_iovec_t *iov,
+                               unsigned iovcnt);
+  ssize_t __vfsfile_writev_impl(void *ip, const vfs_iovec_t *iov,
+                                unsigned iovcnt);
+  ssize_t __vfsfile_splice_impl(void *ip, sequential_stream_i *stmp,
+                                size_t n);
+  msg_t __vfsfile_getmap_impl(void *ip, vfs_offset_t offset, size_t n,
+                              const uint8_t **pp);
 #ifdef __cplusplus
 }
 #endif
@@ -516,6 +556,148 @@ static inline sequential_stream_i *vfsFileGetStream(void *ip) {
 
   return self->vmt->getstream(ip);
 }
+
+/**
+ * @memberof    vfs_file_node_c
+ * @public
+ *
+ * @brief       File node read at an absolute position.
+ * @details     The current file position is not affected.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @param[out]    buf           Pointer to the data buffer.
+ * @param[in]     n             Maximum amount of data to be transferred.
+ * @param[in]     offset        Absolute file position of the first byte.
+ * @return                      The transferred number of bytes or an error.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline ssize_t vfsFileReadAt(void *ip, uint8_t *buf, size_t n,
+                                    vfs_offset_t offset) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+
+  return self->vmt->pread(ip, buf, n, offset);
+}
+
+/**
+ * @memberof    vfs_file_node_c
+ * @public
+ *
+ * @brief       File node write at an absolute position.
+ * @details     The current file position is not affected.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @param[in]     buf           Pointer to the data buffer.
+ * @param[in]     n             Maximum amount of data to be transferred.
+ * @param[in]     offset        Absolute file position of the first byte.
+ * @return                      The transferred number of bytes or an error.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline ssize_t vfsFileWriteAt(void *ip, const uint8_t *buf, size_t n,
+                                     vfs_offset_t offset) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+
+  return self->vmt->pwrite(ip, buf, n, offset);
+}
+
+/**
+ * @memberof    vfs_file_node_c
+ * @public
+ *
+ * @brief       File node scatter read.
+ * @details     Buffers are filled in order, the operation stops on the
+ *              first short transfer.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @param[in]     iov           Array of buffer descriptors.
+ * @param[in]     iovcnt        Number of elements in the array.
+ * @return                      The transferred number of bytes or an error.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline ssize_t vfsFileReadVector(void *ip, const vfs_iovec_t *iov,
+                                        unsigned iovcnt) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+
+  return self->vmt->readv(ip, iov, iovcnt);
+}
+
+/**
+ * @memberof    vfs_file_node_c
+ * @public
+ *
+ * @brief       File node gather write.
+ * @details     Buffers are written in order, the operation stops on the
+ *              first short transfer.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @param[in]     iov           Array of buffer descriptors.
+ * @param[in]     iovcnt        Number of elements in the array.
+ * @return                      The transferred number of bytes or an error.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline ssize_t vfsFileWriteVector(void *ip, const vfs_iovec_t *iov,
+                                         unsigned iovcnt) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+
+  return self->vmt->writev(ip, iov, iovcnt);
+}
+
+/**
+ * @memberof    vfs_file_node_c
+ * @public
+ *
+ * @brief       File node data transfer to a stream.
+ * @details     Data is moved from the current file position to the stream,
+ *              the file position is advanced by the number of bytes
+ *              accepted by the stream.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @param[in]     stmp          Pointer to the destination stream.
+ * @param[in]     n             Maximum amount of data to be transferred.
+ * @return                      The transferred number of bytes or an error.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline ssize_t vfsFileSplice(void *ip, sequential_stream_i *stmp,
+                                    size_t n) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+
+  return self->vmt->splice(ip, stmp, n);
+}
+
+/**
+ * @memberof    vfs_file_node_c
+ * @public
+ *
+ * @brief       File node data mapping.
+ * @details     Returns the address of a range of the file data in directly
+ *              addressable memory, the mapping remains valid while the file
+ *              node is open and the file is not modified.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @param[in]     offset        Offset of the first byte of the range.
+ * @param[in]     n             Size of the range.
+ * @param[out]    pp            Pointer to the returned address.
+ * @return                      The operation result.
+ * @retval CH_RET_ENOSYS        If the file data cannot be addressed directly.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline msg_t vfsFileGetMapping(void *ip, vfs_offset_t offset, size_t n,
+                                      const uint8_t **pp) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+
+  return self->vmt->getmap(ip, offset, n, pp);
+}
 /** @} */
 
 #endif /* VFSNODES_H */
@@ -69,6 +69,14 @@ void vfsInit(void) {
   __drv_streams_init();
 #endif
 
+#if VFS_CFG_ENABLE_DRV_TMPFS == TRUE
+  __drv_tmpfs_init();
+#endif
+
+#if VFS_CFG_ENABLE_DRV_ROMFS == TRUE
+  __drv_romfs_init();
+#endif
+
 #if VFS_CFG_ENABLE_DRV_CHFS == TRUE
   __drv_chfs_init();
 #endif
@@ -328,6 +336,141 @@ ssize_t vfsWriteFile(vfs_file_node_c *vfnp, const uint8_t *buf, size_t n) {
   return vfsFileWrite((void *)vfnp, buf, n);
 }
 
+/**
+ * @brief   File node read at an absolute position.
+ * @details The function reads data from a file node into a buffer starting
+ *          at the specified position, the current file position is not
+ *          affected.
+ *
+ * @param[in] vfnp      Pointer to the @p vfs_file_node_c object.
+ * @param[out] buf      Pointer to the data buffer.
+ * @param[in] n         Maximum amount of data to be transferred.
+ * @param[in] offset    Absolute file position of the first byte.
+ * @return              The transferred number of bytes or an error.
+ *
+ * @api
+ */
+ssize_t vfsReadFileAt(vfs_file_node_c *vfnp, uint8_t *buf, size_t n,
+                      vfs_offset_t offset) {
+
+  chDbgAssert(vfnp->references > 0U, "zero count");
+
+  return vfsFileReadAt((void *)vfnp, buf, n, offset);
+}
+
+/**
+ * @brief   File node write at an absolute position.
+ * @details The function writes data from a buffer to a file node starting
+ *          at the specified position, the current file position is not
+ *          affected.
+ *
+ * @param[in] vfnp      Pointer to the @p vfs_file_node_c object.
+ * @param[in] buf       Pointer to the data buffer.
+ * @param[in] n         Maximum amount of data to be transferred.
+ * @param[in] offset    Absolute file position of the first byte.
+ * @return              The transferred number of bytes or an error.
+ *
+ * @api
+ */
+ssize_t vfsWriteFileAt(vfs_file_node_c *vfnp, const uint8_t *buf, size_t n,
+                       vfs_offset_t offset) {
+
+  chDbgAssert(vfnp->references > 0U, "zero count");
+
+  return vfsFileWriteAt((void *)vfnp, buf, n, offset);
+}
+
+/**
+ * @brief   File node scatter read.
+ * @details The function reads data from a file node into a list of buffers,
+ *          the operation stops on the first short transfer.
+ *
+ * @param[in] vfnp      Pointer to the @p vfs_file_node_c object.
+ * @param[in] iov       Array of buffer descriptors.
+ * @param[in] iovcnt    Number of elements in the array.
+ * @return              The transferred number of bytes or an error.
+ *
+ * @api
+ */
+ssize_t vfsReadFileVector(vfs_file_node_c *vfnp,
+                          const vfs_iovec_t *iov,
+                          unsigned iovcnt) {
+
+  chDbgAssert(vfnp->references > 0U, "zero count");
+
+  return vfsFileReadVector((void *)vfnp, iov, iovcnt);
+}
+
+/**
+ * @brief   File node gather write.
+ * @details The function writes data from a list of buffers to a file node,
+ *          the operation stops on the first short transfer.
+ *
+ * @param[in] vfnp      Pointer to the @p vfs_file_node_c object.
+ * @param[in] iov       Array of buffer descriptors.
+ * @param[in] iovcnt    Number of elements in the array.
+ * @return              The transferred number of bytes or an error.
+ *
+ * @api
+ */
+ssize_t vfsWriteFileVector(vfs_file_node_c *vfnp,
+                           const vfs_iovec_t *iov,
+                           unsigned iovcnt) {
+
+  chDbgAssert(vfnp->references > 0U, "zero count");
+
+  return vfsFileWriteVector((void *)vfnp, iov, iovcnt);
+}
+
+/**
+ * @brief   File node data transfer to a stream.
+ * @details The function moves data from the current position of a file node
+ *          to a stream without passing through a caller buffer, drivers
+ *          can write directly from their internal buffers.
+ *
+ * @param[in] vfnp      Pointer to the @p vfs_file_node_c object.
+ * @param[in] stmp      Pointer to the destination stream.
+ * @param[in] n         Maximum amount of data to be transferred.
+ * @return              The transferred number of bytes or an error.
+ *
+ * @api
+ */
+ssize_t vfsSpliceFile(vfs_file_node_c *vfnp,
+                      sequential_stream_i *stmp,
+                      size_t n) {
+
+  chDbgAssert(vfnp->references > 0U, "zero count");
+
+  return vfsFileSplice((void *)vfnp, stmp, n);
+}
+
+/**
+ * @brief   Returns the address of a range of a file data.
+ * @details The function succeeds only if the driver stores the file data in
+ *          directly addressable memory, for example a memory-mapped flash,
+ *          the data can then be accessed without reading the file.
+ * @note    The mapping remains valid while the file node is open and the
+ *          file is not modified.
+ *
+ * @param[in] vfnp      Pointer to the @p vfs_file_node_c object.
+ * @param[in] offset    Offset of the first byte of the range.
+ * @param[in] n         Size of the range.
+ * @param[out] pp       Pointer to the returned address.
+ * @return              The operation result.
+ * @retval CH_RET_ENOSYS If the file data cannot be addressed directly.
+ *
+ * @api
+ */
+msg_t vfsGetFileMapping(vfs_file_node_c *vfnp,
+                        vfs_offset_t offset,
+                        size_t n,
+                        const uint8_t **pp) {
+
+  chDbgAssert(vfnp->references > 0U, "zero count");
+
+  return vfsFileGetMapping((void *)vfnp, offset, n, pp);
+}
+
 /**
  * @brief   Changes the current file position.
  *
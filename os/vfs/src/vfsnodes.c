@@ -376,6 +376,270 @@ sequential_stream_i *__vfsfile_getstream_impl(void *ip) {
 
   return NULL;
 }
+
+/**
+ * @memberof    vfs_file_node_c
+ * @protected
+ *
+ * @brief       Implementation of method @p vfsFileReadAt().
+ * @note        This function is meant to be used by derived classes.
+ * @note        The default implementation saves the current position, seeks,
+ *              reads and restores the position, drivers able to access
+ *              data at an arbitrary position should override it.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @param[out]    buf           Pointer to the data buffer.
+ * @param[in]     n             Maximum amount of data to be transferred.
+ * @param[in]     offset        Absolute file position of the first byte.
+ * @return                      The transferred number of bytes or an error.
+ */
+ssize_t __vfsfile_pread_impl(void *ip, uint8_t *buf, size_t n,
+                             vfs_offset_t offset) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+  vfs_offset_t pos;
+  ssize_t ret;
+  msg_t err;
+
+  if (offset < (vfs_offset_t)0) {
+    return CH_RET_EINVAL;
+  }
+
+  pos = vfsFileGetPosition(self);
+  CH_RETURN_ON_ERROR(pos);
+
+  err = vfsFileSetPosition(self, offset, VFS_SEEK_SET);
+  CH_RETURN_ON_ERROR(err);
+
+  ret = vfsFileRead(self, buf, n);
+
+  err = vfsFileSetPosition(self, pos, VFS_SEEK_SET);
+  if (CH_RET_IS_ERROR(err) && !CH_RET_IS_ERROR(ret)) {
+    ret = (ssize_t)err;
+  }
+
+  return ret;
+}
+
+/**
+ * @memberof    vfs_file_node_c
+ * @protected
+ *
+ * @brief       Implementation of method @p vfsFileWriteAt().
+ * @note        This function is meant to be used by derived classes.
+ * @note        The default implementation saves the current position, seeks,
+ *              writes and restores the position, drivers able to access
+ *              data at an arbitrary position should override it.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @param[in]     buf           Pointer to the data buffer.
+ * @param[in]     n             Maximum amount of data to be transferred.
+ * @param[in]     offset        Absolute file position of the first byte.
+ * @return                      The transferred number of bytes or an error.
+ */
+ssize_t __vfsfile_pwrite_impl(void *ip, const uint8_t *buf, size_t n,
+                              vfs_offset_t offset) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+  vfs_offset_t pos;
+  ssize_t ret;
+  msg_t err;
+
+  if (offset < (vfs_offset_t)0) {
+    return CH_RET_EINVAL;
+  }
+
+  pos = vfsFileGetPosition(self);
+  CH_RETURN_ON_ERROR(pos);
+
+  err = vfsFileSetPosition(self, offset, VFS_SEEK_SET);
+  CH_RETURN_ON_ERROR(err);
+
+  ret = vfsFileWrite(self, buf, n);
+
+  err = vfsFileSetPosition(self, pos, VFS_SEEK_SET);
+  if (CH_RET_IS_ERROR(err) && !CH_RET_IS_ERROR(ret)) {
+    ret = (ssize_t)err;
+  }
+
+  return ret;
+}
+
+/**
+ * @memberof    vfs_file_node_c
+ * @protected
+ *
+ * @brief       Implementation of method @p vfsFileReadVector().
+ * @note        This function is meant to be used by derived classes.
+ * @note        The default implementation performs a read for each buffer.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @param[in]     iov           Array of buffer descriptors.
+ * @param[in]     iovcnt        Number of elements in the array.
+ * @return                      The transferred number of bytes or an error.
+ */
+ssize_t __vfsfile_readv_impl(void *ip, const vfs_iovec_t *iov,
+                             unsigned iovcnt) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+  ssize_t total = (ssize_t)0;
+  unsigned i;
+
+  for (i = 0U; i < iovcnt; i++) {
+    ssize_t ret;
+
+    ret = vfsFileRead(self, (uint8_t *)iov[i].base, iov[i].len);
+    if (CH_RET_IS_ERROR(ret)) {
+      return total > (ssize_t)0 ? total : ret;
+    }
+    total += ret;
+    if ((size_t)ret < iov[i].len) {
+      break;
+    }
+  }
+
+  return total;
+}
+
+/**
+ * @memberof    vfs_file_node_c
+ * @protected
+ *
+ * @brief       Implementation of method @p vfsFileWriteVector().
+ * @note        This function is meant to be used by derived classes.
+ * @note        The default implementation performs a write for each buffer.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @param[in]     iov           Array of buffer descriptors.
+ * @param[in]     iovcnt        Number of elements in the array.
+ * @return                      The transferred number of bytes or an error.
+ */
+ssize_t __vfsfile_writev_impl(void *ip, const vfs_iovec_t *iov,
+                              unsigned iovcnt) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+  ssize_t total = (ssize_t)0;
+  unsigned i;
+
+  for (i = 0U; i < iovcnt; i++) {
+    ssize_t ret;
+
+    ret = vfsFileWrite(self, (const uint8_t *)iov[i].base, iov[i].len);
+    if (CH_RET_IS_ERROR(ret)) {
+      return total > (ssize_t)0 ? total : ret;
+    }
+    total += ret;
+    if ((size_t)ret < iov[i].len) {
+      break;
+    }
+  }
+
+  return total;
+}
+
+/**
+ * @memberof    vfs_file_node_c
+ * @protected
+ *
+ * @brief       Implementation of method @p vfsFileSplice().
+ * @note        This function is meant to be used by derived classes.
+ * @note        The default implementation moves data through a VFS shared
+ *              buffer.
+ * @note        If the file position is not available, as for stream nodes,
+ *              then chunks are not aligned and the data not accepted by the
+ *              destination stream on a short write is lost.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @param[in]     stmp          Pointer to the destination stream.
+ * @param[in]     n             Maximum amount of data to be transferred.
+ * @return                      The transferred number of bytes or an error.
+ */
+ssize_t __vfsfile_splice_impl(void *ip, sequential_stream_i *stmp,
+                              size_t n) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+  vfs_shared_buffer_t *shbuf;
+  vfs_offset_t pos;
+  ssize_t ret;
+  size_t done;
+  bool seekable;
+
+  /* Files without a position are transferred in unaligned chunks.*/
+  pos = vfsFileGetPosition(self);
+  seekable = (bool)(pos >= (vfs_offset_t)0);
+  if (!seekable) {
+    pos = (vfs_offset_t)0;
+  }
+
+  shbuf = vfs_buffer_take_wait();
+
+  ret  = (ssize_t)0;
+  done = (size_t)0;
+  while (done < n) {
+    size_t m, nw;
+
+    /* Chunks are aligned to the buffer size, after the first one the
+       driver is asked for whole, aligned, blocks.*/
+    m = VFS_BUFFER_SIZE - (size_t)(pos % (vfs_offset_t)VFS_BUFFER_SIZE);
+    if (m > n - done) {
+      m = n - done;
+    }
+
+    ret = vfsFileRead(self, (uint8_t *)shbuf->buf, m);
+    if (ret <= (ssize_t)0) {
+      break;
+    }
+
+    nw    = stmWrite(stmp, (const uint8_t *)shbuf->buf, (size_t)ret);
+    done += nw;
+    pos  += (vfs_offset_t)nw;
+
+    /* The stream did not accept everything, moving the file position back
+       to the first byte not transferred, if possible.*/
+    if (nw < (size_t)ret) {
+      if (seekable) {
+        ret = (ssize_t)vfsFileSetPosition(self, pos, VFS_SEEK_SET);
+      }
+      break;
+    }
+
+    /* End of file.*/
+    if ((size_t)ret < m) {
+      break;
+    }
+  }
+
+  vfs_buffer_release(shbuf);
+
+  if (CH_RET_IS_ERROR(ret) && (done == (size_t)0)) {
+    return ret;
+  }
+
+  return (ssize_t)done;
+}
+
+/**
+ * @memberof    vfs_file_node_c
+ * @protected
+ *
+ * @brief       Implementation of method @p vfsFileGetMapping().
+ * @note        This function is meant to be used by derived classes.
+ * @note        The default implementation reports that the file data is not
+ *              directly addressable.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @param[in]     offset        Offset of the first byte of the range.
+ * @param[in]     n             Size of the range.
+ * @param[out]    pp            Pointer to the returned address.
+ * @return                      The operation result.
+ * @retval CH_RET_ENOSYS        If the file data cannot be addressed directly.
+ */
+msg_t __vfsfile_getmap_impl(void *ip, vfs_offset_t offset, size_t n,
+                            const uint8_t **pp) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+
+  (void)self;
+  (void)offset;
+  (void)n;
+  (void)pp;
+
+  return CH_RET_ENOSYS;
+}
 /** @} */
 
 /** @} */
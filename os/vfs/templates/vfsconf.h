@@ -79,6 +79,20 @@
 #define VFS_CFG_ENABLE_DRV_STREAMS          TRUE
 #endif
 
+/**
+ * @brief   Enables the VFS RAM FS Driver.
+ */
+#if !defined(VFS_CFG_ENABLE_DRV_TMPFS) || defined(__DOXYGEN__)
+#define VFS_CFG_ENABLE_DRV_TMPFS            FALSE
+#endif
+
+/**
+ * @brief   Enables the VFS ROM FS Driver.
+ */
+#if !defined(VFS_CFG_ENABLE_DRV_ROMFS) || defined(__DOXYGEN__)
+#define VFS_CFG_ENABLE_DRV_ROMFS            FALSE
+#endif
+
 /**
  * @brief   Enables the VFS ChibiFS Driver.
  */
@@ -123,6 +137,13 @@
 #define DRV_CFG_OVERLAY_DIR_NODES_NUM       1
 #endif
 
+/**
+ * @brief   Maximum length of a path in the path-resolution cache.
+ */
+#if !defined(DRV_CFG_OVERLAY_CACHE_PATHLEN_MAX) || defined(__DOXYGEN__)
+#define DRV_CFG_OVERLAY_CACHE_PATHLEN_MAX   63
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -148,6 +169,67 @@
 
 /** @} */
 
+/*===========================================================================*/
+/**
+ * @name RAM FS driver settings
+ * @{
+ */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of directory nodes pre-allocated in the pool.
+ */
+#if !defined(DRV_CFG_TMPFS_DIR_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_TMPFS_DIR_NODES_NUM         1
+#endif
+
+/**
+ * @brief   Number of file nodes pre-allocated in the pool.
+ */
+#if !defined(DRV_CFG_TMPFS_FILE_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_TMPFS_FILE_NODES_NUM        2
+#endif
+
+/**
+ * @brief   Size of the data area of a file extent.
+ */
+#if !defined(DRV_CFG_TMPFS_EXTENT_SIZE) || defined(__DOXYGEN__)
+#define DRV_CFG_TMPFS_EXTENT_SIZE           256
+#endif
+
+/**
+ * @brief   Number of hash buckets in each directory.
+ * @note    Must be a power of two.
+ */
+#if !defined(DRV_CFG_TMPFS_DIR_BUCKETS) || defined(__DOXYGEN__)
+#define DRV_CFG_TMPFS_DIR_BUCKETS           8
+#endif
+
+/** @} */
+
+/*===========================================================================*/
+/**
+ * @name ROM FS driver settings
+ * @{
+ */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of directory nodes pre-allocated in the pool.
+ */
+#if !defined(DRV_CFG_ROMFS_DIR_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_ROMFS_DIR_NODES_NUM         1
+#endif
+
+/**
+ * @brief   Number of file nodes pre-allocated in the pool.
+ */
+#if !defined(DRV_CFG_ROMFS_FILE_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_ROMFS_FILE_NODES_NUM        2
+#endif
+
+/** @} */
+
 /*===========================================================================*/
 /**
  * @name ChibiFS driver settings
@@ -169,6 +251,64 @@
 #define DRV_CFG_CHFS_FILE_NODES_NUM         1
 #endif
 
+/**
+ * @brief   Number of page buffers in the shared pages cache.
+ */
+#if !defined(DRV_CFG_CHFS_CACHE_BUFFERS_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_CACHE_BUFFERS_NUM      2
+#endif
+
+/**
+ * @brief   Size of a ChibiFS page.
+ * @note    Must be a power of two and a divider of the flash sector size.
+ */
+#if !defined(DRV_CFG_CHFS_PAGE_SIZE) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_PAGE_SIZE              256
+#endif
+
+/**
+ * @brief   Flash programming granularity.
+ */
+#if !defined(DRV_CFG_CHFS_PROGRAM_SIZE) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_PROGRAM_SIZE           8
+#endif
+
+/**
+ * @brief   Maximum number of flash blocks in a volume.
+ */
+#if !defined(DRV_CFG_CHFS_MAX_BLOCKS) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_MAX_BLOCKS             64
+#endif
+
+/**
+ * @brief   Maximum number of files and directories in a volume.
+ */
+#if !defined(DRV_CFG_CHFS_MAX_NODES) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_MAX_NODES              32
+#endif
+
+/**
+ * @brief   Size of the in-RAM data chunks index.
+ * @note    Must be a power of two.
+ */
+#if !defined(DRV_CFG_CHFS_MAX_CHUNKS) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_MAX_CHUNKS             512
+#endif
+
+/**
+ * @brief   Pages moved by each incremental garbage collection step.
+ */
+#if !defined(DRV_CFG_CHFS_GC_STEP_PAGES) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_GC_STEP_PAGES          4
+#endif
+
+/**
+ * @brief   Erase cycles difference triggering static wear leveling.
+ */
+#if !defined(DRV_CFG_CHFS_WEAR_DELTA) || defined(__DOXYGEN__)
+#define DRV_CFG_CHFS_WEAR_DELTA             32
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -11,6 +11,8 @@ VFSSRC := $(CHIBIOS)/os/vfs/src/vfspaths.c \
           $(CHIBIOS)/os/vfs/src/vfsnodes.c \
           $(CHIBIOS)/os/vfs/src/vfs.c \
           $(CHIBIOS)/os/vfs/drivers/tmplfs/drvtmplfs.c \
+          $(CHIBIOS)/os/vfs/drivers/tmpfs/drvtmpfs.c \
+          $(CHIBIOS)/os/vfs/drivers/romfs/drvromfs.c \
           $(CHIBIOS)/os/vfs/drivers/chfs/drvchfs.c \
           $(CHIBIOS)/os/vfs/drivers/fatfs/drvfatfs.c \
           $(CHIBIOS)/os/vfs/drivers/littlefs/drvlittlefs.c \
@@ -21,6 +23,8 @@ VFSSRC := $(CHIBIOS)/os/vfs/src/vfspaths.c \
 VFSINC := $(CHIBIOS)/os/common/include \
           $(CHIBIOS)/os/vfs/include \
           $(CHIBIOS)/os/vfs/drivers/tmplfs \
+          $(CHIBIOS)/os/vfs/drivers/tmpfs \
+          $(CHIBIOS)/os/vfs/drivers/romfs \
           $(CHIBIOS)/os/vfs/drivers/chfs \
           $(CHIBIOS)/os/vfs/drivers/fatfs \
           $(CHIBIOS)/os/vfs/drivers/littlefs \
@@ -0,0 +1,6 @@
+# List of all the ChibiOS/VFS ChibiFS test files.
+TESTSRC += ${CHIBIOS}/test/chfs/source/test/chfs_test_root.c \
+           ${CHIBIOS}/test/chfs/source/test/chfs_test_sequence_001.c
+
+# Required include directories
+TESTINC += ${CHIBIOS}/test/chfs/source/test
@@ -0,0 +1,132 @@
+/*
+    ChibiOS - Copyright (C) 2006..2025 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @mainpage Test Suite Specification
+ * Test suite for the ChibiOS/VFS ChibiFS driver. The purpose of this
+ * suite is to verify the file system consistency after simulated power
+ * losses.
+ *
+ * <h2>Test Sequences</h2>
+ * - @subpage chfs_test_sequence_001
+ * .
+ */
+
+/**
+ * @file    chfs_test_root.c
+ * @brief   Test Suite root structures code.
+ */
+
+#include "hal.h"
+#include "chfs_test_root.h"
+
+#if !defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Array of test sequences.
+ */
+const testsequence_t * const chfs_test_suite_array[] = {
+  &chfs_test_sequence_001,
+  NULL
+};
+
+/**
+ * @brief   Test suite root structure.
+ */
+const testsuite_t chfs_test_suite = {
+  "ChibiOS/VFS ChibiFS Test Suite",
+  chfs_test_suite_array
+};
+
+/*===========================================================================*/
+/* Shared code.                                                              */
+/*===========================================================================*/
+
+#include "vfs.h"
+
+#define CHFS_TEST_BYTE(seed, i) ((uint8_t)(((seed) * 31U) + ((i) * 7U)))
+
+vfs_chfs_driver_c chfs1;
+
+static uint8_t chfs_test_buf[64];
+
+/*
+ * Writes a file of n bytes filled with the pattern of the specified seed,
+ * the file is created or truncated.
+ */
+msg_t chfs_test_write_file(const char *path, unsigned seed, size_t n) {
+  vfs_file_node_c *vfnp;
+  size_t i, j, k;
+  ssize_t nw;
+  msg_t ret;
+
+  ret = vfsDrvOpenFile((vfs_driver_c *)&chfs1, path,
+                       VO_WRONLY | VO_CREAT | VO_TRUNC, &vfnp);
+  CH_RETURN_ON_ERROR(ret);
+
+  for (i = 0U; i < n; i += k) {
+    k = n - i;
+    if (k > sizeof chfs_test_buf) {
+      k = sizeof chfs_test_buf;
+    }
+    for (j = 0U; j < k; j++) {
+      chfs_test_buf[j] = CHFS_TEST_BYTE(seed, i + j);
+    }
+    nw = vfsWriteFile(vfnp, chfs_test_buf, k);
+    if (nw != (ssize_t)k) {
+      ret = nw < (ssize_t)0 ? (msg_t)nw : CH_RET_ENOSPC;
+      break;
+    }
+  }
+  vfsClose((vfs_node_c *)vfnp);
+
+  return ret;
+}
+
+/*
+ * Returns the size of a file if its whole content matches the pattern of
+ * the specified seed, CH_RET_EINVAL if it does not match.
+ */
+ssize_t chfs_test_check_file(const char *path, unsigned seed) {
+  vfs_file_node_c *vfnp;
+  size_t i, j;
+  ssize_t nr;
+  msg_t ret;
+
+  ret = vfsDrvOpenFile((vfs_driver_c *)&chfs1, path, VO_RDONLY, &vfnp);
+  CH_RETURN_ON_ERROR(ret);
+
+  i = 0U;
+  do {
+    nr = vfsReadFile(vfnp, chfs_test_buf, sizeof chfs_test_buf);
+    for (j = 0U; j < (size_t)nr; j++) {
+      if (chfs_test_buf[j] != CHFS_TEST_BYTE(seed, i + j)) {
+        nr = (ssize_t)CH_RET_EINVAL;
+        break;
+      }
+    }
+    i += nr > (ssize_t)0 ? (size_t)nr : 0U;
+  } while (nr > (ssize_t)0);
+  vfsClose((vfs_node_c *)vfnp);
+
+  return nr < (ssize_t)0 ? nr : (ssize_t)i;
+}
+
+#endif /* !defined(__DOXYGEN__) */
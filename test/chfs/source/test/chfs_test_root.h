@@ -0,0 +1,60 @@
+/*
+    ChibiOS - Copyright (C) 2006..2025 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    chfs_test_root.h
+ * @brief   Test Suite root structures header.
+ */
+
+#ifndef CHFS_TEST_ROOT_H
+#define CHFS_TEST_ROOT_H
+
+#include "ch_test.h"
+
+#include "chfs_test_sequence_001.h"
+
+#if !defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern const testsuite_t chfs_test_suite;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Shared definitions.                                                       */
+/*===========================================================================*/
+
+#include "vfs.h"
+
+#define TEST_SUITE_NAME "ChibiOS/VFS ChibiFS Test Suite"
+
+extern const chfs_config_t chfscfg1;
+extern vfs_chfs_driver_c chfs1;
+
+msg_t chfs_test_write_file(const char *path, unsigned seed, size_t n);
+ssize_t chfs_test_check_file(const char *path, unsigned seed);
+
+#endif /* !defined(__DOXYGEN__) */
+
+#endif /* CHFS_TEST_ROOT_H */
@@ -0,0 +1,438 @@
+/*
+    ChibiOS - Copyright (C) 2006..2025 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "chfs_test_root.h"
+
+/**
+ * @file    chfs_test_sequence_001.c
+ * @brief   Test Sequence 001 code.
+ *
+ * @page chfs_test_sequence_001 [1] Power loss tests
+ *
+ * File: @ref chfs_test_sequence_001.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the ChibiFS recovery after power losses during
+ * writes, garbage collection and the recovery itself. The simulated
+ * flash device is used, the configuration @p chfscfg1 is required.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage chfs_test_001_001
+ * - @subpage chfs_test_001_002
+ * - @subpage chfs_test_001_003
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+#include "vfs.h"
+
+/* Size of the file rewritten by the tests, it spans several pages.*/
+#define PL_FILE_SIZE        ((3U * CHFS_CHUNK_SIZE) + 40U)
+
+/* Size of the file never modified after its creation.*/
+#define PL_STATIC_SIZE      (24U * CHFS_CHUNK_SIZE)
+
+/* Power losses simulated by each test case.*/
+#define PL_LOSSES           64U
+
+/* Current content of the rewritten file, seed and size.*/
+static unsigned pl_seed;
+static size_t pl_size;
+
+static msg_t pl_start(void) {
+  msg_t ret;
+
+  eflSimSetPowerLoss(&EFLD1, 0U);
+  ret = chfsdrvFormat(&chfs1);
+  if (ret == CH_RET_SUCCESS) {
+    ret = chfsdrvMount(&chfs1);
+  }
+  if (ret == CH_RET_SUCCESS) {
+    ret = chfs_test_write_file("/s", 1000U, PL_STATIC_SIZE);
+  }
+  if (ret == CH_RET_SUCCESS) {
+    pl_seed = 1U;
+    pl_size = PL_FILE_SIZE;
+    ret = chfs_test_write_file("/a", pl_seed, pl_size);
+  }
+
+  return ret;
+}
+
+static msg_t pl_rewrite(void) {
+  msg_t ret;
+
+  /* Closing does not report errors, the power state is checked.*/
+  ret = chfs_test_write_file("/a", pl_seed + 1U, PL_FILE_SIZE);
+  if ((ret == CH_RET_SUCCESS) && !eflSimIsPowerLost(&EFLD1)) {
+    pl_seed++;
+    pl_size = PL_FILE_SIZE;
+  }
+
+  return ret;
+}
+
+static msg_t pl_remount(void) {
+
+  /* Files have been closed, errors are expected because the flash is
+     not accessible until the power is restored.*/
+  (void) chfsdrvUnmount(&chfs1);
+  eflSimPowerCycle(&EFLD1);
+
+  return chfsdrvMount(&chfs1);
+}
+
+/*
+ * Checks the volume after an interrupted rewrite, the file must hold its
+ * previous content or part of the new one, the static file must be
+ * intact.
+ */
+static bool pl_check(void) {
+  ssize_t n;
+
+  if (chfs_test_check_file("/s", 1000U) != (ssize_t)PL_STATIC_SIZE) {
+    return false;
+  }
+
+  n = chfs_test_check_file("/a", pl_seed);
+  if ((n >= (ssize_t)0) && ((size_t)n == pl_size)) {
+    return true;
+  }
+  n = chfs_test_check_file("/a", pl_seed + 1U);
+  if ((n >= (ssize_t)0) && ((size_t)n <= PL_FILE_SIZE)) {
+    pl_seed++;
+    pl_size = (size_t)n;
+    return true;
+  }
+
+  return false;
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page chfs_test_001_001 [1.1] Power loss during writes
+ *
+ * <h2>Description</h2>
+ * A file spanning several pages is rewritten while the power is lost
+ * at each flash operation in turn, after each loss the volume is
+ * mounted again and checked.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.1.1] The volume is formatted and mounted, a static file and the
+ *   file to be rewritten are created.
+ * - [1.1.2] The file is rewritten arming the power loss one operation
+ *   later at each attempt, the sweep restarts when a rewrite
+ *   completes. After each loss the volume is mounted and the file must
+ *   hold its previous content or part of the new content.
+ * - [1.1.3] The file is rewritten without power losses, the new
+ *   content must be read back after a mount.
+ * .
+ */
+
+static void chfs_test_001_001_setup(void) {
+  chfsdrvObjectInit(&chfs1, &chfscfg1);
+}
+
+static void chfs_test_001_001_teardown(void) {
+  eflSimSetPowerLoss(&EFLD1, 0U);
+  (void) chfsdrvUnmount(&chfs1);
+}
+
+static void chfs_test_001_001_execute(void) {
+
+  /* [1.1.1] The volume is formatted and mounted, a static file and the
+     file to be rewritten are created.*/
+  test_set_step(1);
+  {
+    msg_t ret;
+
+    ret = pl_start();
+    test_assert(ret == CH_RET_SUCCESS, "initialization failed");
+  }
+  test_end_step(1);
+
+  /* [1.1.2] The file is rewritten arming the power loss one operation
+     later at each attempt, the sweep restarts when a rewrite
+     completes. After each loss the volume is mounted and the file must
+     hold its previous content or part of the new content.*/
+  test_set_step(2);
+  {
+    unsigned i, ops = 1U;
+    msg_t ret;
+
+    for (i = 0U; i < PL_LOSSES; ) {
+      eflSimSetPowerLoss(&EFLD1, ops);
+      ret = pl_rewrite();
+      if (!eflSimIsPowerLost(&EFLD1)) {
+        eflSimSetPowerLoss(&EFLD1, 0U);
+        test_assert(ret == CH_RET_SUCCESS, "rewrite failed");
+        ops = 1U;
+        continue;
+      }
+      i++;
+      ops++;
+
+      ret = pl_remount();
+      test_assert(ret == CH_RET_SUCCESS, "mount failed");
+      test_assert(pl_check(), "unexpected content");
+    }
+  }
+  test_end_step(2);
+
+  /* [1.1.3] The file is rewritten without power losses, the new
+     content must be read back after a mount.*/
+  test_set_step(3);
+  {
+    msg_t ret;
+
+    ret = pl_rewrite();
+    test_assert(ret == CH_RET_SUCCESS, "rewrite failed");
+    ret = chfsdrvUnmount(&chfs1);
+    test_assert(ret == CH_RET_SUCCESS, "unmount failed");
+    ret = chfsdrvMount(&chfs1);
+    test_assert(ret == CH_RET_SUCCESS, "mount failed");
+    test_assert(pl_check(), "unexpected content");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t chfs_test_001_001 = {
+  "Power loss during writes",
+  chfs_test_001_001_setup,
+  chfs_test_001_001_teardown,
+  chfs_test_001_001_execute
+};
+
+/**
+ * @page chfs_test_001_002 [1.2] Power loss during garbage collection
+ *
+ * <h2>Description</h2>
+ * The volume is filled with obsolete pages and the power is lost at
+ * each flash operation of the background garbage collection in turn,
+ * no data must be lost.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.2.1] The volume is formatted and mounted, a static file and the
+ *   file to be rewritten are created.
+ * - [1.2.2] The file is rewritten several times, obsolete pages are
+ *   spread over all blocks.
+ * - [1.2.3] The file is rewritten then the garbage collector is
+ *   invoked with the power loss armed one operation later at each
+ *   attempt. After each loss the volume is mounted and both files must
+ *   be intact.
+ * .
+ */
+
+static void chfs_test_001_002_setup(void) {
+  chfsdrvObjectInit(&chfs1, &chfscfg1);
+}
+
+static void chfs_test_001_002_teardown(void) {
+  eflSimSetPowerLoss(&EFLD1, 0U);
+  (void) chfsdrvUnmount(&chfs1);
+}
+
+static void chfs_test_001_002_execute(void) {
+
+  /* [1.2.1] The volume is formatted and mounted, a static file and the
+     file to be rewritten are created.*/
+  test_set_step(1);
+  {
+    msg_t ret;
+
+    ret = pl_start();
+    test_assert(ret == CH_RET_SUCCESS, "initialization failed");
+  }
+  test_end_step(1);
+
+  /* [1.2.2] The file is rewritten several times, obsolete pages are
+     spread over all blocks.*/
+  test_set_step(2);
+  {
+    unsigned i;
+    msg_t ret;
+
+    for (i = 0U; i < 32U; i++) {
+      ret = pl_rewrite();
+      test_assert(ret == CH_RET_SUCCESS, "rewrite failed");
+    }
+  }
+  test_end_step(2);
+
+  /* [1.2.3] The file is rewritten then the garbage collector is
+     invoked with the power loss armed one operation later at each
+     attempt. After each loss the volume is mounted and both files must
+     be intact.*/
+  test_set_step(3);
+  {
+    unsigned i, j, n, ops = 1U;
+    msg_t ret;
+
+    for (i = 0U, n = 0U; (i < PL_LOSSES) && (n < 8U * PL_LOSSES); n++) {
+      ret = pl_rewrite();
+      test_assert(ret == CH_RET_SUCCESS, "rewrite failed");
+
+      eflSimSetPowerLoss(&EFLD1, ops);
+      for (j = 0U; (j < 4U) && !eflSimIsPowerLost(&EFLD1); j++) {
+        ret = chfsdrvGarbageCollect(&chfs1);
+      }
+      if (!eflSimIsPowerLost(&EFLD1)) {
+        eflSimSetPowerLoss(&EFLD1, 0U);
+        test_assert(ret == CH_RET_SUCCESS, "garbage collection failed");
+        ops = 1U;
+        continue;
+      }
+      i++;
+      ops++;
+
+      ret = pl_remount();
+      test_assert(ret == CH_RET_SUCCESS, "mount failed");
+      test_assert(pl_check(), "unexpected content");
+      test_assert(pl_size == PL_FILE_SIZE, "file damaged");
+    }
+    test_assert(i == PL_LOSSES, "garbage collector idle");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t chfs_test_001_002 = {
+  "Power loss during garbage collection",
+  chfs_test_001_002_setup,
+  chfs_test_001_002_teardown,
+  chfs_test_001_002_execute
+};
+
+/**
+ * @page chfs_test_001_003 [1.3] Power loss during mount recovery
+ *
+ * <h2>Description</h2>
+ * Mounting does not program the flash, the blocks left dirty by a
+ * power loss are erased and reused by the first writes after the
+ * mount. The power is lost again during those operations.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.3.1] The volume is formatted and mounted, a static file and the
+ *   file to be rewritten are created.
+ * - [1.3.2] The power is lost during a rewrite and the volume is
+ *   mounted, then the power is lost again within the first operations
+ *   of the next rewrite. The volume is checked after each mount.
+ * - [1.3.3] Open files prevent the unmount, CH_RET_EBUSY is expected.
+ *   The unmount succeeds after closing the file.
+ * .
+ */
+
+static void chfs_test_001_003_setup(void) {
+  chfsdrvObjectInit(&chfs1, &chfscfg1);
+}
+
+static void chfs_test_001_003_teardown(void) {
+  eflSimSetPowerLoss(&EFLD1, 0U);
+  (void) chfsdrvUnmount(&chfs1);
+}
+
+static void chfs_test_001_003_execute(void) {
+
+  /* [1.3.1] The volume is formatted and mounted, a static file and the
+     file to be rewritten are created.*/
+  test_set_step(1);
+  {
+    msg_t ret;
+
+    ret = pl_start();
+    test_assert(ret == CH_RET_SUCCESS, "initialization failed");
+  }
+  test_end_step(1);
+
+  /* [1.3.2] The power is lost during a rewrite and the volume is
+     mounted, then the power is lost again within the first operations
+     of the next rewrite. The volume is checked after each mount.*/
+  test_set_step(2);
+  {
+    unsigned i;
+    msg_t ret;
+
+    for (i = 0U; i < PL_LOSSES; i++) {
+      eflSimSetPowerLoss(&EFLD1, (i % 11U) + 1U);
+      (void) pl_rewrite();
+      eflSimSetPowerLoss(&EFLD1, 0U);
+      ret = pl_remount();
+      test_assert(ret == CH_RET_SUCCESS, "mount failed");
+      test_assert(pl_check(), "unexpected content");
+
+      eflSimSetPowerLoss(&EFLD1, (i % 3U) + 1U);
+      (void) pl_rewrite();
+      eflSimSetPowerLoss(&EFLD1, 0U);
+      ret = pl_remount();
+      test_assert(ret == CH_RET_SUCCESS, "mount failed");
+      test_assert(pl_check(), "unexpected content");
+    }
+  }
+  test_end_step(2);
+
+  /* [1.3.3] Open files prevent the unmount, CH_RET_EBUSY is expected.
+     The unmount succeeds after closing the file.*/
+  test_set_step(3);
+  {
+    vfs_file_node_c *vfnp;
+    msg_t ret;
+
+    ret = vfsDrvOpenFile((vfs_driver_c *)&chfs1, "/a", VO_RDONLY, &vfnp);
+    test_assert(ret == CH_RET_SUCCESS, "open failed");
+    ret = chfsdrvUnmount(&chfs1);
+    test_assert(ret == CH_RET_EBUSY, "unmount with open files");
+    vfsClose((vfs_node_c *)vfnp);
+    ret = chfsdrvUnmount(&chfs1);
+    test_assert(ret == CH_RET_SUCCESS, "unmount failed");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t chfs_test_001_003 = {
+  "Power loss during mount recovery",
+  chfs_test_001_003_setup,
+  chfs_test_001_003_teardown,
+  chfs_test_001_003_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const chfs_test_sequence_001_array[] = {
+  &chfs_test_001_001,
+  &chfs_test_001_002,
+  &chfs_test_001_003,
+  NULL
+};
+
+/**
+ * @brief   Power loss tests.
+ */
+const testsequence_t chfs_test_sequence_001 = {
+  "Power loss tests",
+  chfs_test_sequence_001_array
+};
@@ -27,6 +27,7 @@
 #include "mfs_test_sequence_001.h"
 #include "mfs_test_sequence_002.h"
 #include "mfs_test_sequence_003.h"
+#include "mfs_test_sequence_004.h"
 
 #if !defined(__DOXYGEN__)
 
@@ -55,6 +56,7 @@ extern "C" {
 
 extern mfs_nocache_buffer_t __nocache_mfsbuf1;
 extern const MFSConfig mfscfg1;
+extern const MFSConfig mfscfg2;
 extern MFSDriver mfs1;
 extern uint8_t __nocache_mfs_buffer[512];
 extern const uint8_t mfs_pattern16[16];
@@ -37,6 +37,7 @@
  * - @subpage mfs_test_001_005
  * - @subpage mfs_test_001_006
  * - @subpage mfs_test_001_007
+ * - @subpage mfs_test_001_008
  * .
  */
 
@@ -805,6 +806,120 @@ static const testcase_t mfs_test_001_007 = {
   mfs_test_001_007_execute
 };
 
+/**
+ * @page mfs_test_001_008 [1.8] Testing an erase marker filling the bank
+ *
+ * <h2>Description</h2>
+ * Records are erased until the last erase marker fills the bank
+ * entirely, the records state is checked after a reinitialization.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.8.1] Filling up the storage by writing records with increasing
+ *   IDs, MFS_NO_ERROR is expected.
+ * - [1.8.2] Erasing records until the flash bank is filled entirely,
+ *   the last erase marker must end exactly at the bank end.
+ * - [1.8.3] Reinitializing, the erased records must not be found and
+ *   the other records must be intact, MFS_NO_ERROR is expected.
+ * .
+ */
+
+static void mfs_test_001_008_setup(void) {
+  mfsStart(&mfs1, &mfscfg1);
+  mfsErase(&mfs1);
+}
+
+static void mfs_test_001_008_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_001_008_execute(void) {
+
+  /* [1.8.1] Filling up the storage by writing records with increasing
+     IDs, MFS_NO_ERROR is expected.*/
+  test_set_step(1);
+  {
+    mfs_id_t id;
+    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+                                            sizeof (mfs_data_header_t))) /
+                      (sizeof (mfs_data_header_t) + (sizeof mfs_pattern512 / 4));
+
+    for (id = 1; id <= id_max; id++) {
+      mfs_error_t err;
+
+      err = mfsWriteRecord(&mfs1, id, (sizeof mfs_pattern512 / 4), mfs_pattern512);
+      test_assert(err == MFS_NO_ERROR, "error creating the record");
+    }
+  }
+  test_end_step(1);
+
+  /* [1.8.2] Erasing records until the flash bank is filled entirely,
+     the last erase marker must end exactly at the bank end.*/
+  test_set_step(2);
+  {
+    mfs_error_t err;
+    mfs_id_t id;
+    size_t remaining;
+    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+                                            sizeof (mfs_data_header_t))) /
+                      (sizeof (mfs_data_header_t) + (sizeof mfs_pattern512 / 4));
+    mfs_id_t n = ((mfscfg1.bank_size - sizeof (mfs_bank_header_t)) -
+                  (id_max * (sizeof (mfs_data_header_t) + (sizeof mfs_pattern512 / 4)))) /
+                 sizeof (mfs_data_header_t);
+
+    for (id = 1; id <= n; id++) {
+      err = mfsEraseRecord(&mfs1, id);
+      test_assert(err == MFS_NO_ERROR, "error erasing the record");
+    }
+
+    remaining = (size_t)flashGetSectorOffset(mfscfg1.flashp, mfscfg1.bank0_start) +
+                (size_t)mfscfg1.bank_size - (size_t)mfs1.next_offset;
+    test_assert(remaining == 0U, "remaining space not zero");
+  }
+  test_end_step(2);
+
+  /* [1.8.3] Reinitializing, the erased records must not be found and
+     the other records must be intact, MFS_NO_ERROR is expected.*/
+  test_set_step(3);
+  {
+    mfs_error_t err;
+    mfs_id_t id;
+    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+                                            sizeof (mfs_data_header_t))) /
+                      (sizeof (mfs_data_header_t) + (sizeof mfs_pattern512 / 4));
+    mfs_id_t n = ((mfscfg1.bank_size - sizeof (mfs_bank_header_t)) -
+                  (id_max * (sizeof (mfs_data_header_t) + (sizeof mfs_pattern512 / 4)))) /
+                 sizeof (mfs_data_header_t);
+
+    mfsStop(&mfs1);
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "initialization error");
+
+    for (id = 1; id <= id_max; id++) {
+      size_t size;
+
+      size = sizeof __nocache_mfs_buffer;
+      err = mfsReadRecord(&mfs1, id, &size, __nocache_mfs_buffer);
+      if (id <= n) {
+        test_assert(err == MFS_ERR_NOT_FOUND, "erased record found");
+      }
+      else {
+        test_assert(err == MFS_NO_ERROR, "record not found");
+        test_assert(size == (sizeof mfs_pattern512 / 4), "unexpected record length");
+        test_assert(memcmp(mfs_pattern512, __nocache_mfs_buffer, size) == 0,
+                    "wrong record content");
+      }
+    }
+  }
+  test_end_step(3);
+}
+
+static const testcase_t mfs_test_001_008 = {
+  "Testing an erase marker filling the bank",
+  mfs_test_001_008_setup,
+  mfs_test_001_008_teardown,
+  mfs_test_001_008_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -820,6 +935,7 @@ const testcase_t * const mfs_test_sequence_001_array[] = {
   &mfs_test_001_005,
   &mfs_test_001_006,
   &mfs_test_001_007,
+  &mfs_test_001_008,
   NULL
 };
 
@@ -0,0 +1,799 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "mfs_test_root.h"
+
+/**
+ * @file    mfs_test_sequence_004.c
+ * @brief   Test Sequence 004 code.
+ *
+ * @page mfs_test_sequence_004 [4] Multi-bank tests
+ *
+ * File: @ref mfs_test_sequence_004.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the MFS behavior when the storage is a ring of
+ * banks, the configuration @p mfscfg2 is used. Flash operations go
+ * through a wrapper of the configured flash device able to simulate
+ * power losses and damaged flash cells.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - MFS_CFG_MULTI_BANK == TRUE
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage mfs_test_004_001
+ * - @subpage mfs_test_004_002
+ * - @subpage mfs_test_004_003
+ * - @subpage mfs_test_004_004
+ * .
+ */
+
+#if (MFS_CFG_MULTI_BANK == TRUE) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+#include "hal_mfs.h"
+
+#define MB_RECORDS          8U
+#define MB_RECORD_SIZE      60U
+
+/* Flash operations allowed before the power loss, negative if the power
+   is never lost.*/
+static int32_t mb_ops;
+static bool mb_lost;
+
+/* Offset of a damaged byte or zero, reads return it inverted until its
+   sector is erased.*/
+static flash_offset_t mb_damaged;
+
+/* Offset of the data of the last written index checkpoint.*/
+static flash_offset_t mb_ckpt_offset;
+
+/* Total number of bytes read.*/
+static uint32_t mb_read_bytes;
+
+/* Expected generation of each record, zero if the record is erased.*/
+static uint8_t mb_gen[MB_RECORDS + 1U];
+static uint8_t mb_buffer[MB_RECORD_SIZE];
+
+static bool mb_power_lost(void) {
+
+  if (!mb_lost && (mb_ops >= 0)) {
+    if (mb_ops == 0) {
+      mb_lost = true;
+    }
+    else {
+      mb_ops--;
+    }
+  }
+
+  return mb_lost;
+}
+
+static const flash_descriptor_t *mb_get_descriptor(void *instance) {
+
+  (void)instance;
+
+  return flashGetDescriptor(mfscfg2.flashp);
+}
+
+static flash_error_t mb_read(void *instance, flash_offset_t offset,
+                             size_t n, uint8_t *rp) {
+  flash_error_t ferr;
+
+  (void)instance;
+
+  mb_read_bytes += (uint32_t)n;
+  ferr = flashRead(mfscfg2.flashp, offset, n, rp);
+  if ((ferr == FLASH_NO_ERROR) && (mb_damaged != 0U) &&
+      (mb_damaged >= offset) && (mb_damaged - offset < n)) {
+    rp[mb_damaged - offset] ^= 0xFFU;
+  }
+
+  return ferr;
+}
+
+static flash_error_t mb_program(void *instance, flash_offset_t offset,
+                                size_t n, const uint8_t *pp) {
+
+  (void)instance;
+
+  if (mb_power_lost()) {
+    return FLASH_ERROR_PROGRAM;
+  }
+
+  /* Checkpoints data is the only write with this size.*/
+  if (n == sizeof mfs1.descriptors) {
+    mb_ckpt_offset = offset;
+  }
+
+  return flashProgram(mfscfg2.flashp, offset, n, pp);
+}
+
+static flash_error_t mb_start_erase_all(void *instance) {
+
+  (void)instance;
+
+  if (mb_power_lost()) {
+    return FLASH_ERROR_ERASE;
+  }
+
+  mb_damaged = 0U;
+
+  return flashStartEraseAll(mfscfg2.flashp);
+}
+
+static flash_error_t mb_start_erase_sector(void *instance,
+                                           flash_sector_t sector) {
+  flash_offset_t offset;
+
+  (void)instance;
+
+  if (mb_power_lost()) {
+    return FLASH_ERROR_ERASE;
+  }
+
+  offset = flashGetSectorOffset(mfscfg2.flashp, sector);
+  if ((mb_damaged >= offset) &&
+      (mb_damaged - offset < flashGetSectorSize(mfscfg2.flashp, sector))) {
+    mb_damaged = 0U;
+  }
+
+  return flashStartEraseSector(mfscfg2.flashp, sector);
+}
+
+static flash_error_t mb_query_erase(void *instance, uint32_t *msec) {
+
+  (void)instance;
+
+  return flashQueryErase(mfscfg2.flashp, msec);
+}
+
+static flash_error_t mb_verify_erase(void *instance, flash_sector_t sector) {
+
+  (void)instance;
+
+  return flashVerifyErase(mfscfg2.flashp, sector);
+}
+
+static flash_error_t mb_acquire_exclusive(void *instance) {
+
+  (void)instance;
+
+  return flashAcquireExclusive(mfscfg2.flashp);
+}
+
+static flash_error_t mb_release_exclusive(void *instance) {
+
+  (void)instance;
+
+  return flashReleaseExclusive(mfscfg2.flashp);
+}
+
+static const struct BaseFlashVMT mb_vmt = {
+  (size_t)0,
+  mb_get_descriptor,
+  mb_read,
+  mb_program,
+  mb_start_erase_all,
+  mb_start_erase_sector,
+  mb_query_erase,
+  mb_verify_erase,
+  mb_acquire_exclusive,
+  mb_release_exclusive
+};
+
+static BaseFlash mb_flash = {&mb_vmt, FLASH_READY};
+
+/* Copy of mfscfg2 using the wrapper.*/
+static MFSConfig mb_cfg;
+
+static void mb_start(void) {
+
+  mb_cfg        = mfscfg2;
+  mb_cfg.flashp = &mb_flash;
+  mb_ops        = -1;
+  mb_lost       = false;
+  mb_damaged    = 0U;
+  memset(mb_gen, 0, sizeof mb_gen);
+
+  mfsStart(&mfs1, &mb_cfg);
+  mfsErase(&mfs1);
+}
+
+static void mb_fill(mfs_id_t id, uint8_t gen) {
+
+  memcpy(mb_buffer, mfs_pattern512, sizeof mb_buffer);
+  mb_buffer[0] = (uint8_t)id;
+  mb_buffer[1] = gen;
+}
+
+static mfs_error_t mb_write(mfs_id_t id, uint8_t gen) {
+
+  mb_fill(id, gen);
+
+  return mfsWriteRecord(&mfs1, id, sizeof mb_buffer, mb_buffer);
+}
+
+static mfs_error_t mb_update(mfs_id_t id) {
+  mfs_error_t err;
+
+  err = mb_write(id, (uint8_t)(mb_gen[id] + 1U));
+  if (!MFS_IS_ERROR(err)) {
+    mb_gen[id]++;
+  }
+
+  return err;
+}
+
+/* Generation of a record, zero if not found or -1 if not valid.*/
+static int mb_read_gen(mfs_id_t id) {
+  mfs_error_t err;
+  size_t size;
+
+  size = sizeof __nocache_mfs_buffer;
+  err = mfsReadRecord(&mfs1, id, &size, __nocache_mfs_buffer);
+  if (err == MFS_ERR_NOT_FOUND) {
+    return 0;
+  }
+  if ((err != MFS_NO_ERROR) || (size != sizeof mb_buffer)) {
+    return -1;
+  }
+  mb_fill(id, __nocache_mfs_buffer[1]);
+  if (memcmp(mb_buffer, __nocache_mfs_buffer, size) != 0) {
+    return -1;
+  }
+
+  return (int)__nocache_mfs_buffer[1];
+}
+
+static bool mb_check(void) {
+  mfs_id_t id;
+
+  for (id = 1U; id <= MB_RECORDS; id++) {
+    if (mb_read_gen(id) != (int)mb_gen[id]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/* Erases the storage and performs the first n writes of a sequence.*/
+static mfs_error_t mb_replay(unsigned n) {
+  unsigned i;
+
+  memset(mb_gen, 0, sizeof mb_gen);
+  if (mfsErase(&mfs1) != MFS_NO_ERROR) {
+    return MFS_ERR_INTERNAL;
+  }
+  for (i = 0U; i < n; i++) {
+    mfs_error_t err = mb_update((mfs_id_t)((i % MB_RECORDS) + 1U));
+    if (MFS_IS_ERROR(err)) {
+      return err;
+    }
+  }
+
+  return MFS_NO_ERROR;
+}
+
+/* Restores the power and mounts the storage again.*/
+static mfs_error_t mb_power_on(void) {
+
+  mb_ops  = -1;
+  mb_lost = false;
+
+  return mfsStart(&mfs1, &mb_cfg);
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page mfs_test_004_001 [4.1] Mounting from an index checkpoint
+ *
+ * <h2>Description</h2>
+ * Records are written until index checkpoints are taken, the storage
+ * is mounted again and only the records following the last checkpoint
+ * must be scanned.
+ *
+ * <h2>Test Steps</h2>
+ * - [4.1.1] Records are updated until three index checkpoints have
+ *   been taken, MFS_NO_ERROR is expected.
+ * - [4.1.2] The storage is mounted again, MFS_NO_ERROR is expected,
+ *   the records data preceding the checkpoint must not be read.
+ * - [4.1.3] Records content is verified.
+ * .
+ */
+
+static void mfs_test_004_001_setup(void) {
+  mb_start();
+}
+
+static void mfs_test_004_001_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_004_001_execute(void) {
+  flash_offset_t next_offset;
+  uint32_t used_space;
+
+  /* [4.1.1] Records are updated until three index checkpoints have
+     been taken, MFS_NO_ERROR is expected.*/
+  test_set_step(1);
+  {
+    unsigned i;
+
+    for (i = 0U; i < 3U * (unsigned)MFS_CFG_CHECKPOINT_INTERVAL; i++) {
+      mfs_error_t err;
+
+      err = mb_update((mfs_id_t)((i % MB_RECORDS) + 1U));
+      test_assert(err == MFS_NO_ERROR, "error updating the record");
+    }
+    test_assert(mfs1.ckpt_records == 0U, "checkpoint not taken");
+
+    /* Saving some internal state for successive checks.*/
+    next_offset = mfs1.next_offset;
+    used_space  = mfs1.used_space;
+  }
+  test_end_step(1);
+
+  /* [4.1.2] The storage is mounted again, MFS_NO_ERROR is expected,
+     the records data preceding the checkpoint must not be read.*/
+  test_set_step(2);
+  {
+    mfs_error_t err;
+
+    mb_read_bytes = 0U;
+    err = mfsStart(&mfs1, &mb_cfg);
+    test_assert(err == MFS_NO_ERROR, "re-start failed");
+    test_assert(mb_read_bytes < 3U * (uint32_t)MFS_CFG_CHECKPOINT_INTERVAL *
+                                MB_RECORD_SIZE, "records scanned");
+    test_assert(next_offset == mfs1.next_offset, "internal data mismatch");
+    test_assert(used_space == mfs1.used_space, "internal data mismatch");
+  }
+  test_end_step(2);
+
+  /* [4.1.3] Records content is verified.*/
+  test_set_step(3);
+  {
+    test_assert(mb_check(), "wrong record content");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t mfs_test_004_001 = {
+  "Mounting from an index checkpoint",
+  mfs_test_004_001_setup,
+  mfs_test_004_001_teardown,
+  mfs_test_004_001_execute
+};
+
+/**
+ * @page mfs_test_004_002 [4.2] Mounting with a damaged index checkpoint
+ *
+ * <h2>Description</h2>
+ * The data of the last index checkpoint is damaged, the storage must
+ * be mounted by scanning all records and then repaired.
+ *
+ * <h2>Test Steps</h2>
+ * - [4.2.1] Records are updated until two index checkpoints have been
+ *   taken, MFS_NO_ERROR is expected.
+ * - [4.2.2] Damaging the data of the last checkpoint.
+ * - [4.2.3] The storage is mounted again, MFS_WARN_REPAIR is expected
+ *   and the records must be intact.
+ * - [4.2.4] The storage is mounted again, MFS_NO_ERROR is expected
+ *   and the records must be intact.
+ * .
+ */
+
+static void mfs_test_004_002_setup(void) {
+  mb_start();
+}
+
+static void mfs_test_004_002_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_004_002_execute(void) {
+
+  /* [4.2.1] Records are updated until two index checkpoints have been
+     taken, MFS_NO_ERROR is expected.*/
+  test_set_step(1);
+  {
+    unsigned i;
+
+    for (i = 0U; i < 2U * (unsigned)MFS_CFG_CHECKPOINT_INTERVAL; i++) {
+      mfs_error_t err;
+
+      err = mb_update((mfs_id_t)((i % MB_RECORDS) + 1U));
+      test_assert(err == MFS_NO_ERROR, "error updating the record");
+    }
+    test_assert(mfs1.ckpt_records == 0U, "checkpoint not taken");
+  }
+  test_end_step(1);
+
+  /* [4.2.2] Damaging the data of the last checkpoint.*/
+  test_set_step(2);
+  {
+    mb_damaged = mb_ckpt_offset;
+  }
+  test_end_step(2);
+
+  /* [4.2.3] The storage is mounted again, MFS_WARN_REPAIR is expected
+     and the records must be intact.*/
+  test_set_step(3);
+  {
+    mfs_error_t err;
+
+    err = mfsStart(&mfs1, &mb_cfg);
+    test_assert(err == MFS_WARN_REPAIR, "damage not detected");
+    test_assert(mb_check(), "wrong record content");
+  }
+  test_end_step(3);
+
+  /* [4.2.4] The storage is mounted again, MFS_NO_ERROR is expected
+     and the records must be intact.*/
+  test_set_step(4);
+  {
+    mfs_error_t err;
+
+    err = mfsStart(&mfs1, &mb_cfg);
+    test_assert(err == MFS_NO_ERROR, "storage not repaired");
+    test_assert(mb_check(), "wrong record content");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t mfs_test_004_002 = {
+  "Mounting with a damaged index checkpoint",
+  mfs_test_004_002_setup,
+  mfs_test_004_002_teardown,
+  mfs_test_004_002_execute
+};
+
+/**
+ * @page mfs_test_004_003 [4.3] Power loss during a bank rotation
+ *
+ * <h2>Description</h2>
+ * Power losses are simulated during the writes that rotate the current
+ * bank and reclaim the previous one, the storage must be consistent
+ * after each loss.
+ *
+ * <h2>Test Steps</h2>
+ * - [4.3.1] Records are updated until the current bank is rotated and
+ *   the previous bank is completely reclaimed, the writes involved are
+ *   recorded.
+ * - [4.3.2] The writes are repeated losing the power at each one of
+ *   their flash operations, after each loss the storage is mounted
+ *   again, the record being written must hold either the old or the
+ *   new value and all other records must be intact.
+ * .
+ */
+
+static void mfs_test_004_003_setup(void) {
+  mb_start();
+}
+
+static void mfs_test_004_003_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_004_003_execute(void) {
+  unsigned rotate_at, reclaim_end;
+
+  /* [4.3.1] Records are updated until the current bank is rotated and
+     the previous bank is completely reclaimed, the writes involved are
+     recorded.*/
+  test_set_step(1);
+  {
+    mfs_bank_t bank = mfs1.current_bank;
+    unsigned i = 0U;
+
+    while (mfs1.current_bank == bank) {
+      mfs_error_t err;
+
+      test_assert(i < 1000U, "bank not rotated");
+      err = mb_update((mfs_id_t)((i % MB_RECORDS) + 1U));
+      test_assert(!MFS_IS_ERROR(err), "error updating the record");
+      i++;
+    }
+    rotate_at = i - 1U;
+
+    while (mfs1.gc_bank != mfs1.current_bank) {
+      mfs_error_t err;
+
+      test_assert(i < 1000U, "bank not reclaimed");
+      err = mb_update((mfs_id_t)((i % MB_RECORDS) + 1U));
+      test_assert(!MFS_IS_ERROR(err), "error updating the record");
+      i++;
+    }
+    reclaim_end = i;
+  }
+  test_end_step(1);
+
+  /* [4.3.2] The writes are repeated losing the power at each one of
+     their flash operations, after each loss the storage is mounted
+     again, the record being written must hold either the old or the
+     new value and all other records must be intact.*/
+  test_set_step(2);
+  {
+    int32_t ops = 0;
+    bool lost;
+
+    do {
+      mfs_error_t err;
+      mfs_id_t id = 0U;
+      unsigned i;
+
+      err = mb_replay(rotate_at);
+      test_assert(!MFS_IS_ERROR(err), "error updating the record");
+
+      mb_ops = ops;
+      for (i = rotate_at; i < reclaim_end; i++) {
+        id = (mfs_id_t)((i % MB_RECORDS) + 1U);
+        err = mb_update(id);
+        if (mb_lost) {
+          break;
+        }
+        test_assert(!MFS_IS_ERROR(err), "error updating the record");
+      }
+      lost = mb_lost;
+
+      /* The record being written must hold either the old or the new
+         value, all other records must be intact.*/
+      err = mb_power_on();
+      test_assert(!MFS_IS_ERROR(err), "re-start failed after power loss");
+      if (mb_read_gen(id) == (int)mb_gen[id] + 1) {
+        mb_gen[id]++;
+      }
+      test_assert(mb_check(), "wrong record content after power loss");
+      err = mfsStart(&mfs1, &mb_cfg);
+      test_assert(err == MFS_NO_ERROR, "storage not repaired");
+      ops++;
+    } while (lost);
+  }
+  test_end_step(2);
+}
+
+static const testcase_t mfs_test_004_003 = {
+  "Power loss during a bank rotation",
+  mfs_test_004_003_setup,
+  mfs_test_004_003_teardown,
+  mfs_test_004_003_execute
+};
+
+/**
+ * @page mfs_test_004_004 [4.4] Transactions in multi-bank mode
+ *
+ * <h2>Description</h2>
+ * Transactions are committed and rolled back, one of them requires a
+ * bank rotation. Power losses are simulated during a commit.
+ *
+ * <h2>Test Steps</h2>
+ * - [4.4.1] All records are created, MFS_NO_ERROR is expected.
+ * - [4.4.2] Records are updated within a transaction then the
+ *   transaction is committed, the records must hold the new values
+ *   also after mounting the storage again.
+ * - [4.4.3] Records are updated within a transaction then the
+ *   transaction is rolled back, the records must hold the old values
+ *   also after mounting the storage again.
+ * - [4.4.4] Records are updated until a transaction does not fit in
+ *   the current bank, starting the transaction rotates the bank, the
+ *   committed records must hold the new values also after mounting the
+ *   storage again.
+ * - [4.4.5] A transaction is committed losing the power at each one of
+ *   its flash operations, after each loss the storage is mounted
+ *   again, either all or none of the transaction records must hold the
+ *   new values.
+ * .
+ */
+
+static void mfs_test_004_004_setup(void) {
+  mb_start();
+}
+
+static void mfs_test_004_004_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_004_004_execute(void) {
+
+  /* [4.4.1] All records are created, MFS_NO_ERROR is expected.*/
+  test_set_step(1);
+  {
+    mfs_id_t id;
+
+    for (id = 1U; id <= MB_RECORDS; id++) {
+      mfs_error_t err;
+
+      err = mb_update(id);
+      test_assert(err == MFS_NO_ERROR, "error creating the record");
+    }
+  }
+  test_end_step(1);
+
+  /* [4.4.2] Records are updated within a transaction then the
+     transaction is committed, the records must hold the new values
+     also after mounting the storage again.*/
+  test_set_step(2);
+  {
+    mfs_error_t err;
+
+    err = mfsStartTransaction(&mfs1, 512U);
+    test_assert(err == MFS_NO_ERROR, "error starting transaction");
+    err = mb_write(1U, (uint8_t)(mb_gen[1] + 1U));
+    test_assert(err == MFS_NO_ERROR, "error writing record 1");
+    err = mb_write(2U, (uint8_t)(mb_gen[2] + 1U));
+    test_assert(err == MFS_NO_ERROR, "error writing record 2");
+    err = mfsEraseRecord(&mfs1, 3U);
+    test_assert(err == MFS_NO_ERROR, "error erasing record 3");
+    err = mfsCommitTransaction(&mfs1);
+    test_assert(err == MFS_NO_ERROR, "error committing transaction");
+    mb_gen[1]++;
+    mb_gen[2]++;
+    mb_gen[3] = 0U;
+    test_assert(mb_check(), "wrong record content");
+
+    err = mfsStart(&mfs1, &mb_cfg);
+    test_assert(err == MFS_NO_ERROR, "re-start failed");
+    test_assert(mb_check(), "wrong record content");
+  }
+  test_end_step(2);
+
+  /* [4.4.3] Records are updated within a transaction then the
+     transaction is rolled back, the records must hold the old values
+     also after mounting the storage again.*/
+  test_set_step(3);
+  {
+    mfs_error_t err;
+
+    err = mfsStartTransaction(&mfs1, 512U);
+    test_assert(err == MFS_NO_ERROR, "error starting transaction");
+    err = mb_write(4U, (uint8_t)(mb_gen[4] + 1U));
+    test_assert(err == MFS_NO_ERROR, "error writing record 4");
+    err = mfsEraseRecord(&mfs1, 5U);
+    test_assert(err == MFS_NO_ERROR, "error erasing record 5");
+    err = mfsRollbackTransaction(&mfs1);
+    test_assert(err == MFS_NO_ERROR, "error rolling back transaction");
+    test_assert(mb_check(), "wrong record content");
+
+    err = mfsStart(&mfs1, &mb_cfg);
+    test_assert(err == MFS_NO_ERROR, "re-start failed");
+    test_assert(mb_check(), "wrong record content");
+  }
+  test_end_step(3);
+
+  /* [4.4.4] Records are updated until a transaction does not fit in
+     the current bank, starting the transaction rotates the bank, the
+     committed records must hold the new values also after mounting the
+     storage again.*/
+  test_set_step(4);
+  {
+    mfs_error_t err;
+    mfs_bank_t bank = mfs1.current_bank;
+    flash_offset_t end = flashGetSectorOffset(mfscfg2.flashp,
+                                              mfscfg2.bank0_start +
+                                              (bank * mfscfg2.bank0_sectors)) +
+                         mfscfg2.bank_size;
+    unsigned i = 0U;
+
+    while (mfs1.next_offset + 1024U <= end) {
+      test_assert(mfs1.current_bank == bank, "unexpected bank rotation");
+      err = mb_update((mfs_id_t)((i % MB_RECORDS) + 1U));
+      test_assert(err == MFS_NO_ERROR, "error updating the record");
+      i++;
+    }
+
+    err = mfsStartTransaction(&mfs1, 1024U);
+    test_assert(err == MFS_NO_ERROR, "error starting transaction");
+    test_assert(mfs1.current_bank != bank, "bank not rotated");
+    err = mb_write(6U, (uint8_t)(mb_gen[6] + 1U));
+    test_assert(err == MFS_NO_ERROR, "error writing record 6");
+    err = mb_write(7U, (uint8_t)(mb_gen[7] + 1U));
+    test_assert(err == MFS_NO_ERROR, "error writing record 7");
+    err = mfsCommitTransaction(&mfs1);
+    test_assert(err == MFS_NO_ERROR, "error committing transaction");
+    mb_gen[6]++;
+    mb_gen[7]++;
+    test_assert(mb_check(), "wrong record content");
+
+    err = mfsStart(&mfs1, &mb_cfg);
+    test_assert(err == MFS_NO_ERROR, "re-start failed");
+    test_assert(mb_check(), "wrong record content");
+  }
+  test_end_step(4);
+
+  /* [4.4.5] A transaction is committed losing the power at each one of
+     its flash operations, after each loss the storage is mounted
+     again, either all or none of the transaction records must hold the
+     new values.*/
+  test_set_step(5);
+  {
+    int32_t ops = 0;
+    bool lost;
+
+    do {
+      mfs_error_t err;
+      mfs_id_t id;
+
+      err = mb_replay(MB_RECORDS);
+      test_assert(err == MFS_NO_ERROR, "error creating the record");
+
+      err = mfsStartTransaction(&mfs1, 512U);
+      test_assert(err == MFS_NO_ERROR, "error starting transaction");
+      for (id = 1U; id <= 4U; id++) {
+        err = mb_write(id, (uint8_t)(mb_gen[id] + 1U));
+        test_assert(err == MFS_NO_ERROR, "error writing the record");
+      }
+      mb_ops = ops;
+      (void)mfsCommitTransaction(&mfs1);
+      lost = mb_lost;
+
+      /* All records of the transaction have the same generation.*/
+      err = mb_power_on();
+      test_assert(!MFS_IS_ERROR(err), "re-start failed after power loss");
+      if (mb_read_gen(1U) == (int)mb_gen[1] + 1) {
+        for (id = 1U; id <= 4U; id++) {
+          mb_gen[id]++;
+        }
+      }
+      test_assert(mb_check(), "partial transaction after power loss");
+      ops++;
+    } while (lost);
+  }
+  test_end_step(5);
+}
+
+static const testcase_t mfs_test_004_004 = {
+  "Transactions in multi-bank mode",
+  mfs_test_004_004_setup,
+  mfs_test_004_004_teardown,
+  mfs_test_004_004_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const mfs_test_sequence_004_array[] = {
+  &mfs_test_004_001,
+  &mfs_test_004_002,
+  &mfs_test_004_003,
+  &mfs_test_004_004,
+  NULL
+};
+
+/**
+ * @brief   Multi-bank tests.
+ */
+const testsequence_t mfs_test_sequence_004 = {
+  "Multi-bank tests",
+  mfs_test_sequence_004_array
+};
+
+#endif /* MFS_CFG_MULTI_BANK == TRUE */
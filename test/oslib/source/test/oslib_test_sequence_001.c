@@ -192,6 +192,9 @@ static void oslib_test_001_003_execute(void) {
     test_print("--- CH_CFG_USE_DELEGATES:               ");
     test_printn(CH_CFG_USE_DELEGATES);
     test_println("");
+    test_print("--- CH_CFG_USE_MSG_PORTS:               ");
+    test_printn(CH_CFG_USE_MSG_PORTS);
+    test_println("");
     test_print("--- CH_CFG_USE_FACTORY:                 ");
     test_printn(CH_CFG_USE_FACTORY);
     test_println("");
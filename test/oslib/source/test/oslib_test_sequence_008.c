@@ -38,6 +38,7 @@
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_008_001
  * - @subpage oslib_test_008_002
+ * - @subpage oslib_test_008_003
  * .
  */
 
@@ -296,6 +297,131 @@ static const testcase_t oslib_test_008_002 = {
   oslib_test_008_002_execute
 };
 
+/**
+ * @page oslib_test_008_003 [8.3] Reallocation
+ *
+ * <h2>Description</h2>
+ * Blocks are resized using chHeapRealloc(), growing and shrinking in
+ * place are tested first then a block is grown while the adjacent space
+ * is allocated so it must be moved. The test expects to find the heap
+ * back to the initial status at the end.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.3.1] Testing initial conditions, the heap must not be fragmented
+ *   and one free block present.
+ * - [8.3.2] Growing a block, the adjacent free space is absorbed so the
+ *   block must not move, finally, integrity is checked.
+ * - [8.3.3] Shrinking the block, the excess is returned to the heap and
+ *   merged with the adjacent free space, finally, integrity is checked.
+ * - [8.3.4] Growing a block followed by an allocated block, the block
+ *   must be moved and its content preserved, finally, integrity is
+ *   checked.
+ * - [8.3.5] Growing a block beyond the available space, an error is
+ *   expected and the block must be left untouched, finally, integrity
+ *   is checked.
+ * - [8.3.6] Testing final conditions. The heap geometry must be the
+ *   same than the one registered at beginning, finally, integrity is
+ *   checked.
+ * .
+ */
+
+static void oslib_test_008_003_setup(void) {
+  chHeapObjectInit(&test_heap, test_heap_buffer, sizeof(test_heap_buffer));
+}
+
+static void oslib_test_008_003_execute(void) {
+  void *p1, *p2, *p3;
+  size_t n, sz;
+  unsigned i;
+
+  /* [8.3.1] Testing initial conditions, the heap must not be fragmented
+     and one free block present.*/
+  test_set_step(1);
+  {
+    test_assert(chHeapStatus(&test_heap, &sz, NULL) == 1, "heap fragmented");
+  }
+  test_end_step(1);
+
+  /* [8.3.2] Growing a block, the adjacent free space is absorbed so the
+     block must not move, finally, integrity is checked.*/
+  test_set_step(2);
+  {
+    p1 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    test_assert(p1 != NULL, "allocation failed");
+    p2 = chHeapRealloc(p1, ALLOC_SIZE * 2);
+    test_assert(p2 == p1, "block moved");
+    test_assert(chHeapGetSize(p2) == ALLOC_SIZE * 2, "wrong size");
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+  }
+  test_end_step(2);
+
+  /* [8.3.3] Shrinking the block, the excess is returned to the heap and
+     merged with the adjacent free space, finally, integrity is checked.*/
+  test_set_step(3);
+  {
+    p2 = chHeapRealloc(p1, ALLOC_SIZE);
+    test_assert(p2 == p1, "block moved");
+    test_assert(chHeapStatus(&test_heap, NULL, NULL) == 1, "heap fragmented");
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+  }
+  test_end_step(3);
+
+  /* [8.3.4] Growing a block followed by an allocated block, the block
+     must be moved and its content preserved, finally, integrity is
+     checked.*/
+  test_set_step(4);
+  {
+    p2 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    test_assert(p2 != NULL, "allocation failed");
+    for (i = 0; i < ALLOC_SIZE; i++) {
+      ((uint8_t *)p1)[i] = (uint8_t)i;
+    }
+    p3 = chHeapRealloc(p1, ALLOC_SIZE * 2);
+    test_assert(p3 != NULL, "reallocation failed");
+    test_assert(p3 != p1, "block not moved");
+    for (i = 0; i < ALLOC_SIZE; i++) {
+      test_assert(((uint8_t *)p3)[i] == (uint8_t)i, "content lost");
+    }
+    chHeapFree(p2);
+    chHeapFree(p3);
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+  }
+  test_end_step(4);
+
+  /* [8.3.5] Growing a block beyond the available space, an error is
+     expected and the block must be left untouched, finally, integrity
+     is checked.*/
+  test_set_step(5);
+  {
+    p1 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    test_assert(p1 != NULL, "allocation failed");
+    p2 = chHeapRealloc(p1, sizeof test_heap_buffer * 2);
+    test_assert(p2 == NULL, "reallocation not failed");
+    test_assert(chHeapGetSize(p1) == ALLOC_SIZE, "size changed");
+    chHeapFree(p1);
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+  }
+  test_end_step(5);
+
+  /* [8.3.6] Testing final conditions. The heap geometry must be the
+     same than the one registered at beginning, finally, integrity is
+     checked.*/
+  test_set_step(6);
+  {
+    test_assert(chHeapStatus(&test_heap, &n, NULL) == 1, "heap fragmented");
+    test_assert(n == sz, "size changed");
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+  }
+  test_end_step(6);
+}
+
+static const testcase_t oslib_test_008_003 = {
+  "Reallocation",
+  oslib_test_008_003_setup,
+  NULL,
+  oslib_test_008_003_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -306,6 +432,7 @@ static const testcase_t oslib_test_008_002 = {
 const testcase_t * const oslib_test_sequence_008_array[] = {
   &oslib_test_008_001,
   &oslib_test_008_002,
+  &oslib_test_008_003,
   NULL
 };
 
@@ -0,0 +1,500 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "oslib_test_root.h"
+
+/**
+ * @file    oslib_test_sequence_010.c
+ * @brief   Test Sequence 010 code.
+ *
+ * @page oslib_test_sequence_010 [10] Message Ports
+ *
+ * File: @ref oslib_test_sequence_010.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the ChibiOS library functionalities related to
+ * message ports.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MSG_PORTS == TRUE
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage oslib_test_010_001
+ * - @subpage oslib_test_010_002
+ * - @subpage oslib_test_010_003
+ * - @subpage oslib_test_010_004
+ * .
+ */
+
+#if (CH_CFG_USE_MSG_PORTS == TRUE) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#define MP_SIZE 4
+#define MP_DATA_SIZE 8
+
+static msg_t mp_buffer1[MSG_PORT_BUFFER_SIZE(MP_DATA_SIZE, MP_SIZE) / sizeof (msg_t)];
+static msg_t mp_buffer2[MSG_PORT_BUFFER_SIZE(0, MP_SIZE) / sizeof (msg_t)];
+static msg_port_t mp1, mp2;
+
+static THD_WORKING_AREA(waThread1, 256);
+static THD_FUNCTION(Thread1, arg) {
+  msg_port_slot_t *slotp;
+
+  (void)arg;
+
+  while (chMsgPortFetchTimeout(&mp1, &slotp, TIME_INFINITE) == MSG_OK) {
+    (void) chMsgPortReply(slotp, slotp->msg + 1);
+    chMsgPortRelease(&mp1, 1);
+  }
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page oslib_test_010_001 [10.1] Message port normal API, non-blocking tests
+ *
+ * <h2>Description</h2>
+ * The message port normal API is tested without triggering blocking
+ * conditions.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.1.1] Testing the port size.
+ * - [10.1.2] Resetting the port, conditions are checked, no errors
+ *   expected.
+ * - [10.1.3] Testing the behavior of API when the port is in reset
+ *   state then return in active state.
+ * - [10.1.4] Filling the port using chMsgPortPostTimeout() with inline
+ *   payloads, no errors expected.
+ * - [10.1.5] Fetching all messages in place using
+ *   chMsgPortFetchBatchTimeout(), slots must not become free before
+ *   release.
+ * - [10.1.6] Posting and then fetching one more message, no errors
+ *   expected.
+ * - [10.1.7] Testing final conditions. Data pointers must be aligned
+ *   to buffer start.
+ * .
+ */
+
+static void oslib_test_010_001_setup(void) {
+  chMsgPortObjectInit(&mp1, mp_buffer1, MP_DATA_SIZE, MP_SIZE);
+}
+
+static void oslib_test_010_001_teardown(void) {
+  chMsgPortReset(&mp1);
+}
+
+static void oslib_test_010_001_execute(void) {
+  msg_port_slot_t *slotp;
+  msg_port_slot_t *slots[MP_SIZE];
+  msg_t msg1;
+  size_t n;
+  unsigned i;
+
+  /* [10.1.1] Testing the port size.*/
+  test_set_step(1);
+  {
+    test_assert(chMsgPortGetSizeX(&mp1) == MP_SIZE, "wrong size");
+    test_assert(chMsgPortGetDataSizeX(&mp1) >= MP_DATA_SIZE, "wrong data size");
+    test_assert_lock(chMsgPortGetFreeCountI(&mp1) == MP_SIZE, "not empty");
+  }
+  test_end_step(1);
+
+  /* [10.1.2] Resetting the port, conditions are checked, no errors
+     expected.*/
+  test_set_step(2);
+  {
+    chMsgPortReset(&mp1);
+    test_assert_lock(chMsgPortGetFreeCountI(&mp1) == MP_SIZE, "not empty");
+    test_assert_lock(chMsgPortGetUsedCountI(&mp1) == 0, "still full");
+    test_assert_lock(mp1.buffer == mp1.wrptr, "write pointer not aligned to base");
+    test_assert_lock(mp1.buffer == mp1.rdptr, "read pointer not aligned to base");
+  }
+  test_end_step(2);
+
+  /* [10.1.3] Testing the behavior of API when the port is in reset
+     state then return in active state.*/
+  test_set_step(3);
+  {
+    msg1 = chMsgPortPostTimeout(&mp1, (msg_t)0, NULL, 0, NULL, TIME_INFINITE);
+    test_assert(msg1 == MSG_RESET, "not in reset state");
+    msg1 = chMsgPortFetchTimeout(&mp1, &slotp, TIME_INFINITE);
+    test_assert(msg1 == MSG_RESET, "not in reset state");
+    n = chMsgPortFetchBatchTimeout(&mp1, slots, MP_SIZE, TIME_INFINITE);
+    test_assert(n == 0, "not in reset state");
+    chMsgPortResumeX(&mp1);
+  }
+  test_end_step(3);
+
+  /* [10.1.4] Filling the port using chMsgPortPostTimeout() with inline
+     payloads, no errors expected.*/
+  test_set_step(4);
+  {
+    for (i = 0; i < MP_SIZE; i++) {
+      char c = 'A' + i;
+      msg1 = chMsgPortPostTimeout(&mp1, (msg_t)i, &c, 1, NULL, TIME_INFINITE);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+    }
+    msg1 = chMsgPortPostTimeout(&mp1, (msg_t)0, NULL, 0, NULL, TIME_IMMEDIATE);
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+    test_assert_lock(chMsgPortGetFreeCountI(&mp1) == 0, "still empty");
+    test_assert_lock(chMsgPortGetUsedCountI(&mp1) == MP_SIZE, "not full");
+    test_assert_lock(mp1.rdptr == mp1.wrptr, "pointers not aligned");
+  }
+  test_end_step(4);
+
+  /* [10.1.5] Fetching all messages in place using
+     chMsgPortFetchBatchTimeout(), slots must not become free before
+     release.*/
+  test_set_step(5);
+  {
+    n = chMsgPortFetchBatchTimeout(&mp1, slots, MP_SIZE, TIME_INFINITE);
+    test_assert(n == MP_SIZE, "wrong batch size");
+    for (i = 0; i < n; i++) {
+      test_assert(slots[i]->msg == (msg_t)i, "wrong message");
+      test_assert(slots[i]->size == 1, "wrong payload size");
+      test_emit_token(*(char *)chMsgPortGetDataX(slots[i]));
+    }
+    test_assert_sequence("ABCD", "wrong get sequence");
+    test_assert_lock(chMsgPortGetUsedCountI(&mp1) == 0, "still full");
+    test_assert_lock(chMsgPortGetFreeCountI(&mp1) == 0, "slots released");
+    chMsgPortRelease(&mp1, n);
+    test_assert_lock(chMsgPortGetFreeCountI(&mp1) == MP_SIZE, "slots not released");
+  }
+  test_end_step(5);
+
+  /* [10.1.6] Posting and then fetching one more message, no errors
+     expected.*/
+  test_set_step(6);
+  {
+    msg1 = chMsgPortPostTimeout(&mp1, (msg_t)'E', NULL, 0, NULL, TIME_INFINITE);
+    test_assert(msg1 == MSG_OK, "wrong wake-up message");
+    msg1 = chMsgPortFetchTimeout(&mp1, &slotp, TIME_INFINITE);
+    test_assert(msg1 == MSG_OK, "wrong wake-up message");
+    test_assert(slotp->msg == (msg_t)'E', "wrong message");
+    chMsgPortRelease(&mp1, 1);
+  }
+  test_end_step(6);
+
+  /* [10.1.7] Testing final conditions. Data pointers must be aligned
+     to buffer start.*/
+  test_set_step(7);
+  {
+    test_assert_lock(chMsgPortGetFreeCountI(&mp1) == MP_SIZE, "not empty");
+    test_assert_lock(chMsgPortGetUsedCountI(&mp1) == 0, "still full");
+    test_assert(mp1.buffer == mp1.wrptr, "write pointer not aligned to base");
+    test_assert(mp1.buffer == mp1.rdptr, "read pointer not aligned to base");
+  }
+  test_end_step(7);
+}
+
+static const testcase_t oslib_test_010_001 = {
+  "Message port normal API, non-blocking tests",
+  oslib_test_010_001_setup,
+  oslib_test_010_001_teardown,
+  oslib_test_010_001_execute
+};
+
+/**
+ * @page oslib_test_010_002 [10.2] Message port I-Class API, non-blocking tests
+ *
+ * <h2>Description</h2>
+ * The message port I-Class API is tested without triggering blocking
+ * conditions.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.2.1] Filling the port using chMsgPortPostI(), no errors
+ *   expected.
+ * - [10.2.2] Emptying the port using chMsgPortFetchI() and
+ *   chMsgPortReleaseI(), no errors expected.
+ * - [10.2.3] Testing final conditions. Data pointers must be aligned
+ *   to buffer start.
+ * .
+ */
+
+static void oslib_test_010_002_setup(void) {
+  chMsgPortObjectInit(&mp1, mp_buffer1, MP_DATA_SIZE, MP_SIZE);
+}
+
+static void oslib_test_010_002_teardown(void) {
+  chMsgPortReset(&mp1);
+}
+
+static void oslib_test_010_002_execute(void) {
+  msg_port_slot_t *slotp;
+  msg_t msg1;
+  unsigned i;
+
+  /* [10.2.1] Filling the port using chMsgPortPostI(), no errors
+     expected.*/
+  test_set_step(1);
+  {
+    for (i = 0; i < MP_SIZE; i++) {
+      chSysLock();
+      msg1 = chMsgPortPostI(&mp1, (msg_t)('A' + i), NULL, 0, NULL);
+      chSysUnlock();
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+    }
+    chSysLock();
+    msg1 = chMsgPortPostI(&mp1, (msg_t)0, NULL, 0, NULL);
+    chSysUnlock();
+    test_assert(msg1 == MSG_TIMEOUT, "port not full");
+  }
+  test_end_step(1);
+
+  /* [10.2.2] Emptying the port using chMsgPortFetchI() and
+     chMsgPortReleaseI(), no errors expected.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < MP_SIZE; i++) {
+      chSysLock();
+      msg1 = chMsgPortFetchI(&mp1, &slotp);
+      chMsgPortReleaseI(&mp1, 1);
+      chSysUnlock();
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+      test_emit_token(slotp->msg);
+    }
+    test_assert_sequence("ABCD", "wrong get sequence");
+    chSysLock();
+    msg1 = chMsgPortFetchI(&mp1, &slotp);
+    chSysUnlock();
+    test_assert(msg1 == MSG_TIMEOUT, "port not empty");
+  }
+  test_end_step(2);
+
+  /* [10.2.3] Testing final conditions. Data pointers must be aligned
+     to buffer start.*/
+  test_set_step(3);
+  {
+    test_assert_lock(chMsgPortGetFreeCountI(&mp1) == MP_SIZE, "not empty");
+    test_assert_lock(chMsgPortGetUsedCountI(&mp1) == 0, "still full");
+    test_assert(mp1.buffer == mp1.wrptr, "write pointer not aligned to base");
+    test_assert(mp1.buffer == mp1.rdptr, "read pointer not aligned to base");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_010_002 = {
+  "Message port I-Class API, non-blocking tests",
+  oslib_test_010_002_setup,
+  oslib_test_010_002_teardown,
+  oslib_test_010_002_execute
+};
+
+/**
+ * @page oslib_test_010_003 [10.3] Message port timeouts
+ *
+ * <h2>Description</h2>
+ * The message port API is tested for timeouts.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.3.1] Filling the port.
+ * - [10.3.2] Testing chMsgPortPostTimeout() timeout.
+ * - [10.3.3] Resetting the port. The port is then returned in active
+ *   state.
+ * - [10.3.4] Testing chMsgPortFetchTimeout() and
+ *   chMsgPortFetchBatchTimeout() timeouts.
+ * .
+ */
+
+static void oslib_test_010_003_setup(void) {
+  chMsgPortObjectInit(&mp1, mp_buffer1, MP_DATA_SIZE, MP_SIZE);
+}
+
+static void oslib_test_010_003_teardown(void) {
+  chMsgPortReset(&mp1);
+}
+
+static void oslib_test_010_003_execute(void) {
+  msg_port_slot_t *slotp;
+  msg_t msg1;
+  size_t n;
+  unsigned i;
+
+  /* [10.3.1] Filling the port.*/
+  test_set_step(1);
+  {
+    for (i = 0; i < MP_SIZE; i++) {
+      msg1 = chMsgPortPostTimeout(&mp1, (msg_t)('A' + i), NULL, 0, NULL, TIME_INFINITE);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+    }
+  }
+  test_end_step(1);
+
+  /* [10.3.2] Testing chMsgPortPostTimeout() timeout.*/
+  test_set_step(2);
+  {
+    msg1 = chMsgPortPostTimeout(&mp1, (msg_t)'X', NULL, 0, NULL, 1);
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+  }
+  test_end_step(2);
+
+  /* [10.3.3] Resetting the port. The port is then returned in active
+     state.*/
+  test_set_step(3);
+  {
+    chMsgPortReset(&mp1);
+    chMsgPortResumeX(&mp1);
+  }
+  test_end_step(3);
+
+  /* [10.3.4] Testing chMsgPortFetchTimeout() and
+     chMsgPortFetchBatchTimeout() timeouts.*/
+  test_set_step(4);
+  {
+    msg1 = chMsgPortFetchTimeout(&mp1, &slotp, 1);
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+    n = chMsgPortFetchBatchTimeout(&mp1, &slotp, 1, 1);
+    test_assert(n == 0, "wrong batch size");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_010_003 = {
+  "Message port timeouts",
+  oslib_test_010_003_setup,
+  oslib_test_010_003_teardown,
+  oslib_test_010_003_execute
+};
+
+/**
+ * @page oslib_test_010_004 [10.4] Message port request/response
+ *
+ * <h2>Description</h2>
+ * A server thread answers requests through reply ports, both the
+ * asynchronous reply and the chMsgPortCall() paths are tested.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.4.1] Starting the server thread at a lower priority.
+ * - [10.4.2] Posting requests with a reply port without waiting, then
+ *   collecting the answers.
+ * - [10.4.3] Performing request/response exchanges using
+ *   chMsgPortCall().
+ * - [10.4.4] Resetting the server port, the server thread terminates.
+ * .
+ */
+
+static void oslib_test_010_004_setup(void) {
+  chMsgPortObjectInit(&mp1, mp_buffer1, MP_DATA_SIZE, MP_SIZE);
+  chMsgPortObjectInit(&mp2, mp_buffer2, 0, MP_SIZE);
+}
+
+static void oslib_test_010_004_teardown(void) {
+  chMsgPortReset(&mp1);
+  chMsgPortReset(&mp2);
+}
+
+static void oslib_test_010_004_execute(void) {
+  thread_t *tp;
+  msg_port_slot_t *slotp;
+  msg_t msg1, msg2;
+  unsigned i;
+
+  /* [10.4.1] Starting the server thread at a lower priority.*/
+  test_set_step(1);
+  {
+    thread_descriptor_t td = {
+      .name  = "server",
+      .wbase = waThread1,
+      .wend  = THD_WORKING_AREA_END(waThread1),
+      .prio  = chThdGetPriorityX() - 1,
+      .funcp = Thread1,
+      .arg   = NULL
+    };
+    tp = chThdCreate(&td);
+  }
+  test_end_step(1);
+
+  /* [10.4.2] Posting requests with a reply port without waiting, then
+     collecting the answers.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < MP_SIZE; i++) {
+      msg1 = chMsgPortPostTimeout(&mp1, (msg_t)('A' + i), NULL, 0, &mp2, TIME_INFINITE);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+    }
+    for (i = 0; i < MP_SIZE; i++) {
+      msg1 = chMsgPortFetchTimeout(&mp2, &slotp, TIME_INFINITE);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+      test_emit_token(slotp->msg);
+      chMsgPortRelease(&mp2, 1);
+    }
+    test_assert_sequence("BCDE", "wrong answers sequence");
+  }
+  test_end_step(2);
+
+  /* [10.4.3] Performing request/response exchanges using
+     chMsgPortCall().*/
+  test_set_step(3);
+  {
+    for (i = 0; i < MP_SIZE; i++) {
+      msg1 = chMsgPortCall(&mp1, &mp2, (msg_t)('a' + i), &msg2, TIME_INFINITE);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+      test_emit_token(msg2);
+    }
+    test_assert_sequence("bcde", "wrong answers sequence");
+  }
+  test_end_step(3);
+
+  /* [10.4.4] Resetting the server port, the server thread
+     terminates.*/
+  test_set_step(4);
+  {
+    chMsgPortReset(&mp1);
+    (void) chThdWait(tp);
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_010_004 = {
+  "Message port request/response",
+  oslib_test_010_004_setup,
+  oslib_test_010_004_teardown,
+  oslib_test_010_004_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const oslib_test_sequence_010_array[] = {
+  &oslib_test_010_001,
+  &oslib_test_010_002,
+  &oslib_test_010_003,
+  &oslib_test_010_004,
+  NULL
+};
+
+/**
+ * @brief   Message Ports.
+ */
+const testsequence_t oslib_test_sequence_010 = {
+  "Message Ports",
+  oslib_test_sequence_010_array
+};
+
+#endif /* CH_CFG_USE_MSG_PORTS == TRUE */
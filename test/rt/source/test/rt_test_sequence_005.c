@@ -34,6 +34,7 @@
  * - @subpage rt_test_005_002
  * - @subpage rt_test_005_003
  * - @subpage rt_test_005_004
+ * - @subpage rt_test_005_005
  * .
  */
 
@@ -46,6 +47,18 @@ static THD_FUNCTION(thread, p) {
   test_emit_token(*(char *)p);
 }
 
+#if CH_DBG_FILL_THREADS == TRUE
+static THD_FUNCTION(stack_user, p) {
+  volatile char buf[THREADS_STACK_SIZE / 2];
+  unsigned i;
+
+  for (i = 0U; i < sizeof buf; i++) {
+    buf[i] = *(char *)p;
+  }
+  test_emit_token(buf[sizeof buf - 1U]);
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -339,6 +352,76 @@ static const testcase_t rt_test_005_004 = {
 };
 #endif /* CH_CFG_USE_MUTEXES == TRUE */
 
+#if (CH_DBG_FILL_THREADS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_005_005 [5.5] Stack high-water mark
+ *
+ * <h2>Description</h2>
+ * The stack usage of threads using different amounts of stack is
+ * measured, the cached high-water mark is verified.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_DBG_FILL_THREADS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [5.5.1] Creating a thread using little stack, waiting for it then
+ *   measuring the unused stack.
+ * - [5.5.2] Creating a thread using a buffer on stack in the same
+ *   working area, the unused stack must decrease at least by the buffer
+ *   size.
+ * - [5.5.3] Measuring again, the cached mark must give the same result.
+ * .
+ */
+
+static void rt_test_005_005_execute(void) {
+  thread_t *tp;
+  size_t u1, u2;
+
+  /* [5.5.1] Creating a thread using little stack, waiting for it then
+     measuring the unused stack.*/
+  test_set_step(1);
+  {
+    tp = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() - 1, thread, "A");
+    chThdWait(tp);
+    u1 = chThdGetStackUnused(tp);
+    test_assert(u1 > 0U, "no unused stack");
+    test_assert(u1 < chThdGetStackSizeX(tp), "no used stack");
+    test_assert_sequence("A", "invalid sequence");
+  }
+  test_end_step(1);
+
+  /* [5.5.2] Creating a thread using a buffer on stack in the same
+     working area, the unused stack must decrease at least by the buffer
+     size.*/
+  test_set_step(2);
+  {
+    tp = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() - 1, stack_user, "B");
+    chThdWait(tp);
+    u2 = chThdGetStackUnused(tp);
+    test_assert(u2 + (THREADS_STACK_SIZE / 2) <= u1, "buffer not accounted");
+    test_assert_sequence("B", "invalid sequence");
+  }
+  test_end_step(2);
+
+  /* [5.5.3] Measuring again, the cached mark must give the same result.*/
+  test_set_step(3);
+  {
+    test_assert(chThdGetStackUnused(tp) == u2, "mark changed");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_005_005 = {
+  "Stack high-water mark",
+  NULL,
+  NULL,
+  rt_test_005_005_execute
+};
+#endif /* CH_DBG_FILL_THREADS == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -352,6 +435,9 @@ const testcase_t * const rt_test_sequence_005_array[] = {
   &rt_test_005_003,
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   &rt_test_005_004,
+#endif
+#if (CH_DBG_FILL_THREADS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_005_005,
 #endif
   NULL
 };
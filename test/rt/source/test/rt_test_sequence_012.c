@@ -46,6 +46,11 @@
  * - @subpage rt_test_012_010
  * - @subpage rt_test_012_011
  * - @subpage rt_test_012_012
+ * - @subpage rt_test_012_013
+ * - @subpage rt_test_012_014
+ * - @subpage rt_test_012_015
+ * - @subpage rt_test_012_016
+ * - @subpage rt_test_012_017
  * .
  */
 
@@ -138,6 +143,68 @@ static THD_FUNCTION(bmk_thread8, p) {
   } while(!chThdShouldTerminateX());
 }
 
+#if CH_CFG_USE_MSG_PORTS || defined(__DOXYGEN__)
+#define MP_BMK_SIZE 8
+
+static msg_t mp_bmk_buffer1[MSG_PORT_BUFFER_SIZE(0, MP_BMK_SIZE) / sizeof (msg_t)];
+static msg_t mp_bmk_buffer2[MSG_PORT_BUFFER_SIZE(0, MP_BMK_SIZE) / sizeof (msg_t)];
+static msg_port_t mp_bmk1, mp_bmk2;
+
+static THD_FUNCTION(bmk_thread9, p) {
+  msg_port_slot_t *slots[MP_BMK_SIZE];
+  msg_t msgs[MP_BMK_SIZE];
+  size_t i, n;
+  bool done = false;
+
+  (void)p;
+  do {
+    n = chMsgPortFetchBatchTimeout(&mp_bmk1, slots, MP_BMK_SIZE, TIME_INFINITE);
+    for (i = 0; i < n; i++) {
+      msgs[i] = slots[i]->msg;
+      if (msgs[i] == (msg_t)0) {
+        done = true;
+      }
+    }
+    (void)chMsgPortReplyBatch(&mp_bmk1, slots, msgs, n);
+  } while (!done && (n > 0));
+}
+
+NOINLINE static unsigned int mp_call_loop_test(void) {
+  systime_t start, end;
+  msg_t msg;
+
+  uint32_t n = 0;
+  start = test_wait_tick();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+  do {
+    (void)chMsgPortCall(&mp_bmk1, &mp_bmk2, 1, &msg, TIME_INFINITE);
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+  (void)chMsgPortCall(&mp_bmk1, &mp_bmk2, 0, &msg, TIME_INFINITE);
+  return n;
+}
+
+NOINLINE static unsigned int mp_post_loop_test(void) {
+  systime_t start, end;
+
+  uint32_t n = 0;
+  start = test_wait_tick();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+  do {
+    (void)chMsgPortPostTimeout(&mp_bmk1, 1, NULL, 0, NULL, TIME_INFINITE);
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+  (void)chMsgPortPostTimeout(&mp_bmk1, 0, NULL, 0, NULL, TIME_INFINITE);
+  return n;
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -1038,6 +1105,401 @@ static const testcase_t rt_test_012_012 = {
   rt_test_012_012_execute
 };
 
+#if (CH_CFG_USE_MSG_PORTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_013 [12.13] Message Ports performance #1
+ *
+ * <h2>Description</h2>
+ * A message port server thread is created with a lower priority than
+ * the client thread, the request/response throughput per second is
+ * measured using chMsgPortCall() and the result printed on the output
+ * log.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MSG_PORTS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.13.1] The server thread is started at a lower priority than
+ *   the current thread.
+ * - [12.13.2] The number of request/response exchanges is counted in a
+ *   one second time window.
+ * - [12.13.3] Score is printed.
+ * .
+ */
+
+static void rt_test_012_013_setup(void) {
+  chMsgPortObjectInit(&mp_bmk1, mp_bmk_buffer1, 0, MP_BMK_SIZE);
+  chMsgPortObjectInit(&mp_bmk2, mp_bmk_buffer2, 0, MP_BMK_SIZE);
+}
+
+static void rt_test_012_013_execute(void) {
+  uint32_t n;
+
+  /* [12.13.1] The server thread is started at a lower priority than
+     the current thread.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()-1, bmk_thread9, NULL);
+  }
+  test_end_step(1);
+
+  /* [12.13.2] The number of request/response exchanges is counted in a
+     one second time window.*/
+  test_set_step(2);
+  {
+    n = mp_call_loop_test();
+    test_wait_threads();
+  }
+  test_end_step(2);
+
+  /* [12.13.3] Score is printed.*/
+  test_set_step(3);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_print(" msgs/S, ");
+    test_printn(n << 1);
+    test_println(" ctxswc/S");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_012_013 = {
+  "Message Ports performance #1",
+  rt_test_012_013_setup,
+  NULL,
+  rt_test_012_013_execute
+};
+#endif /* CH_CFG_USE_MSG_PORTS == TRUE */
+
+#if (CH_CFG_USE_MSG_PORTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_014 [12.14] Message Ports performance #2
+ *
+ * <h2>Description</h2>
+ * A message port server thread is created with an higher priority than
+ * the client thread, the request/response throughput per second is
+ * measured using chMsgPortCall() and the result printed on the output
+ * log.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MSG_PORTS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.14.1] The server thread is started at an higher priority than
+ *   the current thread.
+ * - [12.14.2] The number of request/response exchanges is counted in a
+ *   one second time window.
+ * - [12.14.3] Score is printed.
+ * .
+ */
+
+static void rt_test_012_014_setup(void) {
+  chMsgPortObjectInit(&mp_bmk1, mp_bmk_buffer1, 0, MP_BMK_SIZE);
+  chMsgPortObjectInit(&mp_bmk2, mp_bmk_buffer2, 0, MP_BMK_SIZE);
+}
+
+static void rt_test_012_014_execute(void) {
+  uint32_t n;
+
+  /* [12.14.1] The server thread is started at an higher priority than
+     the current thread.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()+1, bmk_thread9, NULL);
+  }
+  test_end_step(1);
+
+  /* [12.14.2] The number of request/response exchanges is counted in a
+     one second time window.*/
+  test_set_step(2);
+  {
+    n = mp_call_loop_test();
+    test_wait_threads();
+  }
+  test_end_step(2);
+
+  /* [12.14.3] Score is printed.*/
+  test_set_step(3);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_print(" msgs/S, ");
+    test_printn(n << 1);
+    test_println(" ctxswc/S");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_012_014 = {
+  "Message Ports performance #2",
+  rt_test_012_014_setup,
+  NULL,
+  rt_test_012_014_execute
+};
+#endif /* CH_CFG_USE_MSG_PORTS == TRUE */
+
+#if (CH_CFG_USE_MSG_PORTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_015 [12.15] Message Ports performance #3
+ *
+ * <h2>Description</h2>
+ * A message port server thread is created with an higher priority than
+ * the client thread, four lower priority threads crowd the ready list,
+ * the request/response throughput per second is measured and the
+ * result printed on the output log.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MSG_PORTS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.15.1] The server thread is started at an higher priority than
+ *   the current thread.
+ * - [12.15.2] Four threads are started at a lower priority than the
+ *   current thread.
+ * - [12.15.3] The number of request/response exchanges is counted in a
+ *   one second time window.
+ * - [12.15.4] Score is printed.
+ * .
+ */
+
+static void rt_test_012_015_setup(void) {
+  chMsgPortObjectInit(&mp_bmk1, mp_bmk_buffer1, 0, MP_BMK_SIZE);
+  chMsgPortObjectInit(&mp_bmk2, mp_bmk_buffer2, 0, MP_BMK_SIZE);
+}
+
+static void rt_test_012_015_execute(void) {
+  uint32_t n;
+
+  /* [12.15.1] The server thread is started at an higher priority than
+     the current thread.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()+1, bmk_thread9, NULL);
+  }
+  test_end_step(1);
+
+  /* [12.15.2] Four threads are started at a lower priority than the
+     current thread.*/
+  test_set_step(2);
+  {
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, chThdGetPriorityX()-2, bmk_thread3, NULL);
+    threads[2] = chThdCreateStatic(wa[2], WA_SIZE, chThdGetPriorityX()-3, bmk_thread3, NULL);
+    threads[3] = chThdCreateStatic(wa[3], WA_SIZE, chThdGetPriorityX()-4, bmk_thread3, NULL);
+    threads[4] = chThdCreateStatic(wa[4], WA_SIZE, chThdGetPriorityX()-5, bmk_thread3, NULL);
+  }
+  test_end_step(2);
+
+  /* [12.15.3] The number of request/response exchanges is counted in a
+     one second time window.*/
+  test_set_step(3);
+  {
+    n = mp_call_loop_test();
+    test_wait_threads();
+  }
+  test_end_step(3);
+
+  /* [12.15.4] Score is printed.*/
+  test_set_step(4);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_print(" msgs/S, ");
+    test_printn(n << 1);
+    test_println(" ctxswc/S");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_012_015 = {
+  "Message Ports performance #3",
+  rt_test_012_015_setup,
+  NULL,
+  rt_test_012_015_execute
+};
+#endif /* CH_CFG_USE_MSG_PORTS == TRUE */
+
+#if (CH_CFG_USE_MSG_PORTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_016 [12.16] Message Ports performance #4
+ *
+ * <h2>Description</h2>
+ * A message port server thread is created with a lower priority than
+ * the client thread, the client posts messages without waiting for
+ * answers and the server fetches and releases them in batches, the
+ * messages throughput per second is measured and the result printed on
+ * the output log.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MSG_PORTS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.16.1] The server thread is started at a lower priority than
+ *   the current thread.
+ * - [12.16.2] The number of messages posted is counted in a one second
+ *   time window.
+ * - [12.16.3] Score is printed.
+ * .
+ */
+
+static void rt_test_012_016_setup(void) {
+  chMsgPortObjectInit(&mp_bmk1, mp_bmk_buffer1, 0, MP_BMK_SIZE);
+  chMsgPortObjectInit(&mp_bmk2, mp_bmk_buffer2, 0, MP_BMK_SIZE);
+}
+
+static void rt_test_012_016_execute(void) {
+  uint32_t n;
+
+  /* [12.16.1] The server thread is started at a lower priority than
+     the current thread.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()-1, bmk_thread9, NULL);
+  }
+  test_end_step(1);
+
+  /* [12.16.2] The number of messages posted is counted in a one second
+     time window.*/
+  test_set_step(2);
+  {
+    n = mp_post_loop_test();
+    test_wait_threads();
+  }
+  test_end_step(2);
+
+  /* [12.16.3] Score is printed.*/
+  test_set_step(3);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" msgs/S");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_012_016 = {
+  "Message Ports performance #4",
+  rt_test_012_016_setup,
+  NULL,
+  rt_test_012_016_execute
+};
+#endif /* CH_CFG_USE_MSG_PORTS == TRUE */
+
+#if (TEST_CFG_BENCHMARKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_017 [12.17] Latency distributions
+ *
+ * <h2>Description</h2>
+ * Single operations are timed using the realtime counter by the
+ * benchmarks harness, the latency distributions are printed on the
+ * output log.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - TEST_CFG_BENCHMARKS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.17.1] A virtual timer is set and reset.
+ * - [12.17.2] A semaphore is waited and signaled without state
+ *   changes.
+ * - [12.17.3] A mutex is locked and unlocked without state changes.
+ * - [12.17.4] A message is exchanged with a thread at higher priority,
+ *   the time includes two context switches.
+ * .
+ */
+
+static void rt_test_012_017_execute(void) {
+  static virtual_timer_t vt1;
+  rtcnt_t start;
+
+  /* [12.17.1] A virtual timer is set and reset.*/
+  test_set_step(1);
+  {
+    test_bmk_begin("Virtual timer set/reset");
+    do {
+      start = test_bmk_now();
+      chSysLock();
+      chVTDoSetI(&vt1, 1, tmo, NULL);
+      chVTDoResetI(&vt1);
+      chSysUnlock();
+    } while (!test_bmk_sample(start));
+    test_bmk_end(NULL);
+  }
+  test_end_step(1);
+
+  /* [12.17.2] A semaphore is waited and signaled without state changes.*/
+  test_set_step(2);
+  {
+#if CH_CFG_USE_SEMAPHORES == TRUE
+    chSemObjectInit(&sem1, 1);
+    test_bmk_begin("Semaphore wait/signal");
+    do {
+      start = test_bmk_now();
+      chSemWait(&sem1);
+      chSemSignal(&sem1);
+    } while (!test_bmk_sample(start));
+    test_bmk_end(NULL);
+#endif
+  }
+  test_end_step(2);
+
+  /* [12.17.3] A mutex is locked and unlocked without state changes.*/
+  test_set_step(3);
+  {
+#if CH_CFG_USE_MUTEXES == TRUE
+    chMtxObjectInit(&mtx1);
+    test_bmk_begin("Mutex lock/unlock");
+    do {
+      start = test_bmk_now();
+      chMtxLock(&mtx1);
+      chMtxUnlock(&mtx1);
+    } while (!test_bmk_sample(start));
+    test_bmk_end(NULL);
+#endif
+  }
+  test_end_step(3);
+
+  /* [12.17.4] A message is exchanged with a thread at higher priority,
+     the time includes two context switches.*/
+  test_set_step(4);
+  {
+#if CH_CFG_USE_MESSAGES == TRUE
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()+1, bmk_thread1, NULL);
+    test_bmk_begin("Message round trip");
+    do {
+      start = test_bmk_now();
+      (void)chMsgSend(threads[0], 1);
+    } while (!test_bmk_sample(start));
+    (void)chMsgSend(threads[0], 0);
+    test_wait_threads();
+    test_bmk_end(NULL);
+#endif
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_012_017 = {
+  "Latency distributions",
+  NULL,
+  NULL,
+  rt_test_012_017_execute
+};
+#endif /* TEST_CFG_BENCHMARKS == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -1070,6 +1532,21 @@ const testcase_t * const rt_test_sequence_012_array[] = {
   &rt_test_012_011,
 #endif
   &rt_test_012_012,
+#if (CH_CFG_USE_MSG_PORTS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_012_013,
+#endif
+#if (CH_CFG_USE_MSG_PORTS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_012_014,
+#endif
+#if (CH_CFG_USE_MSG_PORTS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_012_015,
+#endif
+#if (CH_CFG_USE_MSG_PORTS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_012_016,
+#endif
+#if (TEST_CFG_BENCHMARKS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_012_017,
+#endif
   NULL
 };
 
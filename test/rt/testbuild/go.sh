@@ -122,6 +122,8 @@ test cfg32 "-DCH_CFG_ST_RESOLUTION=16 -DCH_CFG_INTERVALS_SIZE=64"
 test cfg33 "-DCH_CFG_INTERVALS_SIZE=64"
 test cfg34 "-DCH_CFG_USE_OBJ_FIFOS=FALSE"
 test cfg35 "-DCH_CFG_USE_FACTORY=FALSE"
+test cfg36 "-DCH_CFG_USE_MSG_PORTS=FALSE"
+test cfg37 "-DTEST_CFG_BENCHMARKS=TRUE"
 
 rm *log.txt 2> /dev/null
 echo
@@ -37,6 +37,7 @@ DEFS_CFG32 = -DCH_CFG_ST_RESOLUTION=16 -DCH_CFG_INTERVALS_SIZE=64
 DEFS_CFG33 = -DCH_CFG_INTERVALS_SIZE=64
 DEFS_CFG34 = -DCH_CFG_USE_OBJ_FIFOS=FALSE
 DEFS_CFG35 = -DCH_CFG_USE_FACTORY=FALSE
+DEFS_CFG36 = -DCH_CFG_USE_MSG_PORTS=FALSE
 
 #
 # Options for test configurations
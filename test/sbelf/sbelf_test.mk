@@ -0,0 +1,6 @@
+# List of all the ChibiOS/SB ELF loader test files.
+TESTSRC += ${CHIBIOS}/test/sbelf/source/test/sbelf_test_root.c \
+           ${CHIBIOS}/test/sbelf/source/test/sbelf_test_sequence_001.c
+
+# Required include directories
+TESTINC += ${CHIBIOS}/test/sbelf/source/test
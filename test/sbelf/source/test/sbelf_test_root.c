@@ -0,0 +1,149 @@
+/*
+    ChibiOS - Copyright (C) 2006..2025 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @mainpage Test Suite Specification
+ * Test suite for the ChibiOS/SB ELF loader. The purpose of this suite
+ * is to verify the in-place access to read-only sections of
+ * memory-mapped files.
+ *
+ * <h2>Test Sequences</h2>
+ * - @subpage sbelf_test_sequence_001
+ * .
+ */
+
+/**
+ * @file    sbelf_test_root.c
+ * @brief   Test Suite root structures code.
+ */
+
+#include "hal.h"
+#include "sbelf_test_root.h"
+
+#if !defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Array of test sequences.
+ */
+const testsequence_t * const sbelf_test_suite_array[] = {
+  &sbelf_test_sequence_001,
+  NULL
+};
+
+/**
+ * @brief   Test suite root structure.
+ */
+const testsuite_t sbelf_test_suite = {
+  "ChibiOS/SB ELF Loader Test Suite",
+  sbelf_test_suite_array
+};
+
+/*===========================================================================*/
+/* Shared code.                                                              */
+/*===========================================================================*/
+
+#include <stddef.h>
+#include "sb.h"
+
+/* ELF constants used in the test images.*/
+#define SBELF_SHT_PROGBITS      1U
+#define SBELF_SHT_SYMTAB        2U
+#define SBELF_SHT_NOBITS        8U
+#define SBELF_SHT_REL           9U
+#define SBELF_SHF_WRITE         (1U << 0)
+#define SBELF_SHF_ALLOC         (1U << 1)
+#define SBELF_SHF_EXECINSTR     (1U << 2)
+#define SBELF_SHF_INFO_LINK     (1U << 6)
+#define SBELF_R_ARM_ABS32       2U
+#define SBELF_R_ARM_REL32       3U
+
+/* Section header, name, type, flags, addr, offset, size, link, info,
+   alignment and entry size.*/
+#define SBELF_SHDR(type, flags, addr, field, size, link, info, entsize)     \
+  {0U, (type), (flags), (addr), offsetof(sbelf_image_t, field), (size),     \
+   (link), (info), 4U, (entsize)}
+
+/* Test image, the data section refers the read-only data section using
+   the specified relocation type, the code section always uses an absolute
+   relocation in its literal pool.*/
+#define SBELF_IMAGE(reltype) {                                              \
+  .hdr = {                                                                  \
+    .ident      = {0x7f, 0x45, 0x4c, 0x46, 0x01, 0x01, 0x01, 0x00},         \
+    .type       = 2U,                                                       \
+    .machine    = 40U,                                                      \
+    .version    = 1U,                                                       \
+    .shoff      = offsetof(sbelf_image_t, shdr),                            \
+    .ehsize     = 52U,                                                      \
+    .shentsize  = 40U,                                                      \
+    .shnum      = 8U                                                        \
+  },                                                                        \
+  .text         = {0x11111111U, 0x22222222U, 0x33333333U,                   \
+                   SBELF_RODATA_ADDR + 4U},                                 \
+  .rodata       = {SBELF_RODATA_WORD(0), SBELF_RODATA_WORD(1),              \
+                   SBELF_RODATA_WORD(2), SBELF_RODATA_WORD(3)},             \
+  .data         = {SBELF_RODATA_ADDR + 4U, 0x12345678U},                    \
+  .rel_text     = {SBELF_TEXT_ADDR + 12U, (1U << 8) | SBELF_R_ARM_ABS32},   \
+  .rel_data     = {SBELF_DATA_ADDR, (1U << 8) | (reltype)},                 \
+  .symtab       = {                                                         \
+    {0U, 0U, 0U, 0U},                                                       \
+    {0U, SBELF_RODATA_ADDR, 0U, 3U | (2U << 16)}                            \
+  },                                                                        \
+  .shdr         = {                                                         \
+    {0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U},                               \
+    SBELF_SHDR(SBELF_SHT_PROGBITS, SBELF_SHF_ALLOC | SBELF_SHF_EXECINSTR,   \
+               SBELF_TEXT_ADDR, text, 16U, 0U, 0U, 0U),                     \
+    SBELF_SHDR(SBELF_SHT_PROGBITS, SBELF_SHF_ALLOC,                         \
+               SBELF_RODATA_ADDR, rodata, 16U, 0U, 0U, 0U),                 \
+    SBELF_SHDR(SBELF_SHT_PROGBITS, SBELF_SHF_ALLOC | SBELF_SHF_WRITE,       \
+               SBELF_DATA_ADDR, data, 8U, 0U, 0U, 0U),                      \
+    SBELF_SHDR(SBELF_SHT_NOBITS, SBELF_SHF_ALLOC | SBELF_SHF_WRITE,         \
+               SBELF_BSS_ADDR, shdr, 8U, 0U, 0U, 0U),                       \
+    SBELF_SHDR(SBELF_SHT_REL, SBELF_SHF_INFO_LINK,                          \
+               0U, rel_text, 8U, 7U, 1U, 8U),                               \
+    SBELF_SHDR(SBELF_SHT_REL, SBELF_SHF_INFO_LINK,                          \
+               0U, rel_data, 8U, 7U, 3U, 8U),                               \
+    SBELF_SHDR(SBELF_SHT_SYMTAB, 0U,                                        \
+               0U, symtab, 32U, 0U, 1U, 16U)                                \
+  }                                                                         \
+}
+
+/* Image with an absolute reference from data to read-only data.*/
+const sbelf_image_t sbelf_image_abs = SBELF_IMAGE(SBELF_R_ARM_ABS32);
+
+/* Image with a PC-relative reference from data to read-only data.*/
+const sbelf_image_t sbelf_image_rel = SBELF_IMAGE(SBELF_R_ARM_REL32);
+
+/* RAM area where the images are loaded.*/
+uint32_t sbelf_ram[16];
+
+const memory_area_t sbelf_map = {
+  (uint8_t *)sbelf_ram, sizeof sbelf_ram
+};
+
+/* ROM FS exposing the images as files.*/
+vfs_romfs_driver_c sbelf_romfs;
+
+const drv_romfs_element_t sbelf_files[] = {
+  {"abs.elf", (const uint8_t *)&sbelf_image_abs, sizeof (sbelf_image_t)},
+  {"rel.elf", (const uint8_t *)&sbelf_image_rel, sizeof (sbelf_image_t)},
+  {NULL, NULL, 0U}
+};
+
+#endif /* !defined(__DOXYGEN__) */
@@ -0,0 +1,103 @@
+/*
+    ChibiOS - Copyright (C) 2006..2025 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    sbelf_test_root.h
+ * @brief   Test Suite root structures header.
+ */
+
+#ifndef SBELF_TEST_ROOT_H
+#define SBELF_TEST_ROOT_H
+
+#include "ch_test.h"
+
+#include "sbelf_test_sequence_001.h"
+
+#if !defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern const testsuite_t sbelf_test_suite;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Shared definitions.                                                       */
+/*===========================================================================*/
+
+#include "sb.h"
+
+#define TEST_SUITE_NAME "ChibiOS/SB ELF Loader Test Suite"
+
+/* Link addresses of the sections in the test images.*/
+#define SBELF_TEXT_ADDR         0x00U
+#define SBELF_RODATA_ADDR       0x10U
+#define SBELF_DATA_ADDR         0x20U
+#define SBELF_BSS_ADDR          0x28U
+
+/* Content of the read-only data section.*/
+#define SBELF_RODATA_WORD(i)    (0xA0A0A0A0U + ((uint32_t)(i) * 0x01010101U))
+
+/* Fill value of the RAM area before loading.*/
+#define SBELF_FILL_WORD         0x55555555U
+
+/*
+ * Minimal ELF executable image, a code section and a data section both
+ * refer the second word of a read-only data section.
+ */
+typedef struct {
+  struct {
+    uint8_t             ident[16];
+    uint16_t            type;
+    uint16_t            machine;
+    uint32_t            version;
+    uint32_t            entry;
+    uint32_t            phoff;
+    uint32_t            shoff;
+    uint32_t            flags;
+    uint16_t            ehsize;
+    uint16_t            phentsize;
+    uint16_t            phnum;
+    uint16_t            shentsize;
+    uint16_t            shnum;
+    uint16_t            shstrndx;
+  }                     hdr;
+  uint32_t              text[4];
+  uint32_t              rodata[4];
+  uint32_t              data[2];
+  uint32_t              rel_text[2];
+  uint32_t              rel_data[2];
+  uint32_t              symtab[2][4];
+  uint32_t              shdr[8][10];
+} sbelf_image_t;
+
+extern const sbelf_image_t sbelf_image_abs;
+extern const sbelf_image_t sbelf_image_rel;
+extern const drv_romfs_element_t sbelf_files[];
+extern uint32_t sbelf_ram[16];
+extern const memory_area_t sbelf_map;
+extern vfs_romfs_driver_c sbelf_romfs;
+
+#endif /* !defined(__DOXYGEN__) */
+
+#endif /* SBELF_TEST_ROOT_H */
@@ -0,0 +1,331 @@
+/*
+    ChibiOS - Copyright (C) 2006..2025 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "sbelf_test_root.h"
+
+/**
+ * @file    sbelf_test_sequence_001.c
+ * @brief   Test Sequence 001 code.
+ *
+ * @page sbelf_test_sequence_001 [1] In-place access tests
+ *
+ * File: @ref sbelf_test_sequence_001.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the ELF loader with images stored in a ROM FS,
+ * read-only sections inside the executable region are accessed in
+ * place unless relocations make it impossible.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage sbelf_test_001_001
+ * - @subpage sbelf_test_001_002
+ * - @subpage sbelf_test_001_003
+ * - @subpage sbelf_test_001_004
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+#include "sb.h"
+
+/* RAM address of a link address.*/
+#define RAM_ADDR(addr)      ((uint32_t)sbelf_ram + (uint32_t)(addr))
+
+/* RAM word at a link address.*/
+#define RAM_WORD(addr)      (sbelf_ram[(addr) / 4U])
+
+/* Address of the referred word inside an image.*/
+#define ROM_ADDR(image)     ((uint32_t)&(image).rodata[1])
+
+static void fill_ram(void) {
+  unsigned i;
+
+  for (i = 0U; i < sizeof sbelf_ram / sizeof sbelf_ram[0]; i++) {
+    sbelf_ram[i] = SBELF_FILL_WORD;
+  }
+}
+
+static msg_t load(const char *path, const sbelf_image_t *xip, size_t n) {
+  memory_area_t xmap;
+
+  fill_ram();
+  if (xip == NULL) {
+    return sbElfLoadFile((vfs_driver_c *)&sbelf_romfs, path, &sbelf_map);
+  }
+
+  xmap.base = (uint8_t *)xip;
+  xmap.size = n;
+  return sbElfLoadFileInPlace((vfs_driver_c *)&sbelf_romfs, path,
+                              &sbelf_map, &xmap);
+}
+
+static bool rodata_in_ram(void) {
+  unsigned i;
+
+  for (i = 0U; i < 4U; i++) {
+    if (RAM_WORD(SBELF_RODATA_ADDR + (i * 4U)) != SBELF_RODATA_WORD(i)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page sbelf_test_001_001 [1.1] Loading without in-place access
+ *
+ * <h2>Description</h2>
+ * The image is loaded without an executable region, all sections are
+ * copied in RAM and relocated to the RAM area.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.1.1] The image is loaded, success is expected.
+ * - [1.1.2] All sections are in RAM and the references point to the
+ *   read-only data in RAM.
+ * .
+ */
+
+static void sbelf_test_001_001_setup(void) {
+  romfsdrvObjectInit(&sbelf_romfs, sbelf_files);
+}
+
+static void sbelf_test_001_001_execute(void) {
+
+  /* [1.1.1] The image is loaded, success is expected.*/
+  test_set_step(1);
+  {
+    msg_t ret;
+
+    ret = load("/abs.elf", NULL, 0U);
+    test_assert(ret == CH_RET_SUCCESS, "load failed");
+  }
+  test_end_step(1);
+
+  /* [1.1.2] All sections are in RAM and the references point to the
+     read-only data in RAM.*/
+  test_set_step(2);
+  {
+    test_assert(RAM_WORD(SBELF_TEXT_ADDR) == 0x11111111U, "code not loaded");
+    test_assert(rodata_in_ram(), "read-only data not loaded");
+    test_assert(RAM_WORD(SBELF_TEXT_ADDR + 12U) == RAM_ADDR(SBELF_RODATA_ADDR + 4U),
+                "wrong code reference");
+    test_assert(RAM_WORD(SBELF_DATA_ADDR) == RAM_ADDR(SBELF_RODATA_ADDR + 4U),
+                "wrong data reference");
+    test_assert(RAM_WORD(SBELF_DATA_ADDR + 4U) == 0x12345678U, "data not loaded");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t sbelf_test_001_001 = {
+  "Loading without in-place access",
+  sbelf_test_001_001_setup,
+  NULL,
+  sbelf_test_001_001_execute
+};
+
+/**
+ * @page sbelf_test_001_002 [1.2] Read-only data accessed in place
+ *
+ * <h2>Description</h2>
+ * The image is inside the executable region, the read-only data
+ * section has no relocations and is accessed in place. The code and
+ * data sections referring it through absolute relocations are loaded
+ * in RAM and relocated to the mapped section.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.2.1] The image is loaded with the executable region covering
+ *   it, success is expected.
+ * - [1.2.2] The read-only data has not been copied, the code and data
+ *   sections are in RAM and refer the read-only data inside the image.
+ * .
+ */
+
+static void sbelf_test_001_002_setup(void) {
+  romfsdrvObjectInit(&sbelf_romfs, sbelf_files);
+}
+
+static void sbelf_test_001_002_execute(void) {
+
+  /* [1.2.1] The image is loaded with the executable region covering
+     it, success is expected.*/
+  test_set_step(1);
+  {
+    msg_t ret;
+
+    ret = load("/abs.elf", &sbelf_image_abs, sizeof sbelf_image_abs);
+    test_assert(ret == CH_RET_SUCCESS, "load failed");
+  }
+  test_end_step(1);
+
+  /* [1.2.2] The read-only data has not been copied, the code and data
+     sections are in RAM and refer the read-only data inside the
+     image.*/
+  test_set_step(2);
+  {
+    test_assert(RAM_WORD(SBELF_TEXT_ADDR) == 0x11111111U, "code not loaded");
+    test_assert(RAM_WORD(SBELF_RODATA_ADDR) == SBELF_FILL_WORD,
+                "read-only data copied");
+    test_assert(RAM_WORD(SBELF_TEXT_ADDR + 12U) == ROM_ADDR(sbelf_image_abs),
+                "wrong code reference");
+    test_assert(RAM_WORD(SBELF_DATA_ADDR) == ROM_ADDR(sbelf_image_abs),
+                "wrong data reference");
+    test_assert(RAM_WORD(SBELF_DATA_ADDR + 4U) == 0x12345678U, "data not loaded");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t sbelf_test_001_002 = {
+  "Read-only data accessed in place",
+  sbelf_test_001_002_setup,
+  NULL,
+  sbelf_test_001_002_execute
+};
+
+/**
+ * @page sbelf_test_001_003 [1.3] PC-relative reference to read-only data
+ *
+ * <h2>Description</h2>
+ * The data section refers the read-only data section through a
+ * PC-relative relocation, the displacement would be wrong with the
+ * read-only data accessed in place so it is moved in RAM.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.3.1] The image is loaded with the executable region covering
+ *   it, success is expected.
+ * - [1.3.2] All sections are in RAM and the absolute reference points
+ *   to the read-only data in RAM.
+ * .
+ */
+
+static void sbelf_test_001_003_setup(void) {
+  romfsdrvObjectInit(&sbelf_romfs, sbelf_files);
+}
+
+static void sbelf_test_001_003_execute(void) {
+
+  /* [1.3.1] The image is loaded with the executable region covering
+     it, success is expected.*/
+  test_set_step(1);
+  {
+    msg_t ret;
+
+    ret = load("/rel.elf", &sbelf_image_rel, sizeof sbelf_image_rel);
+    test_assert(ret == CH_RET_SUCCESS, "load failed");
+  }
+  test_end_step(1);
+
+  /* [1.3.2] All sections are in RAM and the absolute reference points
+     to the read-only data in RAM.*/
+  test_set_step(2);
+  {
+    test_assert(RAM_WORD(SBELF_TEXT_ADDR) == 0x11111111U, "code not loaded");
+    test_assert(rodata_in_ram(), "read-only data not loaded");
+    test_assert(RAM_WORD(SBELF_TEXT_ADDR + 12U) == RAM_ADDR(SBELF_RODATA_ADDR + 4U),
+                "wrong code reference");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t sbelf_test_001_003 = {
+  "PC-relative reference to read-only data",
+  sbelf_test_001_003_setup,
+  NULL,
+  sbelf_test_001_003_execute
+};
+
+/**
+ * @page sbelf_test_001_004 [1.4] Image outside the executable region
+ *
+ * <h2>Description</h2>
+ * The executable region covers only the start of the image, the
+ * read-only data section is outside and is loaded in RAM.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.4.1] The image is loaded with an executable region not covering
+ *   the read-only data, success is expected.
+ * - [1.4.2] All sections are in RAM and the references point to the
+ *   read-only data in RAM.
+ * .
+ */
+
+static void sbelf_test_001_004_setup(void) {
+  romfsdrvObjectInit(&sbelf_romfs, sbelf_files);
+}
+
+static void sbelf_test_001_004_execute(void) {
+
+  /* [1.4.1] The image is loaded with an executable region not covering
+     the read-only data, success is expected.*/
+  test_set_step(1);
+  {
+    msg_t ret;
+
+    ret = load("/abs.elf", &sbelf_image_abs, offsetof(sbelf_image_t, rodata));
+    test_assert(ret == CH_RET_SUCCESS, "load failed");
+  }
+  test_end_step(1);
+
+  /* [1.4.2] All sections are in RAM and the references point to the
+     read-only data in RAM.*/
+  test_set_step(2);
+  {
+    test_assert(rodata_in_ram(), "read-only data not loaded");
+    test_assert(RAM_WORD(SBELF_TEXT_ADDR + 12U) == RAM_ADDR(SBELF_RODATA_ADDR + 4U),
+                "wrong code reference");
+    test_assert(RAM_WORD(SBELF_DATA_ADDR) == RAM_ADDR(SBELF_RODATA_ADDR + 4U),
+                "wrong data reference");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t sbelf_test_001_004 = {
+  "Image outside the executable region",
+  sbelf_test_001_004_setup,
+  NULL,
+  sbelf_test_001_004_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const sbelf_test_sequence_001_array[] = {
+  &sbelf_test_001_001,
+  &sbelf_test_001_002,
+  &sbelf_test_001_003,
+  &sbelf_test_001_004,
+  NULL
+};
+
+/**
+ * @brief   In-place access tests.
+ */
+const testsequence_t sbelf_test_sequence_001 = {
+  "In-place access tests",
+  sbelf_test_sequence_001_array
+};
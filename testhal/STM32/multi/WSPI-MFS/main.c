@@ -18,6 +18,7 @@
 
 #include "ch.h"
 #include "hal.h"
+#include "chprintf.h"
 
 #include "hal_xsnor_micron_n25q.h"
 #include "hal_xsnor_macronix_mx25.h"
@@ -64,6 +65,45 @@ const MFSConfig mfscfg1 = {
   .bank1_sectors    = 1U
 };
 
+/*
+ * Read latency during a sector erase, sector 2 is read while sector 3 is
+ * being erased, both are outside the MFS banks.
+ */
+static uint8_t rdbuf[256];
+
+static void read_during_erase_bench(BaseSequentialStream *chp) {
+  BaseFlash *flp = mfscfg1.flashp;
+  const flash_descriptor_t *fdp = flashGetDescriptor(flp);
+  flash_error_t err;
+  systime_t start;
+  sysinterval_t worst = (sysinterval_t)0;
+  unsigned reads = 0U, busy = 0U;
+
+  chprintf(chp, "\r\n*** Read latency during erase\r\n");
+  err = flashStartEraseSector(flp, 3U);
+  if (err != FLASH_NO_ERROR) {
+    chprintf(chp, "erase start failed (%d)\r\n", err);
+    return;
+  }
+  do {
+    start = chVTGetSystemTimeX();
+    err = flashRead(flp, 2U * fdp->sectors_size, sizeof rdbuf, rdbuf);
+    if (err == FLASH_NO_ERROR) {
+      sysinterval_t t = chTimeDiffX(start, chVTGetSystemTimeX());
+      if (t > worst) {
+        worst = t;
+      }
+      reads++;
+    }
+    else {
+      busy++;
+    }
+    err = flashQueryErase(flp, NULL);
+  } while (err == FLASH_BUSY_ERASING);
+  chprintf(chp, "erase result %d, reads %u, busy %u, worst %u ms\r\n",
+           err, reads, busy, (unsigned)chTimeI2MS(worst));
+}
+
 /*
  * LED blinker thread, times are in milliseconds.
  */
@@ -127,6 +167,7 @@ int main(void) {
   /* Normal main() thread activity, in this demo it does nothing.*/
   while (true) {
     if (palReadLine(PORTAB_LINE_BUTTON) == PORTAB_BUTTON_PRESSED) {
+       read_during_erase_bench((BaseSequentialStream *)&PORTAB_SD1);
        test_execute((BaseSequentialStream *)&PORTAB_SD1, &mfs_test_suite);
     }
     chThdSleepMilliseconds(500);
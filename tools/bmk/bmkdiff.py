@@ -0,0 +1,85 @@
+#!/usr/bin/env python
+
+"""Compare benchmark results in a test log against a baseline log."""
+
+import argparse
+import json
+import sys
+
+BMK_TAG = '--- BMK '
+FIELDS = ['min', 'median', 'p99', 'max']
+
+
+def load(path):
+    results = {}
+    with open(path) as fd:
+        for line in fd:
+            pos = line.find(BMK_TAG)
+            if pos < 0:
+                continue
+            try:
+                bmk = json.loads(line[pos + len(BMK_TAG):].strip())
+            except ValueError:
+                continue
+            results[bmk['name']] = bmk
+    return results
+
+
+def delta(old, new):
+    if old == 0:
+        return 0.0 if new == 0 else float('inf')
+    return (new - old) * 100.0 / old
+
+
+def compare(args, fd):
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    fd.write('{:<32} {:>7} {:>10} {:>10} {:>9}\n'.format(
+        'benchmark', 'field', 'baseline', 'current', 'delta'))
+
+    regressions = 0
+    for name in sorted(set(baseline) | set(current)):
+        if name not in current:
+            fd.write('{:<32} missing in current results\n'.format(name))
+            continue
+        if name not in baseline:
+            fd.write('{:<32} missing in baseline\n'.format(name))
+            continue
+        for field in FIELDS:
+            old = baseline[name][field]
+            new = current[name][field]
+            d = delta(old, new)
+            mark = ''
+            if field in args.fields and d > args.threshold:
+                mark = ' <<'
+                regressions += 1
+            fd.write('{:<32} {:>7} {:>10} {:>10} {:>+8.1f}%{}\n'.format(
+                name, field, old, new, d, mark))
+
+    if regressions > 0:
+        fd.write('\nFAILED ({} regressions above {:.1f}%)\n'.format(
+            regressions, args.threshold))
+        return 1
+
+    fd.write('\nOK\n')
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=(
+        'Compare benchmark results against a baseline'
+    ))
+    parser.add_argument('baseline', help='Baseline test log')
+    parser.add_argument('current', help='Current test log')
+    parser.add_argument('-t', '--threshold', type=float, default=5.0,
+                        help='Regression threshold in percent')
+    parser.add_argument('-f', '--fields', nargs='+', default=['median', 'p99'],
+                        choices=FIELDS, help='Fields checked for regressions')
+    args = parser.parse_args()
+
+    sys.exit(compare(args, sys.stdout))
+
+
+if __name__ == '__main__':
+    main()